@@ -37,11 +37,7 @@ ROCKSDB_EXTERNAL_DEPS = [
 ROCKSDB_OS_DEPS = [
     (
         "linux",
-        ["third-party//numa:numa", "third-party//liburing:uring", "third-party//tbb:tbb"],
-    ),
-    (
-        "macos",
-        ["third-party//tbb:tbb"],
+        ["third-party//numa:numa", "third-party//liburing:uring"],
     ),
 ]
 
@@ -61,7 +57,6 @@ ROCKSDB_OS_PREPROCESSOR_FLAGS = [
             "-DNUMA",
             "-DROCKSDB_PLATFORM_POSIX",
             "-DROCKSDB_LIB_IO_POSIX",
-            "-DTBB",
         ],
     ),
     (
@@ -70,7 +65,6 @@ ROCKSDB_OS_PREPROCESSOR_FLAGS = [
             "-DOS_MACOSX",
             "-DROCKSDB_PLATFORM_POSIX",
             "-DROCKSDB_LIB_IO_POSIX",
-            "-DTBB",
         ],
     ),
     (
@@ -14,6 +14,7 @@ int main() {
 #include <stdio.h>
 #include <sys/types.h>
 #include <cinttypes>
+#include <cstdlib>
 #include <limits>
 
 #include "port/port.h"
@@ -25,6 +26,7 @@ int main() {
 #include "util/hash.h"
 #include "util/mutexlock.h"
 #include "util/random.h"
+#include "util/string_util.h"
 
 using GFLAGS_NAMESPACE::ParseCommandLineFlags;
 
@@ -33,6 +35,10 @@ static constexpr uint32_t MiB = KiB << 10;
 static constexpr uint64_t GiB = MiB << 10;
 
 DEFINE_uint32(threads, 16, "Number of concurrent threads to run.");
+DEFINE_string(thread_counts, "",
+              "If non-empty, comma-separated list of thread counts (e.g. "
+              "1,8,32,64,128) to run the benchmark with one after another, "
+              "overriding --threads. Useful to see how the cache scales.");
 DEFINE_uint64(cache_size, 1 * GiB,
               "Number of bytes to use as a cache of uncompressed data.");
 DEFINE_uint32(num_shard_bits, 6, "shard_bits.");
@@ -56,7 +62,9 @@ DEFINE_uint32(lookup_percent, 10,
 DEFINE_uint32(erase_percent, 1,
               "Ratio of erase to total workload (expressed as a percentage)");
 
-DEFINE_bool(use_clock_cache, false, "");
+DEFINE_bool(use_clock_cache, false,
+            "Use ClockCache instead of LRUCache. ClockCache doesn't take the "
+            "shard mutex on Lookup() and Release().");
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -365,17 +373,37 @@ int main(int argc, char** argv) {
     exit(1);
   }
 
-  ROCKSDB_NAMESPACE::CacheBench bench;
-  if (FLAGS_populate_cache) {
-    bench.PopulateCache();
-    printf("Population complete\n");
-    printf("----------------------------\n");
-  }
-  if (bench.Run()) {
-    return 0;
+  std::vector<uint32_t> thread_counts;
+  if (FLAGS_thread_counts.empty()) {
+    thread_counts.push_back(FLAGS_threads);
   } else {
-    return 1;
+    for (const std::string& count :
+         ROCKSDB_NAMESPACE::StringSplit(FLAGS_thread_counts, ',')) {
+      int threads = std::atoi(count.c_str());
+      if (threads <= 0) {
+        fprintf(stderr, "invalid thread count in --thread_counts: %s\n",
+                count.c_str());
+        exit(1);
+      }
+      thread_counts.push_back(static_cast<uint32_t>(threads));
+    }
+  }
+
+  const uint64_t ops_per_thread = FLAGS_ops_per_thread;
+  for (uint32_t threads : thread_counts) {
+    FLAGS_threads = threads;
+    FLAGS_ops_per_thread = ops_per_thread;
+    ROCKSDB_NAMESPACE::CacheBench bench;
+    if (FLAGS_populate_cache) {
+      bench.PopulateCache();
+      printf("Population complete\n");
+      printf("----------------------------\n");
+    }
+    if (!bench.Run()) {
+      return 1;
+    }
   }
+  return 0;
 }
 
 #endif  // GFLAGS
@@ -9,6 +9,7 @@
 
 #include "rocksdb/cache.h"
 
+#include <atomic>
 #include <forward_list>
 #include <functional>
 #include <iostream>
@@ -18,6 +19,7 @@
 #include "cache/lru_cache.h"
 #include "test_util/testharness.h"
 #include "util/coding.h"
+#include "util/random.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -757,6 +759,63 @@ TEST_P(CacheTest, GetCharge) {
   cache_->Release(h1);
 }
 
+TEST_P(CacheTest, ManyKeysWithErase) {
+  // Enough keys to make the hash tables of the shards grow several times.
+  const int kNumKeys = 10000;
+  std::shared_ptr<Cache> cache = NewCache(2 * kNumKeys, 2, false);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(cache->Insert(EncodeKey(i), EncodeValue(i), 1, &dumbDeleter));
+  }
+  for (int i = 0; i < kNumKeys; i += 3) {
+    cache->Erase(EncodeKey(i));
+  }
+  for (int i = 0; i < kNumKeys; i++) {
+    if (i % 3 == 0) {
+      ASSERT_EQ(-1, Lookup(cache, i));
+    } else {
+      ASSERT_EQ(i, Lookup(cache, i));
+    }
+  }
+  ASSERT_EQ(kNumKeys - (kNumKeys + 2) / 3, cache->GetUsage());
+}
+
+TEST_P(CacheTest, ConcurrentLookupInsertErase) {
+  const int kNumThreads = 8;
+  const int kNumKeys = 512;
+  const int kOpsPerThread = 20000;
+  std::shared_ptr<Cache> cache = NewCache(kNumKeys / 2, 2, false);
+  std::atomic<int> bad_values{0};
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      for (int i = 0; i < kOpsPerThread; i++) {
+        int key = static_cast<int>(rnd.Uniform(kNumKeys));
+        uint32_t op = rnd.Uniform(10);
+        if (op < 7) {
+          Cache::Handle* h = cache->Lookup(EncodeKey(key));
+          if (h != nullptr) {
+            if (DecodeValue(cache->Value(h)) != key) {
+              bad_values++;
+            }
+            cache->Release(h);
+          }
+        } else if (op < 9) {
+          cache->Insert(EncodeKey(key), EncodeValue(key), 1, &dumbDeleter)
+              .PermitUncheckedError();
+        } else {
+          cache->Erase(EncodeKey(key));
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(0, bad_values.load());
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+}
+
 #ifdef SUPPORT_CLOCK_CACHE
 std::shared_ptr<Cache> (*new_clock_cache_func)(
     size_t, int, bool, CacheMetadataChargePolicy) = NewClockCache;
@@ -27,13 +27,8 @@ std::shared_ptr<Cache> NewClockCache(
 #include <assert.h>
 #include <atomic>
 #include <deque>
-
-// "tbb/concurrent_hash_map.h" requires RTTI if exception is enabled.
-// Disable it so users can chooose to disable RTTI.
-#ifndef ROCKSDB_USE_RTTI
-#define TBB_USE_EXCEPTIONS 0
-#endif
-#include "tbb/concurrent_hash_map.h"
+#include <memory>
+#include <vector>
 
 #include "cache/sharded_cache.h"
 #include "port/malloc.h"
@@ -61,9 +56,10 @@ namespace {
 // to be re-use. This is to avoid memory dealocation, which is hard to deal
 // with in concurrent environment.
 //
-// The cache also maintains a concurrent hash map for lookup. Any concurrent
-// hash map implementation should do the work. We currently use
-// tbb::concurrent_hash_map because it supports concurrent erase.
+// The cache also maintains a concurrent hash map for lookup. We use a
+// self-contained open-addressing (linear probing) table of atomic slots, see
+// ClockHandleTable below. Readers probe it without taking any lock, while
+// modifications are serialized by the shard mutex.
 //
 // Each cache handle has the following flags and counters, which are squeeze
 // in an atomic interger, to make sure the handle always be in a consistent
@@ -135,14 +131,14 @@ namespace {
 //    recycle bin:   | 1 | 5 |
 //                   +---+---+
 //
-// A global mutex guards the circular list, the head, and the recycle bin.
+// A per-shard mutex guards the circular list, the head, and the recycle bin.
 // We additionally require that modifying the hash map needs to hold the mutex.
 // As such, Modifying the cache (such as Insert() and Erase()) require to
 // hold the mutex. Lookup() only access the hash map and the flags associated
 // with each handle, and don't require explicit locking. Release() has to
 // acquire the mutex only when it releases the last reference to the entry and
-// the entry has been erased from cache explicitly. A future improvement could
-// be to remove the mutex completely.
+// the entry has been erased from cache explicitly. Hence, unlike LRUCache, a
+// read-mostly workload doesn't contend on the mutex at all.
 //
 // Benchmark:
 // We run readrandom db_bench on a test DB of size 13GB, with size of each
@@ -227,25 +223,217 @@ struct CacheHandle {
   }
 };
 
-// Key of hash map. We store hash value with the key for convenience.
-struct CacheKey {
-  Slice key;
-  uint32_t hash_value;
+// Hash map from key to the cache handle holding it, using open addressing
+// with linear probing. Each slot stores the handle pointer together with the
+// hash of its key, so that probing rarely needs to dereference a handle.
+//
+// Find() is lock-free and may run concurrently with the modifying methods,
+// which must be externally serialized (by the shard mutex). To make this
+// safe:
+//
+//   * Slot arrays are never freed while the table is alive. Growing the table
+//     publishes a fully populated new array, and the old one is retired but
+//     kept around for readers that may still be probing it. As the table only
+//     doubles, retired arrays take less memory than the current one.
+//   * Removing an entry shifts the following entries of the probe sequence
+//     backward (so that there are no tombstones), and replacing an entry
+//     swaps the handle in place. Both are bracketed by a sequence counter,
+//     and a reader that misses while the counter moved simply probes again.
+//   * A handle found by a reader may be evicted, erased or even reused for
+//     another key at any time, so the caller has to pin the handle and then
+//     verify its key, which is what the try_ref callback of Find() does.
+class ClockHandleTable {
+ public:
+  ClockHandleTable() : count_(0), seq_(0) {
+    arrays_.emplace_back(new Array(kInitialSize));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
 
-  CacheKey() = default;
+  // Return the first handle in the probe sequence of hash for which try_ref
+  // returns true, or nullptr if there isn't one. try_ref is expected to pin
+  // the handle and check that it holds the looked up key.
+  //
+  // Not necessary to hold mutex before being called.
+  template <typename TryRef>
+  CacheHandle* Find(uint32_t hash, const TryRef& try_ref) const {
+    while (true) {
+      uint64_t seq = seq_.load(std::memory_order_acquire);
+      if ((seq & 1) == 0) {
+        const Array* array = array_.load(std::memory_order_acquire);
+        size_t i = hash & array->mask;
+        for (size_t n = 0; n <= array->mask; n++) {
+          CacheHandle* h =
+              array->slots[i].handle.load(std::memory_order_acquire);
+          if (h == nullptr) {
+            break;
+          }
+          if (array->slots[i].hash.load(std::memory_order_relaxed) == hash &&
+              try_ref(h)) {
+            return h;
+          }
+          i = (i + 1) & array->mask;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == seq) {
+          return nullptr;
+        }
+      }
+      // An entry has been moved or replaced under us, probe again.
+      port::AsmVolatilePause();
+    }
+  }
 
-  CacheKey(const Slice& k, uint32_t h) {
-    key = k;
-    hash_value = h;
+  // Insert handle into the table. If there is an entry with the same key,
+  // it is replaced and returned. Otherwise returns nullptr.
+  //
+  // Has to hold mutex before being called.
+  CacheHandle* Insert(CacheHandle* handle) {
+    Array* array = array_.load(std::memory_order_relaxed);
+    if ((count_ + 1) * kMaxLoadFactorInverse > array->mask + 1) {
+      array = Grow();
+    }
+    size_t i = handle->hash & array->mask;
+    while (true) {
+      Slot& slot = array->slots[i];
+      CacheHandle* h = slot.handle.load(std::memory_order_relaxed);
+      if (h == nullptr) {
+        slot.hash.store(handle->hash, std::memory_order_relaxed);
+        slot.handle.store(handle, std::memory_order_release);
+        count_++;
+        return nullptr;
+      }
+      if (h->hash == handle->hash && h->key == handle->key) {
+        BeginModify();
+        slot.handle.store(handle, std::memory_order_release);
+        EndModify();
+        return h;
+      }
+      i = (i + 1) & array->mask;
+    }
   }
 
-  static bool equal(const CacheKey& a, const CacheKey& b) {
-    return a.hash_value == b.hash_value && a.key == b.key;
+  // Remove the entry of the given key from the table, and return it.
+  // Returns nullptr if the key is not found.
+  //
+  // Has to hold mutex before being called.
+  CacheHandle* Remove(const Slice& key, uint32_t hash) {
+    Array* array = array_.load(std::memory_order_relaxed);
+    const size_t mask = array->mask;
+    size_t i = hash & mask;
+    CacheHandle* h;
+    while (true) {
+      h = array->slots[i].handle.load(std::memory_order_relaxed);
+      if (h == nullptr) {
+        return nullptr;
+      }
+      if (h->hash == hash && h->key == key) {
+        break;
+      }
+      i = (i + 1) & mask;
+    }
+    BeginModify();
+    // Backward shift deletion: move up each following entry of the cluster
+    // that would no longer be reachable from its home slot.
+    size_t j = i;
+    while (true) {
+      j = (j + 1) & mask;
+      CacheHandle* next =
+          array->slots[j].handle.load(std::memory_order_relaxed);
+      if (next == nullptr) {
+        break;
+      }
+      uint32_t next_hash = array->slots[j].hash.load(std::memory_order_relaxed);
+      size_t home = next_hash & mask;
+      // Skip if home lies cyclically in (i, j].
+      if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) {
+        continue;
+      }
+      array->slots[i].hash.store(next_hash, std::memory_order_relaxed);
+      array->slots[i].handle.store(next, std::memory_order_release);
+      i = j;
+    }
+    array->slots[i].handle.store(nullptr, std::memory_order_release);
+    EndModify();
+    count_--;
+    return h;
   }
 
-  static size_t hash(const CacheKey& a) {
-    return static_cast<size_t>(a.hash_value);
+  // Remove all entries.
+  //
+  // Has to hold mutex before being called.
+  void Clear() {
+    Array* array = array_.load(std::memory_order_relaxed);
+    BeginModify();
+    for (size_t i = 0; i <= array->mask; i++) {
+      array->slots[i].handle.store(nullptr, std::memory_order_relaxed);
+    }
+    EndModify();
+    count_ = 0;
   }
+
+ private:
+  static const size_t kInitialSize = 64;
+  // Keep the table at most half full so that probe sequences stay short.
+  static const size_t kMaxLoadFactorInverse = 2;
+
+  struct Slot {
+    std::atomic<uint32_t> hash{0};
+    std::atomic<CacheHandle*> handle{nullptr};
+  };
+
+  struct Array {
+    explicit Array(size_t size) : mask(size - 1), slots(new Slot[size]) {}
+
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+  };
+
+  // Double the number of slots and rehash all entries into the new array.
+  Array* Grow() {
+    const Array* old_array = array_.load(std::memory_order_relaxed);
+    Array* array = new Array((old_array->mask + 1) * 2);
+    for (size_t i = 0; i <= old_array->mask; i++) {
+      CacheHandle* h =
+          old_array->slots[i].handle.load(std::memory_order_relaxed);
+      if (h == nullptr) {
+        continue;
+      }
+      uint32_t hash = old_array->slots[i].hash.load(std::memory_order_relaxed);
+      size_t j = hash & array->mask;
+      while (array->slots[j].handle.load(std::memory_order_relaxed) !=
+             nullptr) {
+        j = (j + 1) & array->mask;
+      }
+      array->slots[j].hash.store(hash, std::memory_order_relaxed);
+      array->slots[j].handle.store(h, std::memory_order_relaxed);
+    }
+    arrays_.emplace_back(array);
+    array_.store(array, std::memory_order_release);
+    return array;
+  }
+
+  void BeginModify() {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void EndModify() {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  // The slot array readers should probe.
+  std::atomic<Array*> array_;
+
+  // All slot arrays ever allocated; the last one is the current one.
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  // Number of entries in the current slot array.
+  size_t count_;
+
+  // Odd while entries are being moved, replaced or removed.
+  std::atomic<uint64_t> seq_;
 };
 
 struct CleanupContext {
@@ -259,18 +447,17 @@ struct CleanupContext {
 // A cache shard which maintains its own CLOCK cache.
 class ClockCacheShard final : public CacheShard {
  public:
-  // Hash map type.
-  typedef tbb::concurrent_hash_map<CacheKey, CacheHandle*, CacheKey> HashTable;
-
   ClockCacheShard();
   ~ClockCacheShard() override;
 
   // Interfaces
   void SetCapacity(size_t capacity) override;
   void SetStrictCapacityLimit(bool strict_capacity_limit) override;
+  using CacheShard::Insert;
   Status Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
                 void (*deleter)(const Slice& key, void* value),
                 Cache::Handle** handle, Cache::Priority priority) override;
+  using CacheShard::Lookup;
   Cache::Handle* Lookup(const Slice& key, uint32_t hash) override;
   // If the entry in in cache, increase reference count and return true.
   // Return false otherwise.
@@ -377,8 +564,8 @@ class ClockCacheShard final : public CacheShard {
   // Whether allow insert into cache if cache is full.
   std::atomic<bool> strict_capacity_limit_;
 
-  // Hash table (tbb::concurrent_hash_map) for lookup.
-  HashTable table_;
+  // Hash table for lookup.
+  ClockHandleTable table_;
 };
 
 ClockCacheShard::ClockCacheShard()
@@ -511,9 +698,9 @@ bool ClockCacheShard::TryEvict(CacheHandle* handle, CleanupContext* context) {
   uint32_t flags = kInCacheBit;
   if (handle->flags.compare_exchange_strong(flags, 0, std::memory_order_acquire,
                                             std::memory_order_relaxed)) {
-    bool erased __attribute__((__unused__)) =
-        table_.erase(CacheKey(handle->key, handle->hash));
-    assert(erased);
+    CacheHandle* erased __attribute__((__unused__)) =
+        table_.Remove(handle->key, handle->hash);
+    assert(erased == handle);
     RecycleHandle(handle, context);
     return true;
   }
@@ -596,15 +783,14 @@ CacheHandle* ClockCacheShard::Insert(
   handle->charge = charge;
   handle->deleter = deleter;
   uint32_t flags = hold_reference ? kInCacheBit + kOneRef : kInCacheBit;
-  handle->flags.store(flags, std::memory_order_relaxed);
-  HashTable::accessor accessor;
-  if (table_.find(accessor, CacheKey(key, hash))) {
+  // Use release semantics so that a concurrent Lookup() which manages to
+  // reference the handle observes the fields filled above.
+  handle->flags.store(flags, std::memory_order_release);
+  CacheHandle* existing_handle = table_.Insert(handle);
+  if (existing_handle != nullptr) {
     *overwritten = true;
-    CacheHandle* existing_handle = accessor->second;
-    table_.erase(accessor);
     UnsetInCache(existing_handle, context);
   }
-  table_.insert(HashTable::value_type(CacheKey(key, hash), handle));
   if (hold_reference) {
     pinned_usage_.fetch_add(total_charge, std::memory_order_relaxed);
   }
@@ -618,7 +804,6 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
                                Cache::Handle** out_handle,
                                Cache::Priority /*priority*/) {
   CleanupContext context;
-  HashTable::accessor accessor;
   char* key_data = new char[key.size()];
   memcpy(key_data, key.data(), key.size());
   Slice key_copy(key_data, key.size());
@@ -642,27 +827,24 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
 }
 
 Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash) {
-  HashTable::const_accessor accessor;
-  if (!table_.find(accessor, CacheKey(key, hash))) {
-    return nullptr;
-  }
-  CacheHandle* handle = accessor->second;
-  accessor.release();
-  // Ref() could fail if another thread sneak in and evict/erase the cache
-  // entry before we are able to hold reference.
-  if (!Ref(reinterpret_cast<Cache::Handle*>(handle))) {
-    return nullptr;
-  }
-  // Double check the key since the handle may now representing another key
-  // if other threads sneak in, evict/erase the entry and re-used the handle
-  // for another cache entry.
-  if (hash != handle->hash || key != handle->key) {
-    CleanupContext context;
-    Unref(handle, false, &context);
-    // It is possible Unref() delete the entry, so we need to cleanup.
-    Cleanup(context);
-    return nullptr;
-  }
+  CacheHandle* handle = table_.Find(hash, [&](CacheHandle* h) {
+    // Ref() could fail if another thread sneak in and evict/erase the cache
+    // entry before we are able to hold reference.
+    if (!Ref(reinterpret_cast<Cache::Handle*>(h))) {
+      return false;
+    }
+    // Double check the key since the handle may now representing another key
+    // if other threads sneak in, evict/erase the entry and re-used the handle
+    // for another cache entry.
+    if (hash != h->hash || key != h->key) {
+      CleanupContext context;
+      Unref(h, false, &context);
+      // It is possible Unref() delete the entry, so we need to cleanup.
+      Cleanup(context);
+      return false;
+    }
+    return true;
+  });
   return reinterpret_cast<Cache::Handle*>(handle);
 }
 
@@ -686,11 +868,9 @@ void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
 bool ClockCacheShard::EraseAndConfirm(const Slice& key, uint32_t hash,
                                       CleanupContext* context) {
   MutexLock l(&mutex_);
-  HashTable::accessor accessor;
   bool erased = false;
-  if (table_.find(accessor, CacheKey(key, hash))) {
-    CacheHandle* handle = accessor->second;
-    table_.erase(accessor);
+  CacheHandle* handle = table_.Remove(key, hash);
+  if (handle != nullptr) {
     erased = UnsetInCache(handle, context);
   }
   return erased;
@@ -700,7 +880,7 @@ void ClockCacheShard::EraseUnRefEntries() {
   CleanupContext context;
   {
     MutexLock l(&mutex_);
-    table_.clear();
+    table_.Clear();
     for (auto& handle : list_) {
       UnsetInCache(&handle, &context);
     }
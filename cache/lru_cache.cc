@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <string>
 
+#include "monitoring/statistics.h"
 #include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -97,7 +98,8 @@ void LRUHandleTable::Resize() {
 LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              double high_pri_pool_ratio,
                              bool use_adaptive_mutex,
-                             CacheMetadataChargePolicy metadata_charge_policy)
+                             CacheMetadataChargePolicy metadata_charge_policy,
+                             SecondaryCache* secondary_cache)
     : capacity_(0),
       high_pri_pool_usage_(0),
       strict_capacity_limit_(strict_capacity_limit),
@@ -105,7 +107,8 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
       high_pri_pool_capacity_(0),
       usage_(0),
       lru_usage_(0),
-      mutex_(use_adaptive_mutex) {
+      mutex_(use_adaptive_mutex),
+      secondary_cache_(secondary_cache) {
   set_metadata_charge_policy(metadata_charge_policy);
   // Make empty circular linked list
   lru_.next = &lru_;
@@ -257,9 +260,7 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
   }
 
   // Free the entries outside of mutex for performance reasons
-  for (auto entry : last_reference_list) {
-    entry->Free();
-  }
+  FreeEntries(last_reference_list);
 }
 
 void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
@@ -282,6 +283,118 @@ Cache::Handle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash) {
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+Cache::Handle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
+                                     const Cache::CacheItemHelper* helper,
+                                     const Cache::CreateCallback& create_cb,
+                                     Cache::Priority priority, bool wait,
+                                     Statistics* stats) {
+  Cache::Handle* handle = Lookup(key, hash);
+  if (handle != nullptr || secondary_cache_ == nullptr || helper == nullptr ||
+      helper->saveto_cb == nullptr) {
+    return handle;
+  }
+
+  // For objects from the secondary cache, we expect the caller to provide
+  // a way to create/delete the primary cache object.
+  assert(create_cb && helper->del_cb);
+  std::unique_ptr<SecondaryCacheResultHandle> secondary_handle =
+      secondary_cache_->Lookup(key, create_cb, wait);
+  if (secondary_handle == nullptr) {
+    RecordTick(stats, SECONDARY_CACHE_MISSES);
+    return nullptr;
+  }
+  RecordTick(stats, SECONDARY_CACHE_HITS);
+
+  LRUHandle* e = NewHandle(key, hash, nullptr, 0, priority);
+  // Not in the hash table until Promote() inserts it.
+  e->SetInCache(false);
+  e->info_.helper = helper;
+  e->SetSecondaryCacheCompatible(true);
+  e->Ref();
+  e->SetHit();
+  e->sec_handle = secondary_handle.release();
+  e->SetPending(true);
+  {
+    // A pending handle is pinned by the caller, so it is accounted for in
+    // usage_ but not in lru_usage_ until it is released.
+    MutexLock l(&mutex_);
+    usage_ += e->CalcTotalCharge(metadata_charge_policy_);
+  }
+  if (wait || e->sec_handle->IsReady()) {
+    if (!Promote(e)) {
+      // Drop the empty handle and its charge, as for a miss.
+      Release(reinterpret_cast<Cache::Handle*>(e), /*force_erase=*/false);
+      return nullptr;
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+bool LRUCacheShard::IsReady(Cache::Handle* handle) {
+  LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
+  if (!e->IsPending()) {
+    return true;
+  }
+  if (!e->sec_handle->IsReady()) {
+    return false;
+  }
+  // The handle is still owned by the caller if the lookup came back empty,
+  // so the result of the promotion is not needed here.
+  Promote(e);
+  return true;
+}
+
+void LRUCacheShard::Wait(Cache::Handle* handle) {
+  LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
+  if (e->IsPending()) {
+    Promote(e);
+  }
+}
+
+bool LRUCacheShard::Promote(LRUHandle* e) {
+  assert(e->IsPending());
+  assert(e->refs == 1 && !e->InCache());
+  SecondaryCacheResultHandle* secondary_handle = e->sec_handle;
+  secondary_handle->Wait();
+  void* value = secondary_handle->Value();
+  size_t charge = secondary_handle->Size();
+  delete secondary_handle;
+  e->value = value;
+  e->SetPending(false);
+  if (value == nullptr) {
+    // The handle stays referenced by the caller, with no value, until it is
+    // released.
+    return false;
+  }
+
+  {
+    // The placeholder charge of the pending handle is replaced by the charge
+    // of the real object below.
+    MutexLock l(&mutex_);
+    size_t placeholder_charge = e->CalcTotalCharge(metadata_charge_policy_);
+    assert(usage_ >= placeholder_charge);
+    usage_ -= placeholder_charge;
+  }
+  e->charge = charge;
+  e->refs = 0;
+  e->SetInCache(true);
+  Cache::Handle* handle = nullptr;
+  Status s = InsertItem(e, &handle, /*free_handle_on_fail=*/false);
+  if (!s.ok()) {
+    // The strict capacity limit prevented the promotion. Destroy the object
+    // and hand back an empty handle, as for a miss.
+    (*e->info_.helper->del_cb)(e->key(), value);
+    MutexLock l(&mutex_);
+    e->value = nullptr;
+    e->charge = 0;
+    e->refs = 1;
+    usage_ += e->CalcTotalCharge(metadata_charge_policy_);
+    return false;
+  }
+  assert(handle == reinterpret_cast<Cache::Handle*>(e));
+  return true;
+}
+
 bool LRUCacheShard::Ref(Cache::Handle* h) {
   LRUHandle* e = reinterpret_cast<LRUHandle*>(h);
   MutexLock l(&mutex_);
@@ -335,20 +448,13 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
   return last_reference;
 }
 
-Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
-                             size_t charge,
-                             void (*deleter)(const Slice& key, void* value),
-                             Cache::Handle** handle, Cache::Priority priority) {
-  // Allocate the memory here outside of the mutex
-  // If the cache is full, we'll have to release it
-  // It shouldn't happen very often though.
+LRUHandle* LRUCacheShard::NewHandle(const Slice& key, uint32_t hash,
+                                    void* value, size_t charge,
+                                    Cache::Priority priority) {
   LRUHandle* e = reinterpret_cast<LRUHandle*>(
       new char[sizeof(LRUHandle) - 1 + key.size()]);
-  Status s = Status::OK();
-  autovector<LRUHandle*> last_reference_list;
-
   e->value = value;
-  e->deleter = deleter;
+  e->info_.deleter = nullptr;
   e->charge = charge;
   e->key_length = key.size();
   e->flags = 0;
@@ -358,6 +464,13 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   e->SetInCache(true);
   e->SetPriority(priority);
   memcpy(e->key_data, key.data(), key.size());
+  return e;
+}
+
+Status LRUCacheShard::InsertItem(LRUHandle* e, Cache::Handle** handle,
+                                 bool free_handle_on_fail) {
+  Status s = Status::OK();
+  autovector<LRUHandle*> last_reference_list;
   size_t total_charge = e->CalcTotalCharge(metadata_charge_policy_);
 
   {
@@ -375,7 +488,11 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
         e->SetInCache(false);
         last_reference_list.push_back(e);
       } else {
-        delete[] reinterpret_cast<char*>(e);
+        if (free_handle_on_fail) {
+          delete[] reinterpret_cast<char*>(e);
+        } else {
+          e->SetInCache(false);
+        }
         *handle = nullptr;
         s = Status::Incomplete("Insert failed due to LRU cache being full.");
       }
@@ -408,11 +525,45 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   }
 
   // Free the entries here outside of mutex for performance reasons
-  for (auto entry : last_reference_list) {
+  FreeEntries(last_reference_list);
+
+  return s;
+}
+
+void LRUCacheShard::FreeEntries(const autovector<LRUHandle*>& entries) {
+  for (auto entry : entries) {
+    if (secondary_cache_ != nullptr && entry->IsSecondaryCacheCompatible() &&
+        !entry->IsPending() && entry->value != nullptr) {
+      // Demote the entry instead of dropping it. The secondary cache is free
+      // to reject it, so the status is only informational.
+      secondary_cache_->Insert(entry->key(), entry->value, entry->info_.helper)
+          .PermitUncheckedError();
+    }
     entry->Free();
   }
+}
 
-  return s;
+Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
+                             size_t charge,
+                             void (*deleter)(const Slice& key, void* value),
+                             Cache::Handle** handle, Cache::Priority priority) {
+  // Allocate the memory here outside of the mutex
+  // If the cache is full, we'll have to release it
+  // It shouldn't happen very often though.
+  LRUHandle* e = NewHandle(key, hash, value, charge, priority);
+  e->info_.deleter = deleter;
+  return InsertItem(e, handle, /*free_handle_on_fail=*/true);
+}
+
+Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
+                             const Cache::CacheItemHelper* helper,
+                             size_t charge, Cache::Handle** handle,
+                             Cache::Priority priority) {
+  assert(helper);
+  LRUHandle* e = NewHandle(key, hash, value, charge, priority);
+  e->info_.helper = helper;
+  e->SetSecondaryCacheCompatible(true);
+  return InsertItem(e, handle, /*free_handle_on_fail=*/true);
 }
 
 void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
@@ -461,16 +612,23 @@ std::string LRUCacheShard::GetPrintableOptions() const {
     snprintf(buffer, kBufferSize, "    high_pri_pool_ratio: %.3lf\n",
              high_pri_pool_ratio_);
   }
-  return std::string(buffer);
+  std::string ret(buffer);
+  if (secondary_cache_ != nullptr) {
+    ret.append("    secondary_cache:\n");
+    ret.append(secondary_cache_->GetPrintableOptions());
+  }
+  return ret;
 }
 
 LRUCache::LRUCache(size_t capacity, int num_shard_bits,
                    bool strict_capacity_limit, double high_pri_pool_ratio,
                    std::shared_ptr<MemoryAllocator> allocator,
                    bool use_adaptive_mutex,
-                   CacheMetadataChargePolicy metadata_charge_policy)
+                   CacheMetadataChargePolicy metadata_charge_policy,
+                   const std::shared_ptr<SecondaryCache>& secondary_cache)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
-                   std::move(allocator)) {
+                   std::move(allocator)),
+      secondary_cache_(secondary_cache) {
   num_shards_ = 1 << num_shard_bits;
   shards_ = reinterpret_cast<LRUCacheShard*>(
       port::cacheline_aligned_alloc(sizeof(LRUCacheShard) * num_shards_));
@@ -478,7 +636,8 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
   for (int i = 0; i < num_shards_; i++) {
     new (&shards_[i])
         LRUCacheShard(per_shard, strict_capacity_limit, high_pri_pool_ratio,
-                      use_adaptive_mutex, metadata_charge_policy);
+                      use_adaptive_mutex, metadata_charge_policy,
+                      secondary_cache_.get());
   }
 }
 
@@ -501,7 +660,9 @@ const CacheShard* LRUCache::GetShard(int shard) const {
 }
 
 void* LRUCache::Value(Handle* handle) {
-  return reinterpret_cast<const LRUHandle*>(handle)->value;
+  const LRUHandle* e = reinterpret_cast<const LRUHandle*>(handle);
+  // A pending handle has no value until its secondary cache lookup is done
+  return e->IsPending() ? nullptr : e->value;
 }
 
 size_t LRUCache::GetCharge(Handle* handle) const {
@@ -548,14 +709,16 @@ std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
                      cache_opts.strict_capacity_limit,
                      cache_opts.high_pri_pool_ratio,
                      cache_opts.memory_allocator, cache_opts.use_adaptive_mutex,
-                     cache_opts.metadata_charge_policy);
+                     cache_opts.metadata_charge_policy,
+                     cache_opts.secondary_cache);
 }
 
 std::shared_ptr<Cache> NewLRUCache(
     size_t capacity, int num_shard_bits, bool strict_capacity_limit,
     double high_pri_pool_ratio,
     std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
-    CacheMetadataChargePolicy metadata_charge_policy) {
+    CacheMetadataChargePolicy metadata_charge_policy,
+    const std::shared_ptr<SecondaryCache>& secondary_cache) {
   if (num_shard_bits >= 20) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
@@ -568,7 +731,8 @@ std::shared_ptr<Cache> NewLRUCache(
   }
   return std::make_shared<LRUCache>(
       capacity, num_shard_bits, strict_capacity_limit, high_pri_pool_ratio,
-      std::move(memory_allocator), use_adaptive_mutex, metadata_charge_policy);
+      std::move(memory_allocator), use_adaptive_mutex, metadata_charge_policy,
+      secondary_cache);
 }
 
 }  // namespace ROCKSDB_NAMESPACE
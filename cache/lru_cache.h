@@ -14,6 +14,7 @@
 
 #include "port/malloc.h"
 #include "port/port.h"
+#include "rocksdb/secondary_cache.h"
 #include "util/autovector.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -46,10 +47,26 @@ namespace ROCKSDB_NAMESPACE {
 // that any successful LRUCacheShard::Lookup/LRUCacheShard::Insert have a
 // matching LRUCache::Release (to move into state 2) or LRUCacheShard::Erase
 // (to move into state 3).
+//
+// With a secondary cache, LRUCacheShard::Lookup can also return a handle that
+// is not in the hash table yet because the secondary cache lookup is still in
+// flight (IS_PENDING). Such a handle is referenced only by the caller, and is
+// moved into state 1 by LRUCacheShard::Wait (or IsReady) once the object has
+// been created from the secondary cache data.
 
 struct LRUHandle {
-  void* value;
-  void (*deleter)(const Slice&, void* value);
+  union {
+    void* value;
+    // The secondary cache lookup result, if the handle is pending
+    SecondaryCacheResultHandle* sec_handle;
+  };
+  union Info {
+    Info() {}
+    ~Info() {}
+    Cache::DeleterFn deleter;
+    // Used instead of deleter if the entry is secondary cache compatible
+    const Cache::CacheItemHelper* helper;
+  } info_;
   LRUHandle* next_hash;
   LRUHandle* next;
   LRUHandle* prev;
@@ -69,6 +86,11 @@ struct LRUHandle {
     IN_HIGH_PRI_POOL = (1 << 2),
     // Wwhether this entry has had any lookups (hits).
     HAS_HIT = (1 << 3),
+    // Whether this entry was inserted with a CacheItemHelper, so it can be
+    // demoted to a secondary cache.
+    IS_SECONDARY_CACHE_COMPATIBLE = (1 << 4),
+    // Whether the secondary cache lookup for this entry is still pending.
+    IS_PENDING = (1 << 5),
   };
 
   uint8_t flags;
@@ -95,6 +117,10 @@ struct LRUHandle {
   bool IsHighPri() const { return flags & IS_HIGH_PRI; }
   bool InHighPriPool() const { return flags & IN_HIGH_PRI_POOL; }
   bool HasHit() const { return flags & HAS_HIT; }
+  bool IsSecondaryCacheCompatible() const {
+    return flags & IS_SECONDARY_CACHE_COMPATIBLE;
+  }
+  bool IsPending() const { return flags & IS_PENDING; }
 
   void SetInCache(bool in_cache) {
     if (in_cache) {
@@ -122,10 +148,40 @@ struct LRUHandle {
 
   void SetHit() { flags |= HAS_HIT; }
 
+  void SetSecondaryCacheCompatible(bool compat) {
+    if (compat) {
+      flags |= IS_SECONDARY_CACHE_COMPATIBLE;
+    } else {
+      flags &= ~IS_SECONDARY_CACHE_COMPATIBLE;
+    }
+  }
+
+  void SetPending(bool pending) {
+    if (pending) {
+      flags |= IS_PENDING;
+    } else {
+      flags &= ~IS_PENDING;
+    }
+  }
+
   void Free() {
     assert(refs == 0);
-    if (deleter) {
-      (*deleter)(key(), value);
+    if (IsPending()) {
+      // The caller gave up on the secondary cache lookup; destroy whatever
+      // object it produced.
+      assert(IsSecondaryCacheCompatible());
+      SecondaryCacheResultHandle* handle = sec_handle;
+      handle->Wait();
+      value = handle->Value();
+      delete handle;
+      SetPending(false);
+    }
+    if (IsSecondaryCacheCompatible()) {
+      if (value != nullptr && info_.helper->del_cb) {
+        (*info_.helper->del_cb)(key(), value);
+      }
+    } else if (info_.deleter) {
+      (*info_.deleter)(key(), value);
     }
     delete[] reinterpret_cast<char*>(this);
   }
@@ -193,7 +249,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
  public:
   LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                 double high_pri_pool_ratio, bool use_adaptive_mutex,
-                CacheMetadataChargePolicy metadata_charge_policy);
+                CacheMetadataChargePolicy metadata_charge_policy,
+                SecondaryCache* secondary_cache = nullptr);
   virtual ~LRUCacheShard() override = default;
 
   // Separate from constructor so caller can easily make an array of LRUCache
@@ -213,7 +270,18 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
                         void (*deleter)(const Slice& key, void* value),
                         Cache::Handle** handle,
                         Cache::Priority priority) override;
+  virtual Status Insert(const Slice& key, uint32_t hash, void* value,
+                        const Cache::CacheItemHelper* helper, size_t charge,
+                        Cache::Handle** handle,
+                        Cache::Priority priority) override;
   virtual Cache::Handle* Lookup(const Slice& key, uint32_t hash) override;
+  virtual Cache::Handle* Lookup(const Slice& key, uint32_t hash,
+                                const Cache::CacheItemHelper* helper,
+                                const Cache::CreateCallback& create_cb,
+                                Cache::Priority priority, bool wait,
+                                Statistics* stats) override;
+  virtual bool IsReady(Cache::Handle* handle) override;
+  virtual void Wait(Cache::Handle* handle) override;
   virtual bool Ref(Cache::Handle* handle) override;
   virtual bool Release(Cache::Handle* handle,
                        bool force_erase = false) override;
@@ -243,6 +311,25 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   double GetHighPriPoolRatio();
 
  private:
+  // Allocate a handle for key, not yet inserted into the table.
+  LRUHandle* NewHandle(const Slice& key, uint32_t hash, void* value,
+                       size_t charge, Cache::Priority priority);
+
+  // Insert a handle allocated by NewHandle() into the table. Shared by the
+  // Insert() variants and by the promotion of secondary cache entries. If
+  // the insertion fails and free_handle_on_fail is false, the handle is left
+  // to the caller.
+  Status InsertItem(LRUHandle* e, Cache::Handle** handle,
+                    bool free_handle_on_fail);
+
+  // Move a pending handle whose secondary cache lookup completed into the
+  // table. Returns false if the lookup did not produce an object.
+  bool Promote(LRUHandle* e);
+
+  // Free the entries that were removed from the cache, demoting the ones
+  // that are secondary cache compatible into the secondary cache.
+  void FreeEntries(const autovector<LRUHandle*>& entries);
+
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
 
@@ -303,6 +390,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
   mutable port::Mutex mutex_;
+
+  // Owned by the LRUCache this shard belongs to. May be nullptr.
+  SecondaryCache* secondary_cache_;
 };
 
 class LRUCache
@@ -316,7 +406,8 @@ class LRUCache
            std::shared_ptr<MemoryAllocator> memory_allocator = nullptr,
            bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
            CacheMetadataChargePolicy metadata_charge_policy =
-               kDontChargeCacheMetadata);
+               kDontChargeCacheMetadata,
+           const std::shared_ptr<SecondaryCache>& secondary_cache = nullptr);
   virtual ~LRUCache();
   virtual const char* Name() const override { return "LRUCache"; }
   virtual CacheShard* GetShard(int shard) override;
@@ -325,6 +416,9 @@ class LRUCache
   virtual size_t GetCharge(Handle* handle) const override;
   virtual uint32_t GetHash(Handle* handle) const override;
   virtual void DisownData() override;
+  virtual bool HasSecondaryCache() const override {
+    return secondary_cache_ != nullptr;
+  }
 
   //  Retrieves number of elements in LRU, for unit test purpose only
   size_t TEST_GetLRUSize();
@@ -334,6 +428,7 @@ class LRUCache
  private:
   LRUCacheShard* shards_ = nullptr;
   int num_shards_ = 0;
+  std::shared_ptr<SecondaryCache> secondary_cache_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
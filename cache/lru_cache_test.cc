@@ -6,9 +6,13 @@
 #include "cache/lru_cache.h"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "cache/lru_secondary_cache.h"
 #include "port/port.h"
+#include "rocksdb/secondary_cache.h"
 #include "test_util/testharness.h"
+#include "util/compression.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -191,6 +195,277 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"e", "f", "g", "Z", "d"}, 2);
 }
 
+
+// A secondary cache that stores the persistable data of the demoted entries
+// in a std::unordered_map, and can be told to make its lookups complete
+// asynchronously.
+class TestSecondaryCache : public SecondaryCache {
+ public:
+  TestSecondaryCache() : num_inserts_(0), num_lookups_(0), async_(false) {}
+
+  const char* Name() const override { return "TestSecondaryCache"; }
+
+  Status Insert(const Slice& key, void* value,
+                const Cache::CacheItemHelper* helper) override {
+    size_t size = (*helper->size_cb)(value);
+    std::string buf(size, '\0');
+    Status s = (*helper->saveto_cb)(value, 0, size, &buf[0]);
+    if (s.ok()) {
+      num_inserts_++;
+      data_[key.ToString()] = std::move(buf);
+    }
+    return s;
+  }
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CreateCallback& create_cb,
+      bool wait) override {
+    num_lookups_++;
+    std::unique_ptr<SecondaryCacheResultHandle> handle;
+    auto iter = data_.find(key.ToString());
+    if (iter == data_.end()) {
+      return handle;
+    }
+    handle.reset(new ResultHandle(iter->second, create_cb, async_ && !wait));
+    return handle;
+  }
+
+  void Erase(const Slice& key) override { data_.erase(key.ToString()); }
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override {
+    for (SecondaryCacheResultHandle* handle : handles) {
+      handle->Wait();
+    }
+  }
+
+  std::string GetPrintableOptions() const override { return ""; }
+
+  void SetAsync(bool async) { async_ = async; }
+
+  uint32_t num_inserts() const { return num_inserts_; }
+
+  uint32_t num_lookups() const { return num_lookups_; }
+
+ private:
+  // Creates the object only when waited upon if the lookup is asynchronous
+  class ResultHandle : public SecondaryCacheResultHandle {
+   public:
+    ResultHandle(const std::string& data, const Cache::CreateCallback& cb,
+                 bool async)
+        : data_(data), create_cb_(cb), ready_(false) {
+      if (!async) {
+        Wait();
+      }
+    }
+
+    bool IsReady() override { return ready_; }
+
+    void Wait() override {
+      if (!ready_) {
+        EXPECT_OK(create_cb_(&data_[0], data_.size(), &value_, &size_));
+        ready_ = true;
+      }
+    }
+
+    void* Value() override { return value_; }
+
+    size_t Size() override { return size_; }
+
+   private:
+    std::string data_;
+    Cache::CreateCallback create_cb_;
+    bool ready_;
+    void* value_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  std::unordered_map<std::string, std::string> data_;
+  uint32_t num_inserts_;
+  uint32_t num_lookups_;
+  bool async_;
+};
+
+class LRUSecondaryCacheTest : public testing::Test {
+ public:
+  // The cached object: a string, persisted as its contents
+  class TestItem {
+   public:
+    explicit TestItem(const std::string& data) : data_(data) {}
+
+    const std::string& data() const { return data_; }
+
+   private:
+    std::string data_;
+  };
+
+  static size_t SizeCallback(void* obj) {
+    return reinterpret_cast<TestItem*>(obj)->data().size();
+  }
+
+  static Status SaveToCallback(void* from_obj, size_t from_offset,
+                               size_t length, void* out) {
+    TestItem* item = reinterpret_cast<TestItem*>(from_obj);
+    memcpy(out, item->data().data() + from_offset, length);
+    return Status::OK();
+  }
+
+  static void DeletionCallback(const Slice& /*key*/, void* obj) {
+    delete reinterpret_cast<TestItem*>(obj);
+  }
+
+  static Cache::CacheItemHelper helper_;
+
+  Cache::CreateCallback test_item_creator_ =
+      [](void* buf, size_t size, void** out_obj, size_t* charge) -> Status {
+    *out_obj = new TestItem(std::string(reinterpret_cast<char*>(buf), size));
+    *charge = size;
+    return Status::OK();
+  };
+
+  std::shared_ptr<Cache> NewPrimaryCache(
+      size_t capacity, std::shared_ptr<SecondaryCache> secondary_cache) {
+    LRUCacheOptions opts(capacity, 0 /*num_shard_bits*/,
+                         false /*strict_capacity_limit*/,
+                         0.5 /*high_pri_pool_ratio*/);
+    opts.secondary_cache = secondary_cache;
+    return NewLRUCache(opts);
+  }
+
+  Status InsertItem(Cache* cache, const std::string& key,
+                    const std::string& value) {
+    TestItem* item = new TestItem(value);
+    return cache->Insert(key, item, &helper_, value.size());
+  }
+
+  std::string LookupItem(Cache* cache, const std::string& key,
+                         Statistics* stats = nullptr) {
+    Cache::Handle* handle =
+        cache->Lookup(key, &helper_, test_item_creator_, Cache::Priority::LOW,
+                      true /*wait*/, stats);
+    if (handle == nullptr) {
+      return "NOT_FOUND";
+    }
+    std::string result =
+        reinterpret_cast<TestItem*>(cache->Value(handle))->data();
+    cache->Release(handle);
+    return result;
+  }
+};
+
+Cache::CacheItemHelper LRUSecondaryCacheTest::helper_(
+    LRUSecondaryCacheTest::SizeCallback, LRUSecondaryCacheTest::SaveToCallback,
+    LRUSecondaryCacheTest::DeletionCallback);
+
+TEST_F(LRUSecondaryCacheTest, DemoteAndPromote) {
+  std::shared_ptr<TestSecondaryCache> secondary_cache =
+      std::make_shared<TestSecondaryCache>();
+  std::shared_ptr<Cache> cache = NewPrimaryCache(1024, secondary_cache);
+  std::shared_ptr<Statistics> stats = CreateDBStatistics();
+
+  std::string value1(700, 'a');
+  std::string value2(700, 'b');
+  ASSERT_OK(InsertItem(cache.get(), "k1", value1));
+  // Evicts k1 into the secondary cache
+  ASSERT_OK(InsertItem(cache.get(), "k2", value2));
+  ASSERT_EQ(secondary_cache->num_inserts(), 1u);
+
+  // Hit in the primary cache, no secondary lookup
+  ASSERT_EQ(LookupItem(cache.get(), "k2", stats.get()), value2);
+  ASSERT_EQ(secondary_cache->num_lookups(), 0u);
+
+  // Promoted from the secondary cache, which demotes k2
+  ASSERT_EQ(LookupItem(cache.get(), "k1", stats.get()), value1);
+  ASSERT_EQ(secondary_cache->num_lookups(), 1u);
+  ASSERT_EQ(secondary_cache->num_inserts(), 2u);
+  ASSERT_EQ(stats->getTickerCount(SECONDARY_CACHE_HITS), 1u);
+
+  // k1 is now in the primary cache
+  ASSERT_EQ(LookupItem(cache.get(), "k1", stats.get()), value1);
+  ASSERT_EQ(secondary_cache->num_lookups(), 1u);
+
+  ASSERT_EQ(LookupItem(cache.get(), "k3", stats.get()), "NOT_FOUND");
+  ASSERT_EQ(secondary_cache->num_lookups(), 2u);
+  ASSERT_EQ(stats->getTickerCount(SECONDARY_CACHE_MISSES), 1u);
+
+  // Plain lookups and inserts without a helper bypass the secondary cache
+  ASSERT_EQ(cache->Lookup("k2"), nullptr);
+  ASSERT_EQ(secondary_cache->num_lookups(), 2u);
+  ASSERT_OK(cache->Insert("k4", new TestItem(value1), value1.size(),
+                          &DeletionCallback));
+  // k1 was evicted, and demoted since it was inserted with a helper
+  ASSERT_EQ(secondary_cache->num_inserts(), 3u);
+  ASSERT_OK(cache->Insert("k5", new TestItem(value2), value2.size(),
+                          &DeletionCallback));
+  // k4 was evicted, but dropped
+  ASSERT_EQ(secondary_cache->num_inserts(), 3u);
+}
+
+TEST_F(LRUSecondaryCacheTest, NonBlockingLookup) {
+  std::shared_ptr<TestSecondaryCache> secondary_cache =
+      std::make_shared<TestSecondaryCache>();
+  secondary_cache->SetAsync(true);
+  std::shared_ptr<Cache> cache = NewPrimaryCache(2048, secondary_cache);
+
+  std::vector<std::string> values;
+  for (int i = 0; i < 4; ++i) {
+    values.push_back(std::string(700, static_cast<char>('a' + i)));
+    ASSERT_OK(InsertItem(cache.get(), "k" + ToString(i), values.back()));
+  }
+  ASSERT_EQ(secondary_cache->num_inserts(), 2u);
+
+  // k0 and k1 were demoted. Look them up without waiting.
+  std::vector<Cache::Handle*> handles;
+  for (int i = 0; i < 2; ++i) {
+    Cache::Handle* handle =
+        cache->Lookup("k" + ToString(i), &helper_, test_item_creator_,
+                      Cache::Priority::LOW, false /*wait*/);
+    ASSERT_NE(handle, nullptr);
+    ASSERT_FALSE(cache->IsReady(handle));
+    ASSERT_EQ(cache->Value(handle), nullptr);
+    handles.push_back(handle);
+  }
+  cache->WaitAll(handles);
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(cache->IsReady(handles[i]));
+    TestItem* item = reinterpret_cast<TestItem*>(cache->Value(handles[i]));
+    ASSERT_NE(item, nullptr);
+    ASSERT_EQ(item->data(), values[i]);
+    cache->Release(handles[i]);
+  }
+
+  // A pending handle can also be released without waiting
+  Cache::Handle* handle = cache->Lookup("k2", &helper_, test_item_creator_,
+                                        Cache::Priority::LOW, false /*wait*/);
+  ASSERT_NE(handle, nullptr);
+  cache->Release(handle);
+  ASSERT_LE(cache->GetUsage(), cache->GetCapacity());
+}
+
+TEST_F(LRUSecondaryCacheTest, LRUSecondaryCache) {
+  for (CompressionType type : {kNoCompression, kSnappyCompression,
+                               kLZ4Compression, kZlibCompression}) {
+    if (!CompressionTypeSupported(type)) {
+      continue;
+    }
+    LRUSecondaryCacheOptions secondary_opts(4096, 0 /*num_shard_bits*/, type);
+    std::shared_ptr<SecondaryCache> secondary_cache =
+        NewLRUSecondaryCache(secondary_opts);
+    std::shared_ptr<Cache> cache = NewPrimaryCache(1024, secondary_cache);
+
+    std::string value1(700, 'a');
+    std::string value2(700, 'b');
+    ASSERT_OK(InsertItem(cache.get(), "k1", value1));
+    ASSERT_OK(InsertItem(cache.get(), "k2", value2));
+    ASSERT_EQ(LookupItem(cache.get(), "k1"), value1);
+    ASSERT_EQ(LookupItem(cache.get(), "k2"), value2);
+    // A promoted entry is erased from the secondary cache, so each key lives
+    // in only one of the tiers.
+    ASSERT_EQ(secondary_cache->Lookup("k2", test_item_creator_, true),
+              nullptr);
+    ASSERT_EQ(LookupItem(cache.get(), "k3"), "NOT_FOUND");
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
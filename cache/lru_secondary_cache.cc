@@ -0,0 +1,140 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/lru_secondary_cache.h"
+
+#include <memory>
+
+#include "memory/memory_allocator.h"
+#include "util/compression.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+// The persistable data of one demoted entry, possibly compressed.
+struct StoredEntry {
+  CacheAllocationPtr data;
+  size_t size = 0;
+  CompressionType compression_type = kNoCompression;
+};
+
+void DeleteStoredEntry(const Slice& /*key*/, void* value) {
+  delete static_cast<StoredEntry*>(value);
+}
+
+}  // namespace
+
+LRUSecondaryCache::LRUSecondaryCache(const LRUSecondaryCacheOptions& opts)
+    : cache_options_(opts) {
+  cache_ = NewLRUCache(opts.capacity, opts.num_shard_bits,
+                       false /* strict_capacity_limit */,
+                       0.0 /* high_pri_pool_ratio */, opts.memory_allocator);
+}
+
+LRUSecondaryCache::~LRUSecondaryCache() { cache_.reset(); }
+
+Status LRUSecondaryCache::Insert(const Slice& key, void* value,
+                                 const Cache::CacheItemHelper* helper) {
+  assert(helper);
+  MemoryAllocator* allocator = cache_options_.memory_allocator.get();
+  size_t size = (*helper->size_cb)(value);
+  CacheAllocationPtr buf = AllocateBlock(size, allocator);
+  Status s = (*helper->saveto_cb)(value, 0, size, buf.get());
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::unique_ptr<StoredEntry> entry(new StoredEntry);
+  if (cache_options_.compression_type != kNoCompression) {
+    CompressionOptions compression_opts;
+    CompressionContext compression_context(cache_options_.compression_type);
+    CompressionInfo compression_info(
+        compression_opts, compression_context, CompressionDict::GetEmptyDict(),
+        cache_options_.compression_type, 0 /* sample_for_compression */);
+    std::string compressed;
+    // Keep the data uncompressed if the compression method is not supported
+    // or does not save anything.
+    if (CompressData(Slice(buf.get(), size), compression_info,
+                     cache_options_.compress_format_version, &compressed) &&
+        compressed.size() < size) {
+      buf = AllocateBlock(compressed.size(), allocator);
+      memcpy(buf.get(), compressed.data(), compressed.size());
+      size = compressed.size();
+      entry->compression_type = cache_options_.compression_type;
+    }
+  }
+  entry->data = std::move(buf);
+  entry->size = size;
+
+  return cache_->Insert(key, entry.release(), size, &DeleteStoredEntry);
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> LRUSecondaryCache::Lookup(
+    const Slice& key, const Cache::CreateCallback& create_cb, bool /*wait*/) {
+  std::unique_ptr<SecondaryCacheResultHandle> handle;
+  Cache::Handle* lru_handle = cache_->Lookup(key);
+  if (lru_handle == nullptr) {
+    return handle;
+  }
+
+  StoredEntry* entry = static_cast<StoredEntry*>(cache_->Value(lru_handle));
+  CacheAllocationPtr uncompressed;
+  char* data = entry->data.get();
+  size_t size = entry->size;
+  Status s;
+  if (entry->compression_type != kNoCompression) {
+    UncompressionContext uncompression_context(entry->compression_type);
+    UncompressionInfo uncompression_info(uncompression_context,
+                                         UncompressionDict::GetEmptyDict(),
+                                         entry->compression_type);
+    size_t uncompressed_size = 0;
+    uncompressed = UncompressData(
+        uncompression_info, data, size, &uncompressed_size,
+        cache_options_.compress_format_version,
+        cache_options_.memory_allocator.get());
+    if (!uncompressed) {
+      s = Status::Corruption("Unable to decompress secondary cache entry");
+    }
+    data = uncompressed.get();
+    size = uncompressed_size;
+  }
+
+  void* value = nullptr;
+  size_t charge = 0;
+  if (s.ok()) {
+    s = create_cb(data, size, &value, &charge);
+  }
+  // The entry now lives in the primary cache again (or is unusable), so it
+  // does not need to take space here.
+  cache_->Release(lru_handle, true /* force_erase */);
+  if (s.ok()) {
+    handle.reset(new LRUSecondaryCacheResultHandle(value, charge));
+  }
+  return handle;
+}
+
+void LRUSecondaryCache::Erase(const Slice& key) { cache_->Erase(key); }
+
+std::string LRUSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  ret.append(cache_->GetPrintableOptions());
+  snprintf(buffer, kBufferSize, "    compression_type : %s\n",
+           CompressionTypeToString(cache_options_.compression_type).c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
+           cache_options_.compress_format_version);
+  ret.append(buffer);
+  return ret;
+}
+
+std::shared_ptr<SecondaryCache> NewLRUSecondaryCache(
+    const LRUSecondaryCacheOptions& opts) {
+  return std::make_shared<LRUSecondaryCache>(opts);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
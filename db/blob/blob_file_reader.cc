@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 #include "db/blob/blob_log_format.h"
 #include "file/filename.h"
@@ -333,6 +334,152 @@ Status BlobFileReader::GetBlob(const ReadOptions& read_options,
   return Status::OK();
 }
 
+void BlobFileReader::MultiGetBlob(
+    const ReadOptions& read_options,
+    const autovector<BlobReadRequest*>& blob_reqs) const {
+  constexpr size_t kNoRead = port::kMaxSizet;
+
+  // For each blob request, the read request covering its record and the
+  // adjustment applied to its offset (see GetBlob).
+  autovector<size_t> read_req_idx;
+  autovector<uint64_t> adjustments;
+  std::vector<FSReadRequest> read_reqs;
+  size_t total_len = 0;
+
+  for (BlobReadRequest* const blob_req : blob_reqs) {
+    assert(blob_req);
+    assert(blob_req->user_key);
+    assert(blob_req->result);
+    assert(blob_req->status);
+
+    const uint64_t key_size = blob_req->user_key->size();
+
+    if (!IsValidBlobOffset(blob_req->offset, key_size, blob_req->value_size,
+                           file_size_)) {
+      *blob_req->status = Status::Corruption("Invalid blob offset");
+      read_req_idx.push_back(kNoRead);
+      adjustments.push_back(0);
+      continue;
+    }
+
+    if (blob_req->compression != compression_type_) {
+      *blob_req->status =
+          Status::Corruption("Compression type mismatch when reading blob");
+      read_req_idx.push_back(kNoRead);
+      adjustments.push_back(0);
+      continue;
+    }
+
+    const uint64_t adjustment =
+        read_options.verify_checksums
+            ? BlobLogRecord::CalculateAdjustmentForRecordHeader(key_size)
+            : 0;
+    assert(blob_req->offset >= adjustment);
+
+    const uint64_t record_offset = blob_req->offset - adjustment;
+    const uint64_t record_end = blob_req->offset + blob_req->value_size;
+
+    if (!read_reqs.empty() &&
+        record_offset <= read_reqs.back().offset + read_reqs.back().len) {
+      assert(record_offset >= read_reqs.back().offset);
+
+      FSReadRequest& prev = read_reqs.back();
+      const uint64_t prev_end = prev.offset + prev.len;
+      if (record_end > prev_end) {
+        prev.len += static_cast<size_t>(record_end - prev_end);
+        total_len += static_cast<size_t>(record_end - prev_end);
+      }
+    } else {
+      FSReadRequest req;
+      req.offset = record_offset;
+      req.len = static_cast<size_t>(record_end - record_offset);
+      req.scratch = nullptr;
+      read_reqs.emplace_back(req);
+      total_len += req.len;
+    }
+
+    read_req_idx.push_back(read_reqs.size() - 1);
+    adjustments.push_back(adjustment);
+  }
+
+  if (read_reqs.empty()) {
+    return;
+  }
+
+  Buffer buf;
+  AlignedBuf aligned_buf;
+
+  {
+    size_t num_read_reqs = read_reqs.size();
+    TEST_SYNC_POINT_CALLBACK("BlobFileReader::MultiGetBlob:ReadFromFile",
+                             &num_read_reqs);
+
+    if (!file_reader_->use_direct_io()) {
+      buf.reset(new char[total_len]);
+
+      size_t buf_offset = 0;
+      for (FSReadRequest& req : read_reqs) {
+        req.scratch = buf.get() + buf_offset;
+        buf_offset += req.len;
+      }
+    }
+
+    const Status s = file_reader_->MultiRead(IOOptions(), read_reqs.data(),
+                                             read_reqs.size(), &aligned_buf);
+    if (!s.ok()) {
+      for (size_t i = 0; i < blob_reqs.size(); ++i) {
+        if (read_req_idx[i] != kNoRead) {
+          *blob_reqs[i]->status = s;
+        }
+      }
+      return;
+    }
+  }
+
+  for (size_t i = 0; i < blob_reqs.size(); ++i) {
+    if (read_req_idx[i] == kNoRead) {
+      continue;
+    }
+
+    BlobReadRequest* const blob_req = blob_reqs[i];
+    const FSReadRequest& req = read_reqs[read_req_idx[i]];
+
+    if (!req.status.ok()) {
+      *blob_req->status = req.status;
+      continue;
+    }
+
+    const uint64_t adjustment = adjustments[i];
+    const uint64_t record_offset = blob_req->offset - adjustment;
+    const uint64_t record_size = blob_req->value_size + adjustment;
+    const uint64_t offset_in_req = record_offset - req.offset;
+
+    if (req.result.size() < offset_in_req + record_size) {
+      *blob_req->status =
+          Status::Corruption("Failed to read data from blob file");
+      continue;
+    }
+
+    const Slice record_slice(req.result.data() + offset_in_req,
+                             static_cast<size_t>(record_size));
+
+    if (read_options.verify_checksums) {
+      const Status s =
+          VerifyBlob(record_slice, *blob_req->user_key, blob_req->value_size);
+      if (!s.ok()) {
+        *blob_req->status = s;
+        continue;
+      }
+    }
+
+    const Slice value_slice(record_slice.data() + adjustment,
+                            blob_req->value_size);
+
+    *blob_req->status = UncompressBlobIfNeeded(
+        value_slice, blob_req->compression, blob_req->result);
+  }
+}
+
 Status BlobFileReader::VerifyBlob(const Slice& record_slice,
                                   const Slice& user_key, uint64_t value_size) {
   BlobLogRecord record;
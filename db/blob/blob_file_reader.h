@@ -11,6 +11,7 @@
 #include "file/random_access_file_reader.h"
 #include "rocksdb/compression_type.h"
 #include "rocksdb/rocksdb_namespace.h"
+#include "util/autovector.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -22,6 +23,21 @@ struct ReadOptions;
 class Slice;
 class PinnableSlice;
 
+// A request to read a single blob, used by BlobFileReader::MultiGetBlob.
+struct BlobReadRequest {
+  // User key the blob belongs to, used for verifying the blob record
+  const Slice* user_key = nullptr;
+
+  // Offset and size of the blob value in the blob file, and its compression
+  uint64_t offset = 0;
+  uint64_t value_size = 0;
+  CompressionType compression = kNoCompression;
+
+  // Output: the uncompressed blob value, and the status of the read
+  PinnableSlice* result = nullptr;
+  Status* status = nullptr;
+};
+
 class BlobFileReader {
  public:
   static Status Create(const ImmutableCFOptions& immutable_cf_options,
@@ -40,6 +56,13 @@ class BlobFileReader {
                  uint64_t offset, uint64_t value_size,
                  CompressionType compression_type, PinnableSlice* value) const;
 
+  // Reads the blobs of blob_reqs, which have to be sorted by offset, with a
+  // single MultiRead. The reads of blob records that are adjacent in the file
+  // are coalesced into one. The outcome of each request is stored in its
+  // status.
+  void MultiGetBlob(const ReadOptions& read_options,
+                    const autovector<BlobReadRequest*>& blob_reqs) const;
+
  private:
   BlobFileReader(std::unique_ptr<RandomAccessFileReader>&& file_reader,
                  uint64_t file_size, CompressionType compression_type);
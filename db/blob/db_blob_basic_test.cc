@@ -3,6 +3,8 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <array>
+
 #include "db/blob/blob_index.h"
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
@@ -44,6 +46,228 @@ TEST_F(DBBlobBasicTest, GetBlob) {
                   .IsIncomplete());
 }
 
+TEST_F(DBBlobBasicTest, GetBlobFromCache) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.statistics = CreateDBStatistics();
+
+  LRUCacheOptions co;
+  co.capacity = 1 << 20;
+  // Leave the handles out of the usage, so that it is the size of the blobs.
+  co.metadata_charge_policy = kDontChargeCacheMetadata;
+  options.blob_cache = NewLRUCache(co);
+
+  Reopen(options);
+
+  constexpr char key[] = "key";
+  constexpr char blob_value[] = "blob_value";
+
+  ASSERT_OK(Put(key, blob_value));
+
+  ASSERT_OK(Flush());
+
+  // Reading without fill_cache should not populate the blob cache.
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+
+  {
+    PinnableSlice result;
+    ASSERT_OK(
+        db_->Get(read_options, db_->DefaultColumnFamily(), key, &result));
+    ASSERT_EQ(result, blob_value);
+  }
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_MISS), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 0);
+  ASSERT_EQ(options.blob_cache->GetUsage(), 0);
+
+  ASSERT_EQ(Get(key), blob_value);
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_MISS), 2);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 1);
+  ASSERT_EQ(options.blob_cache->GetUsage(), strlen(blob_value));
+
+  // The blob is now served from the cache, even with no I/O allowed. The
+  // result pins the cache entry until it is reset.
+  read_options.fill_cache = true;
+  read_options.read_tier = kBlockCacheTier;
+
+  {
+    PinnableSlice result;
+    ASSERT_OK(
+        db_->Get(read_options, db_->DefaultColumnFamily(), key, &result));
+    ASSERT_EQ(result, blob_value);
+    ASSERT_EQ(options.blob_cache->GetPinnedUsage(), strlen(blob_value));
+  }
+
+  ASSERT_EQ(options.blob_cache->GetPinnedUsage(), 0);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_HIT), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_MISS), 2);
+}
+
+TEST_F(DBBlobBasicTest, PinBlobsAddedToCache) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.statistics = CreateDBStatistics();
+
+  LRUCacheOptions co;
+  co.capacity = 1 << 20;
+  // Leave the handles out of the usage, so that it is the size of the blobs.
+  co.metadata_charge_policy = kDontChargeCacheMetadata;
+  options.blob_cache = NewLRUCache(co);
+
+  Reopen(options);
+
+  constexpr size_t num_keys = 2;
+  const std::array<std::string, num_keys> keys{{"key0", "key1"}};
+  const std::array<std::string, num_keys> values{
+      {std::string(1000, 'a'), std::string(2000, 'b')}};
+
+  for (size_t i = 0; i < num_keys; ++i) {
+    ASSERT_OK(Put(keys[i], values[i]));
+  }
+
+  ASSERT_OK(Flush());
+
+  // The blob read from the file is moved into the cache, and the result pins
+  // it there.
+  {
+    PinnableSlice result;
+    ASSERT_OK(
+        db_->Get(ReadOptions(), db_->DefaultColumnFamily(), keys[0], &result));
+    ASSERT_EQ(result, values[0]);
+    ASSERT_TRUE(result.IsPinned());
+    ASSERT_EQ(options.blob_cache->GetPinnedUsage(), values[0].size());
+  }
+
+  ASSERT_EQ(options.blob_cache->GetPinnedUsage(), 0);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 1);
+
+  {
+    std::array<Slice, num_keys> key_slices{{keys[0], keys[1]}};
+    std::array<PinnableSlice, num_keys> results;
+    std::array<Status, num_keys> statuses;
+
+    db_->MultiGet(ReadOptions(), db_->DefaultColumnFamily(), num_keys,
+                  &key_slices[0], &results[0], &statuses[0]);
+
+    for (size_t i = 0; i < num_keys; ++i) {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(results[i], values[i]);
+      ASSERT_TRUE(results[i].IsPinned());
+    }
+    ASSERT_EQ(options.blob_cache->GetPinnedUsage(),
+              values[0].size() + values[1].size());
+  }
+
+  ASSERT_EQ(options.blob_cache->GetPinnedUsage(), 0);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_HIT), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 2);
+
+  // A std::string result still gets a copy of the blob.
+  ASSERT_EQ(Get(keys[1]), values[1]);
+}
+
+TEST_F(DBBlobBasicTest, MultiGetBlobs) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+
+  Reopen(options);
+
+  // All the blobs end up next to each other in a single blob file.
+  constexpr size_t num_keys = 3;
+  const std::array<std::string, num_keys> keys{{"key0", "key1", "key2"}};
+  const std::array<std::string, num_keys> values{
+      {"blob_value0", "blob_value1", "blob_value2"}};
+
+  for (size_t i = 0; i < num_keys; ++i) {
+    ASSERT_OK(Put(keys[i], values[i]));
+  }
+
+  ASSERT_OK(Flush());
+
+  size_t num_read_reqs = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::MultiGetBlob:ReadFromFile",
+      [&](void* arg) { num_read_reqs = *static_cast<size_t*>(arg); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool verify_checksums : {true, false}) {
+    ReadOptions read_options;
+    read_options.verify_checksums = verify_checksums;
+
+    std::array<Slice, num_keys + 1> key_slices;
+    for (size_t i = 0; i < num_keys; ++i) {
+      key_slices[i] = keys[i];
+    }
+    key_slices[num_keys] = "missing_key";
+
+    std::array<PinnableSlice, num_keys + 1> results;
+    std::array<Status, num_keys + 1> statuses;
+
+    num_read_reqs = 0;
+    db_->MultiGet(read_options, db_->DefaultColumnFamily(), num_keys + 1,
+                  &key_slices[0], &results[0], &statuses[0]);
+
+    for (size_t i = 0; i < num_keys; ++i) {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(results[i], values[i]);
+    }
+    ASSERT_TRUE(statuses[num_keys].IsNotFound());
+
+    // When the whole records are read, the adjacent blobs are read at once.
+    ASSERT_EQ(num_read_reqs, verify_checksums ? 1 : num_keys);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBBlobBasicTest, MultiGetBlobsValueSizeSoftLimit) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+
+  Reopen(options);
+
+  constexpr size_t num_keys = 4;
+  const std::array<std::string, num_keys> keys{
+      {"key0", "key1", "key2", "key3"}};
+  const std::string value(100, 'a');
+
+  for (size_t i = 0; i < num_keys; ++i) {
+    ASSERT_OK(Put(keys[i], value));
+  }
+
+  ASSERT_OK(Flush());
+
+  // The blob indexes are much smaller than the limit, but the blobs they
+  // refer to exceed it from the second key on.
+  ReadOptions read_options;
+  read_options.value_size_soft_limit = 150;
+
+  std::array<Slice, num_keys> key_slices;
+  for (size_t i = 0; i < num_keys; ++i) {
+    key_slices[i] = keys[i];
+  }
+  std::array<PinnableSlice, num_keys> results;
+  std::array<Status, num_keys> statuses;
+
+  db_->MultiGet(read_options, db_->DefaultColumnFamily(), num_keys,
+                &key_slices[0], &results[0], &statuses[0]);
+
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_OK(statuses[i]);
+    ASSERT_EQ(results[i], value);
+  }
+  for (size_t i = 2; i < num_keys; ++i) {
+    ASSERT_TRUE(statuses[i].IsAborted());
+  }
+}
+
 TEST_F(DBBlobBasicTest, GetBlob_CorruptIndex) {
   Options options = GetDefaultOptions();
   options.enable_blob_files = true;
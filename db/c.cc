@@ -5152,6 +5152,47 @@ rocksdb_pinnableslice_t* rocksdb_get_pinned_cf(
   return v;
 }
 
+void rocksdb_multi_get_pinned(rocksdb_t* db,
+                              const rocksdb_readoptions_t* options,
+                              size_t num_keys, const char* const* keys_list,
+                              const size_t* keys_list_sizes,
+                              rocksdb_pinnableslice_t** values, char** errs) {
+  rocksdb_column_family_handle_t default_cf;
+  default_cf.rep = db->rep->DefaultColumnFamily();
+  rocksdb_multi_get_pinned_cf(db, options, &default_cf, num_keys, keys_list,
+                              keys_list_sizes, values, errs);
+}
+
+void rocksdb_multi_get_pinned_cf(
+    rocksdb_t* db, const rocksdb_readoptions_t* options,
+    rocksdb_column_family_handle_t* column_family, size_t num_keys,
+    const char* const* keys_list, const size_t* keys_list_sizes,
+    rocksdb_pinnableslice_t** values, char** errs) {
+  std::vector<Slice> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = Slice(keys_list[i], keys_list_sizes[i]);
+  }
+  std::vector<PinnableSlice> pinned_values(num_keys);
+  std::vector<Status> statuses(num_keys);
+  db->rep->MultiGet(options->rep, column_family->rep, num_keys, keys.data(),
+                    pinned_values.data(), statuses.data());
+  for (size_t i = 0; i < num_keys; i++) {
+    if (statuses[i].ok()) {
+      // Take over the value, and the cleanups that keep its block pinned
+      values[i] = new (rocksdb_pinnableslice_t);
+      values[i]->rep = std::move(pinned_values[i]);
+      errs[i] = nullptr;
+    } else {
+      values[i] = nullptr;
+      if (!statuses[i].IsNotFound()) {
+        errs[i] = strdup(statuses[i].ToString().c_str());
+      } else {
+        errs[i] = nullptr;
+      }
+    }
+  }
+}
+
 void rocksdb_pinnableslice_destroy(rocksdb_pinnableslice_t* v) { delete v; }
 
 const char* rocksdb_pinnableslice_value(const rocksdb_pinnableslice_t* v,
@@ -969,6 +969,29 @@ int main(int argc, char** argv) {
     CheckPinGet(db, roptions, "notfound", NULL);
   }
 
+  StartPhase("multi_get_pinned");
+  {
+    const char* keys[3] = { "box", "foo", "notfound" };
+    const size_t keys_sizes[3] = { 3, 3, 8 };
+    rocksdb_pinnableslice_t* vals[3];
+    char* errs[3];
+    rocksdb_multi_get_pinned(db, roptions, 3, keys, keys_sizes, vals, errs);
+
+    const char* expected[3] = { "c", "hello", NULL };
+    int i;
+    for (i = 0; i < 3; i++) {
+      CheckEqual(NULL, errs[i], 0);
+      if (expected[i] == NULL) {
+        CheckCondition(vals[i] == NULL);
+      } else {
+        size_t val_len;
+        const char* val = rocksdb_pinnableslice_value(vals[i], &val_len);
+        CheckEqual(expected[i], val, val_len);
+        rocksdb_pinnableslice_destroy(vals[i]);
+      }
+    }
+  }
+
   StartPhase("approximate_sizes");
   {
     int i;
@@ -1300,6 +1323,24 @@ int main(int argc, char** argv) {
       Free(&vals[i]);
     }
 
+    {
+      rocksdb_pinnableslice_t* pinned_vals[3];
+      rocksdb_multi_get_pinned_cf(db, roptions, handles[1], 3, keys,
+                                  keys_sizes, pinned_vals, errs);
+      for (i = 0; i < 3; i++) {
+        CheckEqual(NULL, errs[i], 0);
+        if (i == 2) {
+          CheckCondition(pinned_vals[i] == NULL);
+        } else {
+          size_t val_len;
+          const char* val =
+              rocksdb_pinnableslice_value(pinned_vals[i], &val_len);
+          CheckEqual("c", val, val_len);
+          rocksdb_pinnableslice_destroy(pinned_vals[i]);
+        }
+      }
+    }
+
     {
       unsigned char value_found = 0;
 
@@ -37,6 +37,7 @@
 #include "table/merging_iterator.h"
 #include "util/autovector.h"
 #include "util/cast_util.h"
+#include "util/coding.h"
 #include "util/compression.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -563,6 +564,9 @@ ColumnFamilyData::ColumnFamilyData(
     blob_file_cache_.reset(
         new BlobFileCache(_table_cache, ioptions(), soptions(), id_,
                           internal_stats_->GetBlobFileReadHist()));
+    if (ioptions_.blob_cache) {
+      PutVarint64(&blob_cache_key_prefix_, ioptions_.blob_cache->NewId());
+    }
 
     if (ioptions_.compaction_style == kCompactionStyleLevel) {
       compaction_picker_.reset(
@@ -729,6 +733,7 @@ const double kIncSlowdownRatio = 0.8;
 const double kDecSlowdownRatio = 1 / kIncSlowdownRatio;
 const double kNearStopSlowdownRatio = 0.6;
 const double kDelayRecoverSlowdownRatio = 1.4;
+const uint64_t kMinWriteRate = 16 * 1024u;  // Minimum write rate 16KB/s.
 
 namespace {
 // If penalize_stop is true, we further reduce slowdown rate.
@@ -736,8 +741,6 @@ std::unique_ptr<WriteControllerToken> SetupDelay(
     WriteController* write_controller, uint64_t compaction_needed_bytes,
     uint64_t prev_compaction_need_bytes, bool penalize_stop,
     bool auto_comapctions_disabled) {
-  const uint64_t kMinWriteRate = 16 * 1024u;  // Minimum write rate 16KB/s.
-
   uint64_t max_write_rate = write_controller->max_delayed_write_rate();
   uint64_t write_rate = write_controller->delayed_write_rate();
 
@@ -881,6 +884,26 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     bool was_stopped = write_controller->IsStopped();
     bool needed_delay = write_controller->NeedsDelay();
 
+    // With a pending compaction bytes target, the controller sees every
+    // recalculation so its throughput estimate stays current, but its rate is
+    // only applied while the debt is above the target.
+    uint64_t controller_write_rate = 0;
+    if (mutable_cf_options.pending_compaction_bytes_target > 0 &&
+        !mutable_cf_options.disable_auto_compactions) {
+      uint64_t max_write_rate = write_controller->max_delayed_write_rate();
+      controller_write_rate = pending_compaction_bytes_controller_.Update(
+          ioptions_.env->NowMicros(), compaction_needed_bytes,
+          mutable_cf_options.pending_compaction_bytes_target,
+          internal_stats_->GetCFStatsValue(
+              InternalStats::BYTES_WRITTEN_BY_COMPACTION),
+          internal_stats_->GetCFStatsValue(InternalStats::BYTES_FLUSHED) +
+              internal_stats_->GetCFStatsValue(
+                  InternalStats::BYTES_INGESTED_ADD_FILE),
+          std::min(kMinWriteRate, max_write_rate), max_write_rate);
+    } else {
+      pending_compaction_bytes_controller_.Reset();
+    }
+
     if (write_stall_condition == WriteStallCondition::kStopped &&
         write_stall_cause == WriteStallCause::kMemtableLimit) {
       write_controller_token_ = write_controller->GetStopToken();
@@ -960,10 +983,15 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
                    mutable_cf_options.soft_pending_compaction_bytes_limit) /
                   4;
 
-      write_controller_token_ =
-          SetupDelay(write_controller, compaction_needed_bytes,
-                     prev_compaction_needed_bytes_, was_stopped || near_stop,
-                     mutable_cf_options.disable_auto_compactions);
+      if (controller_write_rate > 0) {
+        write_controller_token_ =
+            write_controller->GetDelayToken(controller_write_rate);
+      } else {
+        write_controller_token_ =
+            SetupDelay(write_controller, compaction_needed_bytes,
+                       prev_compaction_needed_bytes_, was_stopped || near_stop,
+                       mutable_cf_options.disable_auto_compactions);
+      }
       internal_stats_->AddCFStats(
           InternalStats::PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS, 1);
       ROCKS_LOG_WARN(
@@ -972,6 +1000,22 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
           "bytes %" PRIu64 " rate %" PRIu64,
           name_.c_str(), vstorage->estimated_compaction_needed_bytes(),
           write_controller->delayed_write_rate());
+    } else if (controller_write_rate > 0 &&
+               compaction_needed_bytes >
+                   mutable_cf_options.pending_compaction_bytes_target) {
+      assert(write_stall_condition == WriteStallCondition::kNormal);
+      write_stall_condition = WriteStallCondition::kDelayed;
+      write_controller_token_ =
+          write_controller->GetDelayToken(controller_write_rate);
+      internal_stats_->AddCFStats(
+          InternalStats::PENDING_COMPACTION_BYTES_TARGET_SLOWDOWNS, 1);
+      ROCKS_LOG_WARN(
+          ioptions_.info_log,
+          "[%s] Stalling writes because estimated pending compaction bytes "
+          "%" PRIu64 " are above the target %" PRIu64 " rate %" PRIu64,
+          name_.c_str(), compaction_needed_bytes,
+          mutable_cf_options.pending_compaction_bytes_target,
+          write_controller->delayed_write_rate());
     } else {
       assert(write_stall_condition == WriteStallCondition::kNormal);
       if (vstorage->l0_delay_trigger_count() >=
@@ -358,6 +358,11 @@ class ColumnFamilyData {
 
   InternalStats* internal_stats() { return internal_stats_.get(); }
 
+  const PendingCompactionBytesController& pending_compaction_bytes_controller()
+      const {
+    return pending_compaction_bytes_controller_;
+  }
+
   MemTableList* imm() { return &imm_; }
   MemTable* mem() { return mem_; }
   Version* current() { return current_; }
@@ -383,6 +388,12 @@ class ColumnFamilyData {
 
   TableCache* table_cache() const { return table_cache_.get(); }
   BlobFileCache* blob_file_cache() const { return blob_file_cache_.get(); }
+  // Prefix of the keys under which the values of this column family's blob
+  // files are stored in ioptions()->blob_cache. Empty if there is no blob
+  // cache.
+  const std::string& blob_cache_key_prefix() const {
+    return blob_cache_key_prefix_;
+  }
 
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
@@ -547,6 +558,7 @@ class ColumnFamilyData {
 
   std::unique_ptr<TableCache> table_cache_;
   std::unique_ptr<BlobFileCache> blob_file_cache_;
+  std::string blob_cache_key_prefix_;
 
   std::unique_ptr<InternalStats> internal_stats_;
 
@@ -595,6 +607,9 @@ class ColumnFamilyData {
 
   uint64_t prev_compaction_needed_bytes_;
 
+  // Drives the delayed write rate when pending_compaction_bytes_target is set.
+  PendingCompactionBytesController pending_compaction_bytes_controller_;
+
   // if the database was opened with 2pc enabled
   bool allow_2pc_;
 
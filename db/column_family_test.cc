@@ -2745,6 +2745,76 @@ TEST_P(ColumnFamilyTest, WriteStallSingleColumnFamily) {
   ASSERT_EQ(kBaseRate / 1.25, GetDbDelayedWriteRate());
 }
 
+TEST_P(ColumnFamilyTest, WriteStallPendingCompactionBytesTarget) {
+  const uint64_t kBaseRate = 800000u;
+  db_options_.delayed_write_rate = kBaseRate;
+  db_options_.max_background_compactions = 6;
+
+  Open({"default"});
+  ColumnFamilyData* cfd =
+      static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())->cfd();
+
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+
+  MutableCFOptions mutable_cf_options(column_family_options_);
+
+  mutable_cf_options.level0_slowdown_writes_trigger = 20;
+  mutable_cf_options.level0_stop_writes_trigger = 10000;
+  mutable_cf_options.soft_pending_compaction_bytes_limit = 2000;
+  mutable_cf_options.hard_pending_compaction_bytes_limit = 4000;
+  mutable_cf_options.pending_compaction_bytes_target = 100;
+  mutable_cf_options.disable_auto_compactions = false;
+
+  vstorage->TEST_set_estimated_compaction_needed_bytes(50);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(!IsDbWriteStopped());
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().NeedsDelay());
+
+  // No compaction has finished, so the configured rate is corrected by the
+  // distance from the target: 50% above it takes 25% off.
+  vstorage->TEST_set_estimated_compaction_needed_bytes(150);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(!IsDbWriteStopped());
+  ASSERT_TRUE(dbfull()->TEST_write_controler().NeedsDelay());
+  uint64_t rate = GetDbDelayedWriteRate();
+  ASSERT_LE(rate, kBaseRate * 3 / 4);
+  ASSERT_GT(rate, kBaseRate * 7 / 10);
+
+  // Far above the target the rate drops, but at most by half per update.
+  vstorage->TEST_set_estimated_compaction_needed_bytes(300);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(dbfull()->TEST_write_controler().NeedsDelay());
+  ASSERT_LT(GetDbDelayedWriteRate(), rate);
+  ASSERT_GE(GetDbDelayedWriteRate(), rate / 2);
+
+  vstorage->TEST_set_estimated_compaction_needed_bytes(50);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(!IsDbWriteStopped());
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().NeedsDelay());
+
+  // The hard limit still stops writes.
+  vstorage->TEST_set_estimated_compaction_needed_bytes(4001);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(IsDbWriteStopped());
+
+  vstorage->TEST_set_estimated_compaction_needed_bytes(50);
+  RecalculateWriteStallConditions(cfd, mutable_cf_options);
+  ASSERT_TRUE(!IsDbWriteStopped());
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().NeedsDelay());
+
+#ifndef ROCKSDB_LITE
+  std::map<std::string, std::string> stall_stats;
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kCFWriteStallStats,
+                                  &stall_stats));
+  ASSERT_EQ("2",
+            stall_stats["io_stalls.slowdown_for_pending_compaction_bytes_target"]);
+  ASSERT_EQ("1", stall_stats["io_stalls.stop_for_pending_compaction_bytes"]);
+  ASSERT_EQ("2", stall_stats["io_stalls.total_slowdown"]);
+  ASSERT_TRUE(stall_stats.count("controller.write_rate") > 0);
+  ASSERT_TRUE(stall_stats.count("controller.compaction_bytes_per_sec") > 0);
+#endif  // !ROCKSDB_LITE
+}
+
 TEST_P(ColumnFamilyTest, CompactionSpeedupSingleColumnFamily) {
   db_options_.max_background_compactions = 6;
   Open({"default"});
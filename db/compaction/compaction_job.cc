@@ -46,7 +46,9 @@
 #include "monitoring/iostats_context_imp.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/thread_status_util.h"
+#include "options/options_helper.h"
 #include "port/port.h"
+#include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/sst_partitioner.h"
@@ -128,9 +130,11 @@ struct CompactionJob::SubcompactionState {
   // Files produced by this subcompaction
   struct Output {
     Output(FileMetaData&& _meta, const InternalKeyComparator& _icmp,
-           bool _enable_order_check, bool _enable_hash)
+           bool _enable_order_check, bool _enable_hash,
+           uint64_t _precalculated_hash = 0)
         : meta(std::move(_meta)),
-          validator(_icmp, _enable_order_check, _enable_hash),
+          validator(_icmp, _enable_order_check, _enable_hash,
+                    _precalculated_hash),
           finished(false) {}
     FileMetaData meta;
     OutputValidator validator;
@@ -162,6 +166,7 @@ struct CompactionJob::SubcompactionState {
   // State during the subcompaction
   uint64_t total_bytes = 0;
   uint64_t num_output_records = 0;
+  uint64_t num_input_records = 0;
   CompactionJobStats compaction_job_stats;
   uint64_t approx_size = 0;
   // An index that used to speed up ShouldStopBefore().
@@ -296,6 +301,7 @@ void CompactionJob::AggregateStatistics() {
 
 CompactionJob::CompactionJob(
     int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+    const MutableDBOptions& mutable_db_options,
     const FileOptions& file_options, VersionSet* versions,
     const std::atomic<bool>* shutting_down,
     const SequenceNumber preserve_deletes_seqnum, LogBuffer* log_buffer,
@@ -318,6 +324,7 @@ CompactionJob::CompactionJob(
       db_id_(db_id),
       db_session_id_(db_session_id),
       db_options_(db_options),
+      mutable_db_options_copy_(mutable_db_options),
       file_options_(file_options),
       env_(db_options.env),
       io_tracer_(io_tracer),
@@ -451,6 +458,10 @@ struct RangeWithSize {
 void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
   auto* cfd = c->column_family_data();
+  if (cfd->ioptions()->compaction_style == kCompactionStyleUniversal) {
+    GenSubcompactionBoundariesFromAnchors();
+    return;
+  }
   const Comparator* cfd_comparator = cfd->user_comparator();
   std::vector<Slice> bounds;
   int start_lvl = c->start_level();
@@ -576,6 +587,79 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::GenSubcompactionBoundariesFromAnchors() {
+  auto* c = compact_->compaction;
+  auto* cfd = c->column_family_data();
+  const Comparator* ucmp = cfd->user_comparator();
+
+  // Reading the indexes of the files may incur I/O, so unlock db mutex to
+  // reduce contention. The input version is referenced by the compaction.
+  std::vector<TableReader::Anchor> anchors;
+  ReadOptions ro;
+  db_mutex_->Unlock();
+  for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
+    for (const FileMetaData* f : *c->inputs(lvl_idx)) {
+      const size_t num_anchors = anchors.size();
+      Status s = cfd->table_cache()->ApproximateKeyAnchors(
+          ro, cfd->internal_comparator(), f->fd, &anchors);
+      if (!s.ok()) {
+        // Table formats without an index fall back to the whole file.
+        anchors.erase(anchors.begin() + num_anchors, anchors.end());
+        anchors.emplace_back(f->largest.user_key(), f->fd.GetFileSize());
+      }
+    }
+  }
+  db_mutex_->Lock();
+
+  std::sort(anchors.begin(), anchors.end(),
+            [ucmp](const TableReader::Anchor& a, const TableReader::Anchor& b) {
+              return ucmp->Compare(a.user_key, b.user_key) < 0;
+            });
+  uint64_t total_size = 0;
+  for (const auto& anchor : anchors) {
+    total_size += anchor.range_size;
+  }
+
+  const double min_file_fill_percent = 4.0 / 5;
+  uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
+      total_size / min_file_fill_percent /
+      MaxFileSizeForLevel(*(c->mutable_cf_options()), c->output_level(),
+                          kCompactionStyleUniversal)));
+  uint64_t subcompactions =
+      std::min({static_cast<uint64_t>(anchors.size()),
+                static_cast<uint64_t>(c->max_subcompactions()),
+                max_output_files});
+
+  if (subcompactions > 1) {
+    double mean = total_size * 1.0 / subcompactions;
+    // Greedily add anchored ranges to the subcompaction until the sum of
+    // their sizes becomes >= the expected mean size of a subcompaction. The
+    // anchors of different files may be equal, and a boundary must be
+    // greater than the previous one.
+    uint64_t sum = 0;
+    for (size_t i = 0; i + 1 < anchors.size() && subcompactions > 1; i++) {
+      sum += anchors[i].range_size;
+      if (sum >= mean && (boundary_keys_.empty() ||
+                          ucmp->Compare(anchors[i].user_key,
+                                        boundary_keys_.back()) > 0)) {
+        boundary_keys_.push_back(anchors[i].user_key);
+        sizes_.emplace_back(sum);
+        subcompactions--;
+        sum = 0;
+      }
+    }
+    for (const std::string& key : boundary_keys_) {
+      boundaries_.emplace_back(key);
+    }
+  }
+  // The last subcompaction covers the rest of the anchored ranges.
+  uint64_t last_size = total_size;
+  for (const uint64_t size : sizes_) {
+    last_size -= size;
+  }
+  sizes_.emplace_back(last_size);
+}
+
 Status CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -591,7 +675,7 @@ Status CompactionJob::Run() {
   std::vector<port::Thread> thread_pool;
   thread_pool.reserve(num_threads - 1);
   for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this,
+    thread_pool.emplace_back(&CompactionJob::RunSubcompactionThread, this,
                              &compact_->sub_compact_states[i]);
   }
 
@@ -775,6 +859,8 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
 
   cfd->internal_stats()->AddCompactionStats(
       compact_->compaction->output_level(), thread_pri_, compaction_stats_);
+  cfd->internal_stats()->AddCFStats(InternalStats::BYTES_WRITTEN_BY_COMPACTION,
+                                    compaction_stats_.bytes_written);
 
   if (status.ok()) {
     status = InstallCompactionResults(mutable_cf_options);
@@ -860,6 +946,27 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
          << "output_compression"
          << CompressionTypeToString(compact_->compaction->output_compression());
 
+  if (compact_->sub_compact_states.size() > 1) {
+    stream << "subcompaction_input_records";
+    stream.StartArray();
+    for (const auto& state : compact_->sub_compact_states) {
+      stream << state.num_input_records;
+    }
+    stream.EndArray();
+    stream << "subcompaction_output_bytes";
+    stream.StartArray();
+    for (const auto& state : compact_->sub_compact_states) {
+      stream << state.total_bytes;
+    }
+    stream.EndArray();
+    stream << "subcompaction_cpu_micros";
+    stream.StartArray();
+    for (const auto& state : compact_->sub_compact_states) {
+      stream << state.compaction_job_stats.cpu_micros;
+    }
+    stream.EndArray();
+  }
+
   stream << "num_single_delete_mismatches"
          << compaction_job_stats_->num_single_del_mismatch;
   stream << "num_single_delete_fallthrough"
@@ -890,10 +997,209 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   return status;
 }
 
+#ifndef ROCKSDB_LITE
+CompactionServiceJobStatus
+CompactionJob::ProcessKeyValueCompactionWithCompactionService(
+    SubcompactionState* sub_compact) {
+  assert(sub_compact);
+  assert(sub_compact->compaction);
+  assert(db_options_.compaction_service);
+
+  const Compaction* compaction = sub_compact->compaction;
+  ColumnFamilyData* cfd = compaction->column_family_data();
+  if (compaction->mutable_cf_options()->enable_blob_files) {
+    // The worker does not write blob files.
+    return CompactionServiceJobStatus::kUseLocal;
+  }
+
+  CompactionServiceInput compaction_input;
+  compaction_input.column_family_name = cfd->GetName();
+  ConfigOptions config_options;
+  Status s = GetStringFromColumnFamilyOptions(
+      config_options,
+      BuildColumnFamilyOptions(cfd->initial_cf_options(),
+                               *compaction->mutable_cf_options()),
+      &compaction_input.cf_options);
+  if (s.ok()) {
+    s = GetStringFromDBOptions(
+        config_options, BuildDBOptions(db_options_, mutable_db_options_copy_),
+        &compaction_input.db_options);
+  }
+  if (!s.ok()) {
+    sub_compact->status = s;
+    return CompactionServiceJobStatus::kFailure;
+  }
+  compaction_input.snapshots = existing_snapshots_;
+  for (size_t level = 0; level < compaction->num_input_levels(); level++) {
+    for (size_t i = 0; i < compaction->num_input_files(level); i++) {
+      compaction_input.input_files.emplace_back(
+          MakeTableFileName(compaction->input(level, i)->fd.GetNumber()));
+    }
+  }
+  compaction_input.output_level = compaction->output_level();
+  compaction_input.has_begin = sub_compact->start != nullptr;
+  if (compaction_input.has_begin) {
+    compaction_input.begin = sub_compact->start->ToString();
+  }
+  compaction_input.has_end = sub_compact->end != nullptr;
+  if (compaction_input.has_end) {
+    compaction_input.end = sub_compact->end->ToString();
+  }
+  compaction_input.approx_size = sub_compact->approx_size;
+
+  std::string compaction_input_binary;
+  compaction_input.EncodeTo(&compaction_input_binary);
+  // Job IDs are unique in the DB and there are fewer than 2^32
+  // subcompactions.
+  const uint64_t remote_job_id =
+      (static_cast<uint64_t>(job_id_) << 32) |
+      static_cast<uint64_t>(sub_compact - &compact_->sub_compact_states[0]);
+
+  ROCKS_LOG_INFO(db_options_.info_log,
+                 "[%s] [JOB %d] Starting remote compaction of %" ROCKSDB_PRIszt
+                 " files to level %d",
+                 cfd->GetName().c_str(), job_id_,
+                 compaction_input.input_files.size(),
+                 compaction_input.output_level);
+  CompactionServiceJobStatus compaction_status =
+      db_options_.compaction_service->Start(compaction_input_binary,
+                                            remote_job_id);
+  if (compaction_status == CompactionServiceJobStatus::kUseLocal) {
+    ROCKS_LOG_INFO(db_options_.info_log,
+                   "[%s] [JOB %d] Remote compaction declined, running it "
+                   "locally",
+                   cfd->GetName().c_str(), job_id_);
+    return compaction_status;
+  }
+  if (compaction_status != CompactionServiceJobStatus::kSuccess) {
+    sub_compact->status =
+        Status::Incomplete("CompactionService failed to start compaction job");
+    return compaction_status;
+  }
+
+  std::string compaction_result_binary;
+  compaction_status = db_options_.compaction_service->WaitForComplete(
+      remote_job_id, &compaction_result_binary);
+  if (compaction_status == CompactionServiceJobStatus::kUseLocal) {
+    return compaction_status;
+  }
+  if (compaction_status != CompactionServiceJobStatus::kSuccess) {
+    sub_compact->status =
+        Status::Incomplete("CompactionService failed to run compaction job");
+    return compaction_status;
+  }
+
+  CompactionServiceResult compaction_result;
+  s = compaction_result.DecodeFrom(compaction_result_binary);
+  if (s.ok() && compaction_result.output_level != compaction->output_level()) {
+    s = Status::Corruption("Remote compaction result for another output level");
+  }
+  if (!s.ok()) {
+    sub_compact->status = s;
+    return CompactionServiceJobStatus::kFailure;
+  }
+
+  // Move the output files into the DB and track them like the outputs of a
+  // local compaction.
+  const uint32_t path_id = compaction->output_path_id();
+  const auto* prefix_extractor =
+      compaction->mutable_cf_options()->prefix_extractor.get();
+  for (const auto& file : compaction_result.output_files) {
+    const uint64_t file_number = versions_->NewFileNumber();
+    const std::string src_file =
+        compaction_result.output_path + "/" + file.file_name;
+    const std::string tgt_file =
+        GetTableFileName(sub_compact, file_number, path_id);
+    IOStatus io_s =
+        fs_->RenameFile(src_file, tgt_file, IOOptions(), /*dbg=*/nullptr);
+    uint64_t file_size = 0;
+    if (io_s.ok()) {
+      io_s = fs_->GetFileSize(tgt_file, IOOptions(), &file_size,
+                              /*dbg=*/nullptr);
+    }
+    if (!io_s.ok()) {
+      sub_compact->status = io_s;
+      sub_compact->io_status = io_s;
+      return CompactionServiceJobStatus::kFailure;
+    }
+
+    FileMetaData meta;
+    meta.fd = FileDescriptor(file_number, path_id, file_size,
+                             file.smallest_seqno, file.largest_seqno);
+    meta.smallest.DecodeFrom(file.smallest_internal_key);
+    meta.largest.DecodeFrom(file.largest_internal_key);
+    meta.oldest_ancester_time = file.oldest_ancester_time;
+    meta.file_creation_time = file.file_creation_time;
+    meta.marked_for_compaction = file.marked_for_compaction;
+    sub_compact->outputs.emplace_back(std::move(meta),
+                                      cfd->internal_comparator(),
+                                      /*enable_order_check=*/false,
+                                      /*enable_hash=*/false,
+                                      file.paranoid_hash);
+    SubcompactionState::Output* output = sub_compact->current_output();
+    output->finished = true;
+    s = cfd->table_cache()->GetTableProperties(
+        file_options_, cfd->internal_comparator(), output->meta.fd,
+        &output->table_properties, prefix_extractor);
+    if (!s.ok()) {
+      sub_compact->status = s;
+      return CompactionServiceJobStatus::kFailure;
+    }
+  }
+  sub_compact->num_output_records = compaction_result.num_output_records;
+  sub_compact->total_bytes = compaction_result.total_bytes;
+  return CompactionServiceJobStatus::kSuccess;
+}
+#endif  // !ROCKSDB_LITE
+
+void CompactionJob::RunSubcompactionThread(SubcompactionState* sub_compact) {
+  ThreadStatus::ThreadType thread_type = ThreadStatus::LOW_PRIORITY;
+  if (thread_pri_ == Env::Priority::BOTTOM) {
+    thread_type = ThreadStatus::BOTTOM_PRIORITY;
+  } else if (thread_pri_ == Env::Priority::HIGH) {
+    thread_type = ThreadStatus::HIGH_PRIORITY;
+  }
+  ThreadStatusUtil::RegisterThread(env_, thread_type);
+  const auto* cfd = sub_compact->compaction->column_family_data();
+  ThreadStatusUtil::SetColumnFamily(cfd, cfd->ioptions()->env,
+                                    db_options_.enable_thread_tracking);
+  ThreadStatusUtil::SetThreadOperationProperty(ThreadStatus::COMPACTION_JOB_ID,
+                                               job_id_);
+  ThreadStatusUtil::SetThreadOperationProperty(
+      ThreadStatus::COMPACTION_INPUT_OUTPUT_LEVEL,
+      (static_cast<uint64_t>(sub_compact->compaction->start_level()) << 32) +
+          sub_compact->compaction->output_level());
+  ThreadStatusUtil::SetThreadOperationProperty(
+      ThreadStatus::COMPACTION_TOTAL_INPUT_BYTES, sub_compact->approx_size);
+  IOSTATS_RESET(bytes_written);
+  IOSTATS_RESET(bytes_read);
+  ThreadStatusUtil::SetThreadOperationProperty(
+      ThreadStatus::COMPACTION_BYTES_WRITTEN, 0);
+  ThreadStatusUtil::SetThreadOperationProperty(
+      ThreadStatus::COMPACTION_BYTES_READ, 0);
+  ThreadStatusUtil::SetThreadOperation(ThreadStatus::OP_COMPACTION);
+
+  ProcessKeyValueCompaction(sub_compact);
+
+  ThreadStatusUtil::ResetThreadStatus();
+  ThreadStatusUtil::UnregisterThread();
+}
+
 void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact);
   assert(sub_compact->compaction);
 
+#ifndef ROCKSDB_LITE
+  if (db_options_.compaction_service) {
+    CompactionServiceJobStatus comp_status =
+        ProcessKeyValueCompactionWithCompactionService(sub_compact);
+    if (comp_status != CompactionServiceJobStatus::kUseLocal) {
+      return;
+    }
+    // The service declined the job, run it locally.
+  }
+#endif  // !ROCKSDB_LITE
+
   uint64_t prev_cpu_micros = env_->NowCPUNanos() / 1000;
 
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
@@ -925,12 +1231,14 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   // (a) concurrent compactions,
   // (b) CompactionFilter::Decision::kRemoveAndSkipUntil.
   read_options.total_order_seek = true;
+  read_options.rate_limiter_priority = GetRateLimiterPriority();
 
   // Although the v2 aggregator is what the level iterator(s) know about,
   // the AddTombstones calls will be propagated down to the v1 aggregator.
   std::unique_ptr<InternalIterator> input(
       versions_->MakeInputIterator(read_options, sub_compact->compaction,
-                                   &range_del_agg, file_options_for_read_));
+                                   &range_del_agg, file_options_for_read_,
+                                   db_options_.enable_pipelined_compaction));
 
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_PROCESS_KV);
@@ -975,7 +1283,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
                 versions_, env_, fs_.get(),
                 sub_compact->compaction->immutable_cf_options(),
                 mutable_cf_options, &file_options_, job_id_, cfd->GetID(),
-                cfd->GetName(), Env::IOPriority::IO_LOW, write_hint_,
+                cfd->GetName(), GetRateLimiterPriority(), write_hint_,
                 &blob_file_paths, &sub_compact->blob_file_additions)
           : nullptr);
 
@@ -1123,6 +1431,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       c_iter_stats.num_input_deletion_records;
   sub_compact->compaction_job_stats.num_corrupt_keys =
       c_iter_stats.num_input_corrupt_records;
+  sub_compact->num_input_records = c_iter_stats.num_input_records;
   sub_compact->compaction_job_stats.num_single_del_fallthru =
       c_iter_stats.num_single_del_fallthru;
   sub_compact->compaction_job_stats.num_single_del_mismatch =
@@ -1497,9 +1806,8 @@ Status CompactionJob::FinishCompactionOutputFile(
     // If there is nothing to output, no necessary to generate a sst file.
     // This happens when the output level is bottom level, at the same time
     // the sub_compact output nothing.
-    std::string fname =
-        TableFileName(sub_compact->compaction->immutable_cf_options()->cf_paths,
-                      meta->fd.GetNumber(), meta->fd.GetPathId());
+    std::string fname = GetTableFileName(sub_compact, meta->fd.GetNumber(),
+                                         meta->fd.GetPathId());
     env_->DeleteFile(fname);
 
     // Also need to remove the file from outputs, or it will be added to the
@@ -1524,9 +1832,8 @@ Status CompactionJob::FinishCompactionOutputFile(
   FileDescriptor output_fd;
   uint64_t oldest_blob_file_number = kInvalidBlobFileNumber;
   if (meta != nullptr) {
-    fname =
-        TableFileName(sub_compact->compaction->immutable_cf_options()->cf_paths,
-                      meta->fd.GetNumber(), meta->fd.GetPathId());
+    fname = GetTableFileName(sub_compact, meta->fd.GetNumber(),
+                             meta->fd.GetPathId());
     output_fd = meta->fd;
     oldest_blob_file_number = meta->oldest_blob_file_number;
   } else {
@@ -1642,15 +1949,21 @@ void CompactionJob::RecordCompactionIOStats() {
   IOSTATS_RESET(bytes_written);
 }
 
+std::string CompactionJob::GetTableFileName(
+    const SubcompactionState* sub_compact, uint64_t file_number,
+    uint32_t path_id) {
+  return TableFileName(sub_compact->compaction->immutable_cf_options()->cf_paths,
+                       file_number, path_id);
+}
+
 Status CompactionJob::OpenCompactionOutputFile(
     SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
   assert(sub_compact->builder == nullptr);
   // no need to lock because VersionSet::next_file_number_ is atomic
   uint64_t file_number = versions_->NewFileNumber();
-  std::string fname =
-      TableFileName(sub_compact->compaction->immutable_cf_options()->cf_paths,
-                    file_number, sub_compact->compaction->output_path_id());
+  std::string fname = GetTableFileName(
+      sub_compact, file_number, sub_compact->compaction->output_path_id());
   // Fire events.
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
 #ifndef ROCKSDB_LITE
@@ -1722,7 +2035,7 @@ Status CompactionJob::OpenCompactionOutputFile(
         /*enable_hash=*/paranoid_file_checks_);
   }
 
-  writable_file->SetIOPriority(Env::IOPriority::IO_LOW);
+  writable_file->SetIOPriority(GetRateLimiterPriority());
   writable_file->SetWriteLifeTimeHint(write_hint_);
   writable_file->SetPreallocationBlockSize(static_cast<size_t>(
       sub_compact->compaction->OutputFilePreallocationSize()));
@@ -1905,4 +2218,301 @@ void CompactionJob::LogCompaction() {
   }
 }
 
+Env::IOPriority CompactionJob::GetRateLimiterPriority() const {
+  return compact_->compaction->start_level() == 0 ? Env::IO_MID : Env::IO_LOW;
+}
+
+
+#ifndef ROCKSDB_LITE
+namespace {
+// Bumped when the encoding of CompactionServiceInput or
+// CompactionServiceResult changes incompatibly.
+const uint32_t kCompactionServiceFormatVersion = 1;
+
+bool GetLengthPrefixedString(Slice* input, std::string* value) {
+  Slice str;
+  if (!GetLengthPrefixedSlice(input, &str)) {
+    return false;
+  }
+  value->assign(str.data(), str.size());
+  return true;
+}
+
+bool GetBool(Slice* input, bool* value) {
+  uint32_t v = 0;
+  if (!GetVarint32(input, &v) || v > 1) {
+    return false;
+  }
+  *value = v != 0;
+  return true;
+}
+
+bool GetOutputLevel(Slice* input, int* level) {
+  uint32_t v = 0;
+  if (!GetVarint32(input, &v)) {
+    return false;
+  }
+  *level = static_cast<int>(v);
+  return true;
+}
+
+Status CheckFormatVersion(Slice* input, const char* what) {
+  uint32_t format_version = 0;
+  if (!GetVarint32(input, &format_version)) {
+    return Status::Corruption(what, "missing format version");
+  }
+  if (format_version != kCompactionServiceFormatVersion) {
+    return Status::NotSupported(what, "unknown format version");
+  }
+  return Status::OK();
+}
+}  // namespace
+
+void CompactionServiceInput::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, kCompactionServiceFormatVersion);
+  PutLengthPrefixedSlice(dst, column_family_name);
+  PutLengthPrefixedSlice(dst, cf_options);
+  PutLengthPrefixedSlice(dst, db_options);
+  PutVarint64(dst, snapshots.size());
+  for (SequenceNumber snapshot : snapshots) {
+    PutVarint64(dst, snapshot);
+  }
+  PutVarint64(dst, input_files.size());
+  for (const auto& file : input_files) {
+    PutLengthPrefixedSlice(dst, file);
+  }
+  PutVarint32(dst, static_cast<uint32_t>(output_level));
+  PutVarint32(dst, has_begin ? 1 : 0);
+  PutLengthPrefixedSlice(dst, begin);
+  PutVarint32(dst, has_end ? 1 : 0);
+  PutLengthPrefixedSlice(dst, end);
+  PutVarint64(dst, approx_size);
+}
+
+Status CompactionServiceInput::DecodeFrom(const Slice& src) {
+  const char* kWhat = "CompactionServiceInput";
+  Slice input = src;
+  Status s = CheckFormatVersion(&input, kWhat);
+  if (!s.ok()) {
+    return s;
+  }
+  uint64_t num_snapshots = 0;
+  if (!GetLengthPrefixedString(&input, &column_family_name) ||
+      !GetLengthPrefixedString(&input, &cf_options) ||
+      !GetLengthPrefixedString(&input, &db_options) ||
+      !GetVarint64(&input, &num_snapshots)) {
+    return Status::Corruption(kWhat, "bad options");
+  }
+  snapshots.clear();
+  for (uint64_t i = 0; i < num_snapshots; i++) {
+    SequenceNumber snapshot = 0;
+    if (!GetVarint64(&input, &snapshot)) {
+      return Status::Corruption(kWhat, "bad snapshots");
+    }
+    snapshots.push_back(snapshot);
+  }
+  uint64_t num_input_files = 0;
+  if (!GetVarint64(&input, &num_input_files)) {
+    return Status::Corruption(kWhat, "bad input files");
+  }
+  input_files.clear();
+  for (uint64_t i = 0; i < num_input_files; i++) {
+    std::string file;
+    if (!GetLengthPrefixedString(&input, &file)) {
+      return Status::Corruption(kWhat, "bad input files");
+    }
+    input_files.push_back(std::move(file));
+  }
+  if (!GetOutputLevel(&input, &output_level) || !GetBool(&input, &has_begin) ||
+      !GetLengthPrefixedString(&input, &begin) || !GetBool(&input, &has_end) ||
+      !GetLengthPrefixedString(&input, &end) ||
+      !GetVarint64(&input, &approx_size)) {
+    return Status::Corruption(kWhat, "bad key range");
+  }
+  if (!input.empty()) {
+    return Status::Corruption(kWhat, "unexpected trailing data");
+  }
+  return Status::OK();
+}
+
+void CompactionServiceResult::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, kCompactionServiceFormatVersion);
+  PutVarint64(dst, output_files.size());
+  for (const auto& file : output_files) {
+    PutLengthPrefixedSlice(dst, file.file_name);
+    PutVarint64(dst, file.smallest_seqno);
+    PutVarint64(dst, file.largest_seqno);
+    PutLengthPrefixedSlice(dst, file.smallest_internal_key);
+    PutLengthPrefixedSlice(dst, file.largest_internal_key);
+    PutVarint64(dst, file.oldest_ancester_time);
+    PutVarint64(dst, file.file_creation_time);
+    PutFixed64(dst, file.paranoid_hash);
+    PutVarint32(dst, file.marked_for_compaction ? 1 : 0);
+  }
+  PutVarint32(dst, static_cast<uint32_t>(output_level));
+  PutLengthPrefixedSlice(dst, output_path);
+  PutVarint64(dst, num_output_records);
+  PutVarint64(dst, total_bytes);
+}
+
+Status CompactionServiceResult::DecodeFrom(const Slice& src) {
+  const char* kWhat = "CompactionServiceResult";
+  Slice input = src;
+  Status s = CheckFormatVersion(&input, kWhat);
+  if (!s.ok()) {
+    return s;
+  }
+  uint64_t num_output_files = 0;
+  if (!GetVarint64(&input, &num_output_files)) {
+    return Status::Corruption(kWhat, "bad output files");
+  }
+  output_files.clear();
+  for (uint64_t i = 0; i < num_output_files; i++) {
+    CompactionServiceOutputFile file;
+    if (!GetLengthPrefixedString(&input, &file.file_name) ||
+        !GetVarint64(&input, &file.smallest_seqno) ||
+        !GetVarint64(&input, &file.largest_seqno) ||
+        !GetLengthPrefixedString(&input, &file.smallest_internal_key) ||
+        !GetLengthPrefixedString(&input, &file.largest_internal_key) ||
+        !GetVarint64(&input, &file.oldest_ancester_time) ||
+        !GetVarint64(&input, &file.file_creation_time) ||
+        !GetFixed64(&input, &file.paranoid_hash) ||
+        !GetBool(&input, &file.marked_for_compaction)) {
+      return Status::Corruption(kWhat, "bad output files");
+    }
+    output_files.push_back(std::move(file));
+  }
+  if (!GetOutputLevel(&input, &output_level) ||
+      !GetLengthPrefixedString(&input, &output_path) ||
+      !GetVarint64(&input, &num_output_records) ||
+      !GetVarint64(&input, &total_bytes)) {
+    return Status::Corruption(kWhat, "bad statistics");
+  }
+  if (!input.empty()) {
+    return Status::Corruption(kWhat, "unexpected trailing data");
+  }
+  return Status::OK();
+}
+
+CompactionServiceCompactionJob::CompactionServiceCompactionJob(
+    int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+    const MutableDBOptions& mutable_db_options,
+    const FileOptions& file_options, VersionSet* versions,
+    const std::atomic<bool>* shutting_down, LogBuffer* log_buffer,
+    FSDirectory* output_directory, Statistics* stats,
+    InstrumentedMutex* db_mutex, ErrorHandler* db_error_handler,
+    std::vector<SequenceNumber> existing_snapshots,
+    std::shared_ptr<Cache> table_cache, EventLogger* event_logger,
+    const std::string& dbname, const std::shared_ptr<IOTracer>& io_tracer,
+    const std::string& db_id, const std::string& db_session_id,
+    const std::string& output_path,
+    const CompactionServiceInput& compaction_service_input,
+    CompactionServiceResult* compaction_service_result)
+    : CompactionJob(
+          job_id, compaction, db_options, mutable_db_options, file_options,
+          versions, shutting_down, /*preserve_deletes_seqnum=*/0, log_buffer,
+          /*db_directory=*/nullptr, output_directory,
+          /*blob_output_directory=*/nullptr, stats, db_mutex,
+          db_error_handler, std::move(existing_snapshots),
+          /*earliest_write_conflict_snapshot=*/kMaxSequenceNumber,
+          /*snapshot_checker=*/nullptr, std::move(table_cache), event_logger,
+          compaction->mutable_cf_options()->paranoid_file_checks,
+          compaction->mutable_cf_options()->report_bg_io_stats, dbname,
+          &job_stats_, Env::Priority::USER, io_tracer,
+          /*manual_compaction_paused=*/nullptr, db_id, db_session_id),
+      output_path_(output_path),
+      compaction_input_(compaction_service_input),
+      compaction_result_(compaction_service_result),
+      begin_(compaction_service_input.begin),
+      end_(compaction_service_input.end) {}
+
+void CompactionServiceCompactionJob::Prepare() {
+  AutoThreadOperationStageUpdater stage_updater(
+      ThreadStatus::STAGE_COMPACTION_PREPARE);
+  db_mutex_->AssertHeld();
+
+  Compaction* c = compact_->compaction;
+  assert(c->column_family_data() != nullptr);
+  bottommost_level_ = c->bottommost_level();
+
+  // The primary already split the compaction; run the one key range it asked
+  // for.
+  compact_->sub_compact_states.emplace_back(
+      c, compaction_input_.has_begin ? &begin_ : nullptr,
+      compaction_input_.has_end ? &end_ : nullptr,
+      compaction_input_.approx_size);
+}
+
+Status CompactionServiceCompactionJob::Run() {
+  AutoThreadOperationStageUpdater stage_updater(
+      ThreadStatus::STAGE_COMPACTION_RUN);
+  log_buffer_->FlushBufferToLog();
+  LogCompaction();
+
+  assert(compact_->sub_compact_states.size() == 1);
+  SubcompactionState* sub_compact = &compact_->sub_compact_states[0];
+
+  const uint64_t start_micros = env_->NowMicros();
+  ProcessKeyValueCompaction(sub_compact);
+  compaction_stats_.micros = env_->NowMicros() - start_micros;
+  compaction_stats_.cpu_micros = sub_compact->compaction_job_stats.cpu_micros;
+
+  RecordTimeToHistogram(stats_, COMPACTION_TIME, compaction_stats_.micros);
+  RecordTimeToHistogram(stats_, COMPACTION_CPU_TIME,
+                        compaction_stats_.cpu_micros);
+
+  Status status = sub_compact->status;
+  IOStatus io_s = sub_compact->io_status;
+  if (io_status_.ok()) {
+    io_status_ = io_s;
+  }
+  if (status.ok() && output_directory_) {
+    io_s = output_directory_->Fsync(IOOptions(), /*dbg=*/nullptr);
+  }
+  if (io_status_.ok()) {
+    io_status_ = io_s;
+  }
+  if (status.ok()) {
+    status = io_s;
+  }
+
+  AggregateStatistics();
+  UpdateCompactionStats();
+  RecordCompactionIOStats();
+  LogFlush(db_options_.info_log);
+  compact_->status = status;
+
+  compaction_result_->output_level = compact_->compaction->output_level();
+  compaction_result_->output_path = output_path_;
+  compaction_result_->output_files.clear();
+  for (const auto& output : sub_compact->outputs) {
+    const FileMetaData& meta = output.meta;
+    CompactionServiceOutputFile file;
+    file.file_name = MakeTableFileName(meta.fd.GetNumber());
+    file.smallest_seqno = meta.fd.smallest_seqno;
+    file.largest_seqno = meta.fd.largest_seqno;
+    file.smallest_internal_key = meta.smallest.Encode().ToString();
+    file.largest_internal_key = meta.largest.Encode().ToString();
+    file.oldest_ancester_time = meta.oldest_ancester_time;
+    file.file_creation_time = meta.file_creation_time;
+    file.paranoid_hash = output.validator.GetHash();
+    file.marked_for_compaction = meta.marked_for_compaction;
+    compaction_result_->output_files.push_back(std::move(file));
+  }
+  compaction_result_->num_output_records = sub_compact->num_output_records;
+  compaction_result_->total_bytes = sub_compact->total_bytes;
+  return status;
+}
+
+void CompactionServiceCompactionJob::CleanupCompaction() {
+  CompactionJob::CleanupCompaction();
+}
+
+std::string CompactionServiceCompactionJob::GetTableFileName(
+    const SubcompactionState* /*sub_compact*/, uint64_t file_number,
+    uint32_t /*path_id*/) {
+  return MakeTableFileName(output_path_, file_number);
+}
+#endif  // !ROCKSDB_LITE
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -64,6 +64,7 @@ class CompactionJob {
  public:
   CompactionJob(
       int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+      const MutableDBOptions& mutable_db_options,
       const FileOptions& file_options, VersionSet* versions,
       const std::atomic<bool>* shutting_down,
       const SequenceNumber preserve_deletes_seqnum, LogBuffer* log_buffer,
@@ -81,7 +82,7 @@ class CompactionJob {
       const std::string& db_id = "", const std::string& db_session_id = "",
       std::string full_history_ts_low = "");
 
-  ~CompactionJob();
+  virtual ~CompactionJob();
 
   // no copy/move
   CompactionJob(CompactionJob&& job) = delete;
@@ -104,8 +105,10 @@ class CompactionJob {
   // Return the IO status
   IOStatus io_status() const { return io_status_; }
 
- private:
+ protected:
   struct SubcompactionState;
+  // CompactionJob state
+  struct CompactionState;
 
   void AggregateStatistics();
 
@@ -115,6 +118,11 @@ class CompactionJob {
   // each consecutive pair of slices. Then it divides these ranges into
   // consecutive groups such that each group has a similar size.
   void GenSubcompactionBoundaries();
+  // Like GenSubcompactionBoundaries(), but for the sorted runs merged by
+  // universal compactions, which often consist of a few very large files.
+  // Splits the input at the key anchors of the input files, whose sizes are
+  // known, instead of at the file boundaries.
+  void GenSubcompactionBoundariesFromAnchors();
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -122,6 +130,17 @@ class CompactionJob {
   // Call compaction filter. Then iterate through input and compact the
   // kv-pairs
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
+  // Runs ProcessKeyValueCompaction() for one of the subcompactions after the
+  // first, on a thread that reports the progress of that subcompaction alone
+  // to GetThreadList().
+  void RunSubcompactionThread(SubcompactionState* sub_compact);
+#ifndef ROCKSDB_LITE
+  // Hands the subcompaction over to db_options_.compaction_service and
+  // installs its output files in the DB directory. Returns kUseLocal if the
+  // service declined the job, which must then be run by this process.
+  CompactionServiceJobStatus ProcessKeyValueCompactionWithCompactionService(
+      SubcompactionState* sub_compact);
+#endif  // !ROCKSDB_LITE
 
   Status FinishCompactionOutputFile(
       const Status& input_status, SubcompactionState* sub_compact,
@@ -143,10 +162,17 @@ class CompactionJob {
 
   void LogCompaction();
 
+  // Priority of the reads and writes of this compaction in the rate limiter:
+  // compactions out of L0 go ahead of the others, since L0 files are what
+  // stalls writes.
+  Env::IOPriority GetRateLimiterPriority() const;
+
+  // Path of the output table file `file_number` of `sub_compact`.
+  virtual std::string GetTableFileName(const SubcompactionState* sub_compact,
+                                       uint64_t file_number, uint32_t path_id);
+
   int job_id_;
 
-  // CompactionJob state
-  struct CompactionState;
   CompactionState* compact_;
   CompactionJobStats* compaction_job_stats_;
   InternalStats::CompactionStats compaction_stats_;
@@ -156,6 +182,9 @@ class CompactionJob {
   const std::string db_id_;
   const std::string db_session_id_;
   const ImmutableDBOptions& db_options_;
+  // Copied, as the options of the DB can change while the job runs
+  // without the DB mutex.
+  const MutableDBOptions mutable_db_options_copy_;
   const FileOptions file_options_;
 
   Env* env_;
@@ -197,6 +226,8 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
+  // Owns the keys of boundaries_ that are not keys of the input files' metadata
+  std::vector<std::string> boundary_keys_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
   Env::WriteLifeTimeHint write_hint_;
@@ -205,4 +236,108 @@ class CompactionJob {
   std::string full_history_ts_low_;
 };
 
+#ifndef ROCKSDB_LITE
+// The description of a compaction job that a DB hands over to its
+// CompactionService, from which DB::OpenAndCompact() runs it on the worker.
+struct CompactionServiceInput {
+  std::string column_family_name;
+  // The options of the column family and of the DB, as strings produced by
+  // GetStringFromColumnFamilyOptions() and GetStringFromDBOptions().
+  std::string cf_options;
+  std::string db_options;
+
+  std::vector<SequenceNumber> snapshots;
+
+  // SST file names of all the input files, e.g. "000012.sst".
+  std::vector<std::string> input_files;
+  int output_level = 0;
+
+  // The key range of the subcompaction, unbounded when !has_begin/!has_end.
+  bool has_begin = false;
+  std::string begin;
+  bool has_end = false;
+  std::string end;
+  uint64_t approx_size = 0;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+// The metadata of a table file written by a remote compaction.
+struct CompactionServiceOutputFile {
+  std::string file_name;
+  SequenceNumber smallest_seqno = 0;
+  SequenceNumber largest_seqno = 0;
+  // Encoded internal keys.
+  std::string smallest_internal_key;
+  std::string largest_internal_key;
+  uint64_t oldest_ancester_time = 0;
+  uint64_t file_creation_time = 0;
+  uint64_t paranoid_hash = 0;
+  bool marked_for_compaction = false;
+};
+
+// The result of a remote compaction, returned by DB::OpenAndCompact().
+struct CompactionServiceResult {
+  std::vector<CompactionServiceOutputFile> output_files;
+  int output_level = 0;
+  // The directory holding the output files.
+  std::string output_path;
+
+  uint64_t num_output_records = 0;
+  uint64_t total_bytes = 0;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+// The compaction job run on the worker by DB::OpenAndCompact(). It compacts
+// the single key range described by CompactionServiceInput, writes the
+// output files to output_path and describes them in a
+// CompactionServiceResult, without installing them.
+class CompactionServiceCompactionJob : private CompactionJob {
+ public:
+  CompactionServiceCompactionJob(
+      int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+      const MutableDBOptions& mutable_db_options,
+      const FileOptions& file_options, VersionSet* versions,
+      const std::atomic<bool>* shutting_down, LogBuffer* log_buffer,
+      FSDirectory* output_directory, Statistics* stats,
+      InstrumentedMutex* db_mutex, ErrorHandler* db_error_handler,
+      std::vector<SequenceNumber> existing_snapshots,
+      std::shared_ptr<Cache> table_cache, EventLogger* event_logger,
+      const std::string& dbname, const std::shared_ptr<IOTracer>& io_tracer,
+      const std::string& db_id, const std::string& db_session_id,
+      const std::string& output_path,
+      const CompactionServiceInput& compaction_service_input,
+      CompactionServiceResult* compaction_service_result);
+
+  // REQUIRED: mutex held
+  void Prepare();
+
+  // REQUIRED: mutex not held
+  // Runs the compaction and fills in the CompactionServiceResult.
+  Status Run();
+
+  // REQUIRED: mutex held
+  // Releases the state of the job. The output files are left in place.
+  void CleanupCompaction();
+
+  IOStatus io_status() const { return CompactionJob::io_status(); }
+
+ protected:
+  std::string GetTableFileName(const SubcompactionState* sub_compact,
+                               uint64_t file_number, uint32_t path_id) override;
+
+ private:
+  CompactionJobStats job_stats_;
+  std::string output_path_;
+  const CompactionServiceInput& compaction_input_;
+  CompactionServiceResult* compaction_result_;
+  // The bounds of the key range to compact.
+  Slice begin_;
+  Slice end_;
+};
+#endif  // !ROCKSDB_LITE
+
 }  // namespace ROCKSDB_NAMESPACE
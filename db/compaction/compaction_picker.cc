@@ -57,6 +57,27 @@ bool FindIntraL0Compaction(const std::vector<FileMetaData*>& level_files,
       break;
     }
   }
+  // Files written by one partitioned flush have interleaved seqnos, so
+  // compacting only some of them would leave an output that is not ordered
+  // against the others. Returns whether the files before `pos` and the ones
+  // from `pos` on share a partitioned flush.
+  auto splits_flush = [&level_files](size_t pos) {
+    for (size_t i = 0; i < pos; i++) {
+      const uint64_t flush_id = level_files[i]->partitioned_flush_id;
+      if (flush_id == 0) {
+        continue;
+      }
+      for (size_t j = pos; j < level_files.size(); j++) {
+        if (level_files[j]->partitioned_flush_id == flush_id) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+  while (start > 0 && start < level_files.size() && splits_flush(start)) {
+    start++;
+  }
   if (start >= level_files.size()) {
     return false;
   }
@@ -80,6 +101,9 @@ bool FindIntraL0Compaction(const std::vector<FileMetaData*>& level_files,
     }
     compact_bytes_per_del_file = new_compact_bytes_per_del_file;
   }
+  while (limit > start && limit < level_files.size() && splits_flush(limit)) {
+    limit--;
+  }
 
   if ((limit - start) >= min_files_to_compact &&
       compact_bytes_per_del_file < max_compact_bytes_per_del_file) {
@@ -1852,6 +1852,38 @@ TEST_F(CompactionPickerTest, IntraL0ForEarliestSeqno) {
   ASSERT_EQ(0, compaction->output_level());
 }
 
+TEST_F(CompactionPickerTest, IntraL0KeepsPartitionedFlushTogether) {
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+  mutable_cf_options_.max_compaction_bytes = 1000000u;
+  NewVersionStorage(6, kCompactionStyleLevel);
+
+  // max_compaction_bytes would take the 5 newest L0 files, and so one of the
+  // two files of a partitioned flush. One of them holds a single seqno, like
+  // an ingested file would.
+  Add(1, 1U, "100", "400", 200000U, 0, 110, 111);
+  Add(0, 2U, "351", "400", 200000U, 0, 108, 109);
+  Add(0, 3U, "301", "350", 200000U, 0, 106, 107);
+  Add(0, 4U, "251", "300", 200000U, 0, 104, 105);
+  Add(0, 5U, "201", "250", 200000U, 0, 102, 103);
+  Add(0, 6U, "151", "200", 200000U, 0, 101, 101);
+  Add(0, 7U, "100", "150", 200000U, 0, 100, 101);
+  file_map_[6U].first->partitioned_flush_id = 6;
+  file_map_[7U].first->partitioned_flush_id = 6;
+  vstorage_->LevelFiles(1)[0]->being_compacted = true;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(4U, compaction->num_input_files(0));
+  for (size_t i = 0; i < compaction->num_input_files(0); i++) {
+    ASSERT_EQ(0U, compaction->input(0, i)->partitioned_flush_id);
+  }
+  ASSERT_EQ(0, compaction->output_level());
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(CompactionPickerTest, UniversalMarkedCompactionFullOverlap) {
   const uint64_t kFileSize = 100000;
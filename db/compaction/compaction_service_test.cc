@@ -0,0 +1,276 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include <mutex>
+
+#include "db/compaction/compaction_job.h"
+#include "db/db_test_util.h"
+#include "file/file_util.h"
+#include "port/stack_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Runs the compactions through DB::OpenAndCompact() in the process of the
+// DB, the way an external worker sharing its file system would.
+class MyTestCompactionService : public CompactionService {
+ public:
+  MyTestCompactionService(const std::string& db_path,
+                          const std::string& output_path, Options& options)
+      : db_path_(db_path), output_path_(output_path), options_(options) {}
+
+  const char* Name() const override { return "MyTestCompactionService"; }
+
+  CompactionServiceJobStatus Start(const std::string& compaction_service_input,
+                                   uint64_t job_id) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (start_status_ != CompactionServiceJobStatus::kSuccess) {
+      return start_status_;
+    }
+    jobs_.emplace(job_id, compaction_service_input);
+    return CompactionServiceJobStatus::kSuccess;
+  }
+
+  CompactionServiceJobStatus WaitForComplete(
+      uint64_t job_id, std::string* compaction_service_result) override {
+    std::string compaction_input;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = jobs_.find(job_id);
+      if (it == jobs_.end()) {
+        return CompactionServiceJobStatus::kFailure;
+      }
+      compaction_input = std::move(it->second);
+      jobs_.erase(it);
+    }
+
+    CompactionServiceOptionsOverride options_override;
+    options_override.env = options_.env;
+    options_override.comparator = options_.comparator;
+    options_override.table_factory = options_.table_factory;
+
+    Status s = DB::OpenAndCompact(db_path_,
+                                  output_path_ + "/" + ToString(job_id),
+                                  compaction_input, compaction_service_result,
+                                  options_override);
+    if (!s.ok()) {
+      return CompactionServiceJobStatus::kFailure;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    compaction_num_++;
+    last_input_ = std::move(compaction_input);
+    return CompactionServiceJobStatus::kSuccess;
+  }
+
+  int GetCompactionNum() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return compaction_num_;
+  }
+
+  std::string GetLastInput() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_input_;
+  }
+
+  void SetStartStatus(CompactionServiceJobStatus status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    start_status_ = status;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<uint64_t, std::string> jobs_;
+  int compaction_num_ = 0;
+  std::string last_input_;
+  CompactionServiceJobStatus start_status_ =
+      CompactionServiceJobStatus::kSuccess;
+  const std::string db_path_;
+  const std::string output_path_;
+  Options options_;
+};
+
+class CompactionServiceTest : public DBTestBase {
+ public:
+  CompactionServiceTest()
+      : DBTestBase("/compaction_service_test", /*env_do_fsync=*/true) {
+    output_path_ = test::PerThreadDBPath(env_, "compaction_service_output");
+    // OpenAndCompact() only creates the directory of the job, not its parent.
+    EXPECT_OK(env_->CreateDirIfMissing(output_path_));
+  }
+
+  ~CompactionServiceTest() override {
+    Close();
+    EXPECT_OK(DestroyDir(env_, output_path_));
+  }
+
+ protected:
+  Options ServiceOptions() {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.compaction_service = std::make_shared<MyTestCompactionService>(
+        dbname_, output_path_, options);
+    return options;
+  }
+
+  MyTestCompactionService* GetService(const Options& options) {
+    return static_cast_with_check<MyTestCompactionService>(
+        options.compaction_service.get());
+  }
+
+  // Writes kNumFiles overlapping L0 files, overwriting the values of the
+  // previous round.
+  void GenerateFiles(int round) {
+    for (int i = 0; i < kNumFiles; i++) {
+      for (int j = 0; j < kKeysPerFile; j++) {
+        int key_id = i + j * kNumFiles;
+        ASSERT_OK(Put(Key(key_id), Value(round, key_id)));
+      }
+      ASSERT_OK(Flush());
+    }
+  }
+
+  void VerifyData(int round) {
+    for (int i = 0; i < kNumFiles * kKeysPerFile; i++) {
+      ASSERT_EQ(Value(round, i), Get(Key(i)));
+    }
+  }
+
+  static std::string Value(int round, int key_id) {
+    return "value" + ToString(round) + "_" + ToString(key_id);
+  }
+
+  static constexpr int kNumFiles = 10;
+  static constexpr int kKeysPerFile = 20;
+
+  std::string output_path_;
+};
+
+constexpr int CompactionServiceTest::kNumFiles;
+constexpr int CompactionServiceTest::kKeysPerFile;
+
+TEST_F(CompactionServiceTest, BasicCompactions) {
+  Options options = ServiceOptions();
+  options.paranoid_file_checks = true;
+  DestroyAndReopen(options);
+  MyTestCompactionService* service = GetService(options);
+
+  GenerateFiles(0);
+  const Snapshot* snapshot = db_->GetSnapshot();
+  GenerateFiles(1);
+  // The worker is sent the current DB options, not the ones it was opened
+  // with.
+  ASSERT_OK(dbfull()->SetDBOptions({{"bytes_per_sync", "65536"}}));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  ASSERT_GE(service->GetCompactionNum(), 1);
+
+  VerifyData(1);
+  ReadOptions read_options;
+  read_options.snapshot = snapshot;
+  std::string value;
+  ASSERT_OK(db_->Get(read_options, Key(0), &value));
+  ASSERT_EQ(Value(0, 0), value);
+  db_->ReleaseSnapshot(snapshot);
+
+  CompactionServiceInput input;
+  ASSERT_OK(input.DecodeFrom(service->GetLastInput()));
+  ASSERT_EQ(kDefaultColumnFamilyName, input.column_family_name);
+  ASSERT_EQ(static_cast<size_t>(2 * kNumFiles), input.input_files.size());
+  ASSERT_EQ(1, input.output_level);
+  ASSERT_EQ(1, input.snapshots.size());
+  ConfigOptions config_options;
+  config_options.ignore_unknown_options = true;
+  DBOptions db_options;
+  ASSERT_OK(GetDBOptionsFromString(config_options, DBOptions(),
+                                   input.db_options, &db_options));
+  ASSERT_EQ(65536U, db_options.bytes_per_sync);
+
+  // The output files were moved into the DB and are installed there.
+  Reopen(options);
+  VerifyData(1);
+}
+
+TEST_F(CompactionServiceTest, Subcompactions) {
+  Options options = ServiceOptions();
+  options.max_subcompactions = 4;
+  options.target_file_size_base = 1 << 10;
+  DestroyAndReopen(options);
+  MyTestCompactionService* service = GetService(options);
+
+  GenerateFiles(0);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  const int num_compactions = service->GetCompactionNum();
+  GenerateFiles(1);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(service->GetCompactionNum(), num_compactions + 1);
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  VerifyData(1);
+}
+
+TEST_F(CompactionServiceTest, UseLocal) {
+  Options options = ServiceOptions();
+  DestroyAndReopen(options);
+  MyTestCompactionService* service = GetService(options);
+  service->SetStartStatus(CompactionServiceJobStatus::kUseLocal);
+
+  GenerateFiles(0);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  ASSERT_EQ(0, service->GetCompactionNum());
+  VerifyData(0);
+}
+
+TEST_F(CompactionServiceTest, Failure) {
+  Options options = ServiceOptions();
+  DestroyAndReopen(options);
+  MyTestCompactionService* service = GetService(options);
+  service->SetStartStatus(CompactionServiceJobStatus::kFailure);
+
+  GenerateFiles(0);
+  Status s = db_->CompactRange(CompactRangeOptions(), nullptr, nullptr);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(0, service->GetCompactionNum());
+  VerifyData(0);
+}
+
+TEST_F(CompactionServiceTest, InvalidInput) {
+  std::string result;
+  CompactionServiceOptionsOverride options_override;
+  Status s = DB::OpenAndCompact(dbname_, output_path_, "garbage", &result,
+                                options_override);
+  ASSERT_TRUE(s.IsCorruption() || s.IsNotSupported());
+
+  CompactionServiceInput input;
+  input.column_family_name = "cf";
+  input.snapshots = {1, 2};
+  input.input_files = {"000012.sst"};
+  input.output_level = 3;
+  input.has_end = true;
+  input.end = "key";
+  std::string encoded;
+  input.EncodeTo(&encoded);
+  CompactionServiceInput decoded;
+  ASSERT_OK(decoded.DecodeFrom(encoded));
+  ASSERT_EQ(input.column_family_name, decoded.column_family_name);
+  ASSERT_EQ(input.snapshots, decoded.snapshots);
+  ASSERT_EQ(input.input_files, decoded.input_files);
+  ASSERT_EQ(input.output_level, decoded.output_level);
+  ASSERT_FALSE(decoded.has_begin);
+  ASSERT_TRUE(decoded.has_end);
+  ASSERT_EQ(input.end, decoded.end);
+  ASSERT_TRUE(decoded.DecodeFrom(Slice(encoded.data(), encoded.size() - 1))
+                  .IsCorruption());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+#endif  // ROCKSDB_LITE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,241 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/pipelined_input_iterator.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "port/port.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+class PipelinedInputIterator : public InternalIterator {
+ public:
+  PipelinedInputIterator(InternalIterator* input, size_t batch_size,
+                         size_t max_batches)
+      : input_(input),
+        batch_size_(batch_size),
+        max_batches_(max_batches > 0 ? max_batches : 1),
+        cv_(&mu_),
+        stop_(false),
+        pos_(0),
+        direct_(false) {}
+
+  ~PipelinedInputIterator() override {
+    StopReader();
+    status_.PermitUncheckedError();
+  }
+
+  bool Valid() const override {
+    if (direct_) {
+      return input_->Valid();
+    }
+    return batch_ != nullptr && pos_ < batch_->entries.size();
+  }
+
+  void SeekToFirst() override { StartReader(nullptr); }
+
+  void Seek(const Slice& target) override { StartReader(&target); }
+
+  void SeekToLast() override {
+    StopReader();
+    direct_ = true;
+    input_->SeekToLast();
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    StopReader();
+    direct_ = true;
+    input_->SeekForPrev(target);
+  }
+
+  void Next() override {
+    assert(Valid());
+    if (direct_) {
+      input_->Next();
+      return;
+    }
+    if (++pos_ == batch_->entries.size() && !batch_->last) {
+      NextBatch();
+    }
+  }
+
+  void Prev() override {
+    assert(Valid());
+    if (!direct_) {
+      // The reader has moved the input past the current entry.
+      std::string current = key().ToString();
+      StopReader();
+      direct_ = true;
+      input_->Seek(current);
+      if (!input_->Valid()) {
+        return;
+      }
+    }
+    input_->Prev();
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    if (direct_) {
+      return input_->key();
+    }
+    const Entry& entry = batch_->entries[pos_];
+    return Slice(batch_->data.data() + entry.offset, entry.key_size);
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    if (direct_) {
+      return input_->value();
+    }
+    const Entry& entry = batch_->entries[pos_];
+    return Slice(batch_->data.data() + entry.offset + entry.key_size,
+                 entry.value_size);
+  }
+
+  Status status() const override {
+    if (direct_) {
+      return input_->status();
+    }
+    // The error of the input follows its last entry
+    return Valid() ? Status::OK() : status_;
+  }
+
+ private:
+  struct Entry {
+    size_t offset;
+    size_t key_size;
+    size_t value_size;
+  };
+
+  // Consecutive entries of the input, with their keys and values copied
+  // back to back into data.
+  struct Batch {
+    std::string data;
+    std::vector<Entry> entries;
+    // Whether the input ends after these entries
+    bool last = false;
+    // The status of the input, if last
+    Status status;
+  };
+
+  void StartReader(const Slice* target) {
+    StopReader();
+    direct_ = false;
+    status_ = Status::OK();
+    stop_ = false;
+    const bool seek_to_first = target == nullptr;
+    std::string seek_target = seek_to_first ? "" : target->ToString();
+    reader_ = port::Thread([this, seek_to_first, seek_target]() {
+      Read(seek_to_first, seek_target);
+    });
+    NextBatch();
+  }
+
+  void StopReader() {
+    if (reader_.joinable()) {
+      {
+        MutexLock l(&mu_);
+        stop_ = true;
+        cv_.SignalAll();
+      }
+      reader_.join();
+    }
+    ready_.clear();
+    batch_.reset();
+    pos_ = 0;
+  }
+
+  // Runs on the reader thread until the input ends or StopReader() is called.
+  void Read(bool seek_to_first, const std::string& seek_target) {
+    if (seek_to_first) {
+      input_->SeekToFirst();
+    } else {
+      input_->Seek(seek_target);
+    }
+    bool last = false;
+    while (!last) {
+      std::unique_ptr<Batch> batch(new Batch());
+      batch->data.reserve(batch_size_);
+      while (input_->Valid() && batch->data.size() < batch_size_) {
+        const Slice k = input_->key();
+        const Slice v = input_->value();
+        batch->entries.push_back({batch->data.size(), k.size(), v.size()});
+        batch->data.append(k.data(), k.size());
+        batch->data.append(v.data(), v.size());
+        input_->Next();
+      }
+      if (!input_->Valid()) {
+        batch->last = true;
+        batch->status = input_->status();
+      }
+      last = batch->last;
+
+      MutexLock l(&mu_);
+      while (!stop_ && ready_.size() >= max_batches_) {
+        cv_.Wait();
+      }
+      if (stop_) {
+        batch->status.PermitUncheckedError();
+        return;
+      }
+      ready_.push_back(std::move(batch));
+      cv_.SignalAll();
+    }
+  }
+
+  // Moves on to the next batch the reader has filled, waiting for it if
+  // necessary.
+  void NextBatch() {
+    // Free the consumed entries before waiting
+    batch_.reset();
+    {
+      MutexLock l(&mu_);
+      while (ready_.empty()) {
+        cv_.Wait();
+      }
+      batch_ = std::move(ready_.front());
+      ready_.pop_front();
+      cv_.SignalAll();
+    }
+    pos_ = 0;
+    if (batch_->last) {
+      status_ = batch_->status;
+    }
+  }
+
+  std::unique_ptr<InternalIterator> input_;
+  const size_t batch_size_;
+  const size_t max_batches_;
+
+  // Protect ready_ and stop_
+  port::Mutex mu_;
+  port::CondVar cv_;
+  std::deque<std::unique_ptr<Batch>> ready_;
+  bool stop_;
+  port::Thread reader_;
+
+  // State of the consumer
+  std::unique_ptr<Batch> batch_;
+  size_t pos_;
+  Status status_;
+  // Whether the reader is stopped and the input is used directly
+  bool direct_;
+};
+}  // namespace
+
+InternalIterator* NewPipelinedInputIterator(InternalIterator* input,
+                                            size_t batch_size,
+                                            size_t max_batches) {
+  return new PipelinedInputIterator(input, batch_size, max_batches);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
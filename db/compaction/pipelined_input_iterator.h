@@ -0,0 +1,28 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Returns an iterator over the entries of `input` that reads them ahead on a
+// thread of its own, so that reading and decompressing the blocks of a
+// compaction input overlaps with the merge of the compaction thread.
+//
+// After a seek to the first entry or to a target, the thread moves `input`
+// forward and copies its entries into batches of about `batch_size` bytes,
+// keeping up to `max_batches` of them ready for the consumer. SeekToLast(),
+// SeekForPrev() and Prev() stop the thread and use `input` directly. The
+// keys and values of the returned iterator are not pinned.
+//
+// Takes ownership of `input`, which must not be used by any other thread.
+// The returned iterator must be used by a single thread.
+extern InternalIterator* NewPipelinedInputIterator(
+    InternalIterator* input, size_t batch_size = 64 * 1024,
+    size_t max_batches = 4);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,158 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/pipelined_input_iterator.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Fails with `status` once it reaches the end of its entries
+class FailingVectorIterator : public test::VectorIterator {
+ public:
+  FailingVectorIterator(const std::vector<std::string>& keys,
+                        const std::vector<std::string>& values,
+                        const Status& status)
+      : test::VectorIterator(keys, values), status_(status) {}
+
+  Status status() const override { return Valid() ? Status::OK() : status_; }
+
+ private:
+  Status status_;
+};
+}  // namespace
+
+class PipelinedInputIteratorTest : public testing::Test {
+ public:
+  PipelinedInputIteratorTest() {
+    for (int i = 0; i < 1000; i++) {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "key%06d", i);
+      keys_.push_back(buf);
+      values_.push_back(std::string(i % 50, 'v'));
+    }
+  }
+
+  // Small batches, so that the reader fills and waits many times
+  InternalIterator* NewIterator() {
+    return NewPipelinedInputIterator(
+        new test::VectorIterator(keys_, values_), 256 /* batch_size */,
+        2 /* max_batches */);
+  }
+
+  void VerifyForward(InternalIterator* iter, size_t start) {
+    for (size_t i = start; i < keys_.size(); i++) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys_[i], iter->key().ToString());
+      ASSERT_EQ(values_[i], iter->value().ToString());
+      iter->Next();
+    }
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+  }
+
+  std::vector<std::string> keys_;
+  std::vector<std::string> values_;
+};
+
+TEST_F(PipelinedInputIteratorTest, Empty) {
+  std::unique_ptr<InternalIterator> iter(
+      NewPipelinedInputIterator(new test::VectorIterator({}, {})));
+  ASSERT_FALSE(iter->Valid());
+  iter->SeekToFirst();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+  iter->Seek("a");
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
+TEST_F(PipelinedInputIteratorTest, Scan) {
+  std::unique_ptr<InternalIterator> iter(NewIterator());
+  iter->SeekToFirst();
+  VerifyForward(iter.get(), 0);
+}
+
+TEST_F(PipelinedInputIteratorTest, Seek) {
+  std::unique_ptr<InternalIterator> iter(NewIterator());
+  for (size_t start : {500, 0, 999, 250}) {
+    iter->Seek(keys_[start]);
+    VerifyForward(iter.get(), start);
+  }
+  // Seek before the reader has consumed the input
+  iter->SeekToFirst();
+  iter->Seek(keys_[700]);
+  VerifyForward(iter.get(), 700);
+  iter->Seek("zzz");
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
+TEST_F(PipelinedInputIteratorTest, Backward) {
+  std::unique_ptr<InternalIterator> iter(NewIterator());
+  iter->Seek(keys_[600]);
+  for (size_t i = 600; i < 650; i++) {
+    ASSERT_TRUE(iter->Valid());
+    iter->Next();
+  }
+  // Prev() continues from the current entry, not from where the reader got
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(keys_[649], iter->key().ToString());
+
+  iter->SeekToLast();
+  for (size_t i = keys_.size(); i > 0; i--) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys_[i - 1], iter->key().ToString());
+    ASSERT_EQ(values_[i - 1], iter->value().ToString());
+    iter->Prev();
+  }
+  ASSERT_FALSE(iter->Valid());
+
+  iter->SeekForPrev(keys_[10]);
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(keys_[10], iter->key().ToString());
+
+  // Forward seeks start the reader again
+  iter->Seek(keys_[20]);
+  VerifyForward(iter.get(), 20);
+}
+
+TEST_F(PipelinedInputIteratorTest, Error) {
+  std::unique_ptr<InternalIterator> iter(
+      NewPipelinedInputIterator(new FailingVectorIterator(
+                                    keys_, values_, Status::IOError("failed")),
+                                256 /* batch_size */, 2 /* max_batches */));
+  iter->SeekToFirst();
+  for (size_t i = 0; i < keys_.size(); i++) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_OK(iter->status());
+    iter->Next();
+  }
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_TRUE(iter->status().IsIOError());
+}
+
+TEST_F(PipelinedInputIteratorTest, DestroyWhileReading) {
+  // The reader is waiting for room in the queue
+  for (int i = 0; i < 10; i++) {
+    std::unique_ptr<InternalIterator> iter(NewIterator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1576,6 +1576,83 @@ TEST_F(DBBasicTest, MultiGetBatchedMultiLevel) {
   }
 }
 
+TEST_F(DBBasicTest, MultiGetAsyncIOMultiFileLevel) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  // Small files, so that a batch spans many files of a level
+  options.target_file_size_base = 4 * 1024;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> l2_values;
+  for (int i = 0; i < 512; ++i) {
+    l2_values.push_back(rnd.RandomString(100));
+    ASSERT_OK(Put(Key(i), l2_values.back()));
+  }
+  ASSERT_OK(Flush());
+  // Rewrite the files on the way down, as moving them would keep a single
+  // file per level.
+  for (int level = 0; level < 2; ++level) {
+    ASSERT_OK(dbfull()->TEST_CompactRange(level, nullptr, nullptr, nullptr,
+                                          true /* disallow_trivial_move */));
+  }
+  // Overwrite every other key with values large enough for L1 to span
+  // several files too.
+  std::map<int, std::string> l1_values;
+  for (int i = 0; i < 512; i += 2) {
+    l1_values[i] = rnd.RandomString(100);
+    ASSERT_OK(Put(Key(i), l1_values[i]));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr, nullptr,
+                                        true /* disallow_trivial_move */));
+  ASSERT_GT(NumTableFilesAtLevel(1), 4);
+  ASSERT_GT(NumTableFilesAtLevel(2), 4);
+
+  size_t max_parallel_lookups = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "Version::MultiGet:ParallelLookups", [&](void* arg) {
+        max_parallel_lookups =
+            std::max(max_parallel_lookups, *static_cast<size_t*>(arg));
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<std::string> key_strs;
+  for (int i = 0; i < 512; i += 17) {
+    key_strs.push_back(Key(i));
+  }
+  key_strs.push_back("not_found");
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  for (bool async_io : {false, true}) {
+    ReadOptions ro;
+    ro.async_io = async_io;
+    std::vector<PinnableSlice> values(keys.size());
+    std::vector<Status> statuses(keys.size());
+    db_->MultiGet(ro, dbfull()->DefaultColumnFamily(), keys.size(),
+                  keys.data(), values.data(), statuses.data());
+    for (size_t j = 0; j + 1 < keys.size(); ++j) {
+      int key = static_cast<int>(j * 17);
+      ASSERT_OK(statuses[j]);
+      if (key % 2 == 0) {
+        ASSERT_EQ(l1_values[key], values[j].ToString());
+      } else {
+        ASSERT_EQ(l2_values[key], values[j].ToString());
+      }
+    }
+    ASSERT_TRUE(statuses.back().IsNotFound());
+    if (!async_io) {
+      ASSERT_EQ(0, max_parallel_lookups);
+    }
+  }
+  ASSERT_GT(max_parallel_lookups, 1);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBBasicTest, MultiGetBatchedMultiLevelMerge) {
   Options options = CurrentOptions();
   options.disable_auto_compactions = true;
@@ -2723,6 +2800,7 @@ class DBBasicTestMultiGet : public DBTestBase {
 
     const char* Name() const override { return "MyBlockCache"; }
 
+    using Cache::Insert;
     Status Insert(const Slice& key, void* value, size_t charge,
                   void (*deleter)(const Slice& key, void* value),
                   Handle** handle = nullptr,
@@ -2731,6 +2809,7 @@ class DBBasicTestMultiGet : public DBTestBase {
       return target_->Insert(key, value, charge, deleter, handle, priority);
     }
 
+    using Cache::Lookup;
     Handle* Lookup(const Slice& key, Statistics* stats = nullptr) override {
       num_lookups_++;
       Handle* handle = target_->Lookup(key, stats);
@@ -11,6 +11,7 @@
 #include "cache/lru_cache.h"
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
+#include "rocksdb/secondary_cache.h"
 #include "util/compression.h"
 #include "util/random.h"
 
@@ -456,6 +457,17 @@ class MockCache : public LRUCache {
     }
     return LRUCache::Insert(key, value, charge, deleter, handle, priority);
   }
+
+  Status Insert(const Slice& key, void* value,
+                const Cache::CacheItemHelper* helper, size_t charge,
+                Handle** handle, Priority priority) override {
+    if (priority == Priority::LOW) {
+      low_pri_insert_count++;
+    } else {
+      high_pri_insert_count++;
+    }
+    return LRUCache::Insert(key, value, helper, charge, handle, priority);
+  }
 };
 
 uint32_t MockCache::high_pri_insert_count = 0;
@@ -533,6 +545,7 @@ class LookupLiarCache : public CacheWrapper {
   explicit LookupLiarCache(std::shared_ptr<Cache> target)
       : CacheWrapper(std::move(target)) {}
 
+  using Cache::Lookup;
   Handle* Lookup(const Slice& key, Statistics* stats) override {
     if (nth_lookup_not_found_ == 1) {
       nth_lookup_not_found_ = 0;
@@ -653,6 +666,53 @@ TEST_F(DBBlockCacheTest, AddRedundantStats) {
   EXPECT_GE(iterations_tested, 1);
 }
 
+TEST_F(DBBlockCacheTest, SecondaryCache) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  // Room for only a few data blocks in the primary cache
+  LRUCacheOptions cache_opts(4 * 1024 /*capacity*/, 0 /*num_shard_bits*/,
+                             false /*strict_capacity_limit*/,
+                             0.0 /*high_pri_pool_ratio*/);
+  cache_opts.secondary_cache =
+      NewLRUSecondaryCache(LRUSecondaryCacheOptions(1 << 20, 0));
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(cache_opts);
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 100;
+  Random rnd(301);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    keys.push_back(Key(i));
+    values.push_back(rnd.RandomString(static_cast<int>(kValueSize)));
+    ASSERT_OK(Put(keys.back(), values.back()));
+  }
+  ASSERT_OK(Flush());
+
+  // The first pass reads every data block from the file
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(keys[i]));
+  }
+  ASSERT_EQ(0, TestGetTickerCount(options, SECONDARY_CACHE_HITS));
+
+  // The blocks that no longer fit in the block cache were demoted, and are
+  // promoted back on the second pass
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(keys[i]));
+  }
+  uint64_t hits = TestGetTickerCount(options, SECONDARY_CACHE_HITS);
+  ASSERT_GT(hits, 0);
+
+  // MultiGet looks up the secondary cache without blocking, for all the
+  // blocks of the batch at once
+  ASSERT_EQ(values, MultiGet(keys, nullptr /*snapshot*/));
+  ASSERT_GT(TestGetTickerCount(options, SECONDARY_CACHE_HITS), hits);
+}
+
 TEST_F(DBBlockCacheTest, ParanoidFileChecks) {
   Options options = CurrentOptions();
   options.create_if_missing = true;
@@ -2116,6 +2116,77 @@ TEST_F(DBBloomFilterTest, DynamicBloomFilterOptions) {
   }
 }
 
+TEST_F(DBBloomFilterTest, RangeFilter) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  table_options.range_filter_levels = 8;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  auto make_key = [](uint32_t n) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%08u", n);
+    return std::string(buf);
+  };
+  // Overlapping files of sparse keys
+  Random rnd(301);
+  std::set<std::string> keys;
+  for (int file = 0; file < 4; file++) {
+    for (int i = 0; i < 500; i++) {
+      std::string key = make_key(rnd.Uniform(10000000));
+      ASSERT_OK(Put(key, "v"));
+      keys.insert(key);
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("4", FilesPerLevel());
+
+  auto verify_short_scans = [&]() {
+    for (int i = 0; i < 200; i++) {
+      const uint32_t start = rnd.Uniform(10000000);
+      const std::string start_key = make_key(start);
+      const std::string end_key = make_key(start + 1 + rnd.Uniform(1000));
+      Slice upper_bound(end_key);
+      ReadOptions read_options;
+      read_options.iterate_upper_bound = &upper_bound;
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+      auto expected = keys.lower_bound(start_key);
+      for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
+        ASSERT_TRUE(expected != keys.end());
+        ASSERT_EQ(*expected, iter->key().ToString());
+        ++expected;
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_TRUE(expected == keys.end() || *expected >= end_key);
+    }
+  };
+
+  verify_short_scans();
+  // Each seek checks the range filter of every file
+  ASSERT_EQ(TestGetAndResetTickerCount(options, RANGE_FILTER_CHECKED),
+            4 * 200);
+  // Most short ranges hold none of the keys of a file
+  ASSERT_GT(TestGetAndResetTickerCount(options, RANGE_FILTER_USEFUL), 700);
+
+  // Unbounded scans do not check the range filters
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  iter->Seek(make_key(5000000));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(*keys.lower_bound(make_key(5000000)), iter->key().ToString());
+  ASSERT_EQ(TestGetTickerCount(options, RANGE_FILTER_CHECKED), 0);
+  iter.reset();
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  verify_short_scans();
+  ASSERT_EQ(TestGetTickerCount(options, RANGE_FILTER_CHECKED), 200);
+  ASSERT_GT(TestGetTickerCount(options, RANGE_FILTER_USEFUL), 150);
+}
+
 #endif  // ROCKSDB_LITE
 
 }  // namespace ROCKSDB_NAMESPACE
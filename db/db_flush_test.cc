@@ -179,6 +179,61 @@ TEST_F(DBFlushTest, FlushInLowPriThreadPool) {
   ASSERT_EQ(1, num_compactions);
 }
 
+#ifndef ROCKSDB_LITE
+TEST_F(DBFlushTest, PartitionedFlush) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 1 << 20;
+  options.max_flush_partitions = 4;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  // Fill most of the memtable, so that the flush is split in a few files.
+  Random rnd(301);
+  const int kNumKeys = 3000;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    values.push_back(rnd.RandomString(200));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+
+  auto verify = [&]() {
+    std::vector<LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    ASSERT_GT(files.size(), 1);
+    ASSERT_LE(files.size(), 4);
+    std::sort(files.begin(), files.end(),
+              [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+                return a.smallestkey < b.smallestkey;
+              });
+    for (size_t i = 0; i < files.size(); i++) {
+      ASSERT_EQ(0, files[i].level);
+      if (i > 0) {
+        ASSERT_LT(files[i - 1].largestkey, files[i].smallestkey);
+      }
+    }
+    ASSERT_EQ(Key(0), files.front().smallestkey);
+    ASSERT_EQ(Key(kNumKeys - 1), files.back().largestkey);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  };
+  verify();
+  Reopen(options);
+  verify();
+  const int num_files = NumTableFilesAtLevel(0);
+
+  // Range deletions keep the flush in a single file.
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(10)));
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(num_files + 1, NumTableFilesAtLevel(0));
+}
+#endif  // ROCKSDB_LITE
+
 TEST_F(DBFlushTest, ManualFlushWithMinWriteBufferNumberToMerge) {
   Options options = CurrentOptions();
   options.write_buffer_size = 100;
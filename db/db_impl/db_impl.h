@@ -597,6 +597,9 @@ class DBImpl : public DB {
 
   Status TraceIteratorSeek(const uint32_t& cf_id, const Slice& key);
   Status TraceIteratorSeekForPrev(const uint32_t& cf_id, const Slice& key);
+  // Traces a MultiGet of keys[i] in column_families[i], if tracing.
+  void TraceMultiGet(size_t num_keys, ColumnFamilyHandle* const* column_families,
+                     const Slice* keys);
 #endif  // ROCKSDB_LITE
 
   // Similar to GetSnapshot(), but also lets the db know that this snapshot
@@ -1254,6 +1257,7 @@ class DBImpl : public DB {
 #endif
   friend struct SuperVersion;
   friend class CompactedDBImpl;
+  friend class DBImplSecondary;
   friend class DBTest_ConcurrentFlushWAL_Test;
   friend class DBTest_MixedSlowdownOptionsStop_Test;
   friend class DBCompactionTest_CompactBottomLevelFilesWithDeletions_Test;
@@ -1582,13 +1586,22 @@ class DBImpl : public DB {
   Status PreprocessWrite(const WriteOptions& write_options, bool* need_log_sync,
                          WriteContext* write_context);
 
+  // Returns the batch whose header is the header of the WAL record of
+  // write_group, and sets *wal_parts to the slices the record is made of.
+  // When several batches go to the WAL, the returned batch is tmp_batch,
+  // which only holds the header, and the records of the batches are
+  // referenced in place instead of being copied into it.
   WriteBatch* MergeBatch(const WriteThread::WriteGroup& write_group,
-                         WriteBatch* tmp_batch, size_t* write_with_wal,
+                         WriteBatch* tmp_batch, std::vector<Slice>* wal_parts,
+                         size_t* write_with_wal,
                          WriteBatch** to_be_cached_state);
 
   IOStatus WriteToWAL(const WriteBatch& merged_batch, log::Writer* log_writer,
                       uint64_t* log_used, uint64_t* log_size);
 
+  IOStatus WriteToWAL(const SliceParts& log_entry, log::Writer* log_writer,
+                      uint64_t* log_used, uint64_t* log_size);
+
   IOStatus WriteToWAL(const WriteThread::WriteGroup& write_group,
                       log::Writer* log_writer, uint64_t* log_used,
                       bool need_log_sync, bool need_log_dir_sync,
@@ -1967,6 +1980,7 @@ class DBImpl : public DB {
 
   WriteThread write_thread_;
   WriteBatch tmp_batch_;
+  std::vector<Slice> tmp_wal_parts_;
   // The write thread when the writers have no memtable write. This will be used
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
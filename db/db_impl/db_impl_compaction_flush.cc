@@ -289,6 +289,12 @@ Status DBImpl::FlushMemTableToOutputFile(
       std::string file_path = MakeTableFileName(
           cfd->ioptions()->cf_paths[0].path, file_meta.fd.GetNumber());
       sfm->OnAddFile(file_path);
+      for (const FileMetaData& meta : flush_job.GetPartitionFileMetas()) {
+        if (meta.fd.GetFileSize() > 0) {
+          sfm->OnAddFile(MakeTableFileName(cfd->ioptions()->cf_paths[0].path,
+                                           meta.fd.GetNumber()));
+        }
+      }
       if (sfm->IsMaxAllowedSpaceReached()) {
         Status new_bg_error =
             Status::SpaceLimit("Max allowed space was reached");
@@ -641,6 +647,12 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         std::string file_path = MakeTableFileName(
             cfds[i]->ioptions()->cf_paths[0].path, file_meta[i].fd.GetNumber());
         sfm->OnAddFile(file_path);
+        for (const FileMetaData& meta : jobs[i]->GetPartitionFileMetas()) {
+          if (meta.fd.GetFileSize() > 0) {
+            sfm->OnAddFile(MakeTableFileName(
+                cfds[i]->ioptions()->cf_paths[0].path, meta.fd.GetNumber()));
+          }
+        }
         if (sfm->IsMaxAllowedSpaceReached() &&
             error_handler_.GetBGError().ok()) {
           Status new_bg_error =
@@ -1151,7 +1163,7 @@ Status DBImpl::CompactFilesImpl(
   CompactionJobStats compaction_job_stats;
   CompactionJob compaction_job(
       job_context->job_id, c.get(), immutable_db_options_,
-      file_options_for_compaction_, versions_.get(), &shutting_down_,
+      mutable_db_options_, file_options_for_compaction_, versions_.get(), &shutting_down_,
       preserve_deletes_seqnum_.load(), log_buffer, directories_.GetDbDir(),
       GetDataDir(c->column_family_data(), c->output_path_id()),
       GetDataDir(c->column_family_data(), 0), stats_, &mutex_, &error_handler_,
@@ -2959,7 +2971,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
         job_context->job_id, c.get(), immutable_db_options_,
-        file_options_for_compaction_, versions_.get(), &shutting_down_,
+        mutable_db_options_, file_options_for_compaction_, versions_.get(), &shutting_down_,
         preserve_deletes_seqnum_.load(), log_buffer, directories_.GetDbDir(),
         GetDataDir(c->column_family_data(), c->output_path_id()),
         GetDataDir(c->column_family_data(), 0), stats_, &mutex_,
@@ -7,6 +7,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
@@ -18,9 +21,11 @@
 #include "file/writable_file_writer.h"
 #include "monitoring/persistent_stats_history.h"
 #include "options/options_helper.h"
+#include "port/port.h"
 #include "rocksdb/table.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/sync_point.h"
+#include "util/compression.h"
 #include "util/rate_limiter.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -89,6 +94,12 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     result.recycle_log_file_num = false;
   }
 
+  if (result.wal_compression != kNoCompression) {
+    // A recycled WAL file may still hold a stale kSetCompressionType record
+    // of its previous user.
+    result.recycle_log_file_num = 0;
+  }
+
   if (result.recycle_log_file_num &&
       (result.wal_recovery_mode ==
            WALRecoveryMode::kTolerateCorruptedTailRecords ||
@@ -260,6 +271,12 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "atomic_flush is currently incompatible with best-efforts recovery");
   }
 
+  if (!StreamingCompressionTypeSupported(db_options.wal_compression)) {
+    return Status::NotSupported(
+        "wal_compression is not supported for the compression type: " +
+        CompressionTypeToString(db_options.wal_compression));
+  }
+
   return Status::OK();
 }
 
@@ -766,6 +783,108 @@ Status DBImpl::InitPersistStatsColumnFamily() {
   return s;
 }
 
+namespace {
+// Reads the records of a WAL file on a background thread, so that reading,
+// checksum verification and decompression of the following records overlap
+// with the memtable insertion of the current one. The records are handed
+// over in the order they are read, through a queue bounded by
+// kMaxQueuedBytes. The background thread stops at the first record read
+// after the reader reported an error to *read_status, like the serial replay
+// loop does.
+class PipelinedWalReader {
+ public:
+  static constexpr size_t kMaxQueuedBytes = 16 << 20;
+
+  PipelinedWalReader(log::Reader* reader, WALRecoveryMode recovery_mode,
+                     const Status* read_status)
+      : reader_(reader),
+        recovery_mode_(recovery_mode),
+        read_status_(read_status),
+        queued_bytes_(0),
+        stop_(false),
+        done_(false),
+        drained_(false),
+        thread_(&PipelinedWalReader::BackgroundRead, this) {}
+
+  ~PipelinedWalReader() { Stop(); }
+
+  // Same contract as log::Reader::ReadRecord(): on success, *record points
+  // to the next record, which is kept in *scratch.
+  bool ReadRecord(Slice* record, std::string* scratch) {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this] { return !queue_.empty() || done_; });
+    if (queue_.empty()) {
+      drained_ = true;
+      return false;
+    }
+    queued_bytes_ -= queue_.front().size();
+    *scratch = std::move(queue_.front());
+    queue_.pop_front();
+    cv_.notify_all();
+    *record = Slice(*scratch);
+    return true;
+  }
+
+  // Whether all the records of the file have been returned. When false after
+  // Stop(), the replay was cut short and the errors that the background
+  // thread may have reported past that point must be ignored.
+  bool drained() const { return drained_; }
+
+  // Stops the background thread and waits for it. Once this returns,
+  // *read_status can be accessed by the caller.
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+ private:
+  void BackgroundRead() {
+    std::string scratch;
+    Slice record;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock,
+                 [this] { return stop_ || queued_bytes_ < kMaxQueuedBytes; });
+        if (stop_) {
+          break;
+        }
+      }
+      if (!reader_->ReadRecord(&record, &scratch, recovery_mode_) ||
+          !read_status_->ok()) {
+        break;
+      }
+      std::lock_guard<std::mutex> lock(mu_);
+      queue_.emplace_back(record.data(), record.size());
+      queued_bytes_ += record.size();
+      cv_.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    done_ = true;
+    cv_.notify_all();
+  }
+
+  log::Reader* const reader_;
+  const WALRecoveryMode recovery_mode_;
+  const Status* const read_status_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<std::string> queue_;
+  size_t queued_bytes_;
+  bool stop_;
+  bool done_;
+  bool drained_;
+  port::Thread thread_;
+};
+}  // namespace
+
 // REQUIRES: wal_numbers are sorted in ascending order
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                                SequenceNumber* next_sequence, bool read_only,
@@ -891,12 +1010,23 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     } else {
       reporter.status = &status;
     }
+    // With pipelined recovery, the errors found while reading the file are
+    // collected in read_status by the background thread, and merged into
+    // status once all the records read before them have been replayed.
+    Status read_status;
+    LogReporter read_reporter = reporter;
+    if (reporter.status != nullptr) {
+      read_reporter.status = &read_status;
+    }
+    const bool pipelined =
+        immutable_db_options_.enable_pipelined_wal_recovery;
     // We intentially make log::Reader do checksumming even if
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
     // large sequence numbers).
     log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+                       pipelined ? &read_reporter : &reporter,
+                       true /*checksum*/, wal_number);
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
@@ -906,9 +1036,16 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
 
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
+    std::unique_ptr<PipelinedWalReader> pipelined_reader;
+    if (pipelined) {
+      pipelined_reader.reset(new PipelinedWalReader(
+          &reader, immutable_db_options_.wal_recovery_mode, &read_status));
+    }
     while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode) &&
+           (pipelined_reader
+                ? pipelined_reader->ReadRecord(&record, &scratch)
+                : reader.ReadRecord(&record, &scratch,
+                                    immutable_db_options_.wal_recovery_mode)) &&
            status.ok()) {
       if (record.size() < WriteBatchInternal::kHeader) {
         reporter.Corruption(record.size(),
@@ -1061,6 +1198,14 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
     }
 
+    if (pipelined_reader) {
+      pipelined_reader->Stop();
+      if (pipelined_reader->drained() && status.ok()) {
+        status = read_status;
+      }
+      pipelined_reader.reset();
+    }
+
     if (!status.ok()) {
       if (status.IsNotSupported()) {
         // We should not treat NotSupported as corruption. It is rather a clear
@@ -1485,7 +1630,13 @@ IOStatus DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
         nullptr /* stats */, listeners));
     *new_log = new log::Writer(std::move(file_writer), log_file_num,
                                immutable_db_options_.recycle_log_file_num > 0,
-                               immutable_db_options_.manual_wal_flush);
+                               immutable_db_options_.manual_wal_flush,
+                               immutable_db_options_.wal_compression);
+    io_s = (*new_log)->AddCompressionTypeRecord();
+    if (!io_s.ok()) {
+      delete *new_log;
+      *new_log = nullptr;
+    }
   }
   return io_s;
 }
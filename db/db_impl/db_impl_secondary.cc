@@ -8,9 +8,11 @@
 #include <cinttypes>
 
 #include "db/arena_wrapped_db_iter.h"
+#include "db/compaction/compaction_job.h"
 #include "db/merge_context.h"
 #include "logging/auto_roll_logger.h"
 #include "monitoring/perf_context_imp.h"
+#include "rocksdb/convenience.h"
 #include "util/cast_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -574,6 +576,166 @@ Status DBImplSecondary::TryCatchUpWithPrimary() {
   return s;
 }
 
+Status DBImplSecondary::CompactWithoutInstallation(
+    ColumnFamilyHandle* cfh, const std::string& output_path,
+    const CompactionServiceInput& input, CompactionServiceResult* result) {
+  InstrumentedMutexLock l(&mutex_);
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(cfh)->cfd();
+  if (!cfd) {
+    return Status::InvalidArgument("Cannot find column family" +
+                                   cfh->GetName());
+  }
+  const MutableCFOptions* mutable_cf_options = cfd->GetLatestMutableCFOptions();
+  if (mutable_cf_options->enable_blob_files) {
+    return Status::NotSupported(
+        "Remote compactions cannot write blob files yet");
+  }
+
+  std::unordered_set<uint64_t> input_set;
+  for (const auto& file_name : input.input_files) {
+    input_set.insert(TableFileNameToNumber(file_name));
+  }
+
+  Version* version = cfd->current();
+  VersionStorageInfo* vstorage = version->storage_info();
+
+  // Form the compaction the way CompactFiles() does, with the output file
+  // size the primary would have used for that level.
+  CompactionOptions comp_options;
+  comp_options.compression = kDisableCompressionOption;
+  comp_options.output_file_size_limit = MaxFileSizeForLevel(
+      *mutable_cf_options, input.output_level,
+      cfd->ioptions()->compaction_style, vstorage->base_level(),
+      cfd->ioptions()->level_compaction_dynamic_level_bytes);
+
+  std::vector<CompactionInputFiles> input_files;
+  Status s = cfd->compaction_picker()->GetCompactionInputsFromFileNumbers(
+      &input_files, &input_set, vstorage, comp_options);
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::unique_ptr<Compaction> c(cfd->compaction_picker()->CompactFiles(
+      comp_options, input_files, input.output_level, vstorage,
+      *mutable_cf_options, mutable_db_options_, /*output_path_id=*/0));
+  assert(c != nullptr);
+  c->SetInputVersion(version);
+
+  std::unique_ptr<FSDirectory> output_dir;
+  s = CreateAndNewDirectory(fs_.get(), output_path, &output_dir);
+  if (!s.ok()) {
+    c->ReleaseCompactionFiles(s);
+    return s;
+  }
+
+  LogBuffer log_buffer(InfoLogLevel::INFO_LEVEL,
+                       immutable_db_options_.info_log.get());
+  const int job_id = next_job_id_.fetch_add(1);
+  CompactionServiceCompactionJob compaction_job(
+      job_id, c.get(), immutable_db_options_, mutable_db_options_,
+      file_options_for_compaction_, versions_.get(), &shutting_down_, &log_buffer, output_dir.get(), stats_,
+      &mutex_, &error_handler_, input.snapshots, table_cache_, &event_logger_,
+      dbname_, io_tracer_, db_id_, db_session_id_, output_path, input, result);
+  compaction_job.Prepare();
+
+  mutex_.Unlock();
+  s = compaction_job.Run();
+  mutex_.Lock();
+
+  compaction_job.io_status().PermitUncheckedError();
+  compaction_job.CleanupCompaction();
+  c->ReleaseCompactionFiles(s);
+  log_buffer.FlushBufferToLog();
+  return s;
+}
+
+Status DB::OpenAndCompact(
+    const std::string& name, const std::string& output_directory,
+    const std::string& input, std::string* output,
+    const CompactionServiceOptionsOverride& override_options) {
+  CompactionServiceInput compaction_input;
+  Status s = compaction_input.DecodeFrom(input);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // The objects that cannot be serialized come from override_options, so the
+  // options they were serialized as are ignored.
+  ConfigOptions config_options;
+  config_options.ignore_unknown_options = true;
+  DBOptions db_options;
+  s = GetDBOptionsFromString(config_options, DBOptions(),
+                             compaction_input.db_options, &db_options);
+  if (!s.ok()) {
+    return s;
+  }
+  db_options.env = override_options.env;
+  db_options.file_checksum_gen_factory =
+      override_options.file_checksum_gen_factory;
+  db_options.max_open_files = -1;
+
+  ColumnFamilyOptions cf_options;
+  cf_options.comparator = override_options.comparator;
+  s = GetColumnFamilyOptionsFromString(config_options, cf_options,
+                                       compaction_input.cf_options,
+                                       &cf_options);
+  if (!s.ok()) {
+    return s;
+  }
+  cf_options.comparator = override_options.comparator;
+  if (override_options.merge_operator) {
+    cf_options.merge_operator = override_options.merge_operator;
+  }
+  if (override_options.compaction_filter) {
+    cf_options.compaction_filter = override_options.compaction_filter;
+  }
+  if (override_options.compaction_filter_factory) {
+    cf_options.compaction_filter_factory =
+        override_options.compaction_filter_factory;
+  }
+  if (override_options.prefix_extractor) {
+    cf_options.prefix_extractor = override_options.prefix_extractor;
+  }
+  if (override_options.table_factory) {
+    cf_options.table_factory = override_options.table_factory;
+  }
+  if (override_options.sst_partitioner_factory) {
+    cf_options.sst_partitioner_factory =
+        override_options.sst_partitioner_factory;
+  }
+
+  // A secondary instance has to open the default column family.
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.emplace_back(compaction_input.column_family_name,
+                               cf_options);
+  if (compaction_input.column_family_name != kDefaultColumnFamilyName) {
+    column_families.emplace_back(kDefaultColumnFamilyName, cf_options);
+  }
+
+  DB* db = nullptr;
+  std::vector<ColumnFamilyHandle*> handles;
+  s = DB::OpenAsSecondary(db_options, name, output_directory, column_families,
+                          &handles, &db);
+  if (!s.ok()) {
+    return s;
+  }
+
+  CompactionServiceResult compaction_result;
+  auto db_secondary = static_cast_with_check<DBImplSecondary>(db);
+  assert(handles.size() > 0);
+  s = db_secondary->CompactWithoutInstallation(
+      handles[0], output_directory, compaction_input, &compaction_result);
+  if (s.ok()) {
+    compaction_result.EncodeTo(output);
+  }
+
+  for (auto& handle : handles) {
+    delete handle;
+  }
+  delete db;
+  return s;
+}
+
 Status DB::OpenAsSecondary(const Options& options, const std::string& dbname,
                            const std::string& secondary_path, DB** dbptr) {
   *dbptr = nullptr;
@@ -678,6 +840,13 @@ Status DB::OpenAsSecondary(
     std::vector<ColumnFamilyHandle*>* /*handles*/, DB** /*dbptr*/) {
   return Status::NotSupported("Not supported in ROCKSDB_LITE.");
 }
+
+Status DB::OpenAndCompact(
+    const std::string& /*name*/, const std::string& /*output_directory*/,
+    const std::string& /*input*/, std::string* /*output*/,
+    const CompactionServiceOptionsOverride& /*override_options*/) {
+  return Status::NotSupported("Not supported in ROCKSDB_LITE.");
+}
 #endif  // !ROCKSDB_LITE
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -222,6 +222,15 @@ class DBImplSecondary : public DBImpl {
   // not flag the missing file as inconsistency.
   Status CheckConsistency() override;
 
+  // Runs the compaction described by `input` on the current version of the
+  // column family, writing the output files to `output_path` instead of
+  // installing them, and describes them in `result`. Used by
+  // DB::OpenAndCompact() on behalf of a CompactionService.
+  Status CompactWithoutInstallation(ColumnFamilyHandle* cfh,
+                                    const std::string& output_path,
+                                    const CompactionServiceInput& input,
+                                    CompactionServiceResult* result);
+
  protected:
   // ColumnFamilyCollector is a write batch handler which does nothing
   // except recording unique column family IDs
@@ -163,6 +163,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   StopWatch write_sw(env_, immutable_db_options_.statistics.get(), DB_WRITE);
 
   write_thread_.JoinBatchGroup(&w);
+  if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_CALLER) {
+    write_thread_.SetMemWritersEachStride(&w);
+  }
   Status status;
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
     // we are a non-leader in a parallel group
@@ -585,6 +588,9 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     }
   }
 
+  if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_CALLER) {
+    write_thread_.SetMemWritersEachStride(&w);
+  }
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
     assert(w.ShouldWriteToMemtable());
     ColumnFamilyMemTablesImpl column_family_memtables(
@@ -982,12 +988,16 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
 }
 
 WriteBatch* DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
-                               WriteBatch* tmp_batch, size_t* write_with_wal,
+                               WriteBatch* tmp_batch,
+                               std::vector<Slice>* wal_parts,
+                               size_t* write_with_wal,
                                WriteBatch** to_be_cached_state) {
   assert(write_with_wal != nullptr);
   assert(tmp_batch != nullptr);
+  assert(wal_parts != nullptr);
   assert(*to_be_cached_state == nullptr);
   WriteBatch* merged_batch = nullptr;
+  wal_parts->clear();
   *write_with_wal = 0;
   auto* leader = write_group.leader;
   assert(!leader->disable_wal);  // Same holds for all in the batch group
@@ -997,21 +1007,26 @@ WriteBatch* DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
     // contains one batch, that batch should be written to the WAL,
     // and the batch is not wanting to be truncated
     merged_batch = leader->batch;
+    wal_parts->push_back(WriteBatchInternal::Contents(merged_batch));
     if (WriteBatchInternal::IsLatestPersistentState(merged_batch)) {
       *to_be_cached_state = merged_batch;
     }
     *write_with_wal = 1;
   } else {
-    // WAL needs all of the batches flattened into a single batch.
-    // We could avoid copying here with an iov-like AddRecord
-    // interface
+    // WAL needs all of the batches flattened into a single record. Instead of
+    // copying them into tmp_batch, the record is gathered by log::Writer from
+    // the header of tmp_batch followed by the records of each batch.
     merged_batch = tmp_batch;
+    assert(WriteBatchInternal::ByteSize(merged_batch) ==
+           WriteBatchInternal::kHeader);
+    wal_parts->push_back(WriteBatchInternal::Contents(merged_batch));
+    uint32_t count = 0;
     for (auto writer : write_group) {
       if (!writer->CallbackFailed()) {
-        Status s = WriteBatchInternal::Append(merged_batch, writer->batch,
-                                              /*WAL_only*/ true);
-        // Always returns Status::OK.
-        assert(s.ok());
+        uint32_t batch_count = 0;
+        wal_parts->push_back(
+            WriteBatchInternal::RecordsForWAL(writer->batch, &batch_count));
+        count += batch_count;
         if (WriteBatchInternal::IsLatestPersistentState(writer->batch)) {
           // We only need to cache the last of such write batch
           *to_be_cached_state = writer->batch;
@@ -1019,18 +1034,28 @@ WriteBatch* DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
         (*write_with_wal)++;
       }
     }
+    WriteBatchInternal::SetCount(merged_batch, count);
   }
   return merged_batch;
 }
 
+IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
+                            log::Writer* log_writer, uint64_t* log_used,
+                            uint64_t* log_size) {
+  Slice log_entry = WriteBatchInternal::Contents(&merged_batch);
+  return WriteToWAL(SliceParts(&log_entry, 1), log_writer, log_used, log_size);
+}
+
 // When two_write_queues_ is disabled, this function is called from the only
 // write thread. Otherwise this must be called holding log_write_mutex_.
-IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
+IOStatus DBImpl::WriteToWAL(const SliceParts& log_entry,
                             log::Writer* log_writer, uint64_t* log_used,
                             uint64_t* log_size) {
   assert(log_size != nullptr);
-  Slice log_entry = WriteBatchInternal::Contents(&merged_batch);
-  *log_size = log_entry.size();
+  *log_size = 0;
+  for (int i = 0; i < log_entry.num_parts; i++) {
+    *log_size += log_entry.parts[i].size();
+  }
   // When two_write_queues_ WriteToWAL has to be protected from concurretn calls
   // from the two queues anyway and log_write_mutex_ is already held. Otherwise
   // if manual_wal_flush_ is enabled we need to protect log_writer->AddRecord
@@ -1050,10 +1075,10 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (log_used != nullptr) {
     *log_used = logfile_number_;
   }
-  total_log_size_ += log_entry.size();
+  total_log_size_ += *log_size;
   // TODO(myabandeh): it might be unsafe to access alive_log_files_.back() here
   // since alive_log_files_ might be modified concurrently
-  alive_log_files_.back().AddSize(log_entry.size());
+  alive_log_files_.back().AddSize(*log_size);
   log_empty_ = false;
   return io_s;
 }
@@ -1067,8 +1092,9 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   // Same holds for all in the batch group
   size_t write_with_wal = 0;
   WriteBatch* to_be_cached_state = nullptr;
-  WriteBatch* merged_batch = MergeBatch(write_group, &tmp_batch_,
-                                        &write_with_wal, &to_be_cached_state);
+  WriteBatch* merged_batch =
+      MergeBatch(write_group, &tmp_batch_, &tmp_wal_parts_, &write_with_wal,
+                 &to_be_cached_state);
   if (merged_batch == write_group.leader->batch) {
     write_group.leader->log_used = logfile_number_;
   } else if (write_with_wal > 1) {
@@ -1080,7 +1106,9 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   WriteBatchInternal::SetSequence(merged_batch, sequence);
 
   uint64_t log_size;
-  io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size);
+  io_s = WriteToWAL(SliceParts(tmp_wal_parts_.data(),
+                               static_cast<int>(tmp_wal_parts_.size())),
+                    log_writer, log_used, &log_size);
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
     cached_recoverable_state_empty_ = false;
@@ -1113,6 +1141,7 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   if (merged_batch == &tmp_batch_) {
     tmp_batch_.Clear();
   }
+  tmp_wal_parts_.clear();
   if (io_s.ok()) {
     auto stats = default_cf_internal_stats_;
     if (need_log_sync) {
@@ -1135,10 +1164,11 @@ IOStatus DBImpl::ConcurrentWriteToWAL(
   assert(!write_group.leader->disable_wal);
   // Same holds for all in the batch group
   WriteBatch tmp_batch;
+  std::vector<Slice> wal_parts;
   size_t write_with_wal = 0;
   WriteBatch* to_be_cached_state = nullptr;
-  WriteBatch* merged_batch =
-      MergeBatch(write_group, &tmp_batch, &write_with_wal, &to_be_cached_state);
+  WriteBatch* merged_batch = MergeBatch(write_group, &tmp_batch, &wal_parts,
+                                        &write_with_wal, &to_be_cached_state);
 
   // We need to lock log_write_mutex_ since logs_ and alive_log_files might be
   // pushed back concurrently
@@ -1156,7 +1186,9 @@ IOStatus DBImpl::ConcurrentWriteToWAL(
 
   log::Writer* log_writer = logs_.back().writer;
   uint64_t log_size;
-  io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size);
+  io_s = WriteToWAL(
+      SliceParts(wal_parts.data(), static_cast<int>(wal_parts.size())),
+      log_writer, log_used, &log_size);
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
     cached_recoverable_state_empty_ = false;
@@ -274,6 +274,80 @@ TEST_F(DBMemTableTest, ConcurrentMergeWrite) {
   delete mem;
 }
 
+#ifndef ROCKSDB_LITE
+TEST_F(DBMemTableTest, SortedRunMemTable) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.allow_concurrent_memtable_write = true;
+  // Small runs, so that the keys end up in many runs of every buffer
+  options.memtable_factory.reset(new SortedRunRepFactory(16));
+  DestroyAndReopen(options);
+
+  const int kNumThreads = 4;
+  const int kNumKeys = 1000;
+  auto key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06d", i);
+    return std::string(buf);
+  };
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < kNumKeys; i += kNumThreads) {
+        ASSERT_OK(Put(key(i), "v1_" + key(i)));
+      }
+      // Overwrite some of the keys, so that a key has several entries.
+      for (int i = t; i < kNumKeys; i += 3 * kNumThreads) {
+        ASSERT_OK(Put(key(i), "v2_" + key(i)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ((i % (3 * kNumThreads) < kNumThreads ? "v2_" : "v1_") + key(i),
+                Get(key(i)));
+    }
+    ASSERT_EQ("NOT_FOUND", Get("key"));
+    ASSERT_EQ("NOT_FOUND", Get("zzz"));
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(key(count), iter->key().ToString());
+      count++;
+    }
+    ASSERT_EQ(kNumKeys, count);
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      count--;
+      ASSERT_EQ(key(count), iter->key().ToString());
+    }
+    ASSERT_EQ(0, count);
+    iter->Seek(key(kNumKeys / 2));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(kNumKeys / 2), iter->key().ToString());
+    iter->SeekForPrev(key(kNumKeys / 2) + "a");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(kNumKeys / 2), iter->key().ToString());
+  };
+  // From the mutable memtable
+  verify();
+  // From the immutable memtable, whose runs are merged once
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  verify();
+  // And from the table file the merged runs were flushed to. Nothing
+  // scheduled the flush of the switched memtable, so the flush must not wait
+  // for it to clear the write stall.
+  ASSERT_OK(dbfull()->TEST_FlushMemTable(true /* wait */,
+                                         true /* allow_write_stall */));
+  ASSERT_EQ("1", FilesPerLevel());
+  verify();
+}
+#endif  // ROCKSDB_LITE
+
 TEST_F(DBMemTableTest, InsertWithHint) {
   Options options;
   options.allow_concurrent_memtable_write = false;
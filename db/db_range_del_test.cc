@@ -354,6 +354,64 @@ TEST_F(DBRangeDelTest, CompactionRemovesCoveredKeys) {
   }
 }
 
+TEST_F(DBRangeDelTest, PipelinedCompactionRemovesCoveredKeys) {
+  const int kNumKeys = 200;
+  Options opts = CurrentOptions();
+  opts.disable_auto_compactions = true;
+  opts.enable_pipelined_compaction = true;
+  opts.num_levels = 3;
+  DestroyAndReopen(opts);
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), "v1"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+
+  // A L1 file with a range tombstone, whose range deletions are added up
+  // front when the level is read by a pipelined iterator
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(50), Key(100)));
+  for (int i = 150; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), "v2"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+
+  // Two L0 files, merged into one pipelined iterator
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(120), Key(130)));
+  ASSERT_OK(Put(Key(kNumKeys - 1), "v3"));
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "v3"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ("2,1,1", FilesPerLevel());
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,0,1", FilesPerLevel());
+
+  ReadOptions read_opts;
+  read_opts.ignore_range_deletions = true;
+  for (int i = 0; i < kNumKeys; ++i) {
+    std::string value;
+    Status s = db_->Get(read_opts, Key(i), &value);
+    if ((i >= 50 && i < 100) || (i >= 120 && i < 130)) {
+      ASSERT_TRUE(s.IsNotFound());
+      continue;
+    }
+    ASSERT_OK(s);
+    if (i < 10 || i == kNumKeys - 1) {
+      ASSERT_EQ("v3", value);
+    } else if (i >= 150) {
+      ASSERT_EQ("v2", value);
+    } else {
+      ASSERT_EQ("v1", value);
+    }
+  }
+}
+
 TEST_F(DBRangeDelTest, ValidLevelSubcompactionBoundaries) {
   const int kNumPerFile = 100, kNumFiles = 4, kFileBytes = 100 << 10;
   Options options = CurrentOptions();
@@ -3489,10 +3489,12 @@ TEST_F(DBTest2, RateLimitedCompactionReads) {
     ASSERT_EQ(0, NumTableFilesAtLevel(0));
 
     ASSERT_EQ(0, options.rate_limiter->GetTotalBytesThrough(Env::IO_HIGH));
+    // The compaction is out of L0, so its reads are charged to IO_MID
+    ASSERT_EQ(0, options.rate_limiter->GetTotalBytesThrough(Env::IO_LOW));
     // should be slightly above 512KB due to non-data blocks read. Arbitrarily
     // chose 1MB as the upper bound on the total bytes read.
     size_t rate_limited_bytes =
-        options.rate_limiter->GetTotalBytesThrough(Env::IO_LOW);
+        options.rate_limiter->GetTotalBytesThrough(Env::IO_MID);
     // Include the explicit prefetch of the footer in direct I/O case.
     size_t direct_io_extra = use_direct_io ? 512 * 1024 : 0;
     ASSERT_GE(
@@ -3511,7 +3513,23 @@ TEST_F(DBTest2, RateLimitedCompactionReads) {
     // bytes read for user iterator shouldn't count against the rate limit.
     ASSERT_EQ(rate_limited_bytes,
               static_cast<size_t>(
-                  options.rate_limiter->GetTotalBytesThrough(Env::IO_LOW)));
+                  options.rate_limiter->GetTotalBytesThrough(Env::IO_MID)));
+    ASSERT_EQ(0, options.rate_limiter->GetTotalBytesThrough(Env::IO_USER));
+
+    // unless the user asks for it
+    ReadOptions read_options;
+    read_options.rate_limiter_priority = Env::IO_USER;
+    iter = db_->NewIterator(read_options);
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(iter->value().ToString(), DummyString(kBytesPerKey));
+    }
+    ASSERT_OK(iter->status());
+    delete iter;
+    ASSERT_GE(options.rate_limiter->GetTotalBytesThrough(Env::IO_USER),
+              kNumKeysPerFile * kBytesPerKey);
+    ASSERT_EQ(rate_limited_bytes,
+              static_cast<size_t>(
+                  options.rate_limiter->GetTotalBytesThrough(Env::IO_MID)));
   }
 }
 #endif  // ROCKSDB_LITE
@@ -3842,6 +3860,102 @@ TEST_F(DBTest2, TraceAndReplay) {
   ASSERT_OK(DestroyDB(dbname2, options));
 }
 
+TEST_F(DBTest2, TraceAndShardedReplay) {
+  Options options = CurrentOptions();
+  ReadOptions ro;
+  TraceOptions trace_opts;
+  EnvOptions env_opts;
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  std::string trace_filename = dbname_ + "/rocksdb.trace";
+  std::unique_ptr<TraceWriter> trace_writer;
+  ASSERT_OK(NewFileTraceWriter(env_, env_opts, trace_filename, &trace_writer));
+  ASSERT_OK(db_->StartTrace(trace_opts, std::move(trace_writer)));
+
+  // Each key is overwritten, so that only the replay in order of the writes
+  // of a key gives its last value.
+  constexpr int kNumKeys = 100;
+  constexpr int kNumVersions = 5;
+  for (int version = 0; version < kNumVersions; version++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(0, Key(i), "v" + ToString(version)));
+    }
+  }
+  ASSERT_OK(Put(1, "foo", "bar"));
+
+  std::vector<std::string> key_strs = {Key(1), Key(2), "foo"};
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::vector<ColumnFamilyHandle*> cfs = {handles_[0], handles_[0],
+                                          handles_[1]};
+  std::vector<PinnableSlice> values(keys.size());
+  std::vector<Status> statuses(keys.size());
+  db_->MultiGet(ro, keys.size(), cfs.data(), keys.data(), values.data(),
+                statuses.data());
+  for (const Status& s : statuses) {
+    ASSERT_OK(s);
+  }
+  ASSERT_EQ("v4", Get(0, Key(3)));
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+  iter->Seek(Key(50));
+  ASSERT_TRUE(iter->Valid());
+  iter.reset();
+  ASSERT_OK(db_->EndTrace());
+
+  // Open another db, replay, and verify the data
+  std::string dbname2 = test::PerThreadDBPath(env_, "/db_replay");
+  ASSERT_OK(DestroyDB(dbname2, options));
+  DB* db2_init = nullptr;
+  options.create_if_missing = true;
+  ASSERT_OK(DB::Open(options, dbname2, &db2_init));
+  ColumnFamilyHandle* cf;
+  ASSERT_OK(
+      db2_init->CreateColumnFamily(ColumnFamilyOptions(), "pikachu", &cf));
+  delete cf;
+  delete db2_init;
+
+  DB* db2 = nullptr;
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.push_back(
+      ColumnFamilyDescriptor("default", ColumnFamilyOptions()));
+  column_families.push_back(
+      ColumnFamilyDescriptor("pikachu", ColumnFamilyOptions()));
+  std::vector<ColumnFamilyHandle*> handles;
+  DBOptions db_opts;
+  db_opts.env = env_;
+  ASSERT_OK(DB::Open(db_opts, dbname2, column_families, &handles, &db2));
+
+  std::unique_ptr<TraceReader> trace_reader;
+  ASSERT_OK(NewFileTraceReader(env_, env_opts, trace_filename, &trace_reader));
+  Replayer replayer(db2, handles, std::move(trace_reader));
+  ReplayOptions replay_opts;
+  replay_opts.num_threads = 4;
+  replay_opts.preserve_key_order = true;
+  replay_opts.fast_as_possible = true;
+  ASSERT_OK(replayer.Replay(replay_opts));
+
+  std::string value;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(db2->Get(ro, handles[0], Key(i), &value));
+    ASSERT_EQ("v" + ToString(kNumVersions - 1), value);
+  }
+  ASSERT_OK(db2->Get(ro, handles[1], "foo", &value));
+  ASSERT_EQ("bar", value);
+
+  ASSERT_EQ(uint64_t{kNumKeys * kNumVersions + 1},
+            replayer.GetLatencies(kTraceWrite).num());
+  ASSERT_EQ(uint64_t{1}, replayer.GetLatencies(kTraceMultiGet).num());
+  ASSERT_EQ(uint64_t{1}, replayer.GetLatencies(kTraceGet).num());
+  ASSERT_EQ(uint64_t{1}, replayer.GetLatencies(kTraceIteratorSeek).num());
+  ASSERT_NE(std::string::npos,
+            replayer.GetLatencyReport().find("MultiGet latency"));
+
+  for (auto handle : handles) {
+    delete handle;
+  }
+  delete db2;
+  ASSERT_OK(DestroyDB(dbname2, options));
+}
+
 TEST_F(DBTest2, TraceWithLimit) {
   Options options = CurrentOptions();
   options.merge_operator = MergeOperators::CreatePutOperator();
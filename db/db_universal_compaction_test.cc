@@ -1930,6 +1930,48 @@ TEST_F(DBTestUniversalCompaction2, BasicL0toL1) {
   ASSERT_GT(NumTableFilesAtLevel(6), 0);
 }
 
+TEST_F(DBTestUniversalCompaction2, FullCompactionSubcompactions) {
+  const int kNumKeys = 2000;
+  const int kNumFiles = 4;
+
+  Options opts = CurrentOptions();
+  opts.compaction_style = kCompactionStyleUniversal;
+  opts.num_levels = 4;
+  opts.disable_auto_compactions = true;
+  opts.compression = kNoCompression;
+  opts.target_file_size_base = 64 << 10;
+  opts.target_file_size_multiplier = 1;
+  opts.max_subcompactions = 4;
+  opts.statistics = CreateDBStatistics();
+  Reopen(opts);
+
+  // Every sorted run is a single file that covers the whole key range, so
+  // only the anchors within the files can split the compaction.
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int f = 0; f < kNumFiles; f++) {
+    for (int i = f; i < kNumKeys; i += kNumFiles) {
+      values[i] = rnd.RandomString(1000);
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ(kNumFiles, NumTableFilesAtLevel(0));
+
+  ASSERT_OK(dbfull()->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_GT(NumTableFilesAtLevel(opts.num_levels - 1), 1);
+
+  HistogramData subcompactions;
+  opts.statistics->histogramData(NUM_SUBCOMPACTIONS_SCHEDULED,
+                                 &subcompactions);
+  ASSERT_GT(subcompactions.max, 1);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
 #if defined(ENABLE_SINGLE_LEVEL_DTC)
 TEST_F(DBTestUniversalCompaction2, SingleLevel) {
   const int kNumKeys = 3000;
@@ -13,6 +13,7 @@
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "test_util/sync_point.h"
+#include "util/compression.h"
 #include "utilities/fault_injection_env.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -277,6 +278,47 @@ TEST_F(DBWALTest, Recover) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, RecoverWithCompressedWAL) {
+  if (!StreamingCompressionTypeSupported(kZSTD)) {
+    ROCKSDB_GTEST_SKIP("ZSTD streaming compression not supported");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.wal_compression = kZSTD;
+  CreateAndReopenWithCF({"pikachu"}, options);
+  ASSERT_OK(Put(1, "foo", "v1"));
+  ASSERT_OK(Put(1, "baz", std::string(10000, 'x')));
+
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  ASSERT_EQ("v1", Get(1, "foo"));
+  ASSERT_EQ(std::string(10000, 'x'), Get(1, "baz"));
+  ASSERT_OK(Put(1, "foo", "v2"));
+
+#ifndef ROCKSDB_LITE
+  // The transaction log iterator reads the compressed WAL transparently.
+  std::unique_ptr<TransactionLogIterator> iter;
+  ASSERT_OK(dbfull()->GetUpdatesSince(0, &iter));
+  SequenceNumber last_seq = 0;
+  for (; iter->Valid(); iter->Next()) {
+    last_seq = iter->GetBatch().sequence;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(db_->GetLatestSequenceNumber(), last_seq);
+#endif  // ROCKSDB_LITE
+
+  // Reopen without WAL compression; the compressed WAL is still recovered.
+  options.wal_compression = kNoCompression;
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  ASSERT_EQ("v2", Get(1, "foo"));
+  ASSERT_EQ(std::string(10000, 'x'), Get(1, "baz"));
+}
+
+TEST_F(DBWALTest, UnsupportedWALCompression) {
+  Options options = CurrentOptions();
+  options.wal_compression = kSnappyCompression;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+}
+
 TEST_F(DBWALTest, RecoverWithTableHandle) {
   do {
     Options options = CurrentOptions();
@@ -1628,6 +1670,70 @@ TEST_P(DBWALTestWithParamsVaryingRecoveryMode,
   ASSERT_EQ(data, actual_data);
 }
 
+// Test scope:
+// - Pipelined WAL recovery recovers the same data and returns the same status
+// as the serial replay, whatever the corruption and the recovery mode
+TEST_P(DBWALTestWithParamsVaryingRecoveryMode, PipelinedRecoveryMatchesSerial) {
+  bool trunc = std::get<0>(GetParam());  // Corruption style
+  // Corruption offset position
+  int corrupt_offset = std::get<1>(GetParam());
+  int wal_file_id = std::get<2>(GetParam());  // WAL file
+  WALRecoveryMode recovery_mode = std::get<3>(GetParam());
+
+  Options options = CurrentOptions();
+  options.wal_recovery_mode = recovery_mode;
+  RecoveryTestHelper::FillData(this, &options);
+  RecoveryTestHelper::CorruptWAL(this, options, corrupt_offset * .3,
+                                 /*len%=*/.1, wal_file_id, trunc);
+  options.create_if_missing = false;
+
+  // Read-only opens replay the WAL without rewriting the DB, so both kinds of
+  // recovery see the same files.
+  auto recover = [&](bool pipelined, std::vector<std::string>* keys) {
+    options.enable_pipelined_wal_recovery = pipelined;
+    Status s = ReadOnlyReopen(options);
+    if (s.ok()) {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        keys->push_back(iter->key().ToString());
+      }
+      EXPECT_OK(iter->status());
+    }
+    Close();
+    return s;
+  };
+  std::vector<std::string> serial_keys;
+  Status serial_status = recover(false, &serial_keys);
+  std::vector<std::string> pipelined_keys;
+  Status pipelined_status = recover(true, &pipelined_keys);
+  ASSERT_EQ(serial_status.code(), pipelined_status.code());
+  ASSERT_EQ(serial_keys, pipelined_keys);
+}
+
+TEST_F(DBWALTest, PipelinedRecoveryWithFlush) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 64 << 10;
+  options.disable_auto_compactions = true;
+  options.enable_pipelined_wal_recovery = true;
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  const int kNumKeys = 2000;
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    values.push_back(rnd.RandomString(100));
+    ASSERT_OK(Put(i % 2, Key(i), values.back()));
+  }
+  // Recovery does not fit in a single memtable, so it has to flush while the
+  // background thread keeps reading the WAL.
+  options.write_buffer_size = 16 << 10;
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  ASSERT_GT(NumTableFilesAtLevel(0, 0), 1);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(i % 2, Key(i)));
+  }
+}
+
 // Tests that total log size is recovered if we set
 // avoid_flush_during_recovery=true.
 // Flush should trigger if max_total_wal_size is reached.
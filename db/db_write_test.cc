@@ -311,6 +311,68 @@ TEST_P(DBWriteTest, IOErrorOnWALWritePropagateToWriteThreadFollower) {
   Close();
 }
 
+TEST_P(DBWriteTest, LargeParallelWriteGroup) {
+  // Large enough for the leader to delegate waking up the memtable writers.
+  constexpr int kNumThreads = 32;
+  constexpr int kKeysPerThread = 3;
+  Options options = GetOptions();
+  options.allow_concurrent_memtable_write = true;
+  Reopen(options);
+  std::atomic<int> ready_count{0};
+  std::atomic<int> leader_count{0};
+  std::atomic<int> caller_count{0};
+
+  // Wait until all threads linked to write threads, to make sure
+  // all threads join the same batch group.
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::JoinBatchGroup:Wait", [&](void* arg) {
+        ready_count++;
+        auto* w = reinterpret_cast<WriteThread::Writer*>(arg);
+        if (w->state == WriteThread::STATE_GROUP_LEADER) {
+          leader_count++;
+          while (ready_count < kNumThreads) {
+            // busy waiting
+          }
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::SetMemWritersEachStride:Start",
+      [&](void* /*arg*/) { caller_count++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  std::vector<port::Thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.push_back(port::Thread(
+        [&](int index) {
+          WriteBatch batch;
+          for (int j = 0; j < kKeysPerThread; j++) {
+            ASSERT_OK(batch.Put("key" + ToString(index) + "_" + ToString(j),
+                                "value" + ToString(index)));
+          }
+          ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+        },
+        i));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(1, leader_count);
+  // The leader and at least one of the writers woke up the group.
+  ASSERT_GT(caller_count, 1);
+
+  // The records of the whole group went to the WAL as a single record.
+  for (int reopen = 0; reopen < 2; reopen++) {
+    for (int i = 0; i < kNumThreads; i++) {
+      for (int j = 0; j < kKeysPerThread; j++) {
+        ASSERT_EQ("value" + ToString(i),
+                  Get("key" + ToString(i) + "_" + ToString(j)));
+      }
+    }
+    Reopen(options);
+  }
+}
+
 TEST_P(DBWriteTest, ManualWalFlushInEffect) {
   Options options = GetOptions();
   Reopen(options);
@@ -12,6 +12,7 @@
 #include <cinttypes>
 
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 #include "db/builder.h"
@@ -39,6 +40,7 @@
 #include "rocksdb/statistics.h"
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
+#include "table/internal_iterator.h"
 #include "table/merging_iterator.h"
 #include "table/table_builder.h"
 #include "table/two_level_iterator.h"
@@ -80,6 +82,107 @@ const char* GetFlushReasonString (FlushReason flush_reason) {
   }
 }
 
+namespace {
+// Iterates over the entries of `iter` whose user keys are in
+// [*lower, *upper). A null bound leaves that side of the range open.
+class PartitionIterator : public InternalIterator {
+ public:
+  PartitionIterator(InternalIterator* iter, const Comparator* ucmp,
+                    const std::string* lower, const std::string* upper)
+      : iter_(iter), ucmp_(ucmp), lower_(lower), upper_(upper), valid_(false) {}
+
+  bool Valid() const override { return valid_; }
+
+  void SeekToFirst() override {
+    if (lower_ != nullptr) {
+      InternalKey target(*lower_, kMaxSequenceNumber, kValueTypeForSeek);
+      iter_->Seek(target.Encode());
+    } else {
+      iter_->SeekToFirst();
+    }
+    UpdateValid();
+  }
+
+  void SeekToLast() override {
+    if (upper_ != nullptr) {
+      // Sorts before every entry of *upper_
+      InternalKey target(*upper_, kMaxSequenceNumber, kValueTypeForSeek);
+      iter_->SeekForPrev(target.Encode());
+    } else {
+      iter_->SeekToLast();
+    }
+    UpdateValid();
+  }
+
+  void Seek(const Slice& target) override {
+    if (lower_ != nullptr &&
+        ucmp_->Compare(ExtractUserKey(target), *lower_) < 0) {
+      SeekToFirst();
+      return;
+    }
+    iter_->Seek(target);
+    UpdateValid();
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    if (upper_ != nullptr &&
+        ucmp_->Compare(ExtractUserKey(target), *upper_) >= 0) {
+      SeekToLast();
+      return;
+    }
+    iter_->SeekForPrev(target);
+    UpdateValid();
+  }
+
+  void Next() override {
+    assert(valid_);
+    iter_->Next();
+    UpdateValid();
+  }
+
+  void Prev() override {
+    assert(valid_);
+    iter_->Prev();
+    UpdateValid();
+  }
+
+  Slice key() const override {
+    assert(valid_);
+    return iter_->key();
+  }
+
+  Slice value() const override {
+    assert(valid_);
+    return iter_->value();
+  }
+
+  Status status() const override { return iter_->status(); }
+
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    iter_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+
+  bool IsKeyPinned() const override { return iter_->IsKeyPinned(); }
+
+  bool IsValuePinned() const override { return iter_->IsValuePinned(); }
+
+ private:
+  void UpdateValid() {
+    valid_ = iter_->Valid() &&
+             (lower_ == nullptr ||
+              ucmp_->Compare(iter_->user_key(), *lower_) >= 0) &&
+             (upper_ == nullptr ||
+              ucmp_->Compare(iter_->user_key(), *upper_) < 0);
+  }
+
+  InternalIterator* iter_;
+  const Comparator* ucmp_;
+  const std::string* lower_;
+  const std::string* upper_;
+  bool valid_;
+};
+}  // namespace
+
 FlushJob::FlushJob(
     const std::string& dbname, ColumnFamilyData* cfd,
     const ImmutableDBOptions& db_options,
@@ -357,14 +460,20 @@ Status FlushJob::WriteLevel0Table() {
                          << total_memory_usage << "flush_reason"
                          << GetFlushReasonString(cfd_->GetFlushReason());
 
+    std::vector<std::string> boundaries;
+    if (range_del_iters.empty()) {
+      PickPartitionBoundaries(total_memory_usage, &boundaries);
+    }
+
     {
       ScopedArenaIterator iter(
           NewMergingIterator(&cfd_->internal_comparator(), &memtables[0],
                              static_cast<int>(memtables.size()), &arena));
       ROCKS_LOG_INFO(db_options_.info_log,
-                     "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": started",
+                     "[%s] [JOB %d] Level-0 flush table #%" PRIu64
+                     ": started in %" ROCKSDB_PRIszt " partitions",
                      cfd_->GetName().c_str(), job_context_->job_id,
-                     meta_.fd.GetNumber());
+                     meta_.fd.GetNumber(), boundaries.size() + 1);
 
       TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:output_compression",
                                &output_compression_);
@@ -399,23 +508,113 @@ Status FlushJob::WriteLevel0Table() {
                                    ? current_time
                                    : meta_.oldest_ancester_time;
 
-      IOStatus io_s;
       const std::string* const full_history_ts_low =
           (full_history_ts_low_.empty()) ? nullptr : &full_history_ts_low_;
-      s = BuildTable(
-          dbname_, versions_, db_options_, *cfd_->ioptions(),
-          mutable_cf_options_, file_options_, cfd_->table_cache(), iter.get(),
-          std::move(range_del_iters), &meta_, &blob_file_additions,
-          cfd_->internal_comparator(), cfd_->int_tbl_prop_collector_factories(),
-          cfd_->GetID(), cfd_->GetName(), existing_snapshots_,
-          earliest_write_conflict_snapshot_, snapshot_checker_,
-          output_compression_, mutable_cf_options_.sample_for_compression,
-          mutable_cf_options_.compression_opts,
-          mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
-          TableFileCreationReason::kFlush, &io_s, io_tracer_, event_logger_,
-          job_context_->job_id, Env::IO_HIGH, &table_properties_, 0 /* level */,
-          creation_time, oldest_key_time, write_hint, current_time, db_id_,
-          db_session_id_, full_history_ts_low);
+      auto build_table =
+          [&](InternalIterator* input,
+              std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>
+                  range_del_input,
+              FileMetaData* meta, std::vector<BlobFileAddition>* blob_additions,
+              TableProperties* table_properties, IOStatus* io_s) {
+            return BuildTable(
+                dbname_, versions_, db_options_, *cfd_->ioptions(),
+                mutable_cf_options_, file_options_, cfd_->table_cache(), input,
+                std::move(range_del_input), meta, blob_additions,
+                cfd_->internal_comparator(),
+                cfd_->int_tbl_prop_collector_factories(), cfd_->GetID(),
+                cfd_->GetName(), existing_snapshots_,
+                earliest_write_conflict_snapshot_, snapshot_checker_,
+                output_compression_, mutable_cf_options_.sample_for_compression,
+                mutable_cf_options_.compression_opts,
+                mutable_cf_options_.paranoid_file_checks,
+                cfd_->internal_stats(), TableFileCreationReason::kFlush, io_s,
+                io_tracer_, event_logger_, job_context_->job_id, Env::IO_HIGH,
+                table_properties, 0 /* level */, creation_time,
+                oldest_key_time, write_hint, current_time, db_id_,
+                db_session_id_, full_history_ts_low);
+          };
+
+      IOStatus io_s;
+      if (boundaries.empty()) {
+        s = build_table(iter.get(), std::move(range_del_iters), &meta_,
+                        &blob_file_additions, &table_properties_, &io_s);
+      } else {
+        // Each partition gets its own view of the memtables and is written
+        // to its own file. They don't overlap in user keys, so the files can
+        // be added to L0 together.
+        const size_t num_partitions = boundaries.size() + 1;
+        partition_metas_.resize(num_partitions - 1);
+        std::vector<FileMetaData*> metas{&meta_};
+        for (FileMetaData& meta : partition_metas_) {
+          meta.fd = FileDescriptor(versions_->NewFileNumber(), 0, 0);
+          meta.oldest_ancester_time = meta_.oldest_ancester_time;
+          meta.file_creation_time = meta_.file_creation_time;
+          metas.push_back(&meta);
+        }
+        std::vector<std::unique_ptr<ScopedArenaIterator>> merged_iters;
+        std::vector<std::unique_ptr<InternalIterator>> partition_iters;
+        for (size_t i = 0; i < num_partitions; i++) {
+          std::vector<InternalIterator*> partition_memtables;
+          for (MemTable* m : mems_) {
+            partition_memtables.push_back(m->NewIterator(ro, &arena));
+          }
+          merged_iters.emplace_back(new ScopedArenaIterator(NewMergingIterator(
+              &cfd_->internal_comparator(), &partition_memtables[0],
+              static_cast<int>(partition_memtables.size()), &arena)));
+          partition_iters.emplace_back(new PartitionIterator(
+              merged_iters.back()->get(), cfd_->user_comparator(),
+              i == 0 ? nullptr : &boundaries[i - 1],
+              i + 1 == num_partitions ? nullptr : &boundaries[i]));
+        }
+
+        std::vector<Status> statuses(num_partitions);
+        std::vector<IOStatus> io_statuses(num_partitions);
+        std::vector<std::vector<BlobFileAddition>> blob_additions(
+            num_partitions);
+        std::vector<TableProperties> table_properties(num_partitions);
+        auto build_partition = [&](size_t i) {
+          statuses[i] = build_table(
+              partition_iters[i].get(),
+              std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>(),
+              metas[i], &blob_additions[i], &table_properties[i],
+              &io_statuses[i]);
+        };
+        // Like subcompactions, all but the first partition get a thread of
+        // their own, and the first one is written by this thread.
+        std::vector<port::Thread> threads;
+        threads.reserve(num_partitions - 1);
+        for (size_t i = 1; i < num_partitions; i++) {
+          threads.emplace_back(build_partition, i);
+        }
+        build_partition(0);
+        for (auto& thread : threads) {
+          thread.join();
+        }
+
+        for (size_t i = 0; i < num_partitions; i++) {
+          assert(blob_additions[i].empty());
+          if (s.ok()) {
+            s = statuses[i];
+          } else {
+            statuses[i].PermitUncheckedError();
+          }
+          if (io_s.ok()) {
+            io_s = io_statuses[i];
+          } else {
+            io_statuses[i].PermitUncheckedError();
+          }
+        }
+        // The file reported for the flush should be one that is kept.
+        size_t reported = 0;
+        while (reported + 1 < num_partitions &&
+               metas[reported]->fd.GetFileSize() == 0) {
+          reported++;
+        }
+        if (reported > 0) {
+          std::swap(meta_, partition_metas_[reported - 1]);
+        }
+        table_properties_ = table_properties[reported];
+      }
       if (!io_s.ok()) {
         io_status_ = io_s;
       }
@@ -429,6 +628,13 @@ Status FlushJob::WriteLevel0Table() {
                    meta_.fd.GetNumber(), meta_.fd.GetFileSize(),
                    s.ToString().c_str(),
                    meta_.marked_for_compaction ? " (needs compaction)" : "");
+    for (const FileMetaData& meta : partition_metas_) {
+      ROCKS_LOG_INFO(db_options_.info_log,
+                     "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
+                     " bytes (partition)",
+                     cfd_->GetName().c_str(), job_context_->job_id,
+                     meta.fd.GetNumber(), meta.fd.GetFileSize());
+    }
 
     if (s.ok() && output_file_directory_ != nullptr && sync_output_directory_) {
       s = output_file_directory_->Fsync(IOOptions(), nullptr);
@@ -447,13 +653,21 @@ Status FlushJob::WriteLevel0Table() {
     // insert files directly into higher levels because some other
     // threads could be concurrently producing compacted files for
     // that key range.
+    // Intra-L0 compaction takes either all the files of a partitioned flush
+    // or none of them, which it finds by this id.
+    for (FileMetaData& meta : partition_metas_) {
+      if (meta.fd.GetFileSize() > 0) {
+        meta_.partitioned_flush_id = meta_.fd.GetNumber();
+        meta.partitioned_flush_id = meta_.fd.GetNumber();
+      }
+    }
     // Add file to L0
-    edit_->AddFile(0 /* level */, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
-                   meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
-                   meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
-                   meta_.marked_for_compaction, meta_.oldest_blob_file_number,
-                   meta_.oldest_ancester_time, meta_.file_creation_time,
-                   meta_.file_checksum, meta_.file_checksum_func_name);
+    edit_->AddFile(0 /* level */, meta_);
+    for (const FileMetaData& meta : partition_metas_) {
+      if (meta.fd.GetFileSize() > 0) {
+        edit_->AddFile(0 /* level */, meta);
+      }
+    }
 
     edit_->SetBlobFileAdditions(std::move(blob_file_additions));
   }
@@ -470,6 +684,12 @@ Status FlushJob::WriteLevel0Table() {
   if (has_output) {
     stats.bytes_written = meta_.fd.GetFileSize();
     stats.num_output_files = 1;
+    for (const FileMetaData& meta : partition_metas_) {
+      if (meta.fd.GetFileSize() > 0) {
+        stats.bytes_written += meta.fd.GetFileSize();
+        stats.num_output_files++;
+      }
+    }
   }
 
   const auto& blobs = edit_->GetBlobFileAdditions();
@@ -487,6 +707,56 @@ Status FlushJob::WriteLevel0Table() {
   return s;
 }
 
+void FlushJob::PickPartitionBoundaries(
+    size_t memory_usage, std::vector<std::string>* boundaries) const {
+  assert(boundaries != nullptr && boundaries->empty());
+  const uint32_t max_partitions = db_options_.max_flush_partitions;
+  const Comparator* ucmp = cfd_->user_comparator();
+  // Files of other compaction styles, blob references and user-defined
+  // timestamps are not handled by the L0 partitioning.
+  if (max_partitions <= 1 ||
+      cfd_->ioptions()->compaction_style != kCompactionStyleLevel ||
+      mutable_cf_options_.enable_blob_files || ucmp->timestamp_size() > 0) {
+    return;
+  }
+  // A full write buffer gets all the partitions, smaller flushes fewer of
+  // them, so that the files stay about the same size.
+  const size_t partition_size = std::max<size_t>(
+      mutable_cf_options_.write_buffer_size / max_partitions, 1);
+  const size_t num_partitions = std::min<size_t>(
+      max_partitions, (memory_usage + partition_size - 1) / partition_size);
+  if (num_partitions <= 1) {
+    return;
+  }
+
+  // Take the quantiles of a random sample of the user keys.
+  const uint64_t kSamplesPerPartition = 64;
+  std::unordered_set<const char*> entries;
+  for (MemTable* m : mems_) {
+    m->UniqueRandomSample(kSamplesPerPartition * num_partitions, &entries);
+  }
+  if (entries.empty()) {
+    return;
+  }
+  std::vector<Slice> keys;
+  keys.reserve(entries.size());
+  for (const char* entry : entries) {
+    keys.push_back(ExtractUserKey(GetLengthPrefixedSlice(entry)));
+  }
+  std::sort(keys.begin(), keys.end(), [ucmp](const Slice& a, const Slice& b) {
+    return ucmp->Compare(a, b) < 0;
+  });
+  for (size_t i = 1; i < num_partitions; i++) {
+    const Slice& key = keys[i * keys.size() / num_partitions];
+    // Keep the boundaries strictly increasing and above the smallest key.
+    const Slice last =
+        boundaries->empty() ? keys.front() : Slice(boundaries->back());
+    if (ucmp->Compare(key, last) > 0) {
+      boundaries->emplace_back(key.data(), key.size());
+    }
+  }
+}
+
 #ifndef ROCKSDB_LITE
 std::unique_ptr<FlushJobInfo> FlushJob::GetFlushJobInfo() const {
   db_mutex_->AssertHeld();
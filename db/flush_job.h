@@ -95,11 +95,22 @@ class FlushJob {
   // Return the IO status
   IOStatus io_status() const { return io_status_; }
 
+  // The L0 files written besides the one returned by Run() when the flush
+  // was split into partitions. Only valid after Run() succeeded.
+  const std::vector<FileMetaData>& GetPartitionFileMetas() const {
+    return partition_metas_;
+  }
+
  private:
   void ReportStartedFlush();
   void ReportFlushInputSize(const autovector<MemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
+  // Picks the user keys to split the memtables at, so that their partitions
+  // can be flushed to separate L0 files in parallel. Leaves `boundaries`
+  // empty if the flush should write a single file.
+  void PickPartitionBoundaries(size_t memory_usage,
+                               std::vector<std::string>* boundaries) const;
 #ifndef ROCKSDB_LITE
   std::unique_ptr<FlushJobInfo> GetFlushJobInfo() const;
 #endif  // !ROCKSDB_LITE
@@ -156,6 +167,8 @@ class FlushJob {
 
   // Variables below are set by PickMemTable():
   FileMetaData meta_;
+  // Files of all but the first partition of a partitioned flush
+  std::vector<FileMetaData> partition_metas_;
   autovector<MemTable*> mems_;
   VersionEdit* edit_;
   Version* base_;
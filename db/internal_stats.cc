@@ -205,6 +205,7 @@ static const std::string cfstats = "cfstats";
 static const std::string cfstats_no_file_histogram =
     "cfstats-no-file-histogram";
 static const std::string cf_file_histogram = "cf-file-histogram";
+static const std::string cf_write_stall_stats = "cf-write-stall-stats";
 static const std::string dbstats = "dbstats";
 static const std::string levelstats = "levelstats";
 static const std::string num_immutable_mem_table = "num-immutable-mem-table";
@@ -271,6 +272,8 @@ const std::string DB::Properties::kCFStatsNoFileHistogram =
     rocksdb_prefix + cfstats_no_file_histogram;
 const std::string DB::Properties::kCFFileHistogram =
     rocksdb_prefix + cf_file_histogram;
+const std::string DB::Properties::kCFWriteStallStats =
+    rocksdb_prefix + cf_write_stall_stats;
 const std::string DB::Properties::kDBStats = rocksdb_prefix + dbstats;
 const std::string DB::Properties::kLevelStats = rocksdb_prefix + levelstats;
 const std::string DB::Properties::kNumImmutableMemTable =
@@ -370,6 +373,9 @@ const std::unordered_map<std::string, DBPropertyInfo>
         {DB::Properties::kCFFileHistogram,
          {false, &InternalStats::HandleCFFileHistogram, nullptr, nullptr,
           nullptr}},
+        {DB::Properties::kCFWriteStallStats,
+         {false, &InternalStats::HandleCFWriteStallStats, nullptr,
+          &InternalStats::HandleCFWriteStallStatsMap, nullptr}},
         {DB::Properties::kDBStats,
          {false, &InternalStats::HandleDBStats, nullptr, nullptr, nullptr}},
         {DB::Properties::kSSTables,
@@ -593,6 +599,41 @@ bool InternalStats::HandleCFMapStats(
   return true;
 }
 
+bool InternalStats::HandleCFWriteStallStats(std::string* value,
+                                            Slice /*suffix*/) {
+  std::map<std::string, std::string> write_stall_stats;
+  HandleCFWriteStallStatsMap(&write_stall_stats);
+  for (const auto& stat : write_stall_stats) {
+    value->append(stat.first);
+    value->append(": ");
+    value->append(stat.second);
+    value->append("\n");
+  }
+  return true;
+}
+
+bool InternalStats::HandleCFWriteStallStatsMap(
+    std::map<std::string, std::string>* write_stall_stats) {
+  DumpCFMapStatsIOStalls(write_stall_stats);
+
+  const PendingCompactionBytesController& controller =
+      cfd_->pending_compaction_bytes_controller();
+  (*write_stall_stats)["controller.target_pending_compaction_bytes"] =
+      std::to_string(
+          cfd_->GetLatestMutableCFOptions()->pending_compaction_bytes_target);
+  (*write_stall_stats)["controller.pending_compaction_bytes"] = std::to_string(
+      cfd_->current()->storage_info()->estimated_compaction_needed_bytes());
+  (*write_stall_stats)["controller.compaction_bytes_per_sec"] =
+      std::to_string(controller.compaction_bytes_per_sec());
+  (*write_stall_stats)["controller.write_amplification"] =
+      std::to_string(controller.write_amplification());
+  (*write_stall_stats)["controller.integral"] =
+      std::to_string(controller.integral());
+  (*write_stall_stats)["controller.write_rate"] =
+      std::to_string(controller.write_rate());
+  return true;
+}
+
 bool InternalStats::HandleCFStats(std::string* value, Slice /*suffix*/) {
   DumpCFStats(value);
   return true;
@@ -1185,6 +1226,9 @@ void InternalStats::DumpCFMapStatsIOStalls(
       std::to_string(cf_stats_count_[PENDING_COMPACTION_BYTES_LIMIT_STOPS]);
   (*cf_stats)["io_stalls.slowdown_for_pending_compaction_bytes"] =
       std::to_string(cf_stats_count_[PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS]);
+  (*cf_stats)["io_stalls.slowdown_for_pending_compaction_bytes_target"] =
+      std::to_string(
+          cf_stats_count_[PENDING_COMPACTION_BYTES_TARGET_SLOWDOWNS]);
   (*cf_stats)["io_stalls.memtable_compaction"] =
       std::to_string(cf_stats_count_[MEMTABLE_LIMIT_STOPS]);
   (*cf_stats)["io_stalls.memtable_slowdown"] =
@@ -1197,6 +1241,7 @@ void InternalStats::DumpCFMapStatsIOStalls(
   uint64_t total_slowdown =
       cf_stats_count_[L0_FILE_COUNT_LIMIT_SLOWDOWNS] +
       cf_stats_count_[PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS] +
+      cf_stats_count_[PENDING_COMPACTION_BYTES_TARGET_SLOWDOWNS] +
       cf_stats_count_[MEMTABLE_LIMIT_SLOWDOWNS];
 
   (*cf_stats)["io_stalls.total_stop"] = std::to_string(total_stop);
@@ -1241,6 +1286,7 @@ void InternalStats::DumpCFStatsNoFileHistogram(std::string* value) {
       cf_stats_count_[L0_FILE_COUNT_LIMIT_STOPS] +
       cf_stats_count_[PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS] +
       cf_stats_count_[PENDING_COMPACTION_BYTES_LIMIT_STOPS] +
+      cf_stats_count_[PENDING_COMPACTION_BYTES_TARGET_SLOWDOWNS] +
       cf_stats_count_[MEMTABLE_LIMIT_STOPS] +
       cf_stats_count_[MEMTABLE_LIMIT_SLOWDOWNS];
   // Interval summary
@@ -1361,6 +1407,8 @@ void InternalStats::DumpCFStatsNoFileHistogram(std::string* value) {
            "%" PRIu64
            " slowdown for pending_compaction_bytes, "
            "%" PRIu64
+           " slowdown for pending_compaction_bytes_target, "
+           "%" PRIu64
            " memtable_compaction, "
            "%" PRIu64
            " memtable_slowdown, "
@@ -1371,6 +1419,7 @@ void InternalStats::DumpCFStatsNoFileHistogram(std::string* value) {
            cf_stats_count_[LOCKED_L0_FILE_COUNT_LIMIT_STOPS],
            cf_stats_count_[PENDING_COMPACTION_BYTES_LIMIT_STOPS],
            cf_stats_count_[PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS],
+           cf_stats_count_[PENDING_COMPACTION_BYTES_TARGET_SLOWDOWNS],
            cf_stats_count_[MEMTABLE_LIMIT_STOPS],
            cf_stats_count_[MEMTABLE_LIMIT_SLOWDOWNS],
            total_stall_count - cf_stats_snapshot_.stall_count);
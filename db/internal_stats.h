@@ -99,12 +99,14 @@ class InternalStats {
     LOCKED_L0_FILE_COUNT_LIMIT_STOPS,
     PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS,
     PENDING_COMPACTION_BYTES_LIMIT_STOPS,
+    PENDING_COMPACTION_BYTES_TARGET_SLOWDOWNS,
     WRITE_STALLS_ENUM_MAX,
     BYTES_FLUSHED,
     BYTES_INGESTED_ADD_FILE,
     INGESTED_NUM_FILES_TOTAL,
     INGESTED_LEVEL0_NUM_FILES_TOTAL,
     INGESTED_NUM_KEYS_TOTAL,
+    BYTES_WRITTEN_BY_COMPACTION,
     INTERNAL_CF_STATS_ENUM_MAX,
   };
 
@@ -357,6 +359,10 @@ class InternalStats {
     ++cf_stats_count_[type];
   }
 
+  uint64_t GetCFStatsValue(InternalCFStatsType type) const {
+    return cf_stats_value_[type];
+  }
+
   void AddDBStats(InternalDBStatsType type, uint64_t value,
                   bool concurrent = false) {
     auto& v = db_stats_[type];
@@ -526,6 +532,9 @@ class InternalStats {
   bool HandleLevelStats(std::string* value, Slice suffix);
   bool HandleStats(std::string* value, Slice suffix);
   bool HandleCFMapStats(std::map<std::string, std::string>* compaction_stats);
+  bool HandleCFWriteStallStats(std::string* value, Slice suffix);
+  bool HandleCFWriteStallStatsMap(
+      std::map<std::string, std::string>* write_stall_stats);
   bool HandleCFStats(std::string* value, Slice suffix);
   bool HandleCFStatsNoFileHistogram(std::string* value, Slice suffix);
   bool HandleCFFileHistogram(std::string* value, Slice suffix);
@@ -613,12 +622,14 @@ class InternalStats {
     LOCKED_L0_FILE_COUNT_LIMIT_STOPS,
     PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS,
     PENDING_COMPACTION_BYTES_LIMIT_STOPS,
+    PENDING_COMPACTION_BYTES_TARGET_SLOWDOWNS,
     WRITE_STALLS_ENUM_MAX,
     BYTES_FLUSHED,
     BYTES_INGESTED_ADD_FILE,
     INGESTED_NUM_FILES_TOTAL,
     INGESTED_LEVEL0_NUM_FILES_TOTAL,
     INGESTED_NUM_KEYS_TOTAL,
+    BYTES_WRITTEN_BY_COMPACTION,
     INTERNAL_CF_STATS_ENUM_MAX,
   };
 
@@ -668,6 +679,8 @@ class InternalStats {
 
   void AddCFStats(InternalCFStatsType /*type*/, uint64_t /*value*/) {}
 
+  uint64_t GetCFStatsValue(InternalCFStatsType /*type*/) const { return 0; }
+
   void AddDBStats(InternalDBStatsType /*type*/, uint64_t /*value*/,
                   bool /*concurrent */ = false) {}
 
@@ -10,6 +10,7 @@
 #pragma once
 #include <memory>
 #include <stdint.h>
+#include <string>
 
 #include "db/log_format.h"
 #include "file/sequence_file_reader.h"
@@ -19,6 +20,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 class Logger;
+class StreamingUncompress;
 
 namespace log {
 
@@ -128,6 +130,13 @@ class Reader {
   // Whether this is a recycled log file
   bool recycled_;
 
+  // Compression of the records that follow the kSetCompressionType record,
+  // if one was read, and the state needed to uncompress them.
+  bool compression_type_record_read_;
+  CompressionType compression_type_;
+  std::unique_ptr<StreamingUncompress> uncompress_;
+  std::string uncompressed_record_;
+
   // Extend record types with the following special values
   enum {
     kEof = kMaxRecordType + 1,
@@ -158,6 +167,13 @@ class Reader {
   // buffer_ must be updated to remove the dropped bytes prior to invocation.
   void ReportCorruption(size_t bytes, const char* reason);
   void ReportDrop(size_t bytes, const Status& reason);
+
+  // Handles a kSetCompressionType record.
+  void InitCompression(const Slice& fragment);
+
+  // If the records are compressed, replaces *record with its uncompressed
+  // form. Returns false, after reporting the corruption, if that fails.
+  bool MaybeUncompressRecord(Slice* record);
 };
 
 class FragmentBufferedReader : public Reader {
@@ -16,6 +16,7 @@
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 #include "util/random.h"
 
@@ -45,10 +46,12 @@ static std::string RandomSkewedString(int i, Random* rnd) {
   return BigString(NumberString(i), rnd->Skewed(17));
 }
 
-// Param type is tuple<int, bool>
+// Param type is tuple<int, bool, CompressionType>
 // get<0>(tuple): non-zero if recycling log, zero if regular log
 // get<1>(tuple): true if allow retry after read EOF, false otherwise
-class LogTest : public ::testing::TestWithParam<std::tuple<int, bool>> {
+// get<2>(tuple): type of compression used
+class LogTest
+    : public ::testing::TestWithParam<std::tuple<int, bool, CompressionType>> {
  private:
   class StringSource : public SequentialFile {
    public:
@@ -176,7 +179,8 @@ class LogTest : public ::testing::TestWithParam<std::tuple<int, bool>> {
         source_holder_(test::GetSequentialFileReader(
             new StringSource(reader_contents_, !std::get<1>(GetParam())),
             "" /* file name */)),
-        writer_(std::move(dest_holder_), 123, std::get<0>(GetParam())),
+        writer_(std::move(dest_holder_), 123, std::get<0>(GetParam()),
+                false /* manual_flush */, std::get<2>(GetParam())),
         allow_retry_read_(std::get<1>(GetParam())) {
     if (allow_retry_read_) {
       reader_.reset(new FragmentBufferedReader(
@@ -194,6 +198,16 @@ class LogTest : public ::testing::TestWithParam<std::tuple<int, bool>> {
     writer_.AddRecord(Slice(msg));
   }
 
+  void WriteParts(const std::vector<std::string>& parts) {
+    std::vector<Slice> slices(parts.begin(), parts.end());
+    writer_.AddRecord(
+        SliceParts(slices.data(), static_cast<int>(slices.size())));
+  }
+
+  IOStatus AddCompressionTypeRecord() {
+    return writer_.AddCompressionTypeRecord();
+  }
+
   size_t WrittenBytes() const {
     return dest_contents().size();
   }
@@ -307,6 +321,21 @@ TEST_P(LogTest, Fragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, GatheredFragmentation) {
+  const std::vector<std::string> small = {"sm", "", "all"};
+  const std::vector<std::string> large = {BigString("medium", 50000), "",
+                                          BigString("large", 100000), "x"};
+  WriteParts(small);
+  WriteParts({"", ""});
+  WriteParts(large);
+  Write("tail");
+  ASSERT_EQ("small", Read());
+  ASSERT_EQ("", Read());
+  ASSERT_EQ(large[0] + large[2] + large[3], Read());
+  ASSERT_EQ("tail", Read());
+  ASSERT_EQ("EOF", Read());
+}
+
 TEST_P(LogTest, MarginalTrailer) {
   // Make a trailer that is exactly the same length as an empty record.
   int header_size =
@@ -699,11 +728,12 @@ TEST_P(LogTest, Recycle) {
   ASSERT_EQ("EOF", Read());
 }
 
-INSTANTIATE_TEST_CASE_P(bool, LogTest,
-                        ::testing::Values(std::make_tuple(0, false),
-                                          std::make_tuple(0, true),
-                                          std::make_tuple(1, false),
-                                          std::make_tuple(1, true)));
+INSTANTIATE_TEST_CASE_P(
+    bool, LogTest,
+    ::testing::Values(std::make_tuple(0, false, kNoCompression),
+                      std::make_tuple(0, true, kNoCompression),
+                      std::make_tuple(1, false, kNoCompression),
+                      std::make_tuple(1, true, kNoCompression)));
 
 class RetriableLogTest : public ::testing::TestWithParam<int> {
  private:
@@ -919,6 +949,124 @@ TEST_P(RetriableLogTest, NonBlockingReadFullRecord) {
 
 INSTANTIATE_TEST_CASE_P(bool, RetriableLogTest, ::testing::Values(0, 2));
 
+class CompressionLogTest : public LogTest {
+ public:
+  Status SetupTestEnv() {
+    const CompressionType compression_type = std::get<2>(GetParam());
+    if (!StreamingCompressionTypeSupported(compression_type)) {
+      return Status::NotSupported();
+    }
+    return AddCompressionTypeRecord();
+  }
+};
+
+TEST_P(CompressionLogTest, Empty) {
+  Status s = SetupTestEnv();
+  if (s.IsNotSupported()) {
+    ROCKSDB_GTEST_SKIP("streaming compression not supported");
+    return;
+  }
+  ASSERT_OK(s);
+  // The compression type record does not count as a record
+  const bool compressed = std::get<2>(GetParam()) != kNoCompression;
+  ASSERT_EQ(compressed ? static_cast<size_t>(kHeaderSize + 4) : 0,
+            WrittenBytes());
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, ReadWrite) {
+  Status s = SetupTestEnv();
+  if (s.IsNotSupported()) {
+    ROCKSDB_GTEST_SKIP("streaming compression not supported");
+    return;
+  }
+  ASSERT_OK(s);
+  Write("foo");
+  Write("bar");
+  Write("");
+  Write("xxxx");
+  ASSERT_EQ("foo", Read());
+  ASSERT_EQ("bar", Read());
+  ASSERT_EQ("", Read());
+  ASSERT_EQ("xxxx", Read());
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ("EOF", Read());  // Make sure reads at eof work
+}
+
+TEST_P(CompressionLogTest, ManyBlocks) {
+  Status s = SetupTestEnv();
+  if (s.IsNotSupported()) {
+    ROCKSDB_GTEST_SKIP("streaming compression not supported");
+    return;
+  }
+  ASSERT_OK(s);
+  for (int i = 0; i < 100000; i++) {
+    Write(NumberString(i));
+  }
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_EQ(NumberString(i), Read());
+  }
+  ASSERT_EQ("EOF", Read());
+  if (std::get<2>(GetParam()) != kNoCompression) {
+    // The records share a compression context, so the WAL ends up smaller
+    // than the records themselves.
+    ASSERT_LT(WrittenBytes(), 100000 * NumberString(99999).size());
+  }
+}
+
+TEST_P(CompressionLogTest, Fragmentation) {
+  Status s = SetupTestEnv();
+  if (s.IsNotSupported()) {
+    ROCKSDB_GTEST_SKIP("streaming compression not supported");
+    return;
+  }
+  ASSERT_OK(s);
+  Random rnd(301);
+  const std::vector<std::string> wal_entries = {
+      "small",
+      rnd.RandomString(3 * kBlockSize / 2),  // Spans into block 2
+      rnd.RandomString(3 * kBlockSize),      // Spans into block 5
+  };
+  for (const std::string& wal_entry : wal_entries) {
+    Write(wal_entry);
+  }
+
+  for (const std::string& wal_entry : wal_entries) {
+    ASSERT_EQ(wal_entry, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, GatheredRecords) {
+  Status s = SetupTestEnv();
+  if (s.IsNotSupported()) {
+    ROCKSDB_GTEST_SKIP("streaming compression not supported");
+    return;
+  }
+  ASSERT_OK(s);
+  Random rnd(301);
+  const std::vector<std::string> parts = {
+      "small", "", rnd.RandomString(kBlockSize), rnd.RandomString(100)};
+  WriteParts(parts);
+  WriteParts({"foo"});
+  ASSERT_EQ(parts[0] + parts[2] + parts[3], Read());
+  ASSERT_EQ("foo", Read());
+  ASSERT_EQ("EOF", Read());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Compression, CompressionLogTest,
+    ::testing::Combine(::testing::Values(0), ::testing::Bool(),
+                       ::testing::Values(kNoCompression, kZSTD)));
+
+TEST(LogWriterTest, UnsupportedCompressionType) {
+  std::unique_ptr<WritableFileWriter> dest(test::GetWritableFileWriter(
+      new test::StringSink(nullptr), "" /* file name */));
+  Writer writer(std::move(dest), 123, false /* recycle_log_files */,
+                false /* manual_flush */, kSnappyCompression);
+  ASSERT_TRUE(writer.AddCompressionTypeRecord().IsNotSupported());
+}
+
 }  // namespace log
 }  // namespace ROCKSDB_NAMESPACE
 
@@ -10,21 +10,27 @@
 #include "db/log_writer.h"
 
 #include <stdint.h>
+
+#include <algorithm>
+
 #include "file/writable_file_writer.h"
 #include "rocksdb/env.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace log {
 
 Writer::Writer(std::unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
-               bool recycle_log_files, bool manual_flush)
+               bool recycle_log_files, bool manual_flush,
+               CompressionType compression_type)
     : dest_(std::move(dest)),
       block_offset_(0),
       log_number_(log_number),
       recycle_log_files_(recycle_log_files),
-      manual_flush_(manual_flush) {
+      manual_flush_(manual_flush),
+      compression_type_(compression_type) {
   for (int i = 0; i <= kMaxRecordType; i++) {
     char t = static_cast<char>(i);
     type_crc_[i] = crc32c::Value(&t, 1);
@@ -49,8 +55,35 @@ IOStatus Writer::Close() {
 }
 
 IOStatus Writer::AddRecord(const Slice& slice) {
-  const char* ptr = slice.data();
-  size_t left = slice.size();
+  return AddRecord(SliceParts(&slice, 1));
+}
+
+IOStatus Writer::AddRecord(const SliceParts& parts) {
+  const Slice* part = parts.parts;
+  size_t part_offset = 0;
+  size_t left = 0;
+  for (int i = 0; i < parts.num_parts; i++) {
+    left += parts.parts[i].size();
+  }
+
+  Slice compressed;
+  if (compress_) {
+    std::string joined;
+    Slice record;
+    if (parts.num_parts == 1) {
+      record = parts.parts[0];
+    } else {
+      record = Slice(parts, &joined);
+    }
+    compressed_buffer_.clear();
+    const Status cs = compress_->Compress(record, &compressed_buffer_);
+    if (!cs.ok()) {
+      return status_to_io_status(Status(cs));
+    }
+    compressed = compressed_buffer_;
+    part = &compressed;
+    left = compressed.size();
+  }
 
   // Header size varies depending on whether we are recycling or not.
   const int header_size =
@@ -97,8 +130,7 @@ IOStatus Writer::AddRecord(const Slice& slice) {
       type = recycle_log_files_ ? kRecyclableMiddleType : kMiddleType;
     }
 
-    s = EmitPhysicalRecord(type, ptr, fragment_length);
-    ptr += fragment_length;
+    s = EmitPhysicalRecord(type, &part, &part_offset, fragment_length);
     left -= fragment_length;
     begin = false;
   } while (s.ok() && left > 0);
@@ -112,9 +144,49 @@ IOStatus Writer::AddRecord(const Slice& slice) {
   return s;
 }
 
+IOStatus Writer::AddCompressionTypeRecord() {
+  // Should be the first record
+  assert(block_offset_ == 0);
+  assert(!compress_);
+
+  if (compression_type_ == kNoCompression) {
+    // No need to add a record
+    return IOStatus::OK();
+  }
+
+  std::unique_ptr<StreamingCompress> compress = StreamingCompress::Create(
+      compression_type_, CompressionOptions::kDefaultCompressionLevel);
+  if (!compress) {
+    return IOStatus::NotSupported(
+        "Streaming compression not supported for the compression type: " +
+        CompressionTypeToString(compression_type_));
+  }
+
+  std::string encoded;
+  PutFixed32(&encoded, static_cast<uint32_t>(compression_type_));
+
+  IOStatus s =
+      EmitPhysicalRecord(kSetCompressionType, encoded.data(), encoded.size());
+  if (s.ok()) {
+    compress_ = std::move(compress);
+    if (!manual_flush_) {
+      s = dest_->Flush();
+    }
+  }
+  return s;
+}
+
 bool Writer::TEST_BufferIsEmpty() { return dest_->TEST_BufferIsEmpty(); }
 
 IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
+  const Slice payload(ptr, n);
+  const Slice* part = &payload;
+  size_t part_offset = 0;
+  return EmitPhysicalRecord(t, &part, &part_offset, n);
+}
+
+IOStatus Writer::EmitPhysicalRecord(RecordType t, const Slice** part,
+                                    size_t* part_offset, size_t n) {
   assert(n <= 0xffff);  // Must fit in two bytes
 
   size_t header_size;
@@ -126,7 +198,7 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
   buf[6] = static_cast<char>(t);
 
   uint32_t crc = type_crc_[t];
-  if (t < kRecyclableFullType) {
+  if (t < kRecyclableFullType || t == kSetCompressionType) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
     header_size = kHeaderSize;
@@ -145,7 +217,18 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
   }
 
   // Compute the crc of the record type and the payload.
-  crc = crc32c::Extend(crc, ptr, n);
+  const Slice* p = *part;
+  size_t offset = *part_offset;
+  for (size_t left = n; left > 0;) {
+    const size_t len = std::min(p->size() - offset, left);
+    crc = crc32c::Extend(crc, p->data() + offset, len);
+    left -= len;
+    offset += len;
+    if (offset == p->size()) {
+      p++;
+      offset = 0;
+    }
+  }
   crc = crc32c::Mask(crc);  // Adjust for storage
   TEST_SYNC_POINT_CALLBACK("LogWriter::EmitPhysicalRecord:BeforeEncodeChecksum",
                            &crc);
@@ -153,8 +236,18 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
 
   // Write the header and the payload
   IOStatus s = dest_->Append(Slice(buf, header_size));
-  if (s.ok()) {
-    s = dest_->Append(Slice(ptr, n));
+  for (size_t left = n; s.ok() && left > 0;) {
+    const Slice* cur = *part;
+    const size_t len = std::min(cur->size() - *part_offset, left);
+    if (len > 0) {
+      s = dest_->Append(Slice(cur->data() + *part_offset, len));
+    }
+    left -= len;
+    *part_offset += len;
+    if (*part_offset == cur->size()) {
+      (*part)++;
+      *part_offset = 0;
+    }
   }
   block_offset_ += header_size + n;
   return s;
@@ -11,14 +11,17 @@
 #include <stdint.h>
 
 #include <memory>
+#include <string>
 
 #include "db/log_format.h"
+#include "rocksdb/compression_type.h"
 #include "rocksdb/io_status.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+class StreamingCompress;
 class WritableFileWriter;
 
 namespace log {
@@ -65,6 +68,13 @@ namespace log {
  * Same as above, with the addition of
  * Log number = 32bit log file number, so that we can distinguish between
  * records written by the most recent log writer vs a previous one.
+ *
+ * Compressed records:
+ *
+ * A writer created with a compression type first emits a kSetCompressionType
+ * record holding that type (see AddCompressionTypeRecord). The payload of
+ * each following record is then compressed with a streaming context shared
+ * by all the records of the file, and fragmented as above.
  */
 class Writer {
  public:
@@ -73,7 +83,8 @@ class Writer {
   // "*dest" must remain live while this Writer is in use.
   explicit Writer(std::unique_ptr<WritableFileWriter>&& dest,
                   uint64_t log_number, bool recycle_log_files,
-                  bool manual_flush = false);
+                  bool manual_flush = false,
+                  CompressionType compression_type = kNoCompression);
   // No copying allowed
   Writer(const Writer&) = delete;
   void operator=(const Writer&) = delete;
@@ -82,6 +93,15 @@ class Writer {
 
   IOStatus AddRecord(const Slice& slice);
 
+  // Adds the concatenation of parts as a single record, without copying the
+  // parts into a contiguous buffer first (unless the record is compressed).
+  IOStatus AddRecord(const SliceParts& parts);
+
+  // Emits the kSetCompressionType record, which has to be the first record of
+  // a writer created with a compression type other than kNoCompression. The
+  // records added afterwards are compressed.
+  IOStatus AddCompressionTypeRecord();
+
   WritableFileWriter* file() { return dest_.get(); }
   const WritableFileWriter* file() const { return dest_.get(); }
 
@@ -106,9 +126,21 @@ class Writer {
 
   IOStatus EmitPhysicalRecord(RecordType type, const char* ptr, size_t length);
 
+  // Emits the next length bytes of a record made of several parts, starting
+  // at offset *part_offset of **part, and advances *part and *part_offset
+  // past them.
+  IOStatus EmitPhysicalRecord(RecordType type, const Slice** part,
+                              size_t* part_offset, size_t length);
+
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
   bool manual_flush_;
+
+  // Compression of the records, and its state once the kSetCompressionType
+  // record has been emitted.
+  CompressionType compression_type_;
+  std::unique_ptr<StreamingCompress> compress_;
+  std::string compressed_buffer_;
 };
 
 }  // namespace log
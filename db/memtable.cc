@@ -37,6 +37,7 @@
 #include "util/autovector.h"
 #include "util/coding.h"
 #include "util/mutexlock.h"
+#include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -1145,6 +1146,24 @@ size_t MemTable::CountSuccessiveMergeEntries(const LookupKey& key) {
   return num_successive_merges;
 }
 
+void MemTableRep::UniqueRandomSample(const uint64_t num_entries,
+                                     const uint64_t target_sample_size,
+                                     std::unordered_set<const char*>* entries) {
+  // Keep each entry with probability
+  // (samples still to pick) / (entries still to visit).
+  Random* rnd = Random::GetTLSInstance();
+  std::unique_ptr<Iterator> iter(GetIterator());
+  uint64_t visited = 0;
+  uint64_t left = target_sample_size;
+  for (iter->SeekToFirst(); iter->Valid() && left > 0;
+       iter->Next(), visited++) {
+    if (visited >= num_entries || rnd->Next() % (num_entries - visited) < left) {
+      entries->insert(iter->key());
+      left--;
+    }
+  }
+}
+
 void MemTableRep::Get(const LookupKey& k, void* callback_args,
                       bool (*callback_func)(void* arg, const char* entry)) {
   auto iter = GetDynamicPrefixIterator();
@@ -294,6 +294,13 @@ class MemTable {
     return num_entries_.load(std::memory_order_relaxed);
   }
 
+  // Adds about target_sample_size distinct entries of the mem table, picked
+  // at random, to entries. See MemTableRep::UniqueRandomSample().
+  void UniqueRandomSample(const uint64_t target_sample_size,
+                          std::unordered_set<const char*>* entries) {
+    table_->UniqueRandomSample(num_entries(), target_sample_size, entries);
+  }
+
   // Get total number of deletes in the mem table.
   // REQUIRES: external synchronization to prevent simultaneous
   // operations on the same MemTable (unless this Memtable is immutable).
@@ -16,9 +16,13 @@ namespace ROCKSDB_NAMESPACE {
 // of all the key and value.
 class OutputValidator {
  public:
+  // precalculated_hash is the hash of a file whose keys were added to
+  // another validator, e.g. by the worker of a remote compaction.
   explicit OutputValidator(const InternalKeyComparator& icmp,
-                           bool enable_order_check, bool enable_hash)
+                           bool enable_order_check, bool enable_hash,
+                           uint64_t precalculated_hash = 0)
       : icmp_(icmp),
+        paranoid_hash_(precalculated_hash),
         enable_order_check_(enable_order_check),
         enable_hash_(enable_hash) {}
 
@@ -33,11 +37,11 @@ class OutputValidator {
     return GetHash() == other_validator.GetHash();
   }
 
- private:
   // Not (yet) intended to be persisted, so subject to change
   // without notice between releases.
   uint64_t GetHash() const { return paranoid_hash_; }
 
+ private:
   const InternalKeyComparator& icmp_;
   std::string prev_key_;
   uint64_t paranoid_hash_ = 0;
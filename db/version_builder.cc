@@ -306,7 +306,15 @@ class VersionBuilder::Rep {
             return Status::Corruption("L0 files are not sorted properly");
           }
 
-          if (f2->fd.smallest_seqno == f2->fd.largest_seqno) {
+          const Comparator* ucmp =
+              vstorage->InternalComparator()->user_comparator();
+          if (ucmp->Compare(f1->largest.user_key(), f2->smallest.user_key()) <
+                  0 ||
+              ucmp->Compare(f2->largest.user_key(), f1->smallest.user_key()) <
+                  0) {
+            // Files without common user keys, such as the partitions of one
+            // flush, may have interleaved seqnos.
+          } else if (f2->fd.smallest_seqno == f2->fd.largest_seqno) {
             // This is an external file that we ingested
             SequenceNumber external_file_seqno = f2->fd.smallest_seqno;
             if (!(external_file_seqno < f1->fd.largest_seqno ||
@@ -208,6 +208,12 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       PutVarint64(&oldest_blob_file_number, f.oldest_blob_file_number);
       PutLengthPrefixedSlice(dst, Slice(oldest_blob_file_number));
     }
+    if (f.partitioned_flush_id != 0) {
+      PutVarint32(dst, NewFileCustomTag::kPartitionedFlushId);
+      std::string partitioned_flush_id;
+      PutVarint64(&partitioned_flush_id, f.partitioned_flush_id);
+      PutLengthPrefixedSlice(dst, Slice(partitioned_flush_id));
+    }
     TEST_SYNC_POINT_CALLBACK("VersionEdit::EncodeTo:NewFile4:CustomizeFields",
                              dst);
 
@@ -350,6 +356,11 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
             return "invalid oldest blob file number";
           }
           break;
+        case kPartitionedFlushId:
+          if (!GetVarint64(&field, &f.partitioned_flush_id)) {
+            return "invalid partitioned flush id";
+          }
+          break;
         default:
           if ((custom_tag & kCustomTagNonSafeIgnoreMask) != 0) {
             // Should not proceed if cannot understand it
@@ -700,6 +711,10 @@ std::string VersionEdit::DebugString(bool hex_key) const {
       r.append(" blob_file:");
       AppendNumberTo(&r, f.oldest_blob_file_number);
     }
+    if (f.partitioned_flush_id != 0) {
+      r.append(" partitioned_flush:");
+      AppendNumberTo(&r, f.partitioned_flush_id);
+    }
     r.append(" oldest_ancester_time:");
     AppendNumberTo(&r, f.oldest_ancester_time);
     r.append(" file_creation_time:");
@@ -806,6 +821,9 @@ std::string VersionEdit::DebugJSON(int edit_num, bool hex_key) const {
       if (f.oldest_blob_file_number != kInvalidBlobFileNumber) {
         jw << "OldestBlobFile" << f.oldest_blob_file_number;
       }
+      if (f.partitioned_flush_id != 0) {
+        jw << "PartitionedFlush" << f.partitioned_flush_id;
+      }
       jw.EndArrayedObject();
     }
 
@@ -73,6 +73,14 @@ TEST_F(VersionEditTest, EncodeDecodeNewFile4) {
                kUnknownFileCreationTime, kUnknownFileChecksum,
                kUnknownFileChecksumFuncName);
   ;
+  FileMetaData partition(
+      304, 0, 100, InternalKey("foo", kBig + 504, kTypeValue),
+      InternalKey("zoo", kBig + 604, kTypeValue), kBig + 504, kBig + 604,
+      false, kInvalidBlobFileNumber, kUnknownOldestAncesterTime,
+      kUnknownFileCreationTime, kUnknownFileChecksum,
+      kUnknownFileChecksumFuncName);
+  partition.partitioned_flush_id = 302;
+  edit.AddFile(0, partition);
 
   edit.DeleteFile(4, 700);
 
@@ -103,6 +111,8 @@ TEST_F(VersionEditTest, EncodeDecodeNewFile4) {
   ASSERT_EQ(kInvalidBlobFileNumber,
             new_files[2].second.oldest_blob_file_number);
   ASSERT_EQ(1001, new_files[3].second.oldest_blob_file_number);
+  ASSERT_EQ(0u, new_files[3].second.partitioned_flush_id);
+  ASSERT_EQ(302u, new_files[4].second.partitioned_flush_id);
 }
 
 TEST_F(VersionEditTest, ForwardCompatibleNewFile4) {
@@ -14,17 +14,21 @@
 #include <algorithm>
 #include <array>
 #include <cinttypes>
+#include <future>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "cache/cache_helpers.h"
 #include "compaction/compaction.h"
 #include "db/blob/blob_file_cache.h"
 #include "db/blob/blob_file_reader.h"
 #include "db/blob/blob_index.h"
+#include "db/compaction/pipelined_input_iterator.h"
 #include "db/internal_stats.h"
 #include "db/log_reader.h"
 #include "db/log_writer.h"
@@ -35,6 +39,7 @@
 #include "db/table_cache.h"
 #include "db/version_builder.h"
 #include "db/version_edit_handler.h"
+#include "file/async_read_pool.h"
 #include "file/filename.h"
 #include "file/random_access_file_reader.h"
 #include "file/read_write_util.h"
@@ -602,6 +607,11 @@ class FilePickerMultiGet {
   // GetNextFile()) is at the last index in its level.
   bool IsHitFileLastInLevel() { return is_hit_file_last_in_level_; }
 
+  // Returns true if the last key of the most recent "hit file" range may also
+  // have to be looked up in the next file of the level, depending on the
+  // outcome of the lookup in the hit file.
+  bool MaybeRepeatKey() { return maybe_repeat_key_; }
+
   const MultiGetRange& CurrentFileRange() { return current_file_range_; }
 
  private:
@@ -1790,42 +1800,158 @@ Version::Version(ColumnFamilyData* column_family_data, VersionSet* vset,
       version_number_(version_number),
       io_tracer_(io_tracer) {}
 
-Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
-                        PinnableSlice* value) const {
-  assert(value);
+namespace {
+void ReleaseBlobCacheHandle(void* arg1, void* arg2) {
+  Cache* const cache = static_cast<Cache*>(arg1);
+  assert(cache);
 
-  if (read_options.read_tier == kBlockCacheTier) {
-    return Status::Incomplete("Cannot read blob: no disk I/O allowed");
-  }
+  Cache::Handle* const handle = static_cast<Cache::Handle*>(arg2);
+  assert(handle);
 
-  BlobIndex blob_index;
+  cache->Release(handle);
+}
+}  // namespace
+
+Status Version::DecodeBlobIndex(const Slice& value,
+                                BlobIndex* blob_index) const {
+  assert(blob_index);
 
   {
-    Status s = blob_index.DecodeFrom(*value);
+    const Status s = blob_index->DecodeFrom(value);
     if (!s.ok()) {
       return s;
     }
   }
 
-  if (blob_index.HasTTL() || blob_index.IsInlined()) {
+  if (blob_index->HasTTL() || blob_index->IsInlined()) {
     return Status::Corruption("Unexpected TTL/inlined blob index");
   }
 
   const auto& blob_files = storage_info_.GetBlobFiles();
 
-  const uint64_t blob_file_number = blob_index.file_number();
-
-  const auto it = blob_files.find(blob_file_number);
+  const auto it = blob_files.find(blob_index->file_number());
   if (it == blob_files.end()) {
     return Status::Corruption("Invalid blob file number");
   }
 
+  return Status::OK();
+}
+
+Cache* Version::blob_cache() const {
+  return cfd_ ? cfd_->ioptions()->blob_cache.get() : nullptr;
+}
+
+std::string Version::GetBlobCacheKey(const BlobIndex& blob_index) const {
+  assert(blob_cache());
+
+  std::string cache_key = cfd_->blob_cache_key_prefix();
+  PutVarint64(&cache_key, blob_index.file_number());
+  PutVarint64(&cache_key, blob_index.offset());
+
+  return cache_key;
+}
+
+bool Version::GetBlobFromCache(const Slice& cache_key,
+                               PinnableSlice* value) const {
+  assert(value);
+
+  Cache* const cache = blob_cache();
+  assert(cache);
+
+  Cache::Handle* const handle = cache->Lookup(cache_key);
+  if (!handle) {
+    RecordTick(db_statistics_, BLOB_DB_CACHE_MISS);
+    return false;
+  }
+
+  RecordTick(db_statistics_, BLOB_DB_CACHE_HIT);
+
+  const std::string* const cached_value =
+      static_cast<const std::string*>(cache->Value(handle));
+  assert(cached_value);
+
+  // The value stays pinned in the cache until the caller resets it.
+  value->Reset();
+  value->PinSlice(*cached_value, &ReleaseBlobCacheHandle, cache, handle);
+
+  return true;
+}
+
+void Version::AddBlobToCache(const Slice& cache_key,
+                             PinnableSlice* value) const {
+  assert(value);
+
+  Cache* const cache = blob_cache();
+  assert(cache);
+
+  // Hand the buffer the blob was read into over to the cache when the value
+  // owns it, so that a large blob is not copied once more on its first read.
+  std::string* const self = value->GetSelf();
+  const bool owns_buffer = !value->IsPinned() && self != nullptr &&
+                           value->data() == self->data() &&
+                           value->size() == self->size();
+
+  std::unique_ptr<std::string> cached_value(new std::string());
+  if (owns_buffer) {
+    cached_value->swap(*self);
+  } else {
+    cached_value->assign(value->data(), value->size());
+  }
+  const size_t charge = cached_value->size();
+
+  Cache::Handle* handle = nullptr;
+  if (cache
+          ->Insert(cache_key, cached_value.get(), charge,
+                   &DeleteCacheEntry<std::string>, &handle)
+          .ok()) {
+    const std::string* const pinned_value = cached_value.release();
+    RecordTick(db_statistics_, BLOB_DB_CACHE_ADD);
+
+    // The value stays pinned in the cache until the caller resets it.
+    value->Reset();
+    value->PinSlice(*pinned_value, &ReleaseBlobCacheHandle, cache, handle);
+  } else {
+    RecordTick(db_statistics_, BLOB_DB_CACHE_ADD_FAILURES);
+
+    if (owns_buffer) {
+      self->swap(*cached_value);
+      value->PinSelf();
+    }
+  }
+}
+
+Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                        PinnableSlice* value) const {
+  assert(value);
+
+  BlobIndex blob_index;
+
+  {
+    const Status s = DecodeBlobIndex(*value, &blob_index);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  std::string cache_key;
+
+  if (blob_cache()) {
+    cache_key = GetBlobCacheKey(blob_index);
+    if (GetBlobFromCache(cache_key, value)) {
+      return Status::OK();
+    }
+  }
+
+  if (read_options.read_tier == kBlockCacheTier) {
+    return Status::Incomplete("Cannot read blob: no disk I/O allowed");
+  }
+
   CacheHandleGuard<BlobFileReader> blob_file_reader;
 
   {
     assert(blob_file_cache_);
-    const Status s = blob_file_cache_->GetBlobFileReader(blob_file_number,
-                                                         &blob_file_reader);
+    const Status s = blob_file_cache_->GetBlobFileReader(
+        blob_index.file_number(), &blob_file_reader);
     if (!s.ok()) {
       return s;
     }
@@ -1836,9 +1962,128 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
       read_options, user_key, blob_index.offset(), blob_index.size(),
       blob_index.compression(), value);
 
+  if (s.ok() && blob_cache() && read_options.fill_cache) {
+    AddBlobToCache(cache_key, value);
+  }
+
   return s;
 }
 
+void Version::MultiGetBlob(
+    const ReadOptions& read_options,
+    const autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>& blob_keys)
+    const {
+  // A blob that has to be read from its blob file, along with the key it
+  // belongs to.
+  struct PendingBlob {
+    KeyContext* key;
+    Slice user_key;
+    BlobIndex blob_index;
+    std::string cache_key;
+    BlobReadRequest req;
+  };
+
+  std::vector<PendingBlob> pending;
+  pending.reserve(blob_keys.size());
+
+  for (KeyContext* const key : blob_keys) {
+    assert(key);
+    assert(key->value);
+    assert(key->s->ok());
+
+    BlobIndex blob_index;
+
+    {
+      const Status s = DecodeBlobIndex(*key->value, &blob_index);
+      if (!s.ok()) {
+        *key->s = s;
+        continue;
+      }
+    }
+
+    std::string cache_key;
+
+    if (blob_cache()) {
+      cache_key = GetBlobCacheKey(blob_index);
+      if (GetBlobFromCache(cache_key, key->value)) {
+        continue;
+      }
+    }
+
+    if (read_options.read_tier == kBlockCacheTier) {
+      *key->s = Status::Incomplete("Cannot read blob: no disk I/O allowed");
+      continue;
+    }
+
+    pending.push_back({key, key->lkey->user_key(), blob_index,
+                       std::move(cache_key), BlobReadRequest()});
+  }
+
+  // Read the blobs of each file in offset order, so that the reader can
+  // coalesce the reads of adjacent blobs.
+  std::sort(pending.begin(), pending.end(),
+            [](const PendingBlob& lhs, const PendingBlob& rhs) {
+              if (lhs.blob_index.file_number() !=
+                  rhs.blob_index.file_number()) {
+                return lhs.blob_index.file_number() <
+                       rhs.blob_index.file_number();
+              }
+              return lhs.blob_index.offset() < rhs.blob_index.offset();
+            });
+
+  for (size_t begin = 0; begin < pending.size();) {
+    const uint64_t blob_file_number = pending[begin].blob_index.file_number();
+
+    size_t end = begin;
+    while (end < pending.size() &&
+           pending[end].blob_index.file_number() == blob_file_number) {
+      ++end;
+    }
+
+    CacheHandleGuard<BlobFileReader> blob_file_reader;
+
+    {
+      assert(blob_file_cache_);
+      const Status s = blob_file_cache_->GetBlobFileReader(blob_file_number,
+                                                           &blob_file_reader);
+      if (!s.ok()) {
+        for (size_t i = begin; i < end; ++i) {
+          *pending[i].key->s = s;
+        }
+        begin = end;
+        continue;
+      }
+    }
+
+    autovector<BlobReadRequest*> blob_reqs;
+    for (size_t i = begin; i < end; ++i) {
+      PendingBlob& blob = pending[i];
+
+      blob.req.user_key = &blob.user_key;
+      blob.req.offset = blob.blob_index.offset();
+      blob.req.value_size = blob.blob_index.size();
+      blob.req.compression = blob.blob_index.compression();
+      blob.req.result = blob.key->value;
+      blob.req.status = blob.key->s;
+
+      blob_reqs.push_back(&blob.req);
+    }
+
+    assert(blob_file_reader.GetValue());
+    blob_file_reader.GetValue()->MultiGetBlob(read_options, blob_reqs);
+
+    if (blob_cache() && read_options.fill_cache) {
+      for (size_t i = begin; i < end; ++i) {
+        if (pending[i].key->s->ok()) {
+          AddBlobToCache(pending[i].cache_key, pending[i].key->value);
+        }
+      }
+    }
+
+    begin = end;
+  }
+}
+
 void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                   PinnableSlice* value, std::string* timestamp, Status* status,
                   MergeContext* merge_context,
@@ -2026,7 +2271,7 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         iter->ukey_with_ts, iter->value, iter->timestamp, nullptr,
         &(iter->merge_context), true, &iter->max_covering_tombstone_seq,
         this->env_, nullptr, merge_operator_ ? &pinned_iters_mgr : nullptr,
-        callback, is_blob, tracing_mget_id);
+        callback, is_blob ? is_blob : &iter->is_blob_index, tracing_mget_id);
     // MergeInProgress status, if set, has been transferred to the get_context
     // state, so we set status to ok here. From now on, the iter status will
     // be used for IO errors, and get_context state will be used for any
@@ -2050,134 +2295,230 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   uint64_t num_filter_read = 0;
   uint64_t num_data_read = 0;
   uint64_t num_sst_read = 0;
+  // Keys whose values are blob references of the integrated BlobDB. These
+  // are resolved in one batch once all the files have been looked up.
+  autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE> blob_keys;
+
+  // A lookup of a subset of the batch in one file.
+  struct FileLookup {
+    FdWithKeyRange* file;
+    MultiGetRange file_range;
+    bool is_last_in_level;
+    Status s;
+  };
+  // The files of a level other than L0 don't overlap, so unless the same
+  // user key may span two files, the lookups in the different files of the
+  // level are independent. With async_io they are done in parallel, so that
+  // their reads overlap. Merges pin blocks through a shared
+  // PinnedIteratorsManager and are looked up one file at a time.
+  const bool parallel_lookups = read_options.async_io &&
+                                merge_operator_ == nullptr &&
+                                is_blob == nullptr;
 
   while (f != nullptr) {
-    MultiGetRange file_range = fp.CurrentFileRange();
+    const unsigned int level = fp.GetHitFileLevel();
+    autovector<FileLookup, 4> lookups;
+    lookups.push_back(
+        {f, fp.CurrentFileRange(), fp.IsHitFileLastInLevel(), Status()});
+    f = nullptr;
+    if (parallel_lookups && level > 0) {
+      while (!fp.IsHitFileLastInLevel() && !fp.MaybeRepeatKey()) {
+        FdWithKeyRange* next_file = fp.GetNextFile();
+        if (next_file == nullptr) {
+          break;
+        }
+        if (fp.GetHitFileLevel() != level) {
+          // No more keys in this level. Look up next_file after the lookups
+          // of this level are processed.
+          f = next_file;
+          break;
+        }
+        lookups.push_back({next_file, fp.CurrentFileRange(),
+                           fp.IsHitFileLastInLevel(), Status()});
+      }
+    }
+
     bool timer_enabled =
         GetPerfLevel() >= PerfLevel::kEnableTimeExceptForMutex &&
         get_perf_context()->per_level_perf_context_enabled;
     StopWatchNano timer(env_, timer_enabled /* auto_start */);
-    s = table_cache_->MultiGet(
-        read_options, *internal_comparator(), *f->file_metadata, &file_range,
-        mutable_cf_options_.prefix_extractor.get(),
-        cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
-        IsFilterSkipped(static_cast<int>(fp.GetHitFileLevel()),
-                        fp.IsHitFileLastInLevel()),
-        fp.GetHitFileLevel());
+    auto lookup_file = [&](FileLookup* lookup) {
+      lookup->s = table_cache_->MultiGet(
+          read_options, *internal_comparator(), *lookup->file->file_metadata,
+          &lookup->file_range, mutable_cf_options_.prefix_extractor.get(),
+          cfd_->internal_stats()->GetFileReadHist(level),
+          IsFilterSkipped(static_cast<int>(level), lookup->is_last_in_level),
+          level);
+    };
+    if (lookups.size() > 1) {
+      size_t num_lookups = lookups.size();
+      TEST_SYNC_POINT_CALLBACK("Version::MultiGet:ParallelLookups",
+                               &num_lookups);
+      std::vector<std::future<void>> pending;
+      for (size_t i = 1; i < lookups.size(); ++i) {
+        std::shared_ptr<std::promise<void>> done =
+            std::make_shared<std::promise<void>>();
+        pending.push_back(done->get_future());
+        FileLookup* lookup = &lookups[i];
+        AsyncReadThreadPool()->SubmitJob([&lookup_file, lookup, done]() {
+          lookup_file(lookup);
+          done->set_value();
+        });
+      }
+      lookup_file(&lookups[0]);
+      for (auto& p : pending) {
+        p.wait();
+      }
+    } else {
+      lookup_file(&lookups[0]);
+    }
     // TODO: examine the behavior for corrupted key
     if (timer_enabled) {
       PERF_COUNTER_BY_LEVEL_ADD(get_from_table_nanos, timer.ElapsedNanos(),
-                                fp.GetHitFileLevel());
-    }
-    if (!s.ok()) {
-      // TODO: Set status for individual keys appropriately
-      for (auto iter = file_range.begin(); iter != file_range.end(); ++iter) {
-        *iter->s = s;
-        file_range.MarkKeyDone(iter);
-      }
-      return;
+                                level);
     }
-    uint64_t batch_size = 0;
-    for (auto iter = file_range.begin(); s.ok() && iter != file_range.end();
-         ++iter) {
-      GetContext& get_context = *iter->get_context;
-      Status* status = iter->s;
-      // The Status in the KeyContext takes precedence over GetContext state
-      // Status may be an error if there were any IO errors in the table
-      // reader. We never expect Status to be NotFound(), as that is
-      // determined by get_context
-      assert(!status->IsNotFound());
-      if (!status->ok()) {
-        file_range.MarkKeyDone(iter);
-        continue;
-      }
 
-      if (get_context.sample()) {
-        sample_file_read_inc(f->file_metadata);
+    for (auto& lookup : lookups) {
+      MultiGetRange& file_range = lookup.file_range;
+      s = lookup.s;
+      if (!s.ok()) {
+        // TODO: Set status for individual keys appropriately
+        for (auto iter = file_range.begin(); iter != file_range.end();
+             ++iter) {
+          *iter->s = s;
+          file_range.MarkKeyDone(iter);
+        }
+        if (!blob_keys.empty()) {
+          MultiGetBlob(read_options, blob_keys);
+        }
+        return;
       }
-      batch_size++;
-      num_index_read += get_context.get_context_stats_.num_index_read;
-      num_filter_read += get_context.get_context_stats_.num_filter_read;
-      num_data_read += get_context.get_context_stats_.num_data_read;
-      num_sst_read += get_context.get_context_stats_.num_sst_read;
+      uint64_t batch_size = 0;
+      for (auto iter = file_range.begin(); s.ok() && iter != file_range.end();
+           ++iter) {
+        GetContext& get_context = *iter->get_context;
+        Status* status = iter->s;
+        // The Status in the KeyContext takes precedence over GetContext state
+        // Status may be an error if there were any IO errors in the table
+        // reader. We never expect Status to be NotFound(), as that is
+        // determined by get_context
+        assert(!status->IsNotFound());
+        if (!status->ok()) {
+          file_range.MarkKeyDone(iter);
+          continue;
+        }
 
-      // report the counters before returning
-      if (get_context.State() != GetContext::kNotFound &&
-          get_context.State() != GetContext::kMerge &&
-          db_statistics_ != nullptr) {
-        get_context.ReportCounters();
-      } else {
-        if (iter->max_covering_tombstone_seq > 0) {
-          // The remaining files we look at will only contain covered keys, so
-          // we stop here for this key
-          file_picker_range.SkipKey(iter);
+        if (get_context.sample()) {
+          sample_file_read_inc(lookup.file->file_metadata);
         }
-      }
-      switch (get_context.State()) {
-        case GetContext::kNotFound:
-          // Keep searching in other files
-          break;
-        case GetContext::kMerge:
-          // TODO: update per-level perfcontext user_key_return_count for kMerge
-          break;
-        case GetContext::kFound:
-          if (fp.GetHitFileLevel() == 0) {
-            RecordTick(db_statistics_, GET_HIT_L0);
-          } else if (fp.GetHitFileLevel() == 1) {
-            RecordTick(db_statistics_, GET_HIT_L1);
-          } else if (fp.GetHitFileLevel() >= 2) {
-            RecordTick(db_statistics_, GET_HIT_L2_AND_UP);
+        batch_size++;
+        num_index_read += get_context.get_context_stats_.num_index_read;
+        num_filter_read += get_context.get_context_stats_.num_filter_read;
+        num_data_read += get_context.get_context_stats_.num_data_read;
+        num_sst_read += get_context.get_context_stats_.num_sst_read;
+
+        // report the counters before returning
+        if (get_context.State() != GetContext::kNotFound &&
+            get_context.State() != GetContext::kMerge &&
+            db_statistics_ != nullptr) {
+          get_context.ReportCounters();
+        } else {
+          if (iter->max_covering_tombstone_seq > 0) {
+            // The remaining files we look at will only contain covered keys,
+            // so we stop here for this key
+            file_picker_range.SkipKey(iter);
           }
-          PERF_COUNTER_BY_LEVEL_ADD(user_key_return_count, 1,
-                                    fp.GetHitFileLevel());
-          file_range.AddValueSize(iter->value->size());
-          file_range.MarkKeyDone(iter);
-          if (file_range.GetValueSize() > read_options.value_size_soft_limit) {
-            s = Status::Aborted();
+        }
+        switch (get_context.State()) {
+          case GetContext::kNotFound:
+            // Keep searching in other files
             break;
-          }
-          continue;
-        case GetContext::kDeleted:
-          // Use empty error message for speed
-          *status = Status::NotFound();
-          file_range.MarkKeyDone(iter);
-          continue;
-        case GetContext::kCorrupt:
-          *status =
-              Status::Corruption("corrupted key for ", iter->lkey->user_key());
-          file_range.MarkKeyDone(iter);
-          continue;
-        case GetContext::kUnexpectedBlobIndex:
-          ROCKS_LOG_ERROR(info_log_, "Encounter unexpected blob index.");
-          *status = Status::NotSupported(
-              "Encounter unexpected blob index. Please open DB with "
-              "ROCKSDB_NAMESPACE::blob_db::BlobDB instead.");
-          file_range.MarkKeyDone(iter);
-          continue;
+          case GetContext::kMerge:
+            // TODO: update per-level perfcontext user_key_return_count for
+            // kMerge
+            break;
+          case GetContext::kFound:
+            if (level == 0) {
+              RecordTick(db_statistics_, GET_HIT_L0);
+            } else if (level == 1) {
+              RecordTick(db_statistics_, GET_HIT_L1);
+            } else if (level >= 2) {
+              RecordTick(db_statistics_, GET_HIT_L2_AND_UP);
+            }
+            PERF_COUNTER_BY_LEVEL_ADD(user_key_return_count, 1, level);
+            if (is_blob == nullptr && iter->is_blob_index) {
+              blob_keys.push_back(&*iter);
+              // The value is only resolved after the lookups, so charge the
+              // size of the blob the index refers to rather than of the
+              // index itself. A bad index fails in MultiGetBlob().
+              BlobIndex blob_index;
+              if (DecodeBlobIndex(*iter->value, &blob_index).ok()) {
+                file_range.AddValueSize(blob_index.size());
+              } else {
+                file_range.AddValueSize(iter->value->size());
+              }
+            } else {
+              file_range.AddValueSize(iter->value->size());
+            }
+            file_range.MarkKeyDone(iter);
+            if (file_range.GetValueSize() >
+                read_options.value_size_soft_limit) {
+              s = Status::Aborted();
+              break;
+            }
+            continue;
+          case GetContext::kDeleted:
+            // Use empty error message for speed
+            *status = Status::NotFound();
+            file_range.MarkKeyDone(iter);
+            continue;
+          case GetContext::kCorrupt:
+            *status =
+                Status::Corruption("corrupted key for ", iter->lkey->user_key());
+            file_range.MarkKeyDone(iter);
+            continue;
+          case GetContext::kUnexpectedBlobIndex:
+            ROCKS_LOG_ERROR(info_log_, "Encounter unexpected blob index.");
+            *status = Status::NotSupported(
+                "Encounter unexpected blob index. Please open DB with "
+                "ROCKSDB_NAMESPACE::blob_db::BlobDB instead.");
+            file_range.MarkKeyDone(iter);
+            continue;
+        }
       }
-    }
 
-    // Report MultiGet stats per level.
-    if (fp.IsHitFileLastInLevel()) {
-      // Dump the stats if this is the last file of this level and reset for
-      // next level.
-      RecordInHistogram(db_statistics_,
-                        NUM_INDEX_AND_FILTER_BLOCKS_READ_PER_LEVEL,
-                        num_index_read + num_filter_read);
-      RecordInHistogram(db_statistics_, NUM_DATA_BLOCKS_READ_PER_LEVEL,
-                        num_data_read);
-      RecordInHistogram(db_statistics_, NUM_SST_READ_PER_LEVEL, num_sst_read);
-      num_filter_read = 0;
-      num_index_read = 0;
-      num_data_read = 0;
-      num_sst_read = 0;
+      // Report MultiGet stats per level.
+      if (lookup.is_last_in_level) {
+        // Dump the stats if this is the last file of this level and reset for
+        // next level.
+        RecordInHistogram(db_statistics_,
+                          NUM_INDEX_AND_FILTER_BLOCKS_READ_PER_LEVEL,
+                          num_index_read + num_filter_read);
+        RecordInHistogram(db_statistics_, NUM_DATA_BLOCKS_READ_PER_LEVEL,
+                          num_data_read);
+        RecordInHistogram(db_statistics_, NUM_SST_READ_PER_LEVEL,
+                          num_sst_read);
+        num_filter_read = 0;
+        num_index_read = 0;
+        num_data_read = 0;
+        num_sst_read = 0;
+      }
+
+      RecordInHistogram(db_statistics_, SST_BATCH_SIZE, batch_size);
+      if (!s.ok()) {
+        break;
+      }
     }
-
-    RecordInHistogram(db_statistics_, SST_BATCH_SIZE, batch_size);
     if (!s.ok() || file_picker_range.empty()) {
       break;
     }
-    f = fp.GetNextFile();
+    if (f == nullptr) {
+      f = fp.GetNextFile();
+    }
+  }
+
+  if (!blob_keys.empty()) {
+    MultiGetBlob(read_options, blob_keys);
   }
 
   // Process any left over keys
@@ -5556,7 +5897,7 @@ void VersionSet::AddLiveFiles(std::vector<uint64_t>* live_table_files,
 InternalIterator* VersionSet::MakeInputIterator(
     const ReadOptions& read_options, const Compaction* c,
     RangeDelAggregator* range_del_agg,
-    const FileOptions& file_options_compactions) {
+    const FileOptions& file_options_compactions, bool pipelined) {
   auto cfd = c->column_family_data();
   // Level-0 files have to be merged together.  For other levels,
   // we will make a concatenating iterator per level.
@@ -5570,6 +5911,7 @@ InternalIterator* VersionSet::MakeInputIterator(
     if (c->input_levels(which)->num_files != 0) {
       if (c->level(which) == 0) {
         const LevelFilesBrief* flevel = c->input_levels(which);
+        const size_t level0_start = num;
         for (size_t i = 0; i < flevel->num_files; i++) {
           list[num++] = cfd->table_cache()->NewIterator(
               read_options, file_options_compactions,
@@ -5585,7 +5927,43 @@ InternalIterator* VersionSet::MakeInputIterator(
               /*largest_compaction_key=*/nullptr,
               /*allow_unprepared_value=*/false);
         }
+        if (pipelined && num - level0_start > 1) {
+          // Each pipelined iterator has its own reader thread, so merge the
+          // level-0 files first to take one thread per input level.
+          list[level0_start] = NewMergingIterator(
+              &cfd->internal_comparator(), list + level0_start,
+              static_cast<int>(num - level0_start));
+          num = level0_start + 1;
+        }
       } else {
+        RangeDelAggregator* level_range_del_agg = range_del_agg;
+        if (pipelined && range_del_agg != nullptr) {
+          // The level iterator adds the range deletions of a file when it
+          // opens it, which would be on the reader thread of the pipelined
+          // iterator. Add them all up front on this thread instead.
+          const LevelFilesBrief* flevel = c->input_levels(which);
+          const auto* boundaries = c->boundaries(which);
+          for (size_t i = 0; i < flevel->num_files; i++) {
+            std::unique_ptr<InternalIterator> file_iter(
+                cfd->table_cache()->NewIterator(
+                    read_options, file_options_compactions,
+                    cfd->internal_comparator(),
+                    *flevel->files[i].file_metadata, range_del_agg,
+                    c->mutable_cf_options()->prefix_extractor.get(),
+                    /*table_reader_ptr=*/nullptr,
+                    /*file_read_hist=*/nullptr, TableReaderCaller::kCompaction,
+                    /*arena=*/nullptr,
+                    /*skip_filters=*/false,
+                    /*level=*/static_cast<int>(c->level(which)),
+                    /*max_file_size_for_l0_meta_pin=*/0,
+                    boundaries == nullptr ? nullptr : (*boundaries)[i].smallest,
+                    boundaries == nullptr ? nullptr : (*boundaries)[i].largest,
+                    /*allow_unprepared_value=*/false));
+            // An error is reported again by the level iterator
+            file_iter->status().PermitUncheckedError();
+          }
+          level_range_del_agg = nullptr;
+        }
         // Create concatenating iterator for the files from this level
         list[num++] = new LevelIterator(
             cfd->table_cache(), read_options, file_options_compactions,
@@ -5594,12 +5972,17 @@ InternalIterator* VersionSet::MakeInputIterator(
             /*should_sample=*/false,
             /*no per level latency histogram=*/nullptr,
             TableReaderCaller::kCompaction, /*skip_filters=*/false,
-            /*level=*/static_cast<int>(c->level(which)), range_del_agg,
+            /*level=*/static_cast<int>(c->level(which)), level_range_del_agg,
             c->boundaries(which));
       }
     }
   }
   assert(num <= space);
+  if (pipelined) {
+    for (size_t i = 0; i < num; i++) {
+      list[i] = NewPipelinedInputIterator(list[i]);
+    }
+  }
   InternalIterator* result =
       NewMergingIterator(&c->column_family_data()->internal_comparator(), list,
                          static_cast<int>(num));
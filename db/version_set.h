@@ -59,6 +59,7 @@ namespace log {
 class Writer;
 }
 
+class BlobIndex;
 class Compaction;
 class LogBuffer;
 class LookupKey;
@@ -784,6 +785,15 @@ class Version {
   Status GetBlob(const ReadOptions& read_options, const Slice& user_key,
                  PinnableSlice* value) const;
 
+  // Like GetBlob, for the values of a batch of keys found by MultiGet. The
+  // blobs that are not in the blob cache are read with one MultiRead per
+  // blob file. The outcome for each key is stored in its status.
+  // REQUIRES: the values of blob_keys store encoded blob references
+  void MultiGetBlob(
+      const ReadOptions& read_options,
+      const autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>& blob_keys)
+      const;
+
   // Returns true if the filter blocks in the specified level will not be
   // checked during read operations. In certain cases (trivial move or preload),
   // the filter block may already be cached, but we still do not access it such
@@ -804,6 +814,18 @@ class Version {
   // first.
   void UpdateFilesByCompactionPri();
 
+  // Decodes a blob reference and checks that it points into a blob file of
+  // this Version.
+  Status DecodeBlobIndex(const Slice& value, BlobIndex* blob_index) const;
+
+  // The blob cache of the column family (nullptr if there is none), and the
+  // helpers to look up and add blob values in it. Both leave `value` pinned
+  // in the cache when they succeed.
+  Cache* blob_cache() const;
+  std::string GetBlobCacheKey(const BlobIndex& blob_index) const;
+  bool GetBlobFromCache(const Slice& cache_key, PinnableSlice* value) const;
+  void AddBlobToCache(const Slice& cache_key, PinnableSlice* value) const;
+
   ColumnFamilyData* cfd_;  // ColumnFamilyData to which this Version belongs
   Logger* info_log_;
   Statistics* db_statistics_;
@@ -1140,10 +1162,12 @@ class VersionSet {
   // Create an iterator that reads over the compaction inputs for "*c".
   // The caller should delete the iterator when no longer needed.
   // @param read_options Must outlive the returned iterator.
+  // @param pipelined If true, each L0 file and each other level is read
+  // ahead by a thread of its own, see NewPipelinedInputIterator().
   InternalIterator* MakeInputIterator(
       const ReadOptions& read_options, const Compaction* c,
       RangeDelAggregator* range_del_agg,
-      const FileOptions& file_options_compactions);
+      const FileOptions& file_options_compactions, bool pipelined = false);
 
   // Add all files listed in any live version to *live_table_files and
   // *live_blob_files. Note that these lists may contain duplicates.
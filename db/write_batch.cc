@@ -2129,6 +2129,20 @@ Status WriteBatchInternal::Append(WriteBatch* dst, const WriteBatch* src,
   return Status::OK();
 }
 
+Slice WriteBatchInternal::RecordsForWAL(const WriteBatch* batch,
+                                        uint32_t* count) {
+  assert(batch->rep_.size() >= WriteBatchInternal::kHeader);
+  const SavePoint& batch_end = batch->GetWalTerminationPoint();
+  if (!batch_end.is_cleared()) {
+    *count = batch_end.count;
+    return Slice(batch->rep_.data() + WriteBatchInternal::kHeader,
+                 batch_end.size - WriteBatchInternal::kHeader);
+  }
+  *count = Count(batch);
+  return Slice(batch->rep_.data() + WriteBatchInternal::kHeader,
+               batch->rep_.size() - WriteBatchInternal::kHeader);
+}
+
 size_t WriteBatchInternal::AppendedByteSize(size_t leftByteSize,
                                             size_t rightByteSize) {
   if (leftByteSize == 0 || rightByteSize == 0) {
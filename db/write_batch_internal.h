@@ -131,6 +131,11 @@ class WriteBatchInternal {
   // This offset is only valid if the batch is not empty.
   static size_t GetFirstOffset(WriteBatch* batch);
 
+  // Returns the records of batch that Append(dst, batch, /*WAL_only*/ true)
+  // would copy, i.e. the records up to its WAL termination point if it is
+  // set, and sets *count to their number.
+  static Slice RecordsForWAL(const WriteBatch* batch, uint32_t* count);
+
   static Slice Contents(const WriteBatch* batch) {
     return Slice(batch->rep_);
   }
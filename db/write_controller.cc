@@ -5,6 +5,7 @@
 
 #include "db/write_controller.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <ratio>
@@ -125,4 +126,90 @@ CompactionPressureToken::~CompactionPressureToken() {
   assert(controller_->total_compaction_pressure_ >= 0);
 }
 
+namespace {
+// Compaction throughput is averaged over roughly this window. Compactions
+// report their output only when they finish, so a shorter window would make
+// the estimate jump with every compaction.
+const double kThroughputWindowMicros = 10.0 * 1000 * 1000;
+// A debt twice the target halves the rate on the proportional term alone.
+const double kProportionalGain = 0.5;
+// Per second spent above the target.
+const double kIntegralGain = 0.05;
+const double kMaxIntegral = 20.0;
+// Bound the change applied by a single update so the rate moves smoothly.
+const double kMaxStepRatio = 2.0;
+}  // namespace
+
+void PendingCompactionBytesController::Reset() {
+  last_update_micros_ = 0;
+  last_compacted_bytes_ = 0;
+  compaction_bytes_per_sec_ = 0;
+  write_amplification_ = 1;
+  integral_ = 0;
+  write_rate_ = 0;
+}
+
+uint64_t PendingCompactionBytesController::Update(
+    uint64_t now_micros, uint64_t pending_bytes, uint64_t target_bytes,
+    uint64_t compacted_bytes, uint64_t ingested_bytes, uint64_t min_rate,
+    uint64_t max_rate) {
+  assert(min_rate <= max_rate);
+  if (write_rate_ == 0 || now_micros < last_update_micros_ ||
+      compacted_bytes < last_compacted_bytes_) {
+    // First observation, or the clock or the stats went backwards: start
+    // measuring from here.
+    Reset();
+    last_update_micros_ = now_micros;
+    last_compacted_bytes_ = compacted_bytes;
+    write_rate_ = max_rate;
+    return write_rate_;
+  }
+
+  double elapsed_micros =
+      static_cast<double>(now_micros - last_update_micros_);
+  if (elapsed_micros > 0) {
+    double weight = std::min(1.0, elapsed_micros / kThroughputWindowMicros);
+    double sample =
+        static_cast<double>(compacted_bytes - last_compacted_bytes_) *
+        1000000.0 / elapsed_micros;
+    compaction_bytes_per_sec_ =
+        compaction_bytes_per_sec_ * (1 - weight) + sample * weight;
+  }
+  if (ingested_bytes > 0) {
+    write_amplification_ =
+        std::max(1.0, static_cast<double>(compacted_bytes) /
+                          static_cast<double>(ingested_bytes));
+  }
+
+  double error = 0;
+  if (target_bytes > 0) {
+    error = (static_cast<double>(pending_bytes) -
+             static_cast<double>(target_bytes)) /
+            static_cast<double>(target_bytes);
+  }
+  // Only time spent above the target is remembered, so a long quiet period
+  // does not let the debt overshoot once writes pick up again.
+  integral_ += error * elapsed_micros / 1000000.0;
+  integral_ = std::max(0.0, std::min(kMaxIntegral, integral_));
+
+  double correction = 1 - kProportionalGain * error - kIntegralGain * integral_;
+  correction = std::max(0.0, std::min(kMaxStepRatio, correction));
+
+  // Until a compaction has finished there is no throughput to go by, so
+  // correct the configured rate instead.
+  double base = compaction_bytes_per_sec_ > 0
+                    ? compaction_bytes_per_sec_ / write_amplification_
+                    : static_cast<double>(max_rate);
+  double rate = base * correction;
+  rate = std::max(rate, static_cast<double>(write_rate_) / kMaxStepRatio);
+  rate = std::min(rate, static_cast<double>(write_rate_) * kMaxStepRatio);
+  rate = std::max(rate, static_cast<double>(min_rate));
+  rate = std::min(rate, static_cast<double>(max_rate));
+
+  write_rate_ = static_cast<uint64_t>(rate);
+  last_update_micros_ = now_micros;
+  last_compacted_bytes_ = compacted_bytes;
+  return write_rate_;
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -141,4 +141,47 @@ class CompactionPressureToken : public WriteControllerToken {
   virtual ~CompactionPressureToken();
 };
 
+// Computes the delayed write rate for a column family that sets
+// pending_compaction_bytes_target. The static slowdown triggers change the
+// rate in fixed steps each time a threshold is crossed. This controller
+// derives it from what compactions have actually been doing instead. The
+// measured compaction throughput divided by the write amplification is the
+// ingest rate that compactions can sustain. A proportional-integral
+// correction on the distance between the pending compaction bytes and the
+// target then moves the debt back toward the target.
+// Not thread-safe. The owner calls it with the DB mutex held.
+class PendingCompactionBytesController {
+ public:
+  PendingCompactionBytesController() { Reset(); }
+
+  // Takes one observation at `now_micros` and returns the write rate to use,
+  // clamped to [min_rate, max_rate]. `compacted_bytes` is the cumulative
+  // number of bytes written by compactions. `ingested_bytes` is the
+  // cumulative number of bytes written by flushes and file ingestion.
+  uint64_t Update(uint64_t now_micros, uint64_t pending_bytes,
+                  uint64_t target_bytes, uint64_t compacted_bytes,
+                  uint64_t ingested_bytes, uint64_t min_rate,
+                  uint64_t max_rate);
+
+  // Forgets all observations, e.g. after the target was turned off.
+  void Reset();
+
+  // Smoothed bytes per second written by compactions.
+  double compaction_bytes_per_sec() const { return compaction_bytes_per_sec_; }
+  // Bytes written by compactions per ingested byte, at least 1.
+  double write_amplification() const { return write_amplification_; }
+  // Accumulated error, in target-relative units times seconds.
+  double integral() const { return integral_; }
+  // Rate returned by the last call to Update(), 0 before the first one.
+  uint64_t write_rate() const { return write_rate_; }
+
+ private:
+  uint64_t last_update_micros_;
+  uint64_t last_compacted_bytes_;
+  double compaction_bytes_per_sec_;
+  double write_amplification_;
+  double integral_;
+  uint64_t write_rate_;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -127,6 +127,77 @@ TEST_F(WriteControllerTest, SanityTest) {
   ASSERT_FALSE(controller.IsStopped());
 }
 
+TEST_F(WriteControllerTest, PendingCompactionBytesController) {
+  const uint64_t kSecond = 1000000;
+  const uint64_t kTarget = 1 << 30;
+  const uint64_t kMinRate = 16 << 10;
+  const uint64_t kMaxRate = 64 << 20;
+  PendingCompactionBytesController controller;
+
+  uint64_t now = kSecond;
+  uint64_t compacted = 0;
+  uint64_t ingested = 0;
+  ASSERT_EQ(kMaxRate, controller.Update(now, kTarget, kTarget, compacted,
+                                        ingested, kMinRate, kMaxRate));
+
+  // Compactions write 10MB/s while 2MB/s is flushed, so they can sustain
+  // 2MB/s of ingest. With the debt at the target, the rate settles there.
+  uint64_t rate = 0;
+  for (int i = 0; i < 100; ++i) {
+    now += kSecond;
+    compacted += 10 << 20;
+    ingested += 2 << 20;
+    rate = controller.Update(now, kTarget, kTarget, compacted, ingested,
+                             kMinRate, kMaxRate);
+  }
+  ASSERT_NEAR(5.0, controller.write_amplification(), 0.01);
+  ASSERT_NEAR(10 << 20, controller.compaction_bytes_per_sec(), 1 << 16);
+  ASSERT_NEAR(2 << 20, rate, 1 << 14);
+  ASSERT_EQ(0, controller.integral());
+
+  // Twice the target: the proportional and integral terms ask for less than
+  // half the rate, but one update only goes half way. The integral term keeps
+  // pushing the rate down for as long as the debt stays.
+  now += kSecond;
+  compacted += 10 << 20;
+  ingested += 2 << 20;
+  uint64_t above_rate = controller.Update(now, 2 * kTarget, kTarget, compacted,
+                                          ingested, kMinRate, kMaxRate);
+  ASSERT_NEAR(rate / 2.0, above_rate, 1);
+  now += kSecond;
+  compacted += 10 << 20;
+  ingested += 2 << 20;
+  ASSERT_LT(controller.Update(now, 2 * kTarget, kTarget, compacted, ingested,
+                              kMinRate, kMaxRate),
+            above_rate);
+
+  // Below the target the accumulated error drains and writes may go faster
+  // than compactions alone would sustain.
+  for (int i = 0; i < 10; ++i) {
+    now += kSecond;
+    compacted += 10 << 20;
+    ingested += 2 << 20;
+    rate = controller.Update(now, kTarget / 2, kTarget, compacted, ingested,
+                             kMinRate, kMaxRate);
+  }
+  ASSERT_EQ(0, controller.integral());
+  ASSERT_GT(rate, 2 << 20);
+
+  // A debt far above the target never goes below the minimum rate.
+  for (int i = 0; i < 100; ++i) {
+    now += kSecond;
+    rate = controller.Update(now, 100 * kTarget, kTarget, compacted, ingested,
+                             kMinRate, kMaxRate);
+  }
+  ASSERT_EQ(kMinRate, rate);
+
+  // Time going backwards restarts the measurement.
+  ASSERT_EQ(kMaxRate, controller.Update(now - kSecond, kTarget, kTarget,
+                                        compacted, ingested, kMinRate,
+                                        kMaxRate));
+  ASSERT_EQ(0, controller.compaction_bytes_per_sec());
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
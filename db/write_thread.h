@@ -70,6 +70,14 @@ class WriteThread {
     // A state indicating that the thread may be waiting using StateMutex()
     // and StateCondVar()
     STATE_LOCKED_WAITING = 32,
+
+    // The state used to inform a waiting writer that it has become a
+    // parallel memtable writer, and that it has to wake up some of the other
+    // writers of its large parallel group first, see
+    // LaunchParallelMemTableWriters. The writer should call
+    // SetMemWritersEachStride, which moves it to
+    // STATE_PARALLEL_MEMTABLE_WRITER.
+    STATE_PARALLEL_MEMTABLE_CALLER = 64,
   };
 
   struct Writer;
@@ -311,9 +319,20 @@ class WriteThread {
   // non-leader members of this write batch group.  Sets Writer::sequence
   // before waking them up.
   //
+  // Waking up the writers of a large group one by one would make the leader
+  // the bottleneck of the group, so for groups of at least
+  // kMinParallelCallerGroupSize writers the leader only wakes up about
+  // sqrt(size) of them in STATE_PARALLEL_MEMTABLE_CALLER, each of which then
+  // wakes up its share of the rest of the group.
+  //
   // WriteGroup* write_group: Extra state used to coordinate the parallel add
   void LaunchParallelMemTableWriters(WriteGroup* write_group);
 
+  // Sets w, and every stride-th writer of its group after w, to
+  // STATE_PARALLEL_MEMTABLE_WRITER, where stride is sqrt(group size). Called
+  // by the leader and the writers in STATE_PARALLEL_MEMTABLE_CALLER.
+  void SetMemWritersEachStride(Writer* w);
+
   // Reports the completion of w's batch to the parallel group leader, and
   // waits for the rest of the parallel batch to complete.  Returns true
   // if this thread is the last to complete, and hence should advance
@@ -352,6 +371,10 @@ class WriteThread {
   void EndWriteStall();
 
  private:
+  // The smallest parallel memtable write group whose writers are woken up
+  // by STATE_PARALLEL_MEMTABLE_CALLER writers in addition to the leader.
+  static constexpr size_t kMinParallelCallerGroupSize = 20;
+
   // See AwaitState.
   const uint64_t max_yield_usec_;
   const uint64_t slow_yield_usec_;
@@ -25,7 +25,7 @@ StressTest::StressTest()
       filter_policy_(
           FLAGS_bloom_bits >= 0
               ? FLAGS_use_ribbon_filter
-                    ? NewExperimentalRibbonFilterPolicy(FLAGS_bloom_bits)
+                    ? NewRibbonFilterPolicy(FLAGS_bloom_bits)
                     : FLAGS_use_block_based_filter
                           ? NewBloomFilterPolicy(FLAGS_bloom_bits, true)
                           : NewBloomFilterPolicy(FLAGS_bloom_bits, false)
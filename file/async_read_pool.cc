@@ -0,0 +1,21 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "file/async_read_pool.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+const int kNumAsyncReadThreads = 8;
+}  // namespace
+
+ThreadPool* AsyncReadThreadPool() {
+  // Intentionally leaked, so that it outlives any static object waiting for
+  // one of its jobs.
+  static ThreadPool* pool = NewThreadPool(kNumAsyncReadThreads);
+  return pool;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
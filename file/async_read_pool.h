@@ -0,0 +1,18 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include "rocksdb/threadpool.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Returns the process-wide thread pool running the reads that are issued in
+// the background on behalf of a user request (see ReadOptions::async_io),
+// such as iterator readahead and parallel MultiGet lookups. The jobs
+// submitted to it must not wait for other jobs of the pool.
+extern ThreadPool* AsyncReadThreadPool();
+
+}  // namespace ROCKSDB_NAMESPACE
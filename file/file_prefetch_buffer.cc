@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <mutex>
 
+#include "file/async_read_pool.h"
 #include "file/random_access_file_reader.h"
 #include "monitoring/histogram.h"
 #include "monitoring/iostats_context_imp.h"
@@ -21,6 +22,11 @@
 #include "util/rate_limiter.h"
 
 namespace ROCKSDB_NAMESPACE {
+FilePrefetchBuffer::~FilePrefetchBuffer() {
+  // The background read refers to async_buffer_.
+  WaitForAsyncRead().PermitUncheckedError();
+}
+
 Status FilePrefetchBuffer::Prefetch(const IOOptions& opts,
                                     RandomAccessFileReader* reader,
                                     uint64_t offset, size_t n,
@@ -113,7 +119,13 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
   if (track_min_offset_ && offset < min_offset_read_) {
     min_offset_read_ = static_cast<size_t>(offset);
   }
-  if (!enable_ || offset < buffer_offset_) {
+  if (!enable_) {
+    return false;
+  }
+  if (async_io_ && !for_compaction && readahead_size_ > 0) {
+    return TryReadFromCacheAsync(opts, offset, n, result);
+  }
+  if (offset < buffer_offset_) {
     return false;
   }
 
@@ -149,4 +161,119 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
   *result = Slice(buffer_.BufferStart() + offset_in_buffer, n);
   return true;
 }
+
+bool FilePrefetchBuffer::TryReadFromCacheAsync(const IOOptions& opts,
+                                               uint64_t offset, size_t n,
+                                               Slice* result) {
+  assert(file_reader_ != nullptr);
+  assert(max_readahead_size_ >= readahead_size_);
+  if (offset >= buffer_offset_ &&
+      offset + n <= buffer_offset_ + buffer_.CurrentSize()) {
+    uint64_t offset_in_buffer = offset - buffer_offset_;
+    *result = Slice(buffer_.BufferStart() + offset_in_buffer, n);
+    return true;
+  }
+
+  // The requested bytes are not all in the current buffer. They are expected
+  // to be in the one being read in the background, following it.
+  Status s = WaitForAsyncRead();
+  uint64_t buffer_end = buffer_offset_ + buffer_.CurrentSize();
+  uint64_t async_end = async_buffer_offset_ + async_buffer_.CurrentSize();
+  if (s.ok() && async_buffer_.CurrentSize() > 0 && offset + n <= async_end &&
+      offset >= async_buffer_offset_) {
+    // All in the background buffer: consume it while the next one is read.
+    std::swap(buffer_, async_buffer_);
+    buffer_offset_ = async_buffer_offset_;
+    TEST_SYNC_POINT("FilePrefetchBuffer::TryReadFromCacheAsync:SwitchBuffer");
+  } else if (s.ok() && async_buffer_.CurrentSize() > 0 &&
+             offset + n <= async_end && offset >= buffer_offset_ &&
+             buffer_end == async_buffer_offset_) {
+    // Straddling both buffers: keep the needed tail of the current buffer
+    // and append the background buffer to it.
+    size_t alignment = buffer_.Alignment();
+    size_t tail_offset =
+        Rounddown(static_cast<size_t>(offset - buffer_offset_), alignment);
+    size_t tail_len = buffer_.CurrentSize() - tail_offset;
+    assert(tail_len > 0);
+    size_t new_size = tail_len + async_buffer_.CurrentSize();
+    if (buffer_.Capacity() < new_size) {
+      buffer_.AllocateNewBuffer(new_size, true /* copy_data */, tail_offset,
+                                tail_len);
+    } else {
+      buffer_.RefitTail(tail_offset, tail_len);
+    }
+    size_t appended __attribute__((__unused__)) = buffer_.Append(
+        async_buffer_.BufferStart(), async_buffer_.CurrentSize());
+    assert(appended == async_buffer_.CurrentSize());
+    buffer_offset_ += tail_offset;
+    TEST_SYNC_POINT("FilePrefetchBuffer::TryReadFromCacheAsync:SwitchBuffer");
+  } else {
+    // Not a sequential read, or the background read failed: read
+    // synchronously, as without async_io.
+    s = Prefetch(opts, file_reader_, offset, n + readahead_size_);
+    if (!s.ok()) {
+#ifndef NDEBUG
+      IGNORE_STATUS_IF_ERROR(s);
+#endif
+      return false;
+    }
+    if (offset + n > buffer_offset_ + buffer_.CurrentSize()) {
+      // Reading past the end of the file.
+      return false;
+    }
+  }
+  async_buffer_.Size(0);
+  readahead_size_ = std::min(max_readahead_size_, readahead_size_ * 2);
+
+  // Keep the next readahead in flight while the caller consumes buffer_.
+  ScheduleAsyncRead(opts, buffer_offset_ + buffer_.CurrentSize(),
+                    readahead_size_);
+
+  uint64_t offset_in_buffer = offset - buffer_offset_;
+  *result = Slice(buffer_.BufferStart() + offset_in_buffer, n);
+  return true;
+}
+
+void FilePrefetchBuffer::ScheduleAsyncRead(const IOOptions& opts,
+                                           uint64_t offset, size_t n) {
+  assert(!async_read_.valid());
+  size_t alignment = file_reader_->file()->GetRequiredBufferAlignment();
+  async_buffer_.Alignment(alignment);
+  if (async_buffer_.Capacity() < n) {
+    async_buffer_.AllocateNewBuffer(n);
+  }
+  async_buffer_.Size(0);
+  async_buffer_offset_ = offset;
+
+  std::shared_ptr<std::promise<Status>> promise =
+      std::make_shared<std::promise<Status>>();
+  async_read_ = promise->get_future();
+  TEST_SYNC_POINT("FilePrefetchBuffer::ScheduleAsyncRead");
+  RandomAccessFileReader* reader = file_reader_;
+  AlignedBuffer* buffer = &async_buffer_;
+  AsyncReadThreadPool()->SubmitJob([promise, reader, buffer, opts, offset,
+                                    n]() {
+    Slice result;
+    Status s = reader->Read(opts, offset, n, &result, buffer->BufferStart(),
+                            nullptr /* aligned_buf */);
+    if (s.ok()) {
+      if (result.data() != buffer->BufferStart()) {
+        memmove(buffer->BufferStart(), result.data(), result.size());
+      }
+      buffer->Size(result.size());
+    }
+    promise->set_value(s);
+  });
+}
+
+Status FilePrefetchBuffer::WaitForAsyncRead() {
+  if (!async_read_.valid()) {
+    return Status::OK();
+  }
+  Status s = async_read_.get();
+  if (!s.ok()) {
+    async_buffer_.Size(0);
+  }
+  return s;
+}
 }  // namespace ROCKSDB_NAMESPACE
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <atomic>
+#include <future>
 #include <sstream>
 #include <string>
 
@@ -38,6 +39,9 @@ class FilePrefetchBuffer {
   //   for the minimum offset if track_min_offset = true.
   // track_min_offset : Track the minimum offset ever read and collect stats on
   //   it. Used for adaptable readahead of the file footer/metadata.
+  // async_io : if true, readahead done by TryReadFromCache() reads the next
+  //   readahead_size bytes into a second buffer in the background, while the
+  //   current buffer is consumed. Doesn't apply to compaction reads.
   //
   // Automatic readhead is enabled for a file if file_reader, readahead_size,
   // and max_readahead_size are passed in.
@@ -47,14 +51,19 @@ class FilePrefetchBuffer {
   // `Prefetch` to load data into the buffer.
   FilePrefetchBuffer(RandomAccessFileReader* file_reader = nullptr,
                      size_t readadhead_size = 0, size_t max_readahead_size = 0,
-                     bool enable = true, bool track_min_offset = false)
+                     bool enable = true, bool track_min_offset = false,
+                     bool async_io = false)
       : buffer_offset_(0),
         file_reader_(file_reader),
         readahead_size_(readadhead_size),
         max_readahead_size_(max_readahead_size),
         min_offset_read_(port::kMaxSizet),
         enable_(enable),
-        track_min_offset_(track_min_offset) {}
+        track_min_offset_(track_min_offset),
+        async_io_(async_io && file_reader != nullptr),
+        async_buffer_offset_(0) {}
+
+  ~FilePrefetchBuffer();
 
   // Load data into the buffer from a file.
   // reader : the file reader.
@@ -82,6 +91,19 @@ class FilePrefetchBuffer {
   size_t min_offset_read() const { return min_offset_read_; }
 
  private:
+  // TryReadFromCache() with async_io: serve from the current buffer, switch
+  // to the background buffer once it holds the requested bytes, and keep the
+  // next readahead in flight.
+  bool TryReadFromCacheAsync(const IOOptions& opts, uint64_t offset, size_t n,
+                             Slice* result);
+
+  // Start reading n bytes at offset into async_buffer_ in the background.
+  void ScheduleAsyncRead(const IOOptions& opts, uint64_t offset, size_t n);
+
+  // Wait for the background read, if any, to complete and return its status.
+  // async_buffer_ is empty if the read failed.
+  Status WaitForAsyncRead();
+
   AlignedBuffer buffer_;
   uint64_t buffer_offset_;
   RandomAccessFileReader* file_reader_;
@@ -95,5 +117,13 @@ class FilePrefetchBuffer {
   // If true, track minimum `offset` ever passed to TryReadFromCache(), which
   // can be fetched from min_offset_read().
   bool track_min_offset_;
+
+  bool async_io_;
+  // The buffer filled in the background with the bytes following buffer_,
+  // and the file offset of its first byte.
+  AlignedBuffer async_buffer_;
+  uint64_t async_buffer_offset_;
+  // Valid while a background read into async_buffer_ hasn't been waited for.
+  std::future<Status> async_read_;
 };
 }  // namespace ROCKSDB_NAMESPACE
@@ -27,6 +27,15 @@ Status RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
                                     AlignedBuf* aligned_buf,
                                     bool for_compaction) const {
   (void)aligned_buf;
+  // Compaction reads are charged to IO_LOW unless their ReadOptions say
+  // otherwise. Other reads are only charged if their ReadOptions ask for it.
+  Env::IOPriority rate_limiter_priority = opts.rate_limiter_priority;
+  if (rate_limiter_priority == Env::IO_TOTAL && for_compaction) {
+    rate_limiter_priority = Env::IO_LOW;
+  }
+  if (rate_limiter_ == nullptr) {
+    rate_limiter_priority = Env::IO_TOTAL;
+  }
 
   TEST_SYNC_POINT_CALLBACK("RandomAccessFileReader::Read", nullptr);
   Status s;
@@ -50,10 +59,10 @@ Status RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
       buf.AllocateNewBuffer(read_size);
       while (buf.CurrentSize() < read_size) {
         size_t allowed;
-        if (for_compaction && rate_limiter_ != nullptr) {
+        if (rate_limiter_priority != Env::IO_TOTAL) {
           allowed = rate_limiter_->RequestToken(
               buf.Capacity() - buf.CurrentSize(), buf.Alignment(),
-              Env::IOPriority::IO_LOW, stats_, RateLimiter::OpType::kRead);
+              rate_limiter_priority, stats_, RateLimiter::OpType::kRead);
         } else {
           assert(buf.CurrentSize() == 0);
           allowed = read_size;
@@ -69,11 +78,13 @@ Status RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
 
         {
           IOSTATS_CPU_TIMER_GUARD(cpu_read_nanos, env_);
-          // Only user reads are expected to specify a timeout. And user reads
-          // are not subjected to rate_limiter and should go through only
-          // one iteration of this loop, so we don't need to check and adjust
-          // the opts.timeout before calling file_->Read
-          assert(!opts.timeout.count() || allowed == read_size);
+          // Only user reads are expected to specify a timeout. Unless they
+          // are rate limited, user reads should go through only one
+          // iteration of this loop, so we don't need to check and adjust
+          // the opts.timeout before calling file_->Read. A rate limited read
+          // gets the whole timeout for each of its parts.
+          assert(!opts.timeout.count() || allowed == read_size ||
+                 rate_limiter_priority != Env::IO_TOTAL);
           s = file_->Read(aligned_offset + buf.CurrentSize(), allowed, opts,
                           &tmp, buf.Destination(), nullptr);
         }
@@ -105,12 +116,12 @@ Status RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
       const char* res_scratch = nullptr;
       while (pos < n) {
         size_t allowed;
-        if (for_compaction && rate_limiter_ != nullptr) {
+        if (rate_limiter_priority != Env::IO_TOTAL) {
           if (rate_limiter_->IsRateLimited(RateLimiter::OpType::kRead)) {
             sw.DelayStart();
           }
           allowed = rate_limiter_->RequestToken(n - pos, 0 /* alignment */,
-                                                Env::IOPriority::IO_LOW, stats_,
+                                                rate_limiter_priority, stats_,
                                                 RateLimiter::OpType::kRead);
           if (rate_limiter_->IsRateLimited(RateLimiter::OpType::kRead)) {
             sw.DelayStop();
@@ -129,11 +140,13 @@ Status RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
 
         {
           IOSTATS_CPU_TIMER_GUARD(cpu_read_nanos, env_);
-          // Only user reads are expected to specify a timeout. And user reads
-          // are not subjected to rate_limiter and should go through only
-          // one iteration of this loop, so we don't need to check and adjust
-          // the opts.timeout before calling file_->Read
-          assert(!opts.timeout.count() || allowed == n);
+          // Only user reads are expected to specify a timeout. Unless they
+          // are rate limited, user reads should go through only one
+          // iteration of this loop, so we don't need to check and adjust
+          // the opts.timeout before calling file_->Read. A rate limited read
+          // gets the whole timeout for each of its parts.
+          assert(!opts.timeout.count() || allowed == n ||
+                 rate_limiter_priority != Env::IO_TOTAL);
           s = file_->Read(offset + pos, allowed, opts, &tmp_result,
                           scratch + pos, nullptr);
         }
@@ -16,6 +16,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Cache;
 class Slice;
 class SliceTransform;
 class TablePropertiesCollectorFactory;
@@ -555,6 +556,22 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   uint64_t hard_pending_compaction_bytes_limit = 256 * 1073741824ull;
 
+  // If non-zero, writes are throttled by a feedback controller that steers
+  // estimated pending compaction bytes toward this value, instead of waiting
+  // for soft_pending_compaction_bytes_limit to be crossed. While the debt is
+  // above the target, the delayed write rate follows the measured compaction
+  // throughput divided by the write amplification, with a
+  // proportional-integral correction on the distance from the target. It is
+  // never raised above delayed_write_rate. Past
+  // soft_pending_compaction_bytes_limit the same rate is used instead of the
+  // step-wise slowdown. The L0 and memtable triggers and the hard limits
+  // behave as before. Should be set below soft_pending_compaction_bytes_limit.
+  //
+  // Default: 0 (disabled)
+  //
+  // Dynamically changeable through SetOptions() API
+  uint64_t pending_compaction_bytes_target = 0;
+
   // The compaction style. Default: kCompactionStyleLevel
   CompactionStyle compaction_style = kCompactionStyleLevel;
 
@@ -798,6 +815,17 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   double blob_garbage_collection_age_cutoff = 0.25;
 
+  // UNDER CONSTRUCTION -- DO NOT USE
+  // A cache for the uncompressed values read from blob files, keyed by blob
+  // file number and offset. If nullptr, blob values are not cached. Passing
+  // the same Cache object as BlockBasedTableOptions::block_cache makes blobs
+  // and blocks share a single memory budget.
+  //
+  // Default: nullptr (disabled)
+  //
+  // Not dynamically changeable through SetOptions()
+  std::shared_ptr<Cache> blob_cache = nullptr;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
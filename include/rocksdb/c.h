@@ -2171,6 +2171,22 @@ extern ROCKSDB_LIBRARY_API rocksdb_pinnableslice_t* rocksdb_get_pinned_cf(
     rocksdb_t* db, const rocksdb_readoptions_t* options,
     rocksdb_column_family_handle_t* column_family, const char* key,
     size_t keylen, char** errptr);
+// Batched variants of rocksdb_get_pinned(), which look up num_keys keys of a
+// single column family with one MultiGet.
+// values and errs must be num_keys in length, allocated by the caller.
+// values[i] is a pinnable slice to be destroyed with
+// rocksdb_pinnableslice_destroy(), or NULL if keys_list[i] was not found or
+// its lookup failed, in which case errs[i] is set as in rocksdb_multi_get().
+// The values found in the block cache or in the blob cache are not copied.
+extern ROCKSDB_LIBRARY_API void rocksdb_multi_get_pinned(
+    rocksdb_t* db, const rocksdb_readoptions_t* options, size_t num_keys,
+    const char* const* keys_list, const size_t* keys_list_sizes,
+    rocksdb_pinnableslice_t** values, char** errs);
+extern ROCKSDB_LIBRARY_API void rocksdb_multi_get_pinned_cf(
+    rocksdb_t* db, const rocksdb_readoptions_t* options,
+    rocksdb_column_family_handle_t* column_family, size_t num_keys,
+    const char* const* keys_list, const size_t* keys_list_sizes,
+    rocksdb_pinnableslice_t** values, char** errs);
 extern ROCKSDB_LIBRARY_API void rocksdb_pinnableslice_destroy(
     rocksdb_pinnableslice_t* v);
 extern ROCKSDB_LIBRARY_API const char* rocksdb_pinnableslice_value(
@@ -221,6 +221,20 @@ class DB {
       const std::vector<ColumnFamilyDescriptor>& column_families,
       std::vector<ColumnFamilyHandle*>* handles, DB** dbptr);
 
+  // EXPERIMENTAL
+  // Runs, on behalf of a CompactionService, the compaction described by
+  // `input` (as passed to CompactionService::Start()) over the DB `name`.
+  // The DB is opened as a secondary instance with `output_directory` as its
+  // secondary path, and the output files are written to `output_directory`
+  // without being installed; the primary installs them once it gets `output`
+  // back through CompactionService::WaitForComplete(). The objects of the
+  // column family options that cannot be serialized are taken from
+  // `override_options`.
+  static Status OpenAndCompact(
+      const std::string& name, const std::string& output_directory,
+      const std::string& input, std::string* output,
+      const CompactionServiceOptionsOverride& override_options);
+
   // Open DB with column families.
   // db_options specify database specific options
   // column_families is the vector of all column families in the database,
@@ -757,6 +771,14 @@ class DB {
     //      level, as well as the histogram of latency of single requests.
     static const std::string kCFFileHistogram;
 
+    //  "rocksdb.cf-write-stall-stats" - returns the column family's write
+    //      stall counters by cause (the "io_stalls." entries of
+    //      "rocksdb.cfstats"), and the state of the controller enabled by
+    //      pending_compaction_bytes_target, under keys starting with
+    //      "controller.". Best retrieved as a map; as a string, it returns one
+    //      "key: value" line per entry.
+    static const std::string kCFWriteStallStats;
+
     //  "rocksdb.dbstats" - returns a multi-line string with general database
     //      stats, both cumulative (over the db's lifetime) and interval (since
     //      the last retrieval of kDBStats).
@@ -389,8 +389,18 @@ class Env {
 
   static std::string PriorityToString(Priority priority);
 
-  // Priority for requesting bytes in rate limiter scheduler
-  enum IOPriority { IO_LOW = 0, IO_HIGH = 1, IO_TOTAL = 2 };
+  // Priority for requesting bytes in rate limiter scheduler. RocksDB charges
+  // compactions out of L0 to IO_MID and the other compactions to IO_LOW,
+  // flushes to IO_HIGH, and user reads with
+  // ReadOptions::rate_limiter_priority set (typically IO_USER) to that
+  // priority. IO_TOTAL means the I/O is not rate limited.
+  enum IOPriority {
+    IO_LOW = 0,
+    IO_MID = 1,
+    IO_HIGH = 2,
+    IO_USER = 3,
+    IO_TOTAL = 4
+  };
 
   // Arrange to run "(*function)(arg)" once in a background thread, in
   // the thread pool specified by pri. By default, jobs go to the 'LOW'
@@ -86,7 +86,15 @@ struct IOOptions {
   // Type of data being read/written
   IOType type;
 
-  IOOptions() : timeout(0), prio(IOPriority::kIOLow), type(IOType::kUnknown) {}
+  // Priority with which RocksDB charges the read to its rate limiter, if
+  // any, before calling the FileSystem. Env::IO_TOTAL means not charged.
+  Env::IOPriority rate_limiter_priority;
+
+  IOOptions()
+      : timeout(0),
+        prio(IOPriority::kIOLow),
+        type(IOType::kUnknown),
+        rate_limiter_priority(Env::IO_TOTAL) {}
 };
 
 // File scope options that control how a file is opened/created and accessed
@@ -40,6 +40,7 @@
 #include <stdlib.h>
 #include <memory>
 #include <stdexcept>
+#include <unordered_set>
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -194,6 +195,14 @@ class MemTableRep {
     return 0;
   }
 
+  // Adds about target_sample_size distinct entries of the collection, picked
+  // at random, to entries. num_entries is the number of entries in the
+  // collection. The default implementation iterates over the whole
+  // collection.
+  virtual void UniqueRandomSample(const uint64_t num_entries,
+                                  const uint64_t target_sample_size,
+                                  std::unordered_set<const char*>* entries);
+
   // Report an approximation of how much memory has been used other than memory
   // that was allocated through the allocator.  Safe to call from any thread.
   virtual size_t ApproximateMemoryUsage() = 0;
@@ -326,6 +335,26 @@ class SkipListFactory : public MemTableRepFactory {
   const size_t lookahead_;
 };
 
+// This uses a B+-tree to store keys. Like the skip list, it supports
+// concurrent inserts, but it keeps the keys of a range in arrays, which
+// makes point lookups and scans touch fewer cache lines than following the
+// per-key nodes of a skip list. Readers never take locks; writers only lock
+// the tree nodes they change.
+class BTreeFactory : public MemTableRepFactory {
+ public:
+  BTreeFactory() {}
+
+  using MemTableRepFactory::CreateMemTableRep;
+  virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                         Allocator*, const SliceTransform*,
+                                         Logger* logger) override;
+  virtual const char* Name() const override { return "BTreeFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+};
+
 #ifndef ROCKSDB_LITE
 // This creates MemTableReps that are backed by an std::vector. On iteration,
 // the vector is sorted. This is useful for workloads where iteration is very
@@ -349,6 +378,36 @@ class VectorRepFactory : public MemTableRepFactory {
   virtual const char* Name() const override { return "VectorRepFactory"; }
 };
 
+// This creates MemTableReps for write-heavy workloads such as bulk loading.
+// Each core appends the keys written from it to a buffer of its own, which
+// is sorted into a run whenever it fills up, so concurrent writers neither
+// contend with each other nor pay for a sorted insert. Iterators merge the
+// runs; once the memtable is immutable, the runs are merged only once, by
+// the first iterator, so the flush reads sorted keys. Point lookups search
+// every run, so they get slower as the memtable grows. On the mutable
+// memtable, each lookup also copies and sorts the keys that are not in a
+// sorted run yet (up to run_size per core), so a large run_size makes reads
+// of recent writes expensive.
+//
+// Parameters:
+//   run_size: The number of keys each core buffers before sorting them into
+//     a run.
+class SortedRunRepFactory : public MemTableRepFactory {
+  const size_t run_size_;
+
+ public:
+  explicit SortedRunRepFactory(size_t run_size = 4096) : run_size_(run_size) {}
+
+  using MemTableRepFactory::CreateMemTableRep;
+  virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                         Allocator*, const SliceTransform*,
+                                         Logger* logger) override;
+
+  virtual const char* Name() const override { return "SortedRunRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+};
+
 // This class contains a fixed array of buckets, each
 // pointing to a skiplist (null if the bucket is empty).
 // bucket_count: number of fixed array buckets
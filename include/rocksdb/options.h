@@ -351,6 +351,45 @@ struct DbPath {
 
 static const std::string kHostnameForDbHostId = "__hostname__";
 
+enum class CompactionServiceJobStatus : char {
+  kSuccess,
+  kFailure,
+  kUseLocal,
+};
+
+// CompactionService runs the compactions of a DB outside of its process.
+// For each (sub)compaction, the DB calls Start() with a serialized
+// description of the job, which the service passes to DB::OpenAndCompact()
+// on a worker (another process with access to the same file system, or a
+// local stand-in). The DB then blocks in WaitForComplete() until the worker
+// returns the serialized result, and installs the output files itself.
+//
+// Exceptions MUST NOT propagate out of overridden functions into RocksDB,
+// because RocksDB is not exception-safe. This could cause undefined behavior
+// including data loss, unreported corruption, deadlocks, and more.
+//
+// EXPERIMENTAL: the interface and the serialization format may change.
+class CompactionService {
+ public:
+  virtual ~CompactionService() {}
+
+  // Returns the name of this compaction service.
+  virtual const char* Name() const = 0;
+
+  // Starts the compaction job `job_id` described by
+  // `compaction_service_input`. `job_id` is unique among the jobs of the DB,
+  // including the subcompactions of a compaction, which are started
+  // concurrently. Returning kUseLocal makes the DB run this job itself,
+  // kFailure fails it.
+  virtual CompactionServiceJobStatus Start(
+      const std::string& compaction_service_input, uint64_t job_id) = 0;
+
+  // Waits for the compaction job `job_id` to finish and returns the output of
+  // DB::OpenAndCompact() in `compaction_service_result`.
+  virtual CompactionServiceJobStatus WaitForComplete(
+      uint64_t job_id, std::string* compaction_service_result) = 0;
+};
+
 struct DBOptions {
   // The function recovers options to the option as in version 4.6.
   DBOptions* OldDefaults(int rocksdb_major_version = 4,
@@ -1196,6 +1235,59 @@ struct DBOptions {
   //
   // Default: hostname
   std::string db_host_id = kHostnameForDbHostId;
+
+  // Compression of the WAL records. The records of a WAL file share one
+  // streaming compression context, so that small write batches still
+  // compress well. Only kZSTD is supported; it requires RocksDB to be built
+  // with ZSTD. WAL compression is not compatible with recycle_log_file_num,
+  // which is ignored when it is set.
+  //
+  // Default: kNoCompression
+  CompressionType wal_compression = kNoCompression;
+
+  // If true, DB::Open() reads the records of each WAL file on a separate
+  // thread while it inserts the previously read ones into the memtables.
+  // Reading, checksum verification and decompression of the WAL then overlap
+  // with the memtable insertion, which shortens the recovery of large WALs.
+  // The records are still applied in order and the WALRecoveryMode semantics
+  // are unchanged.
+  //
+  // Default: false
+  bool enable_pipelined_wal_recovery = false;
+
+  // EXPERIMENTAL
+  // If set, the compactions (except trivial moves and compactions that
+  // write blob files) are handed over to this service instead of being run
+  // by the DB's background threads. See CompactionService.
+  //
+  // Default: nullptr
+  std::shared_ptr<CompactionService> compaction_service = nullptr;
+
+  // The maximum number of L0 files a flush splits the memtables it flushes
+  // into. The files cover disjoint key ranges, picked from a sample of the
+  // keys, and are built by parallel threads, which shortens the flush of
+  // large memtables. A flush uses fewer partitions if the memtables are
+  // smaller than write_buffer_size. Only column families using level
+  // compaction, without range deletions, blob files or user-defined
+  // timestamps, are flushed this way. Note that the additional files count
+  // towards level0_file_num_compaction_trigger and the L0 write stall
+  // triggers.
+  //
+  // Default: 1 (i.e. no partitioning)
+  uint32_t max_flush_partitions = 1;
+
+  // If true, a compaction reads each of its input levels ahead on a thread of
+  // its own, which reads and decompresses the blocks and parses the entries,
+  // while the compaction thread merges them and writes the output. The L0
+  // input files are merged on a single reader thread. Together with
+  // CompressionOptions::parallel_threads, which compresses the output blocks
+  // in parallel, this lets a single compaction use several cores. Each reader
+  // buffers a few hundred KB of entries, and each subcompaction has its own
+  // readers, so a compaction uses up to max_subcompactions times the number
+  // of its input levels reader threads.
+  //
+  // Default: false
+  bool enable_pipelined_compaction = false;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1426,6 +1518,26 @@ struct ReadOptions {
   // Default: std::numeric_limits<uint64_t>::max()
   uint64_t value_size_soft_limit;
 
+  // If true, iterators doing readahead (see readahead_size) read the next
+  // chunk of the file in the background while the current one is being
+  // consumed, so that a long forward scan doesn't stall on every readahead
+  // boundary. Readahead is then always done in RocksDB's own buffers, even
+  // if the file system supports Prefetch(). Not used by compaction reads.
+  // MultiGet also looks up the keys of a batch falling into different files
+  // of the same level (other than L0) in parallel. The work done on
+  // background threads is not reflected in the caller's PerfContext and
+  // IOStatsContext.
+  // Default: false
+  bool async_io;
+
+  // If not Env::IO_TOTAL, the reads of table files done for this operation
+  // are charged to DBOptions::rate_limiter with this priority, provided its
+  // mode includes reads. Env::IO_USER is meant for reads a user is waiting
+  // on. Reads of data already in the block cache are not charged, nor are
+  // the reads of MultiGet, which are issued as one batch.
+  // Default: Env::IO_TOTAL (not rate limited)
+  Env::IOPriority rate_limiter_priority;
+
   ReadOptions();
   ReadOptions(bool cksum, bool cache);
 };
@@ -1659,7 +1771,7 @@ struct IngestExternalFileOptions {
 enum TraceFilterType : uint64_t {
   // Trace all the operations
   kTraceFilterNone = 0x0,
-  // Do not trace the get operations
+  // Do not trace the get operations, including MultiGet
   kTraceFilterGet = 0x1 << 0,
   // Do not trace the write operations
   kTraceFilterWrite = 0x1 << 1
@@ -1677,6 +1789,23 @@ struct TraceOptions {
   uint64_t filter = kTraceFilterNone;
 };
 
+// The options that DB::OpenAndCompact() cannot get from the serialized
+// compaction input, because they are objects rather than values. The
+// non-null objects given here replace the ones the worker would otherwise
+// create from the options of the DB that scheduled the compaction.
+struct CompactionServiceOptionsOverride {
+  Env* env = Env::Default();
+  std::shared_ptr<FileChecksumGenFactory> file_checksum_gen_factory = nullptr;
+
+  const Comparator* comparator = BytewiseComparator();
+  std::shared_ptr<MergeOperator> merge_operator = nullptr;
+  const CompactionFilter* compaction_filter = nullptr;
+  std::shared_ptr<CompactionFilterFactory> compaction_filter_factory = nullptr;
+  std::shared_ptr<const SliceTransform> prefix_extractor = nullptr;
+  std::shared_ptr<TableFactory> table_factory = nullptr;
+  std::shared_ptr<SstPartitionerFactory> sst_partitioner_factory = nullptr;
+};
+
 // ImportColumnFamilyOptions is used by ImportColumnFamily()
 struct ImportColumnFamilyOptions {
   // Can be set to true to move the files instead of copying them.
@@ -18,7 +18,8 @@ class RateLimiter {
  public:
   enum class OpType {
     // Limitation: we currently only invoke Request() with OpType::kRead for
-    // compactions when DBOptions::new_table_reader_for_compaction_inputs is set
+    // compactions when DBOptions::new_table_reader_for_compaction_inputs is
+    // set, and for user reads with ReadOptions::rate_limiter_priority set
     kRead,
     kWrite,
   };
@@ -119,13 +120,16 @@ class RateLimiter {
 // 100ms, then 1MB is refilled every 100ms internally. Larger value can lead to
 // burstier writes while smaller value introduces more CPU overhead.
 // The default should work for most cases.
-// @fairness: RateLimiter accepts high-pri requests and low-pri requests.
-// A low-pri request is usually blocked in favor of hi-pri request. Currently,
-// RocksDB assigns low-pri to request from compaction and high-pri to request
-// from flush. Low-pri requests can get blocked if flush requests come in
-// continuously. This fairness parameter grants low-pri requests permission by
-// 1/fairness chance even though high-pri requests exist to avoid starvation.
-// You should be good by leaving it at default 10.
+// @fairness: RateLimiter accepts requests of the priorities of
+// Env::IOPriority. A request is usually blocked in favor of requests of higher
+// priority. Currently, RocksDB assigns IO_USER to user reads with
+// ReadOptions::rate_limiter_priority set, IO_HIGH to requests from flush,
+// IO_MID to requests from compactions out of L0, and IO_LOW to requests from
+// other compactions. IO_USER requests are always served first. Lower-pri
+// requests can get blocked if higher-pri requests come in continuously. This
+// fairness parameter lets IO_MID and IO_LOW requests go ahead of IO_HIGH
+// ones, and IO_LOW requests ahead of IO_MID ones, by 1/fairness chance each
+// to avoid starvation. You should be good by leaving it at default 10.
 // @mode: Mode indicates which types of operations count against the limit.
 // @auto_tuned: Enables dynamic adjustment of rate limit within the range
 //              `[rate_bytes_per_sec / 20, rate_bytes_per_sec]`, according to
@@ -374,6 +374,24 @@ enum Tickers : uint32_t {
   // # of files deleted immediately by sst file manger through delete scheduler.
   FILES_DELETED_IMMEDIATELY,
 
+  // # of lookups in the secondary cache (after a primary block cache miss)
+  // that found the entry, and that did not find it.
+  SECONDARY_CACHE_HITS,
+  SECONDARY_CACHE_MISSES,
+
+  // # of blob cache (AdvancedColumnFamilyOptions::blob_cache) misses and hits,
+  // and of values added to it successfully and unsuccessfully.
+  BLOB_DB_CACHE_MISS,
+  BLOB_DB_CACHE_HIT,
+  BLOB_DB_CACHE_ADD,
+  BLOB_DB_CACHE_ADD_FAILURES,
+
+  // # of times the range filter (BlockBasedTableOptions::range_filter_levels)
+  // of a file was checked by a bounded seek, and of times it was useful in
+  // skipping the file.
+  RANGE_FILTER_CHECKED,
+  RANGE_FILTER_USEFUL,
+
   TICKER_ENUM_MAX
 };
 
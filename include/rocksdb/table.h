@@ -204,6 +204,16 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, but the table also stores a small piecewise linear
+    // model of the position of the index entries, learned from their keys.
+    // A seek in the index starts at the entry predicted by the model instead
+    // of bisecting the whole index block, which saves key comparisons and
+    // cache misses when the index is large. The model is only built for
+    // BytewiseComparator; with other comparators this is kBinarySearch.
+    // The table records its index type as kBinarySearch, so versions that
+    // do not know the model read it as a binary search index.
+    kLearnedIndexSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -220,6 +230,17 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, data blocks and binary search index blocks also store the first
+  // four bytes of the user key of each restart point, next to the restart
+  // array. A seek compares these fixed-width prefixes, with vector
+  // instructions where available, to narrow down the restart points it has to
+  // decode and compare keys for to those sharing the prefix of the target.
+  // It costs four more bytes per restart point.
+  //
+  // Only takes effect with the default bytewise comparator. Blocks written
+  // with this option cannot be read by versions of RocksDB without it.
+  bool store_restart_key_prefixes = false;
+
   // This option is now deprecated. No matter what value it is set to,
   // it will behave as if hash_index_allow_collision=true.
   bool hash_index_allow_collision = true;
@@ -337,6 +358,40 @@ struct BlockBasedTableOptions {
   // This must generally be true for gets to be efficient.
   bool whole_key_filtering = true;
 
+  // If greater than 0, each table also stores a range filter built with
+  // filter_policy: a stack of this many filters over prefixes of increasingly
+  // fewer bits of the keys of the table, each grouping the keys of the level
+  // below it by 16. When a seek has an iterate_upper_bound, the range filter
+  // tells whether the table may hold a key between the seek target and the
+  // upper bound; a table that does not is skipped without reading its index
+  // or data blocks. Each level costs up to the size of a full filter, but the
+  // upper levels are smaller when the keys are dense. A range that spans
+  // 64 nodes or more of the top level is assumed to match, so the levels
+  // must cover the bits in which the keys of a scan differ: with keys that
+  // end with decimal digits, each digit takes two levels, and 8 levels suit
+  // scans over up to a few thousand consecutive numbers. At most 16.
+  //
+  // Unlike the other filters, the range filter is read when the table is
+  // opened and kept in the memory of the table reader until it is closed,
+  // whatever cache_index_and_filter_blocks is, and it is not charged to
+  // block_cache: with max_open_files = -1, the range filters of all the
+  // tables are in memory at all times. It is counted in the
+  // "rocksdb.estimate-table-readers-mem" property. Building a table also
+  // holds 8 bytes per distinct key until the range filter is written.
+  //
+  // Only takes effect with the default bytewise comparator, without
+  // user-defined timestamps, and with a filter_policy building full filters.
+  uint32_t range_filter_levels = 0;
+
+  // If true, the memory used to build a Ribbon filter (see
+  // NewRibbonFilterPolicy()), several times the size of the filter, is
+  // charged to block_cache while the filter is built. If the block cache has
+  // a strict capacity limit and is full, a Bloom filter is built instead,
+  // which needs much less memory. Has no effect without a block cache.
+  //
+  // Default: false
+  bool reserve_filter_construction_memory = false;
+
   // Verify that decompressing the compressed block gives back the input. This
   // is a verification mode that we use to detect bugs in compression
   // algorithms.
@@ -109,6 +109,16 @@ struct BackupableDBOptions {
   // Default: 1
   int max_background_operations;
 
+  // If non-zero and max_background_operations > 1, files larger than this
+  // many bytes are copied and checksummed in chunks of this size by up to
+  // max_background_operations threads, so that backing up or restoring one
+  // huge file is not limited to a single thread. The chunk checksums are
+  // combined into the whole-file crc32c, so backups are the same as those
+  // copied in one piece. Falls back to a single-threaded copy if the
+  // destination Env does not support NewRandomRWFile.
+  // Default: 0 (copy each file on one thread)
+  uint64_t parallel_copy_chunk_size;
+
   // During backup user can get callback every time next
   // callback_trigger_interval_size bytes being copied.
   // Default: 4194304
@@ -223,6 +233,7 @@ struct BackupableDBOptions {
         restore_rate_limit(_restore_rate_limit),
         share_files_with_checksum(false),
         max_background_operations(_max_background_operations),
+        parallel_copy_chunk_size(0),
         callback_trigger_interval_size(_callback_trigger_interval_size),
         max_valid_backups_to_open(_max_valid_backups_to_open),
         share_files_with_checksum_naming(_share_files_with_checksum_naming) {
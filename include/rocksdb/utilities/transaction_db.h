@@ -104,6 +104,16 @@ struct TransactionDBOptions {
   // pending writes into the database. A value of 0 or less means no limit.
   int64_t default_write_batch_flush_threshold = 0;
 
+  // If true, the locks of the keys are managed by a lock manager made for
+  // many transactions contending for a few hot keys. Waiting for a key does
+  // not hold the mutex of a stripe of keys, each key has its own queue of
+  // waiters so that releasing a lock only wakes up the waiters of that key,
+  // and deadlock detection does not serialize all the waiting transactions
+  // on one mutex. num_stripes then sizes the lock table, and
+  // custom_mutex_factory is not used. Reaching max_num_locks makes a lock
+  // request fail right away instead of waiting for its timeout.
+  bool use_per_key_point_lock_mgr = false;
+
  private:
   // 128 entries
   size_t wp_snapshot_cache_bits = static_cast<size_t>(7);
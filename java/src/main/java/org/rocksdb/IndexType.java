@@ -36,7 +36,14 @@ public enum IndexType {
    * Makes the index significantly bigger (2x or more), especially when keys
    * are long.
    */
-  kBinarySearchWithFirstKey((byte) 3);
+  kBinarySearchWithFirstKey((byte) 3),
+  /**
+   * Like {@link #kBinarySearch}, but the table also stores a small piecewise
+   * linear model of the position of the index entries, learned from their
+   * keys, and index seeks start at the predicted entry. Only effective with
+   * the bytewise comparator.
+   */
+  kLearnedIndexSearch((byte) 4);
 
   /**
    * Returns the byte value of the enumerations value
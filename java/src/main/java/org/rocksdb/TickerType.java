@@ -742,6 +742,46 @@ public enum TickerType {
     COMPACT_WRITE_BYTES_PERIODIC((byte) -0x14),
     COMPACT_WRITE_BYTES_TTL((byte) -0x15),
 
+    /**
+     * # of lookups in the secondary cache that found the entry.
+     */
+    SECONDARY_CACHE_HITS((byte) -0x16),
+
+    /**
+     * # of lookups in the secondary cache that did not find the entry.
+     */
+    SECONDARY_CACHE_MISSES((byte) -0x17),
+
+    /**
+     * # of blob cache misses.
+     */
+    BLOB_DB_CACHE_MISS((byte) -0x18),
+
+    /**
+     * # of blob cache hits.
+     */
+    BLOB_DB_CACHE_HIT((byte) -0x19),
+
+    /**
+     * # of values added to the blob cache.
+     */
+    BLOB_DB_CACHE_ADD((byte) -0x1A),
+
+    /**
+     * # of failures when adding values to the blob cache.
+     */
+    BLOB_DB_CACHE_ADD_FAILURES((byte) -0x1B),
+
+    /**
+     * # of times the range filter of a file was checked by a bounded seek.
+     */
+    RANGE_FILTER_CHECKED((byte) -0x1C),
+
+    /**
+     * # of times the range filter of a file was useful in skipping the file.
+     */
+    RANGE_FILTER_USEFUL((byte) -0x1D),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
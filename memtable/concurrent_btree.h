@@ -0,0 +1,629 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// ConcurrentBTree is a B+-tree of pointers to keys, for use as a memtable.
+// Unlike InlineSkipList, which links one node per key, it packs the keys of
+// a range into arrays, so a lookup visits about log_32(n) nodes instead of
+// chasing one pointer per level per key, and an iterator reads the keys of a
+// leaf from a single array.
+//
+// Thread safety -------------
+//
+// Insert can be called concurrently with other inserts and with reads. The
+// tree uses optimistic lock coupling: every node has a version word, which a
+// writer locks while it changes the node and bumps when it unlocks it.
+// Readers never lock. They read the version of a node, read the node, and
+// check that the version did not change, starting over from the root
+// otherwise. Writers only lock the leaf they insert into, and its parent
+// when the leaf is full and has to be split.
+//
+// Invariants:
+//
+// (1) Nodes are never deleted until the ConcurrentBTree is destroyed, so a
+// reader can always dereference a node pointer it read, even if the node was
+// split since. The memory comes from the allocator, like the keys.
+//
+// (2) Keys are never removed, and a node only ever holds pointers to keys
+// that were inserted. A reader that races with a writer can see a
+// half-updated node, but every pointer it reads below the count it read is a
+// valid key, and the version check then discards what it read.
+//
+// (3) The first key of the right half of a split stays the separator of the
+// two halves in their parent forever. The separators of the nodes on the
+// path to a leaf bound the keys the leaf holds.
+//
+// Iterators copy the keys of one leaf at a time. Keys inserted in the range
+// of the copied leaf after it was read are not seen until the iterator moves
+// to another leaf. MemTable only needs the keys with a sequence number up to
+// the one it reads at, which were all inserted before the iterator started.
+
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include "memory/allocator.h"
+#include "port/port.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+template <class Comparator>
+class ConcurrentBTree {
+ private:
+  struct Node;
+  struct Leaf;
+  struct Inner;
+
+ public:
+  // The maximum number of keys in a leaf, and of separators in an inner node.
+  static const uint32_t kLeafCapacity = 32;
+  static const uint32_t kInnerCapacity = 32;
+
+  // Create a new ConcurrentBTree object that will use "cmp" for comparing
+  // keys, and will allocate memory using "*allocator". Objects allocated in
+  // the allocator must remain allocated for the lifetime of the tree object.
+  explicit ConcurrentBTree(Comparator cmp, Allocator* allocator);
+  // No copying allowed
+  ConcurrentBTree(const ConcurrentBTree&) = delete;
+  ConcurrentBTree& operator=(const ConcurrentBTree&) = delete;
+
+  // Inserts key into the tree. Returns false, and leaves the tree unchanged,
+  // if a key comparing equal to it is already in the tree.
+  // Thread safe: can be called concurrently with reads and other inserts.
+  bool Insert(const char* key);
+
+  // Returns true iff an entry that compares equal to key is in the tree.
+  bool Contains(const char* key) const;
+
+  // Returns the number of levels of the tree. For tests.
+  int Height() const;
+
+  // Iteration over the contents of a ConcurrentBTree
+  class Iterator {
+   public:
+    // Initialize an iterator over the specified tree.
+    // The returned iterator is not valid.
+    explicit Iterator(const ConcurrentBTree* tree);
+
+    // Returns true iff the iterator is positioned at a valid node.
+    bool Valid() const { return valid_; }
+
+    // Returns the key at the current position.
+    // REQUIRES: Valid()
+    const char* key() const {
+      assert(Valid());
+      return keys_[pos_];
+    }
+
+    // Advances to the next position.
+    // REQUIRES: Valid()
+    void Next();
+
+    // Advances to the previous position.
+    // REQUIRES: Valid()
+    void Prev();
+
+    // Advance to the first entry with a key >= target
+    void Seek(const char* target) { SeekAfter(target, true /* inclusive */); }
+
+    // Retreat to the last entry with a key <= target
+    void SeekForPrev(const char* target) {
+      SeekBefore(target, true /* inclusive */);
+    }
+
+    // Position at the first entry in the tree.
+    // Final state of iterator is Valid() iff the tree is not empty.
+    void SeekToFirst() { SeekAfter(nullptr, true /* inclusive */); }
+
+    // Position at the last entry in the tree.
+    // Final state of iterator is Valid() iff the tree is not empty.
+    void SeekToLast() { SeekBefore(nullptr, true /* inclusive */); }
+
+   private:
+    // Positions at the first key greater than (or equal to, if `inclusive`)
+    // `target`, which nullptr stands as less than all keys for.
+    void SeekAfter(const char* target, bool inclusive);
+    // Positions at the last key less than (or equal to, if `inclusive`)
+    // `target`, which nullptr stands as greater than all keys for.
+    void SeekBefore(const char* target, bool inclusive);
+
+    const ConcurrentBTree* tree_;
+    // The keys of the leaf the iterator is in, copied when it was reached
+    const char* keys_[kLeafCapacity];
+    uint32_t count_;
+    uint32_t pos_;
+    bool valid_;
+    // The separators bounding the keys of the leaf, nullptr if unbounded
+    const char* lower_;
+    const char* upper_;
+  };
+
+ private:
+  // Bit 1 of the version of a node is set while a writer holds its lock.
+  // Unlocking adds 2 more, so the version of an unlocked node is a multiple
+  // of 4 and changes every time the node does.
+  static const uint64_t kLockedBit = 2;
+
+  struct Node {
+    explicit Node(bool leaf) : version(0), count(0), is_leaf(leaf) {}
+
+    std::atomic<uint64_t> version;
+    // Number of keys of a leaf, or of separators of an inner node. Stored
+    // with release semantics after the slots it covers.
+    std::atomic<uint32_t> count;
+    const bool is_leaf;
+  };
+
+  struct Leaf : public Node {
+    Leaf() : Node(true /* leaf */) {}
+
+    std::atomic<const char*> keys[kLeafCapacity];
+  };
+
+  // children[i] holds the keys in [keys[i - 1], keys[i]).
+  struct Inner : public Node {
+    Inner() : Node(false /* leaf */) {}
+
+    std::atomic<const char*> keys[kInnerCapacity];
+    std::atomic<Node*> children[kInnerCapacity + 1];
+  };
+
+  // Waits for the node to be unlocked and returns its version.
+  static uint64_t ReadLock(const Node* node);
+  // Returns true iff the node did not change since ReadLock() returned
+  // `version`.
+  static bool Validate(const Node* node, uint64_t version);
+  // Locks the node if it did not change since ReadLock() returned `version`.
+  static bool UpgradeLock(Node* node, uint64_t version);
+  static void WriteUnlock(Node* node);
+
+  // The number of slots of `keys` in [0, count) whose key is less than
+  // (or equal to, if `or_equal`) `target`.
+  uint32_t Rank(const std::atomic<const char*>* keys, uint32_t count,
+                const char* target, bool or_equal) const;
+
+  // Copies the keys of a leaf into `keys` and returns how many there are.
+  // The leaf is the one covering `target` if not `before`, and otherwise the
+  // one covering the keys right before `target`. A nullptr `target` selects
+  // the first leaf, or the last one with `before`. Sets `lower` and `upper`
+  // to the separators bounding the keys of the leaf.
+  uint32_t ReadLeaf(const char* target, bool before, const char** keys,
+                    const char** lower, const char** upper) const;
+
+  Leaf* NewLeaf();
+  Inner* NewInner();
+
+  // Splits the locked, full `node`. Inserts the new right half into the
+  // locked `parent`, or grows the tree with a new root if `parent` is
+  // nullptr.
+  void Split(Node* node, Inner* parent);
+
+  Allocator* const allocator_;
+  Comparator const compare_;
+  std::atomic<Node*> root_;
+};
+
+// Implementation details follow
+
+template <class Comparator>
+const uint32_t ConcurrentBTree<Comparator>::kLeafCapacity;
+template <class Comparator>
+const uint32_t ConcurrentBTree<Comparator>::kInnerCapacity;
+
+template <class Comparator>
+ConcurrentBTree<Comparator>::ConcurrentBTree(const Comparator cmp,
+                                             Allocator* allocator)
+    : allocator_(allocator), compare_(cmp), root_(nullptr) {
+  root_.store(NewLeaf(), std::memory_order_release);
+}
+
+template <class Comparator>
+typename ConcurrentBTree<Comparator>::Leaf*
+ConcurrentBTree<Comparator>::NewLeaf() {
+  char* mem = allocator_->AllocateAligned(sizeof(Leaf));
+  return new (mem) Leaf();
+}
+
+template <class Comparator>
+typename ConcurrentBTree<Comparator>::Inner*
+ConcurrentBTree<Comparator>::NewInner() {
+  char* mem = allocator_->AllocateAligned(sizeof(Inner));
+  return new (mem) Inner();
+}
+
+template <class Comparator>
+uint64_t ConcurrentBTree<Comparator>::ReadLock(const Node* node) {
+  uint64_t version = node->version.load(std::memory_order_acquire);
+  while ((version & kLockedBit) != 0) {
+    port::AsmVolatilePause();
+    version = node->version.load(std::memory_order_acquire);
+  }
+  return version;
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Validate(const Node* node,
+                                           uint64_t version) {
+  // Keep the reads of the node from moving after the version check.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return node->version.load(std::memory_order_relaxed) == version;
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::UpgradeLock(Node* node, uint64_t version) {
+  if (!node->version.compare_exchange_strong(version, version + kLockedBit,
+                                             std::memory_order_acquire)) {
+    return false;
+  }
+  // Keep the writes to the node from moving before the version change.
+  std::atomic_thread_fence(std::memory_order_release);
+  return true;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::WriteUnlock(Node* node) {
+  node->version.fetch_add(kLockedBit, std::memory_order_release);
+}
+
+template <class Comparator>
+uint32_t ConcurrentBTree<Comparator>::Rank(
+    const std::atomic<const char*>* keys, uint32_t count, const char* target,
+    bool or_equal) const {
+  uint32_t lo = 0;
+  uint32_t hi = count;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const int cmp =
+        compare_(keys[mid].load(std::memory_order_relaxed), target);
+    if (cmp < 0 || (or_equal && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <class Comparator>
+uint32_t ConcurrentBTree<Comparator>::ReadLeaf(const char* target, bool before,
+                                               const char** keys,
+                                               const char** lower,
+                                               const char** upper) const {
+  for (;;) {
+    const Node* node = root_.load(std::memory_order_acquire);
+    uint64_t version = ReadLock(node);
+    if (node != root_.load(std::memory_order_acquire)) {
+      continue;
+    }
+    *lower = nullptr;
+    *upper = nullptr;
+    bool restart = false;
+    while (!node->is_leaf) {
+      const Inner* inner = static_cast<const Inner*>(node);
+      const uint32_t count = std::min(
+          inner->count.load(std::memory_order_acquire), kInnerCapacity);
+      uint32_t index;
+      if (target == nullptr) {
+        index = before ? count : 0;
+      } else {
+        // Keys equal to a separator are on its right.
+        index = Rank(inner->keys, count, target, !before /* or_equal */);
+      }
+      const Node* child = inner->children[index].load(std::memory_order_acquire);
+      const char* child_lower =
+          index > 0 ? inner->keys[index - 1].load(std::memory_order_relaxed)
+                    : *lower;
+      const char* child_upper =
+          index < count ? inner->keys[index].load(std::memory_order_relaxed)
+                        : *upper;
+      // Validating the parent after reading the version of the child makes
+      // sure that the child was not split in between, and still holds all
+      // the keys in [child_lower, child_upper).
+      const uint64_t child_version = ReadLock(child);
+      if (!Validate(node, version)) {
+        restart = true;
+        break;
+      }
+      *lower = child_lower;
+      *upper = child_upper;
+      node = child;
+      version = child_version;
+    }
+    if (restart) {
+      continue;
+    }
+    const Leaf* leaf = static_cast<const Leaf*>(node);
+    const uint32_t count =
+        std::min(leaf->count.load(std::memory_order_acquire), kLeafCapacity);
+    for (uint32_t i = 0; i < count; i++) {
+      keys[i] = leaf->keys[i].load(std::memory_order_relaxed);
+    }
+    if (Validate(node, version)) {
+      return count;
+    }
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Split(Node* node, Inner* parent) {
+  const char* separator;
+  Node* right;
+  if (node->is_leaf) {
+    Leaf* leaf = static_cast<Leaf*>(node);
+    Leaf* new_leaf = NewLeaf();
+    const uint32_t count = leaf->count.load(std::memory_order_relaxed);
+    const uint32_t mid = count / 2;
+    for (uint32_t i = mid; i < count; i++) {
+      new_leaf->keys[i - mid].store(
+          leaf->keys[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    new_leaf->count.store(count - mid, std::memory_order_release);
+    leaf->count.store(mid, std::memory_order_release);
+    separator = new_leaf->keys[0].load(std::memory_order_relaxed);
+    right = new_leaf;
+  } else {
+    Inner* inner = static_cast<Inner*>(node);
+    Inner* new_inner = NewInner();
+    const uint32_t count = inner->count.load(std::memory_order_relaxed);
+    const uint32_t mid = count / 2;
+    // The middle separator moves up to the parent.
+    separator = inner->keys[mid].load(std::memory_order_relaxed);
+    for (uint32_t i = mid + 1; i < count; i++) {
+      new_inner->keys[i - mid - 1].store(
+          inner->keys[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    for (uint32_t i = mid + 1; i <= count; i++) {
+      new_inner->children[i - mid - 1].store(
+          inner->children[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    new_inner->count.store(count - mid - 1, std::memory_order_release);
+    inner->count.store(mid, std::memory_order_release);
+    right = new_inner;
+  }
+
+  if (parent == nullptr) {
+    Inner* new_root = NewInner();
+    new_root->keys[0].store(separator, std::memory_order_relaxed);
+    new_root->children[0].store(node, std::memory_order_relaxed);
+    new_root->children[1].store(right, std::memory_order_relaxed);
+    new_root->count.store(1, std::memory_order_release);
+    root_.store(new_root, std::memory_order_release);
+    return;
+  }
+  const uint32_t count = parent->count.load(std::memory_order_relaxed);
+  assert(count < kInnerCapacity);
+  const uint32_t index =
+      Rank(parent->keys, count, separator, true /* or_equal */);
+  for (uint32_t i = count; i > index; i--) {
+    parent->keys[i].store(parent->keys[i - 1].load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    parent->children[i + 1].store(
+        parent->children[i].load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+  parent->keys[index].store(separator, std::memory_order_relaxed);
+  parent->children[index + 1].store(right, std::memory_order_release);
+  parent->count.store(count + 1, std::memory_order_release);
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Insert(const char* key) {
+  for (;;) {
+    Node* node = root_.load(std::memory_order_acquire);
+    uint64_t version = ReadLock(node);
+    if (node != root_.load(std::memory_order_acquire)) {
+      continue;
+    }
+    Inner* parent = nullptr;
+    uint64_t parent_version = 0;
+    bool restart = false;
+    for (;;) {
+      const uint32_t capacity = node->is_leaf ? kLeafCapacity : kInnerCapacity;
+      if (node->count.load(std::memory_order_relaxed) >= capacity) {
+        // Split full nodes on the way down, so that the parent of a node
+        // always has room for one more child.
+        if (parent != nullptr && !UpgradeLock(parent, parent_version)) {
+          restart = true;
+          break;
+        }
+        if (!UpgradeLock(node, version)) {
+          if (parent != nullptr) {
+            WriteUnlock(parent);
+          }
+          restart = true;
+          break;
+        }
+        // A locked root that did not change since we got it from root_ is
+        // still the root, as growing the tree changes the old root.
+        Split(node, parent);
+        WriteUnlock(node);
+        if (parent != nullptr) {
+          WriteUnlock(parent);
+        }
+        restart = true;
+        break;
+      }
+      if (node->is_leaf) {
+        break;
+      }
+      if (parent != nullptr && !Validate(parent, parent_version)) {
+        restart = true;
+        break;
+      }
+      Inner* inner = static_cast<Inner*>(node);
+      const uint32_t count = inner->count.load(std::memory_order_acquire);
+      const uint32_t index = Rank(inner->keys, std::min(count, kInnerCapacity),
+                                  key, true /* or_equal */);
+      Node* child = inner->children[index].load(std::memory_order_acquire);
+      if (!Validate(inner, version)) {
+        restart = true;
+        break;
+      }
+      parent = inner;
+      parent_version = version;
+      node = child;
+      version = ReadLock(node);
+    }
+    if (restart) {
+      continue;
+    }
+
+    Leaf* leaf = static_cast<Leaf*>(node);
+    if (!UpgradeLock(leaf, version)) {
+      continue;
+    }
+    if (parent != nullptr && !Validate(parent, parent_version)) {
+      // The leaf may no longer cover the key.
+      WriteUnlock(leaf);
+      continue;
+    }
+    const uint32_t count = leaf->count.load(std::memory_order_relaxed);
+    const uint32_t index = Rank(leaf->keys, count, key, false /* or_equal */);
+    if (index < count &&
+        compare_(leaf->keys[index].load(std::memory_order_relaxed), key) ==
+            0) {
+      WriteUnlock(leaf);
+      return false;
+    }
+    for (uint32_t i = count; i > index; i--) {
+      leaf->keys[i].store(leaf->keys[i - 1].load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    }
+    leaf->keys[index].store(key, std::memory_order_relaxed);
+    leaf->count.store(count + 1, std::memory_order_release);
+    WriteUnlock(leaf);
+    return true;
+  }
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Contains(const char* key) const {
+  Iterator iter(this);
+  iter.Seek(key);
+  return iter.Valid() && compare_(iter.key(), key) == 0;
+}
+
+template <class Comparator>
+int ConcurrentBTree<Comparator>::Height() const {
+  int height = 1;
+  const Node* node = root_.load(std::memory_order_acquire);
+  while (!node->is_leaf) {
+    node = static_cast<const Inner*>(node)->children[0].load(
+        std::memory_order_acquire);
+    height++;
+  }
+  return height;
+}
+
+template <class Comparator>
+ConcurrentBTree<Comparator>::Iterator::Iterator(const ConcurrentBTree* tree)
+    : tree_(tree),
+      count_(0),
+      pos_(0),
+      valid_(false),
+      lower_(nullptr),
+      upper_(nullptr) {}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Next() {
+  assert(Valid());
+  if (pos_ + 1 < count_) {
+    pos_++;
+  } else {
+    // Look the key up again rather than following upper_, to also see the
+    // keys inserted into the range of the leaf since it was copied.
+    SeekAfter(keys_[pos_], false /* inclusive */);
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Prev() {
+  assert(Valid());
+  if (pos_ > 0) {
+    pos_--;
+  } else {
+    SeekBefore(keys_[pos_], false /* inclusive */);
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekAfter(const char* target,
+                                                      bool inclusive) {
+  for (;;) {
+    count_ = tree_->ReadLeaf(target, false /* before */, keys_, &lower_,
+                             &upper_);
+    pos_ = 0;
+    if (target != nullptr) {
+      // The first key that is not less than (or equal to) target
+      uint32_t lo = 0;
+      uint32_t hi = count_;
+      while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        const int cmp = tree_->compare_(keys_[mid], target);
+        if (cmp < 0 || (!inclusive && cmp == 0)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      pos_ = lo;
+    }
+    if (pos_ < count_) {
+      valid_ = true;
+      return;
+    }
+    if (upper_ == nullptr) {
+      valid_ = false;
+      return;
+    }
+    // The keys after the leaf start at its upper bound.
+    target = upper_;
+    inclusive = true;
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekBefore(const char* target,
+                                                       bool inclusive) {
+  for (;;) {
+    // A null target is past the last key, so it is in the last leaf.
+    const bool before = target == nullptr || !inclusive;
+    count_ = tree_->ReadLeaf(target, before, keys_, &lower_, &upper_);
+    // The number of keys less than (or equal to) target
+    uint32_t lo = 0;
+    uint32_t hi = count_;
+    if (target != nullptr) {
+      while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        const int cmp = tree_->compare_(keys_[mid], target);
+        if (cmp < 0 || (inclusive && cmp == 0)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+    } else {
+      lo = count_;
+    }
+    if (lo > 0) {
+      pos_ = lo - 1;
+      valid_ = true;
+      return;
+    }
+    if (lower_ == nullptr) {
+      valid_ = false;
+      return;
+    }
+    // The keys before the leaf are less than its lower bound.
+    target = lower_;
+    inclusive = false;
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,219 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memtable/concurrent_btree.h"
+
+#include <atomic>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include "memory/concurrent_arena.h"
+#include "port/port.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Our test tree stores 8-byte unsigned integers
+typedef uint64_t Key;
+
+static const char* Encode(const uint64_t* key) {
+  return reinterpret_cast<const char*>(key);
+}
+
+static Key Decode(const char* key) {
+  Key rv;
+  memcpy(&rv, key, sizeof(Key));
+  return rv;
+}
+
+struct TestComparator {
+  int operator()(const char* a, const char* b) const {
+    if (Decode(a) < Decode(b)) {
+      return -1;
+    } else if (Decode(a) > Decode(b)) {
+      return +1;
+    } else {
+      return 0;
+    }
+  }
+};
+
+typedef ConcurrentBTree<TestComparator> TestBTree;
+
+class ConcurrentBTreeTest : public testing::Test {
+ public:
+  static bool Insert(TestBTree* tree, Allocator* allocator, Key key) {
+    char* buf = allocator->Allocate(sizeof(Key));
+    memcpy(buf, &key, sizeof(Key));
+    return tree->Insert(buf);
+  }
+
+  // Checks that the tree holds exactly `keys`, in both directions.
+  static void Validate(TestBTree* tree, const std::set<Key>& keys) {
+    for (Key key : keys) {
+      ASSERT_TRUE(tree->Contains(Encode(&key)));
+    }
+    TestBTree::Iterator iter(tree);
+    ASSERT_FALSE(iter.Valid());
+    iter.SeekToFirst();
+    for (Key key : keys) {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(key, Decode(iter.key()));
+      iter.Next();
+    }
+    ASSERT_FALSE(iter.Valid());
+    iter.SeekToLast();
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*it, Decode(iter.key()));
+      iter.Prev();
+    }
+    ASSERT_FALSE(iter.Valid());
+  }
+};
+
+TEST_F(ConcurrentBTreeTest, Empty) {
+  Arena arena;
+  TestComparator cmp;
+  TestBTree tree(cmp, &arena);
+  Key key = 10;
+  ASSERT_FALSE(tree.Contains(Encode(&key)));
+
+  TestBTree::Iterator iter(&tree);
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToFirst();
+  ASSERT_FALSE(iter.Valid());
+  iter.Seek(Encode(&key));
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekForPrev(Encode(&key));
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToLast();
+  ASSERT_FALSE(iter.Valid());
+}
+
+TEST_F(ConcurrentBTreeTest, InsertAndLookup) {
+  const int N = 20000;
+  const int R = 50000;
+  Random rnd(1000);
+  std::set<Key> keys;
+  Arena arena;
+  TestComparator cmp;
+  TestBTree tree(cmp, &arena);
+  for (int i = 0; i < N; i++) {
+    Key key = rnd.Next() % R;
+    ASSERT_EQ(keys.insert(key).second, Insert(&tree, &arena, key));
+  }
+  // Enough keys to need a few levels of inner nodes
+  ASSERT_GE(tree.Height(), 3);
+  Validate(&tree, keys);
+
+  for (Key i = 0; i < R + 10; i++) {
+    ASSERT_EQ(keys.count(i) == 1, tree.Contains(Encode(&i)));
+
+    TestBTree::Iterator iter(&tree);
+    iter.Seek(Encode(&i));
+    auto lower = keys.lower_bound(i);
+    if (lower == keys.end()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*lower, Decode(iter.key()));
+    }
+
+    iter.SeekForPrev(Encode(&i));
+    auto upper = keys.upper_bound(i);
+    if (upper == keys.begin()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*std::prev(upper), Decode(iter.key()));
+    }
+  }
+}
+
+TEST_F(ConcurrentBTreeTest, SequentialInsert) {
+  // Ascending and descending inserts always split the same end of the tree.
+  for (bool ascending : {true, false}) {
+    const Key N = 10000;
+    std::set<Key> keys;
+    Arena arena;
+    TestComparator cmp;
+    TestBTree tree(cmp, &arena);
+    for (Key i = 0; i < N; i++) {
+      Key key = ascending ? i : N - i;
+      keys.insert(key);
+      ASSERT_TRUE(Insert(&tree, &arena, key));
+    }
+    Validate(&tree, keys);
+  }
+}
+
+TEST_F(ConcurrentBTreeTest, ConcurrentInsert) {
+  const int kWriters = 4;
+  const Key kKeysPerWriter = 20000;
+  ConcurrentArena arena;
+  TestComparator cmp;
+  TestBTree tree(cmp, &arena);
+  std::atomic<int> writers_done(0);
+
+  std::vector<port::Thread> threads;
+  for (int w = 0; w < kWriters; w++) {
+    threads.emplace_back([&, w]() {
+      Random rnd(301 + w);
+      // Writer w inserts the keys equal to w modulo kWriters, in random
+      // order, trying each of them twice.
+      for (Key i = 0; i < 2 * kKeysPerWriter; i++) {
+        Key key = (rnd.Next() % kKeysPerWriter) * kWriters + w;
+        char* buf = arena.Allocate(sizeof(Key));
+        memcpy(buf, &key, sizeof(Key));
+        tree.Insert(buf);
+      }
+      for (Key i = 0; i < kKeysPerWriter; i++) {
+        Key key = i * kWriters + w;
+        char* buf = arena.Allocate(sizeof(Key));
+        memcpy(buf, &key, sizeof(Key));
+        tree.Insert(buf);
+      }
+      writers_done.fetch_add(1);
+    });
+  }
+  // Scans concurrent with the inserts always see the keys in order.
+  std::atomic<bool> reader_ok(true);
+  threads.emplace_back([&]() {
+    while (writers_done.load() < kWriters) {
+      TestBTree::Iterator iter(&tree);
+      iter.SeekToFirst();
+      Key last = 0;
+      bool first = true;
+      for (; iter.Valid(); iter.Next()) {
+        Key key = Decode(iter.key());
+        if (!first && key <= last) {
+          reader_ok.store(false);
+        }
+        last = key;
+        first = false;
+      }
+    }
+  });
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_TRUE(reader_ok.load());
+
+  std::set<Key> keys;
+  for (Key i = 0; i < kWriters * kKeysPerWriter; i++) {
+    keys.insert(i);
+  }
+  Validate(&tree, keys);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
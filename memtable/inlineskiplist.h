@@ -46,6 +46,7 @@
 #include <algorithm>
 #include <atomic>
 #include <type_traits>
+#include <vector>
 #include "memory/allocator.h"
 #include "port/likely.h"
 #include "port/port.h"
@@ -141,6 +142,12 @@ class InlineSkipList {
   // Return estimated number of entries smaller than `key`.
   uint64_t EstimateCount(const char* key) const;
 
+  // Returns a random entry of the list, or nullptr if the list is empty. The
+  // entry is picked by a random walk down the levels of the list, so it takes
+  // O(log n) time, but the entries are not all picked with the same
+  // probability.
+  const char* FindRandomEntry() const;
+
   // Validate correctness of the skip-list.
   void TEST_Validate() const;
 
@@ -953,6 +960,32 @@ bool InlineSkipList<Comparator>::Contains(const char* key) const {
   }
 }
 
+template <class Comparator>
+const char* InlineSkipList<Comparator>::FindRandomEntry() const {
+  Random* rnd = Random::GetTLSInstance();
+  Node* x = head_;
+  Node* limit = nullptr;
+  std::vector<Node*> candidates;
+  // At each level, pick one of the nodes between x and limit, and narrow
+  // the range down to the nodes that follow it at the next level.
+  for (int level = GetMaxHeight() - 1; level >= 0; level--) {
+    candidates.clear();
+    for (Node* node = x; node != limit; node = node->Next(level)) {
+      candidates.push_back(node);
+    }
+    const size_t index = rnd->Next() % candidates.size();
+    x = candidates[index];
+    if (index + 1 < candidates.size()) {
+      limit = candidates[index + 1];
+    }
+  }
+  if (x == head_) {
+    // The head holds no key.
+    x = head_->Next(0);
+  }
+  return x == nullptr ? nullptr : x->Key();
+}
+
 template <class Comparator>
 void InlineSkipList<Comparator>::TEST_Validate() const {
   // Interate over all levels at the same time, and verify nodes appear in
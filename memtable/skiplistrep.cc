@@ -95,6 +95,27 @@ public:
     return (end_count >= start_count) ? (end_count - start_count) : 0;
   }
 
+  void UniqueRandomSample(const uint64_t num_entries,
+                          const uint64_t target_sample_size,
+                          std::unordered_set<const char*>* entries) override {
+    // Random walks are cheaper than a full scan as long as the sample is
+    // small, and then they rarely pick the same entry twice.
+    if (target_sample_size * target_sample_size > num_entries) {
+      MemTableRep::UniqueRandomSample(num_entries, target_sample_size,
+                                      entries);
+      return;
+    }
+    for (uint64_t i = 0; i < target_sample_size; i++) {
+      // Give up on an entry after a few duplicates.
+      for (int attempt = 0; attempt < 5; attempt++) {
+        const char* entry = skip_list_.FindRandomEntry();
+        if (entry == nullptr || entries->insert(entry).second) {
+          break;
+        }
+      }
+    }
+  }
+
   ~SkipListRep() override {}
 
   // Iteration over the contents of a skip list
@@ -0,0 +1,382 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+#ifndef ROCKSDB_LITE
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "memtable/stl_wrappers.h"
+#include "port/port.h"
+#include "rocksdb/memtablerep.h"
+#include "util/core_local.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+
+using namespace stl_wrappers;
+
+// SortedRunRep appends the keys to a buffer of the core the writer runs on,
+// so concurrent writers rarely share anything. Once a buffer holds run_size
+// keys, the writer that filled it seals it as a run and sorts the run,
+// without holding the lock of the buffer.
+//
+// Readers take a snapshot of all the buffers and runs. Get() searches the
+// sorted runs and the few keys that are not sorted yet. An iterator merges
+// all of them into one sorted array; once the memtable is immutable, that
+// array is built by the first iterator and shared by the later ones, so the
+// flush reads keys that are already sorted.
+class SortedRunRep : public MemTableRep {
+ public:
+  SortedRunRep(const KeyComparator& compare, Allocator* allocator,
+               size_t run_size);
+
+  // Insert key into the collection. (The caller will pack key and value into a
+  // single buffer and pass that in as the parameter to Insert)
+  // REQUIRES: nothing that compares equal to key is currently in the
+  // collection.
+  void Insert(KeyHandle handle) override;
+
+  void InsertConcurrently(KeyHandle handle) override { Insert(handle); }
+
+  // Returns true iff an entry that compares equal to key is in the collection.
+  bool Contains(const char* key) const override;
+
+  void MarkReadOnly() override;
+
+  size_t ApproximateMemoryUsage() override;
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override;
+
+  ~SortedRunRep() override {}
+
+  // Return an iterator over the keys in this representation.
+  MemTableRep::Iterator* GetIterator(Arena* arena) override;
+
+ private:
+  typedef std::vector<const char*> Run;
+
+  struct SealedRun {
+    std::shared_ptr<const Run> keys;
+    bool sorted;
+  };
+
+  struct Buffer {
+    SpinMutex mutex;
+    // The keys that are not part of a run yet
+    Run keys;
+    // The runs sealed from this buffer. A run is replaced with a sorted copy
+    // once the writer that sealed it has sorted it.
+    std::vector<SealedRun> runs;
+    char padding[CACHE_LINE_SIZE] ROCKSDB_FIELD_UNUSED;
+  };
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    Iterator(std::shared_ptr<const Run> keys, const KeyComparator& compare)
+        : keys_(std::move(keys)), pos_(keys_->size()), compare_(compare) {}
+
+    ~Iterator() override {}
+
+    // Returns true iff the iterator is positioned at a valid node.
+    bool Valid() const override { return pos_ < keys_->size(); }
+
+    // Returns the key at the current position.
+    // REQUIRES: Valid()
+    const char* key() const override {
+      assert(Valid());
+      return (*keys_)[pos_];
+    }
+
+    // Advances to the next position.
+    // REQUIRES: Valid()
+    void Next() override {
+      assert(Valid());
+      pos_++;
+    }
+
+    // Advances to the previous position.
+    // REQUIRES: Valid()
+    void Prev() override {
+      assert(Valid());
+      pos_ = pos_ == 0 ? keys_->size() : pos_ - 1;
+    }
+
+    // Advance to the first entry with a key >= target
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      const char* target =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+      pos_ = std::lower_bound(keys_->begin(), keys_->end(), target,
+                              Compare(compare_)) -
+             keys_->begin();
+    }
+
+    // Retreat to the last entry with a key <= target
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override {
+      const char* target =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+      pos_ = std::upper_bound(keys_->begin(), keys_->end(), target,
+                              Compare(compare_)) -
+             keys_->begin();
+      pos_ = pos_ == 0 ? keys_->size() : pos_ - 1;
+    }
+
+    // Position at the first entry in collection.
+    // Final state of iterator is Valid() iff collection is not empty.
+    void SeekToFirst() override { pos_ = 0; }
+
+    // Position at the last entry in collection.
+    // Final state of iterator is Valid() iff collection is not empty.
+    void SeekToLast() override {
+      pos_ = keys_->empty() ? 0 : keys_->size() - 1;
+    }
+
+   private:
+    std::shared_ptr<const Run> keys_;
+    size_t pos_;
+    const KeyComparator& compare_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  // Appends the sorted runs of all the buffers to `runs`, and all the other
+  // keys to `unsorted`.
+  void Snapshot(std::vector<std::shared_ptr<const Run>>* runs,
+                Run* unsorted) const;
+
+  // Returns all the keys, sorted.
+  std::shared_ptr<const Run> MergeAll() const;
+
+  // Counts the memory of run_size_ more keys: their slots in a buffer, and
+  // the ones reserved for them in merged_. merged_ is only built after the
+  // memtable list recorded the memory usage of the immutable memtable, which
+  // must not change afterwards, so it is counted as the keys are inserted.
+  void AddRunMemoryUsage() {
+    memory_usage_.fetch_add(2 * run_size_ * sizeof(const char*),
+                            std::memory_order_relaxed);
+  }
+
+  const KeyComparator& compare_;
+  const size_t run_size_;
+  CoreLocalArray<Buffer> buffers_;
+  std::atomic<size_t> memory_usage_;
+  std::atomic<bool> immutable_;
+  // All the keys, sorted, once the memtable is immutable and an iterator was
+  // created
+  std::shared_ptr<const Run> merged_;
+  port::Mutex merged_mutex_;
+};
+
+SortedRunRep::SortedRunRep(const KeyComparator& compare, Allocator* allocator,
+                           size_t run_size)
+    : MemTableRep(allocator),
+      compare_(compare),
+      run_size_(std::max<size_t>(run_size, 1)),
+      memory_usage_(0),
+      immutable_(false) {}
+
+void SortedRunRep::Insert(KeyHandle handle) {
+  assert(!immutable_.load(std::memory_order_relaxed));
+  const char* key = static_cast<char*>(handle);
+  Buffer* buffer = buffers_.Access();
+  std::shared_ptr<Run> run;
+  size_t run_index;
+  {
+    std::lock_guard<SpinMutex> lock(buffer->mutex);
+    if (buffer->keys.capacity() == 0) {
+      buffer->keys.reserve(run_size_);
+      AddRunMemoryUsage();
+    }
+    buffer->keys.push_back(key);
+    if (buffer->keys.size() < run_size_) {
+      return;
+    }
+    // Readers treat the run as unsorted until its sorted copy replaces it.
+    run = std::make_shared<Run>();
+    run->swap(buffer->keys);
+    buffer->keys.reserve(run_size_);
+    run_index = buffer->runs.size();
+    buffer->runs.push_back({run, false /* sorted */});
+  }
+  AddRunMemoryUsage();
+
+  std::shared_ptr<Run> sorted = std::make_shared<Run>(*run);
+  std::sort(sorted->begin(), sorted->end(), Compare(compare_));
+  std::lock_guard<SpinMutex> lock(buffer->mutex);
+  buffer->runs[run_index] = {sorted, true /* sorted */};
+}
+
+bool SortedRunRep::Contains(const char* key) const {
+  auto equal = [&](const char* k) { return compare_(k, key) == 0; };
+  for (size_t i = 0; i < buffers_.Size(); i++) {
+    Buffer* buffer = buffers_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> lock(buffer->mutex);
+    if (std::find_if(buffer->keys.begin(), buffer->keys.end(), equal) !=
+        buffer->keys.end()) {
+      return true;
+    }
+    for (const SealedRun& run : buffer->runs) {
+      if (run.sorted ? std::binary_search(run.keys->begin(), run.keys->end(),
+                                          key, Compare(compare_))
+                     : std::find_if(run.keys->begin(), run.keys->end(),
+                                    equal) != run.keys->end()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void SortedRunRep::MarkReadOnly() {
+  // The runs are merged by the first iterator rather than here, so that the
+  // write that switched the memtable does not wait for it.
+  immutable_.store(true, std::memory_order_release);
+}
+
+size_t SortedRunRep::ApproximateMemoryUsage() {
+  return memory_usage_.load(std::memory_order_relaxed);
+}
+
+void SortedRunRep::Snapshot(std::vector<std::shared_ptr<const Run>>* runs,
+                            Run* unsorted) const {
+  for (size_t i = 0; i < buffers_.Size(); i++) {
+    Buffer* buffer = buffers_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> lock(buffer->mutex);
+    unsorted->insert(unsorted->end(), buffer->keys.begin(),
+                     buffer->keys.end());
+    for (const SealedRun& run : buffer->runs) {
+      if (run.sorted) {
+        runs->push_back(run.keys);
+      } else {
+        unsorted->insert(unsorted->end(), run.keys->begin(), run.keys->end());
+      }
+    }
+  }
+}
+
+std::shared_ptr<const SortedRunRep::Run> SortedRunRep::MergeAll() const {
+  std::vector<std::shared_ptr<const Run>> runs;
+  std::shared_ptr<Run> unsorted = std::make_shared<Run>();
+  Snapshot(&runs, unsorted.get());
+  if (!unsorted->empty()) {
+    std::sort(unsorted->begin(), unsorted->end(), Compare(compare_));
+    runs.push_back(unsorted);
+  }
+  if (runs.empty()) {
+    return unsorted;
+  }
+  // Merge the runs pairwise, which takes log(number of runs) passes.
+  while (runs.size() > 1) {
+    std::vector<std::shared_ptr<const Run>> next;
+    for (size_t i = 0; i + 1 < runs.size(); i += 2) {
+      const Run& a = *runs[i];
+      const Run& b = *runs[i + 1];
+      std::shared_ptr<Run> merged = std::make_shared<Run>();
+      merged->reserve(a.size() + b.size());
+      std::merge(a.begin(), a.end(), b.begin(), b.end(),
+                 std::back_inserter(*merged), Compare(compare_));
+      next.push_back(merged);
+    }
+    if (runs.size() % 2 != 0) {
+      next.push_back(runs.back());
+    }
+    runs.swap(next);
+  }
+  return runs[0];
+}
+
+void SortedRunRep::Get(const LookupKey& k, void* callback_args,
+                       bool (*callback_func)(void* arg, const char* entry)) {
+  std::shared_ptr<const Run> merged;
+  if (immutable_.load(std::memory_order_acquire)) {
+    MutexLock l(&merged_mutex_);
+    merged = merged_;
+  }
+  if (merged != nullptr) {
+    SortedRunRep::Iterator iter(merged, compare_);
+    for (iter.Seek(k.user_key(), k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+    return;
+  }
+
+  const char* target = k.memtable_key().data();
+  std::vector<std::shared_ptr<const Run>> runs;
+  Run unsorted;
+  Snapshot(&runs, &unsorted);
+  // Only the keys from the target on can be passed to the callback.
+  unsorted.erase(std::remove_if(unsorted.begin(), unsorted.end(),
+                                [&](const char* key) {
+                                  return compare_(key, target) < 0;
+                                }),
+                 unsorted.end());
+  std::sort(unsorted.begin(), unsorted.end(), Compare(compare_));
+
+  struct Cursor {
+    Run::const_iterator pos;
+    Run::const_iterator end;
+  };
+  std::vector<Cursor> cursors;
+  if (!unsorted.empty()) {
+    cursors.push_back({unsorted.cbegin(), unsorted.cend()});
+  }
+  for (const auto& run : runs) {
+    auto pos =
+        std::lower_bound(run->begin(), run->end(), target, Compare(compare_));
+    if (pos != run->end()) {
+      cursors.push_back({pos, run->end()});
+    }
+  }
+  // The callback usually stops after the entries of one user key, so picking
+  // the smallest key with a linear scan over the runs is cheap enough.
+  while (!cursors.empty()) {
+    size_t min = 0;
+    for (size_t i = 1; i < cursors.size(); i++) {
+      if (compare_(*cursors[i].pos, *cursors[min].pos) < 0) {
+        min = i;
+      }
+    }
+    if (!callback_func(callback_args, *cursors[min].pos)) {
+      break;
+    }
+    if (++cursors[min].pos == cursors[min].end) {
+      cursors[min] = cursors.back();
+      cursors.pop_back();
+    }
+  }
+}
+
+MemTableRep::Iterator* SortedRunRep::GetIterator(Arena* arena) {
+  std::shared_ptr<const Run> keys;
+  if (immutable_.load(std::memory_order_acquire)) {
+    MutexLock l(&merged_mutex_);
+    if (merged_ == nullptr) {
+      // Already counted in memory_usage_ by Insert()
+      merged_ = MergeAll();
+    }
+    keys = merged_;
+  } else {
+    keys = MergeAll();
+  }
+  void* mem = arena ? arena->AllocateAligned(sizeof(SortedRunRep::Iterator))
+                    : operator new(sizeof(SortedRunRep::Iterator));
+  return new (mem) SortedRunRep::Iterator(std::move(keys), compare_);
+}
+}  // anon namespace
+
+MemTableRep* SortedRunRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform*, Logger* /*logger*/) {
+  return new SortedRunRep(compare, allocator, run_size_);
+}
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -191,6 +191,14 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.block.cache.compression.dict.add.redundant"},
     {FILES_MARKED_TRASH, "rocksdb.files.marked.trash"},
     {FILES_DELETED_IMMEDIATELY, "rocksdb.files.deleted.immediately"},
+    {SECONDARY_CACHE_HITS, "rocksdb.secondary.cache.hits"},
+    {SECONDARY_CACHE_MISSES, "rocksdb.secondary.cache.misses"},
+    {BLOB_DB_CACHE_MISS, "rocksdb.blobdb.cache.miss"},
+    {BLOB_DB_CACHE_HIT, "rocksdb.blobdb.cache.hit"},
+    {BLOB_DB_CACHE_ADD, "rocksdb.blobdb.cache.add"},
+    {BLOB_DB_CACHE_ADD_FAILURES, "rocksdb.blobdb.cache.add.failures"},
+    {RANGE_FILTER_CHECKED, "rocksdb.range.filter.checked"},
+    {RANGE_FILTER_USEFUL, "rocksdb.range.filter.useful"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
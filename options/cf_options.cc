@@ -244,6 +244,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    hard_pending_compaction_bytes_limit),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"pending_compaction_bytes_target",
+         {offsetof(struct MutableCFOptions, pending_compaction_bytes_target),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"hard_rate_limit",
          {0, OptionType::kDouble, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -845,6 +849,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
       compaction_thread_limiter(cf_options.compaction_thread_limiter),
       file_checksum_gen_factory(db_options.file_checksum_gen_factory.get()),
       sst_partitioner_factory(cf_options.sst_partitioner_factory),
+      blob_cache(cf_options.blob_cache),
       allow_data_in_errors(db_options.allow_data_in_errors),
       db_host_id(db_options.db_host_id) {}
 
@@ -935,6 +940,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  soft_pending_compaction_bytes_limit);
   ROCKS_LOG_INFO(log, "      hard_pending_compaction_bytes_limit: %" PRIu64,
                  hard_pending_compaction_bytes_limit);
+  ROCKS_LOG_INFO(log, "          pending_compaction_bytes_target: %" PRIu64,
+                 pending_compaction_bytes_target);
   ROCKS_LOG_INFO(log, "       level0_file_num_compaction_trigger: %d",
                  level0_file_num_compaction_trigger);
   ROCKS_LOG_INFO(log, "           level0_slowdown_writes_trigger: %d",
@@ -19,6 +19,7 @@
 #include "rocksdb/sst_file_manager.h"
 #include "rocksdb/utilities/options_type.h"
 #include "rocksdb/wal_filter.h"
+#include "util/compression.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -427,6 +428,22 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, allow_data_in_errors),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"wal_compression",
+         {offsetof(struct ImmutableDBOptions, wal_compression),
+          OptionType::kCompressionType, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"enable_pipelined_wal_recovery",
+         {offsetof(struct ImmutableDBOptions, enable_pipelined_wal_recovery),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_flush_partitions",
+         {offsetof(struct ImmutableDBOptions, max_flush_partitions),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"enable_pipelined_compaction",
+         {offsetof(struct ImmutableDBOptions, enable_pipelined_compaction),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kDBOptionsName = "DBOptions";
@@ -580,7 +597,12 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       max_bgerror_resume_count(options.max_bgerror_resume_count),
       bgerror_resume_retry_interval(options.bgerror_resume_retry_interval),
       allow_data_in_errors(options.allow_data_in_errors),
-      db_host_id(options.db_host_id) {
+      db_host_id(options.db_host_id),
+      wal_compression(options.wal_compression),
+      enable_pipelined_wal_recovery(options.enable_pipelined_wal_recovery),
+      compaction_service(options.compaction_service),
+      max_flush_partitions(options.max_flush_partitions),
+      enable_pipelined_compaction(options.enable_pipelined_compaction) {
 }
 
 void ImmutableDBOptions::Dump(Logger* log) const {
@@ -744,6 +766,16 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    allow_data_in_errors);
   ROCKS_LOG_HEADER(log, "            Options.db_host_id: %s",
                    db_host_id.c_str());
+  ROCKS_LOG_HEADER(log, "            Options.wal_compression: %s",
+                   CompressionTypeToString(wal_compression).c_str());
+  ROCKS_LOG_HEADER(log, "            Options.enable_pipelined_wal_recovery: %d",
+                   enable_pipelined_wal_recovery);
+  ROCKS_LOG_HEADER(log, "            Options.compaction_service: %s",
+                   compaction_service ? compaction_service->Name() : "None");
+  ROCKS_LOG_HEADER(log, "            Options.max_flush_partitions: %" PRIu32,
+                   max_flush_partitions);
+  ROCKS_LOG_HEADER(log, "            Options.enable_pipelined_compaction: %d",
+                   enable_pipelined_compaction);
 }
 
 MutableDBOptions::MutableDBOptions()
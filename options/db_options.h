@@ -93,6 +93,11 @@ struct ImmutableDBOptions {
   uint64_t bgerror_resume_retry_interval;
   bool allow_data_in_errors;
   std::string db_host_id;
+  CompressionType wal_compression;
+  bool enable_pipelined_wal_recovery;
+  std::shared_ptr<CompactionService> compaction_service;
+  uint32_t max_flush_partitions;
+  bool enable_pipelined_compaction;
 };
 
 struct MutableDBOptions {
@@ -168,6 +168,13 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
       immutable_db_options.bgerror_resume_retry_interval;
   options.db_host_id = immutable_db_options.db_host_id;
   options.allow_data_in_errors = immutable_db_options.allow_data_in_errors;
+  options.wal_compression = immutable_db_options.wal_compression;
+  options.enable_pipelined_wal_recovery =
+      immutable_db_options.enable_pipelined_wal_recovery;
+  options.compaction_service = immutable_db_options.compaction_service;
+  options.max_flush_partitions = immutable_db_options.max_flush_partitions;
+  options.enable_pipelined_compaction =
+      immutable_db_options.enable_pipelined_compaction;
   return options;
 }
 
@@ -197,6 +204,8 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
       mutable_cf_options.soft_pending_compaction_bytes_limit;
   cf_opts.hard_pending_compaction_bytes_limit =
       mutable_cf_options.hard_pending_compaction_bytes_limit;
+  cf_opts.pending_compaction_bytes_target =
+      mutable_cf_options.pending_compaction_bytes_target;
   cf_opts.level0_file_num_compaction_trigger =
       mutable_cf_options.level0_file_num_compaction_trigger;
   cf_opts.level0_slowdown_writes_trigger =
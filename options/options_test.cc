@@ -1094,6 +1094,12 @@ TEST_F(OptionsTest, GetMemTableRepFactoryFromString) {
   ASSERT_NOK(GetMemTableRepFactoryFromString("skip_list:16:invalid_opt",
                                              &new_mem_factory));
 
+  ASSERT_OK(GetMemTableRepFactoryFromString("btree", &new_mem_factory));
+  ASSERT_EQ(std::string(new_mem_factory->Name()), "BTreeFactory");
+  ASSERT_OK(GetMemTableRepFactoryFromString("BTreeFactory", &new_mem_factory));
+  ASSERT_EQ(std::string(new_mem_factory->Name()), "BTreeFactory");
+  ASSERT_NOK(GetMemTableRepFactoryFromString("btree:16", &new_mem_factory));
+
   ASSERT_OK(GetMemTableRepFactoryFromString("prefix_hash", &new_mem_factory));
   ASSERT_OK(GetMemTableRepFactoryFromString("prefix_hash:1000",
                                             &new_mem_factory));
@@ -1115,6 +1121,13 @@ TEST_F(OptionsTest, GetMemTableRepFactoryFromString) {
   ASSERT_NOK(GetMemTableRepFactoryFromString("vector:1024:invalid_opt",
                                              &new_mem_factory));
 
+  ASSERT_OK(GetMemTableRepFactoryFromString("sorted_run", &new_mem_factory));
+  ASSERT_OK(GetMemTableRepFactoryFromString("sorted_run:1024",
+                                            &new_mem_factory));
+  ASSERT_EQ(std::string(new_mem_factory->Name()), "SortedRunRepFactory");
+  ASSERT_NOK(GetMemTableRepFactoryFromString("sorted_run:1024:invalid_opt",
+                                             &new_mem_factory));
+
   ASSERT_NOK(GetMemTableRepFactoryFromString("cuckoo", &new_mem_factory));
   // CuckooHash memtable is already removed.
   ASSERT_NOK(GetMemTableRepFactoryFromString("cuckoo:1024", &new_mem_factory));
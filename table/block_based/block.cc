@@ -21,8 +21,16 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/learned_index_model.h"
 #include "table/format.h"
 #include "util/coding.h"
+#include "util/math.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -275,7 +283,9 @@ void DataBlockIter::SeekImpl(const Slice& target) {
 //    but larger type).
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
-  uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  uint32_t map_offset =
+      restarts_ + num_restarts_ * sizeof(uint32_t) *
+                      (restart_key_prefixes_ != nullptr ? 2 : 1);
   uint8_t entry =
       data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
@@ -396,6 +406,13 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (learned_model_ != nullptr) {
+    if (value_delta_encoded_) {
+      ok = LearnedSeek<DecodeKeyV4>(target, seek_key, &index,
+                                    &skip_linear_scan);
+    } else {
+      ok = LearnedSeek<DecodeKey>(target, seek_key, &index, &skip_linear_scan);
+    }
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -695,6 +712,134 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
     return false;
   }
 
+  int64_t left = -1, right = num_restarts_ - 1;
+  if (restart_key_prefixes_ != nullptr) {
+    RestartKeyPrefixSeek(target, &left, &right);
+  }
+  return BinarySeekInRange<DecodeKeyFunc>(target, left, right, index,
+                                          skip_linear_scan);
+}
+
+namespace {
+// Arrays of restart key prefixes up to this size are scanned, with vector
+// instructions where available, rather than bisected.
+const uint32_t kMaxRestartKeyPrefixesToScan = 64;
+
+// Counts the sorted fixed32 `prefixes` that are less than `prefix`, and those
+// that are greater than it.
+void CountRestartKeyPrefixes(const char* prefixes, uint32_t n, uint32_t prefix,
+                             uint32_t* num_less, uint32_t* num_greater) {
+  uint32_t less = 0;
+  uint32_t greater = 0;
+  uint32_t i = 0;
+#if defined(__AVX2__)
+  // AVX2 only compares signed integers, so flip the sign bit of both sides.
+  const __m256i sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+  const __m256i target =
+      _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(prefix)), sign);
+  for (; i + 8 <= n; i += 8) {
+    const __m256i values = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+            prefixes + i * sizeof(uint32_t))),
+        sign);
+    less += BitsSetToOne(static_cast<uint32_t>(_mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(target, values)))));
+    greater += BitsSetToOne(static_cast<uint32_t>(_mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(values, target)))));
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  const uint32x4_t target = vdupq_n_u32(prefix);
+  for (; i + 4 <= n; i += 4) {
+    const uint32x4_t values = vreinterpretq_u32_u8(vld1q_u8(
+        reinterpret_cast<const uint8_t*>(prefixes + i * sizeof(uint32_t))));
+    // The lanes of a comparison are all ones where it holds.
+    less += vaddvq_u32(vshrq_n_u32(vcltq_u32(values, target), 31));
+    greater += vaddvq_u32(vshrq_n_u32(vcgtq_u32(values, target), 31));
+  }
+#endif
+  for (; i < n; i++) {
+    const uint32_t value = DecodeFixed32(prefixes + i * sizeof(uint32_t));
+    less += value < prefix ? 1 : 0;
+    greater += value > prefix ? 1 : 0;
+  }
+  *num_less = less;
+  *num_greater = greater;
+}
+}  // namespace
+
+template <class TValue>
+void BlockIter<TValue>::RestartKeyPrefixSeek(const Slice& target,
+                                             int64_t* left, int64_t* right) {
+  assert(restart_key_prefixes_ != nullptr);
+  const uint32_t prefix = RestartKeyPrefix(
+      raw_key_.IsUserKey() ? target : ExtractUserKey(target));
+  auto prefix_at = [this](uint32_t i) {
+    return DecodeFixed32(restart_key_prefixes_ + i * sizeof(uint32_t));
+  };
+
+  // Bisect to the window of restart points sharing the prefix of `target`
+  // until it is small enough to be scanned.
+  uint32_t begin = 0;
+  uint32_t end = num_restarts_;
+  while (end - begin > kMaxRestartKeyPrefixesToScan) {
+    const uint32_t mid = begin + (end - begin) / 2;
+    const uint32_t mid_prefix = prefix_at(mid);
+    if (mid_prefix < prefix) {
+      begin = mid + 1;
+    } else if (mid_prefix > prefix) {
+      end = mid;
+    } else {
+      break;
+    }
+  }
+  // The window may still be large if many restart keys share the prefix. Only
+  // its boundaries matter then, so find them by bisection too.
+  uint32_t first = begin;
+  uint32_t last = end;
+  if (end - begin > kMaxRestartKeyPrefixesToScan) {
+    uint32_t lo = begin;
+    uint32_t hi = end;
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      if (prefix_at(mid) < prefix) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    first = lo;
+    hi = end;
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      if (prefix_at(mid) <= prefix) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    last = lo;
+  } else {
+    uint32_t num_less = 0;
+    uint32_t num_greater = 0;
+    CountRestartKeyPrefixes(restart_key_prefixes_ + begin * sizeof(uint32_t),
+                            end - begin, prefix, &num_less, &num_greater);
+    first = begin + num_less;
+    last = end - num_greater;
+  }
+
+  // The restart keys before `first` have a smaller prefix, so they are less
+  // than `target`, and those from `last` on are greater than it.
+  *left = static_cast<int64_t>(first) - 1;
+  *right = static_cast<int64_t>(last) - 1;
+}
+
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::BinarySeekInRange(const Slice& target, int64_t left,
+                                          int64_t right, uint32_t* index,
+                                          bool* skip_linear_scan) {
+  assert(-1 <= left && left <= right);
   *skip_linear_scan = false;
   // Loop invariants:
   // - Restart key at index `left` is less than or equal to the target key. The
@@ -702,7 +847,6 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -742,6 +886,75 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   return true;
 }
 
+template <typename DecodeKeyFunc>
+bool IndexBlockIter::LearnedSeek(const Slice& target, const Slice& seek_key,
+                                 uint32_t* index, bool* skip_linear_scan) {
+  if (restarts_ == 0) {
+    // Index block of a range tombstone only file, see BinarySeek().
+    return false;
+  }
+
+  const int64_t last = static_cast<int64_t>(num_restarts_) - 1;
+  const int64_t predicted = std::min<int64_t>(
+      learned_model_->Predict(ExtractUserKey(target)), last);
+  // Find a window (left, right] satisfying the invariants of
+  // BinarySeekInRange() by galloping away from the predicted restart point,
+  // doubling the step until the key compares on the other side of target.
+  int64_t left = -1;
+  int64_t right = last;
+  int cmp = CompareBlockKey(static_cast<uint32_t>(predicted), seek_key);
+  if (!status_.ok()) {
+    return false;
+  }
+  int64_t exact = -1;
+  if (cmp == 0) {
+    exact = predicted;
+  } else if (cmp < 0) {
+    left = predicted;
+    for (int64_t step = 1; left < right; step *= 2) {
+      const int64_t probe = std::min(left + step, right);
+      cmp = CompareBlockKey(static_cast<uint32_t>(probe), seek_key);
+      if (!status_.ok()) {
+        return false;
+      }
+      if (cmp < 0) {
+        left = probe;
+      } else {
+        if (cmp == 0) {
+          exact = probe;
+        }
+        right = probe - 1;
+        break;
+      }
+    }
+  } else {
+    right = predicted - 1;
+    for (int64_t step = 1; left < right; step *= 2) {
+      const int64_t probe = std::max<int64_t>(right + 1 - step, 0);
+      cmp = CompareBlockKey(static_cast<uint32_t>(probe), seek_key);
+      if (!status_.ok()) {
+        return false;
+      }
+      if (cmp > 0) {
+        right = probe - 1;
+      } else {
+        if (cmp == 0) {
+          exact = probe;
+        }
+        left = probe;
+        break;
+      }
+    }
+  }
+  if (exact >= 0) {
+    *skip_linear_scan = true;
+    *index = static_cast<uint32_t>(exact);
+    return true;
+  }
+  return BinarySeekInRange<DecodeKeyFunc>(seek_key, left, right, index,
+                                          skip_linear_scan);
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
@@ -873,6 +1086,7 @@ bool IndexBlockIter::PrefixSeek(const Slice& target, uint32_t* index,
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2 * sizeof(uint32_t));
   uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  UnPackRestartKeyPrefixes(&block_footer);
   uint32_t num_restarts = block_footer;
   if (size_ > kMaxBlockSizeSupportedByHashIndex) {
     // In BlockBuilder, we have ensured a block with HashIndex is less than
@@ -899,6 +1113,7 @@ BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
     return BlockBasedTableOptions::kDataBlockBinarySearch;
   }
   uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  UnPackRestartKeyPrefixes(&block_footer);
   uint32_t num_restarts = block_footer;
   BlockBasedTableOptions::DataBlockIndexType index_type;
   UnPackIndexTypeAndNumRestarts(block_footer, &index_type, &num_restarts);
@@ -917,18 +1132,25 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
       data_(contents_.data.data()),
       size_(contents_.data.size()),
       restart_offset_(0),
-      num_restarts_(0) {
+      num_restarts_(0),
+      has_restart_key_prefixes_(false) {
   TEST_SYNC_POINT("Block::Block:0");
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
     // Should only decode restart points for uncompressed blocks
     num_restarts_ = NumRestarts();
+    uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+    has_restart_key_prefixes_ = UnPackRestartKeyPrefixes(&block_footer);
+    // The size of the restart array, and of the restart key prefixes after it
+    const size_t restarts_size = num_restarts_ * sizeof(uint32_t) *
+                                 (has_restart_key_prefixes_ ? 2 : 1);
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
         restart_offset_ = static_cast<uint32_t>(size_) -
-                          (1 + num_restarts_) * sizeof(uint32_t);
-        if (restart_offset_ > size_ - sizeof(uint32_t)) {
+                          static_cast<uint32_t>(restarts_size) -
+                          static_cast<uint32_t>(sizeof(uint32_t));
+        if (restarts_size > size_ - sizeof(uint32_t)) {
           // The size is too small for NumRestarts() and therefore
           // restart_offset_ wrapped around.
           size_ = 0;
@@ -949,9 +1171,10 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
                                                  NUM_RESTARTS*/
             &map_offset);
 
-        restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
+        restart_offset_ =
+            map_offset - static_cast<uint32_t>(restarts_size);
 
-        if (restart_offset_ > map_offset) {
+        if (restarts_size > map_offset) {
           // map_offset is too small for NumRestarts() and
           // therefore restart_offset_ wrapped around.
           size_ = 0;
@@ -990,7 +1213,8 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
     ret_iter->Initialize(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         read_amp_bitmap_.get(), block_contents_pinned,
-        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
+        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        has_restart_key_prefixes_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1006,7 +1230,8 @@ IndexBlockIter* Block::NewIndexIterator(
     const Comparator* raw_ucmp, SequenceNumber global_seqno,
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
-    bool block_contents_pinned, BlockPrefixIndex* prefix_index) {
+    bool block_contents_pinned, BlockPrefixIndex* prefix_index,
+    const LearnedIndexModel* learned_model) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1027,7 +1252,8 @@ IndexBlockIter* Block::NewIndexIterator(
     ret_iter->Initialize(raw_ucmp, data_, restart_offset_, num_restarts_,
                          global_seqno, prefix_index_ptr, have_first_key,
                          key_includes_seq, value_is_full,
-                         block_contents_pinned);
+                         block_contents_pinned, learned_model,
+                         has_restart_key_prefixes_);
   }
 
   return ret_iter;
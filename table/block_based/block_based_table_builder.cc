@@ -38,6 +38,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/range_filter.h"
 #include "table/format.h"
 #include "table/table_builder.h"
 
@@ -220,7 +221,13 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
 
   Status Finish(UserCollectedProperties* properties) override {
     std::string val;
-    PutFixed32(&val, static_cast<uint32_t>(index_type_));
+    // A learned index is a binary search index plus the meta block of its
+    // model, so it is recorded as kBinarySearch for older versions to read.
+    BlockBasedTableOptions::IndexType index_type = index_type_;
+    if (index_type == BlockBasedTableOptions::kLearnedIndexSearch) {
+      index_type = BlockBasedTableOptions::kBinarySearch;
+    }
+    PutFixed32(&val, static_cast<uint32_t>(index_type));
     properties->insert({BlockBasedTablePropertyNames::kIndexType, val});
     properties->insert({BlockBasedTablePropertyNames::kWholeKeyFiltering,
                         whole_key_filtering_ ? kPropTrue : kPropFalse});
@@ -308,6 +315,7 @@ struct BlockBasedTableBuilder::Rep {
 
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
+  std::unique_ptr<RangeFilterBuilder> range_filter_builder;
   char compressed_cache_key_prefix[BlockBasedTable::kMaxCacheKeyPrefixSize];
   size_t compressed_cache_key_prefix_size;
 
@@ -424,7 +432,9 @@ struct BlockBasedTableBuilder::Rep {
                            ->CanKeysWithDifferentByteContentsBeEqual()
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
-                   table_options.data_block_hash_table_util_ratio),
+                   table_options.data_block_hash_table_util_ratio,
+                   table_options.store_restart_key_prefixes &&
+                       icomparator.user_comparator() == BytewiseComparator()),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(_moptions.prefix_extractor.get()),
         compression_type(_compression_type),
@@ -469,18 +479,28 @@ struct BlockBasedTableBuilder::Rep {
           &this->internal_prefix_transform, use_delta_encoding_for_index_values,
           table_options));
     }
+    FilterBuildingContext context(table_options);
+    context.column_family_name = column_family_name;
+    context.compaction_style = ioptions.compaction_style;
+    context.level_at_creation = level_at_creation;
+    context.info_log = ioptions.info_log;
     if (skip_filters) {
       filter_builder = nullptr;
     } else {
-      FilterBuildingContext context(table_options);
-      context.column_family_name = column_family_name;
-      context.compaction_style = ioptions.compaction_style;
-      context.level_at_creation = level_at_creation;
-      context.info_log = ioptions.info_log;
       filter_builder.reset(CreateFilterBlockBuilder(
           ioptions, moptions, context, use_delta_encoding_for_index_values,
           p_index_builder_));
     }
+    // Unlike the other filters, the range filter serves scans, so it is kept
+    // when the filters are skipped for point lookups.
+    if (table_options.range_filter_levels > 0 &&
+        table_options.filter_policy != nullptr &&
+        icomparator.user_comparator() == BytewiseComparator() &&
+        icomparator.user_comparator()->timestamp_size() == 0) {
+      range_filter_builder.reset(
+          new RangeFilterBuilder(table_options.filter_policy.get(), context,
+                                 table_options.range_filter_levels));
+    }
 
     for (auto& collector_factories : *int_tbl_prop_collector_factories) {
       table_properties_collectors.emplace_back(
@@ -932,6 +952,10 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       }
     }
 
+    if (r->range_filter_builder != nullptr) {
+      r->range_filter_builder->Add(ExtractUserKey(key));
+    }
+
     r->last_key.assign(key.data(), key.size());
     r->data_block.Add(key, value);
     if (r->state == Rep::State::kBuffered) {
@@ -1420,6 +1444,24 @@ void BlockBasedTableBuilder::WriteFilterBlock(
   }
 }
 
+void BlockBasedTableBuilder::WriteRangeFilterBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  if (ok() && rep_->range_filter_builder != nullptr &&
+      rep_->range_filter_builder->num_added() > 0) {
+    const std::string range_filter = rep_->range_filter_builder->Finish();
+    if (range_filter.empty()) {
+      return;
+    }
+    BlockHandle range_filter_block_handle;
+    WriteRawBlock(range_filter, kNoCompression, &range_filter_block_handle);
+    if (ok()) {
+      meta_index_builder->Add(
+          kRangeFilterBlockPrefix + rep_->table_options.filter_policy->Name(),
+          range_filter_block_handle);
+    }
+  }
+}
+
 void BlockBasedTableBuilder::WriteIndexBlock(
     MetaIndexBuilder* meta_index_builder, BlockHandle* index_block_handle) {
   IndexBuilder::IndexBlocks index_blocks;
@@ -1730,15 +1772,17 @@ Status BlockBasedTableBuilder::Finish() {
 
   // Write meta blocks, metaindex block and footer in the following order.
   //    1. [meta block: filter]
-  //    2. [meta block: index]
-  //    3. [meta block: compression dictionary]
-  //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: properties]
-  //    6. [metaindex block]
-  //    7. Footer
+  //    2. [meta block: range filter]
+  //    3. [meta block: index]
+  //    4. [meta block: compression dictionary]
+  //    5. [meta block: range deletion tombstone]
+  //    6. [meta block: properties]
+  //    7. [metaindex block]
+  //    8. Footer
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
+  WriteRangeFilterBlock(&meta_index_builder);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
@@ -132,6 +132,7 @@ class BlockBasedTableBuilder : public TableBuilder {
                             const BlockHandle* handle);
 
   void WriteFilterBlock(MetaIndexBuilder* meta_index_builder);
+  void WriteRangeFilterBlock(MetaIndexBuilder* meta_index_builder);
   void WriteIndexBlock(MetaIndexBuilder* meta_index_builder,
                        BlockHandle* index_block_handle);
   void WritePropertiesBlock(MetaIndexBuilder* meta_index_builder);
@@ -20,6 +20,10 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target) {
     ResetDataIter();
     return;
   }
+  if (!CheckRangeMayMatch(target)) {
+    ResetDataIter();
+    return;
+  }
 
   bool need_seek_index = true;
   if (block_iter_points_to_real_block_ && block_iter_.Valid()) {
@@ -234,7 +238,8 @@ void BlockBasedTableIterator::InitDataBlock() {
     //   Enabled from the very first IO when ReadOptions.readahead_size is set.
     block_prefetcher_.PrefetchIfNeeded(rep, data_block_handle,
                                        read_options_.readahead_size,
-                                       is_for_compaction);
+                                       is_for_compaction,
+                                       read_options_.async_io);
 
     Status s;
     table_->NewDataBlockIterator<DataBlockIter>(
@@ -247,5 +247,15 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
     }
     return true;
   }
+
+  // Checks the range filter of the table for the keys from the seek target,
+  // or the first key if `ikey` is nullptr, up to the upper bound of the read.
+  bool CheckRangeMayMatch(const Slice* ikey) {
+    if (read_options_.iterate_upper_bound == nullptr) {
+      return true;
+    }
+    return table_->RangeMayMatch(ikey ? ExtractUserKey(*ikey) : Slice(),
+                                 *read_options_.iterate_upper_bound);
+  }
 };
 }  // namespace ROCKSDB_NAMESPACE
@@ -15,6 +15,7 @@
 #include <utility>
 #include <vector>
 
+#include "cache/cache_helpers.h"
 #include "cache/sharded_cache.h"
 
 #include "db/dbformat.h"
@@ -43,6 +44,7 @@
 #include "table/block_based/filter_block.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -68,7 +70,7 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
-
+extern const std::string kLearnedIndexModelBlock;
 
 // Found that 256 KB readahead size provides the best performance, based on
 // experiments, for auto readahead. Experiment data is in PR #3282.
@@ -80,9 +82,33 @@ BlockBasedTable::~BlockBasedTable() {
 
 std::atomic<uint64_t> BlockBasedTable::next_cache_key_id_(0);
 
+// BlocklikeTraits also provide the callbacks needed to demote a cached
+// block into a secondary cache (the size and contents of its persistable
+// data, see Cache::CacheItemHelper) and to re-create it from that data.
 template <typename TBlocklike>
 class BlocklikeTraits;
 
+template <typename TBlocklike>
+Cache::CreateCallback GetCreateCallback(size_t read_amp_bytes_per_bit,
+                                        Statistics* statistics,
+                                        bool using_zstd,
+                                        const FilterPolicy* filter_policy,
+                                        MemoryAllocator* memory_allocator) {
+  return [read_amp_bytes_per_bit, statistics, using_zstd, filter_policy,
+          memory_allocator](void* buf, size_t size, void** out_obj,
+                            size_t* charge) -> Status {
+    assert(buf != nullptr);
+    CacheAllocationPtr data = AllocateBlock(size, memory_allocator);
+    memcpy(data.get(), buf, size);
+    TBlocklike* obj = BlocklikeTraits<TBlocklike>::Create(
+        BlockContents(std::move(data), size), read_amp_bytes_per_bit,
+        statistics, using_zstd, filter_policy);
+    *out_obj = reinterpret_cast<void*>(obj);
+    *charge = obj->ApproximateMemoryUsage();
+    return Status::OK();
+  };
+}
+
 template <>
 class BlocklikeTraits<BlockContents> {
  public:
@@ -97,6 +123,28 @@ class BlocklikeTraits<BlockContents> {
   static uint32_t GetNumRestarts(const BlockContents& /* contents */) {
     return 0;
   }
+
+  static size_t SizeCallback(void* obj) {
+    assert(obj != nullptr);
+    BlockContents* ptr = static_cast<BlockContents*>(obj);
+    return ptr->data.size();
+  }
+
+  static Status SaveToCallback(void* from_obj, size_t from_offset,
+                               size_t length, void* out) {
+    assert(from_obj != nullptr);
+    BlockContents* ptr = static_cast<BlockContents*>(from_obj);
+    const char* buf = ptr->data.data();
+    assert(length == SizeCallback(from_obj));
+    memcpy(out, buf + from_offset, length);
+    return Status::OK();
+  }
+
+  static Cache::CacheItemHelper* GetCacheItemHelper(BlockType /*block_type*/) {
+    static Cache::CacheItemHelper cache_helper(
+        SizeCallback, SaveToCallback, &DeleteCacheEntry<BlockContents>);
+    return &cache_helper;
+  }
 };
 
 template <>
@@ -113,6 +161,28 @@ class BlocklikeTraits<ParsedFullFilterBlock> {
   static uint32_t GetNumRestarts(const ParsedFullFilterBlock& /* block */) {
     return 0;
   }
+
+  static size_t SizeCallback(void* obj) {
+    assert(obj != nullptr);
+    ParsedFullFilterBlock* ptr = static_cast<ParsedFullFilterBlock*>(obj);
+    return ptr->GetBlockContentsData().size();
+  }
+
+  static Status SaveToCallback(void* from_obj, size_t from_offset,
+                               size_t length, void* out) {
+    assert(from_obj != nullptr);
+    ParsedFullFilterBlock* ptr = static_cast<ParsedFullFilterBlock*>(from_obj);
+    const char* buf = ptr->GetBlockContentsData().data();
+    assert(length == SizeCallback(from_obj));
+    memcpy(out, buf + from_offset, length);
+    return Status::OK();
+  }
+
+  static Cache::CacheItemHelper* GetCacheItemHelper(BlockType /*block_type*/) {
+    static Cache::CacheItemHelper cache_helper(
+        SizeCallback, SaveToCallback, &DeleteCacheEntry<ParsedFullFilterBlock>);
+    return &cache_helper;
+  }
 };
 
 template <>
@@ -127,6 +197,28 @@ class BlocklikeTraits<Block> {
   static uint32_t GetNumRestarts(const Block& block) {
     return block.NumRestarts();
   }
+
+  static size_t SizeCallback(void* obj) {
+    assert(obj != nullptr);
+    Block* ptr = static_cast<Block*>(obj);
+    return ptr->size();
+  }
+
+  static Status SaveToCallback(void* from_obj, size_t from_offset,
+                               size_t length, void* out) {
+    assert(from_obj != nullptr);
+    Block* ptr = static_cast<Block*>(from_obj);
+    const char* buf = ptr->data();
+    assert(length == SizeCallback(from_obj));
+    memcpy(out, buf + from_offset, length);
+    return Status::OK();
+  }
+
+  static Cache::CacheItemHelper* GetCacheItemHelper(BlockType /*block_type*/) {
+    static Cache::CacheItemHelper cache_helper(
+        SizeCallback, SaveToCallback, &DeleteCacheEntry<Block>);
+    return &cache_helper;
+  }
 };
 
 template <>
@@ -144,9 +236,38 @@ class BlocklikeTraits<UncompressionDict> {
   static uint32_t GetNumRestarts(const UncompressionDict& /* dict */) {
     return 0;
   }
+
+  static size_t SizeCallback(void* obj) {
+    assert(obj != nullptr);
+    UncompressionDict* ptr = static_cast<UncompressionDict*>(obj);
+    return ptr->GetRawDict().size();
+  }
+
+  static Status SaveToCallback(void* from_obj, size_t from_offset,
+                               size_t length, void* out) {
+    assert(from_obj != nullptr);
+    UncompressionDict* ptr = static_cast<UncompressionDict*>(from_obj);
+    const char* buf = ptr->GetRawDict().data();
+    assert(length == SizeCallback(from_obj));
+    memcpy(out, buf + from_offset, length);
+    return Status::OK();
+  }
+
+  static Cache::CacheItemHelper* GetCacheItemHelper(BlockType /*block_type*/) {
+    static Cache::CacheItemHelper cache_helper(
+        SizeCallback, SaveToCallback, &DeleteCacheEntry<UncompressionDict>);
+    return &cache_helper;
+  }
 };
 
 namespace {
+// Delete the entry resided in the cache.
+template <class Entry>
+void DeleteCachedEntry(const Slice& /*key*/, void* value) {
+  auto entry = reinterpret_cast<Entry*>(value);
+  delete entry;
+}
+
 // Read the block identified by "handle" from "file".
 // The only relevant option is options.verify_checksums for now.
 // On failure return non-OK.
@@ -180,13 +301,6 @@ Status ReadBlockFromFile(
   return s;
 }
 
-// Delete the entry resided in the cache.
-template <class Entry>
-void DeleteCachedEntry(const Slice& /*key*/, void* value) {
-  auto entry = reinterpret_cast<Entry*>(value);
-  delete entry;
-}
-
 // Release the cached entry and decrement its ref count.
 // Do not force erase
 void ReleaseCachedEntry(void* arg, void* h) {
@@ -430,9 +544,12 @@ void BlockBasedTable::UpdateCacheInsertionMetrics(BlockType block_type,
 }
 
 Cache::Handle* BlockBasedTable::GetEntryFromCache(
-    Cache* block_cache, const Slice& key, BlockType block_type,
-    GetContext* get_context) const {
-  auto cache_handle = block_cache->Lookup(key, rep_->ioptions.statistics);
+    Cache* block_cache, const Slice& key, BlockType block_type, const bool wait,
+    GetContext* get_context, const Cache::CacheItemHelper* cache_helper,
+    const Cache::CreateCallback& create_cb, Cache::Priority priority) const {
+  auto cache_handle =
+      block_cache->Lookup(key, cache_helper, create_cb, priority, wait,
+                          rep_->ioptions.statistics);
 
   if (cache_handle != nullptr) {
     UpdateCacheHitMetrics(block_type, get_context,
@@ -698,6 +815,11 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  s = new_table->ReadRangeFilterBlock(prefetch_buffer.get(),
+                                      metaindex_iter.get());
+  if (!s.ok()) {
+    return s;
+  }
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
       prefetch_all, table_options, level, file_size,
@@ -940,6 +1062,43 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+Status BlockBasedTable::ReadRangeFilterBlock(FilePrefetchBuffer* prefetch_buffer,
+                                             InternalIterator* meta_iter) {
+  const FilterPolicy* policy = rep_->table_options.filter_policy.get();
+  const Comparator* user_comparator = rep_->internal_comparator.user_comparator();
+  if (policy == nullptr || user_comparator != BytewiseComparator() ||
+      user_comparator->timestamp_size() != 0) {
+    return Status::OK();
+  }
+  BlockHandle range_filter_handle;
+  Status s = FindMetaBlock(meta_iter, kRangeFilterBlockPrefix + policy->Name(),
+                           &range_filter_handle);
+  if (!s.ok()) {
+    // The table has no range filter
+    return Status::OK();
+  }
+
+  // A table without its range filter is still readable, so only warn on
+  // errors.
+  BlockContents range_filter_contents;
+  BlockFetcher block_fetcher(
+      rep_->file.get(), prefetch_buffer, rep_->footer, ReadOptions(),
+      range_filter_handle, &range_filter_contents, rep_->ioptions,
+      true /*decompress*/, true /*maybe_compressed*/, BlockType::kRangeFilter,
+      UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options,
+      GetMemoryAllocator(rep_->table_options));
+  s = block_fetcher.ReadBlockContents();
+  if (s.ok()) {
+    s = RangeFilterReader::Create(policy, range_filter_contents.data,
+                                  &rep_->range_filter);
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                   "Unable to load the range filter: %s", s.ToString().c_str());
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
     InternalIterator* meta_iter, BlockBasedTable* new_table, bool prefetch_all,
@@ -1132,6 +1291,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->index_reader) {
     usage += rep_->index_reader->ApproximateMemoryUsage();
   }
+  if (rep_->range_filter) {
+    usage += rep_->range_filter->ApproximateMemoryUsage();
+  }
   if (rep_->uncompression_dict_reader) {
     usage += rep_->uncompression_dict_reader->ApproximateMemoryUsage();
   }
@@ -1178,11 +1340,18 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, CachableEntry<TBlocklike>* block,
     const UncompressionDict& uncompression_dict, BlockType block_type,
-    GetContext* get_context) const {
+    const bool wait, GetContext* get_context) const {
   const size_t read_amp_bytes_per_bit =
       block_type == BlockType::kData
           ? rep_->table_options.read_amp_bytes_per_bit
           : 0;
+  const Cache::Priority priority =
+      rep_->table_options.cache_index_and_filter_blocks_with_high_priority &&
+              (block_type == BlockType::kFilter ||
+               block_type == BlockType::kCompressionDictionary ||
+               block_type == BlockType::kIndex)
+          ? Cache::Priority::HIGH
+          : Cache::Priority::LOW;
   assert(block);
   assert(block->IsEmpty());
 
@@ -1192,9 +1361,23 @@ Status BlockBasedTable::GetDataBlockFromCache(
 
   // Lookup uncompressed cache first
   if (block_cache != nullptr) {
-    auto cache_handle = GetEntryFromCache(block_cache, block_cache_key,
-                                          block_type, get_context);
+    // The callback only re-creates blocks found in a secondary cache, so
+    // don't pay for building it on every lookup otherwise.
+    Cache::CreateCallback create_cb;
+    if (block_cache->HasSecondaryCache()) {
+      create_cb = GetCreateCallback<TBlocklike>(
+          read_amp_bytes_per_bit, rep_->ioptions.statistics,
+          rep_->blocks_definitely_zstd_compressed,
+          rep_->table_options.filter_policy.get(),
+          GetMemoryAllocator(rep_->table_options));
+    }
+    auto cache_handle = GetEntryFromCache(
+        block_cache, block_cache_key, block_type, wait, get_context,
+        BlocklikeTraits<TBlocklike>::GetCacheItemHelper(block_type), create_cb,
+        priority);
     if (cache_handle != nullptr) {
+      // The value is nullptr if the handle is not ready yet (only possible
+      // if !wait); the caller will wait for it and update the value.
       block->SetCachedValue(
           reinterpret_cast<TBlocklike*>(block_cache->Value(cache_handle)),
           block_cache, cache_handle);
@@ -1250,8 +1433,10 @@ Status BlockBasedTable::GetDataBlockFromCache(
         read_options.fill_cache) {
       size_t charge = block_holder->ApproximateMemoryUsage();
       Cache::Handle* cache_handle = nullptr;
-      s = block_cache->Insert(block_cache_key, block_holder.get(), charge,
-                              &DeleteCachedEntry<TBlocklike>, &cache_handle);
+      s = block_cache->Insert(
+          block_cache_key, block_holder.get(),
+          BlocklikeTraits<TBlocklike>::GetCacheItemHelper(block_type), charge,
+          &cache_handle);
       if (s.ok()) {
         assert(cache_handle != nullptr);
         block->SetCachedValue(block_holder.release(), block_cache,
@@ -1355,9 +1540,10 @@ Status BlockBasedTable::PutDataBlockToCache(
   if (block_cache != nullptr && block_holder->own_bytes()) {
     size_t charge = block_holder->ApproximateMemoryUsage();
     Cache::Handle* cache_handle = nullptr;
-    s = block_cache->Insert(block_cache_key, block_holder.get(), charge,
-                            &DeleteCachedEntry<TBlocklike>, &cache_handle,
-                            priority);
+    s = block_cache->Insert(
+        block_cache_key, block_holder.get(),
+        BlocklikeTraits<TBlocklike>::GetCacheItemHelper(block_type), charge,
+        &cache_handle, priority);
     if (s.ok()) {
       assert(cache_handle != nullptr);
       cached_block->SetCachedValue(block_holder.release(), block_cache,
@@ -1454,9 +1640,9 @@ template <typename TBlocklike>
 Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
     FilePrefetchBuffer* prefetch_buffer, const ReadOptions& ro,
     const BlockHandle& handle, const UncompressionDict& uncompression_dict,
-    CachableEntry<TBlocklike>* block_entry, BlockType block_type,
-    GetContext* get_context, BlockCacheLookupContext* lookup_context,
-    BlockContents* contents) const {
+    const bool wait, CachableEntry<TBlocklike>* block_entry,
+    BlockType block_type, GetContext* get_context,
+    BlockCacheLookupContext* lookup_context, BlockContents* contents) const {
   assert(block_entry != nullptr);
   const bool no_io = (ro.read_tier == kBlockCacheTier);
   Cache* block_cache = rep_->table_options.block_cache.get();
@@ -1488,7 +1674,7 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
     if (!contents) {
       s = GetDataBlockFromCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, block_entry, uncompression_dict, block_type,
-                                get_context);
+                                wait, get_context);
       if (block_entry->GetValue()) {
         // TODO(haoyu): Differentiate cache hit on uncompressed block cache and
         // compressed block cache.
@@ -1497,8 +1683,8 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
     }
 
     // Can't find the block from the cache. If I/O is allowed, read from the
-    // file.
-    if (block_entry->GetValue() == nullptr && !no_io && ro.fill_cache) {
+    // file. A pending secondary cache lookup leaves the entry non-empty.
+    if (block_entry->IsEmpty() && !no_io && ro.fill_cache) {
       Statistics* statistics = rep_->ioptions.statistics;
       const bool maybe_compressed =
           block_type != BlockType::kFilter &&
@@ -1847,8 +2033,8 @@ void BlockBasedTable::RetrieveMultipleBlocks(
         // necessary. Since we're passing the raw block contents, it will
         // avoid looking up the block cache
         s = MaybeReadBlockAndLoadToCache(
-            nullptr, options, handle, uncompression_dict, block_entry,
-            BlockType::kData, mget_iter->get_context,
+            nullptr, options, handle, uncompression_dict, /*wait=*/true,
+            block_entry, BlockType::kData, mget_iter->get_context,
             &lookup_data_block_context, &raw_block_contents);
 
         // block_entry value could be null if no block cache is present, i.e
@@ -1895,23 +2081,26 @@ Status BlockBasedTable::RetrieveBlock(
     const BlockHandle& handle, const UncompressionDict& uncompression_dict,
     CachableEntry<TBlocklike>* block_entry, BlockType block_type,
     GetContext* get_context, BlockCacheLookupContext* lookup_context,
-    bool for_compaction, bool use_cache) const {
+    bool for_compaction, bool use_cache, bool wait_for_cache) const {
   assert(block_entry);
   assert(block_entry->IsEmpty());
 
   Status s;
   if (use_cache) {
     s = MaybeReadBlockAndLoadToCache(prefetch_buffer, ro, handle,
-                                     uncompression_dict, block_entry,
-                                     block_type, get_context, lookup_context,
-                                     /*contents=*/nullptr);
+                                     uncompression_dict, wait_for_cache,
+                                     block_entry, block_type, get_context,
+                                     lookup_context, /*contents=*/nullptr);
 
     if (!s.ok()) {
       return s;
     }
 
-    if (block_entry->GetValue() != nullptr) {
+    if (block_entry->GetValue() != nullptr ||
+        block_entry->GetCacheHandle() != nullptr) {
+      // Either found, or a secondary cache lookup is in flight
       assert(s.ok());
+      assert(block_entry->GetValue() != nullptr || !wait_for_cache);
       return s;
     }
   }
@@ -1978,28 +2167,28 @@ template Status BlockBasedTable::RetrieveBlock<BlockContents>(
     const BlockHandle& handle, const UncompressionDict& uncompression_dict,
     CachableEntry<BlockContents>* block_entry, BlockType block_type,
     GetContext* get_context, BlockCacheLookupContext* lookup_context,
-    bool for_compaction, bool use_cache) const;
+    bool for_compaction, bool use_cache, bool wait_for_cache) const;
 
 template Status BlockBasedTable::RetrieveBlock<ParsedFullFilterBlock>(
     FilePrefetchBuffer* prefetch_buffer, const ReadOptions& ro,
     const BlockHandle& handle, const UncompressionDict& uncompression_dict,
     CachableEntry<ParsedFullFilterBlock>* block_entry, BlockType block_type,
     GetContext* get_context, BlockCacheLookupContext* lookup_context,
-    bool for_compaction, bool use_cache) const;
+    bool for_compaction, bool use_cache, bool wait_for_cache) const;
 
 template Status BlockBasedTable::RetrieveBlock<Block>(
     FilePrefetchBuffer* prefetch_buffer, const ReadOptions& ro,
     const BlockHandle& handle, const UncompressionDict& uncompression_dict,
     CachableEntry<Block>* block_entry, BlockType block_type,
     GetContext* get_context, BlockCacheLookupContext* lookup_context,
-    bool for_compaction, bool use_cache) const;
+    bool for_compaction, bool use_cache, bool wait_for_cache) const;
 
 template Status BlockBasedTable::RetrieveBlock<UncompressionDict>(
     FilePrefetchBuffer* prefetch_buffer, const ReadOptions& ro,
     const BlockHandle& handle, const UncompressionDict& uncompression_dict,
     CachableEntry<UncompressionDict>* block_entry, BlockType block_type,
     GetContext* get_context, BlockCacheLookupContext* lookup_context,
-    bool for_compaction, bool use_cache) const;
+    bool for_compaction, bool use_cache, bool wait_for_cache) const;
 
 BlockBasedTable::PartitionedIndexIteratorState::PartitionedIndexIteratorState(
     const BlockBasedTable* table,
@@ -2152,6 +2341,19 @@ bool BlockBasedTable::PrefixMayMatch(
   return may_match;
 }
 
+bool BlockBasedTable::RangeMayMatch(const Slice& start_user_key,
+                                    const Slice& end_user_key) const {
+  if (rep_->range_filter == nullptr) {
+    return true;
+  }
+  Statistics* statistics = rep_->ioptions.statistics;
+  RecordTick(statistics, RANGE_FILTER_CHECKED);
+  if (rep_->range_filter->RangeMayMatch(start_user_key, end_user_key)) {
+    return true;
+  }
+  RecordTick(statistics, RANGE_FILTER_USEFUL);
+  return false;
+}
 
 InternalIterator* BlockBasedTable::NewIterator(
     const ReadOptions& read_options, const SliceTransform* prefix_extractor,
@@ -2519,6 +2721,7 @@ void BlockBasedTable::MultiGet(const ReadOptions& read_options,
       Status uncompression_dict_status;
       uncompression_dict_status.PermitUncheckedError();
       bool uncompression_dict_inited = false;
+      bool pending_lookups = false;
       size_t total_len = 0;
       ReadOptions ro = read_options;
       ro.read_tier = kBlockCacheTier;
@@ -2585,20 +2788,59 @@ void BlockBasedTable::MultiGet(const ReadOptions& read_options,
         Status s = RetrieveBlock(
             nullptr, ro, handle, dict, &(results.back()), BlockType::kData,
             miter->get_context, &lookup_data_block_context,
-            /* for_compaction */ false, /* use_cache */ true);
+            /* for_compaction */ false, /* use_cache */ true,
+            /* wait_for_cache */ false);
         if (s.IsIncomplete()) {
           s = Status::OK();
         }
         if (s.ok() && !results.back().IsEmpty()) {
-          // Found it in the cache. Add NULL handle to indicate there is
-          // nothing to read from disk
-          block_handles.emplace_back(BlockHandle::NullBlockHandle());
+          // Since we have a valid handle, check the value. If it's nullptr,
+          // the secondary cache lookup is still pending and we wait for it
+          // below, together with the other blocks of the batch.
+          if (results.back().GetValue() != nullptr) {
+            // Found it in the cache. Add NULL handle to indicate there is
+            // nothing to read from disk
+            block_handles.emplace_back(BlockHandle::NullBlockHandle());
+          } else {
+            block_handles.emplace_back(handle);
+            pending_lookups = true;
+          }
         } else {
           block_handles.emplace_back(handle);
           total_len += block_size(handle);
         }
       }
 
+      if (pending_lookups) {
+        // Wait for all the secondary cache lookups issued above, so that
+        // they can proceed in parallel
+        std::vector<Cache::Handle*> cache_handles;
+        for (size_t i = 0; i < block_handles.size(); ++i) {
+          if (block_handles[i] != BlockHandle::NullBlockHandle() &&
+              !results[i].IsEmpty()) {
+            cache_handles.push_back(results[i].GetCacheHandle());
+          }
+        }
+        rep_->table_options.block_cache->WaitAll(cache_handles);
+        for (size_t i = 0; i < block_handles.size(); ++i) {
+          // Skip the blocks that were found in the primary cache or that
+          // need to be read from the file anyway
+          if (block_handles[i] == BlockHandle::NullBlockHandle() ||
+              results[i].IsEmpty()) {
+            continue;
+          }
+          results[i].UpdateCachedValue();
+          if (results[i].GetValue() == nullptr) {
+            // The secondary cache did not have the block after all, so read
+            // it from the file
+            results[i].Reset();
+            total_len += block_size(block_handles[i]);
+          } else {
+            block_handles[i] = BlockHandle::NullBlockHandle();
+          }
+        }
+      }
+
       if (total_len) {
         char* scratch = nullptr;
         const UncompressionDict& dict = uncompression_dict.GetValue()
@@ -2972,6 +3214,14 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kLearnedIndexModelBlock) {
+    return BlockType::kLearnedIndexModel;
+  }
+
+  if (meta_block_name.starts_with(kRangeFilterBlockPrefix)) {
+    return BlockType::kRangeFilter;
+  }
+
   assert(false);
   return BlockType::kInvalid;
 }
@@ -3068,8 +3318,23 @@ Status BlockBasedTable::CreateIndexReader(
                                           prefetch, pin, lookup_context,
                                           index_reader);
     }
-    case BlockBasedTableOptions::kBinarySearch:
-      FALLTHROUGH_INTENDED;
+    case BlockBasedTableOptions::kBinarySearch: {
+      // Tables built with kLearnedIndexSearch are recorded as kBinarySearch,
+      // so that older versions can read them. They are told apart by the
+      // meta block of their model.
+      BlockHandle model_handle;
+      if (preloaded_meta_index_iter != nullptr &&
+          FindMetaBlock(preloaded_meta_index_iter, kLearnedIndexModelBlock,
+                        &model_handle)
+              .ok()) {
+        return LearnedIndexReader::Create(
+            this, ro, prefetch_buffer, preloaded_meta_index_iter, use_cache,
+            prefetch, pin, lookup_context, index_reader);
+      }
+      return BinarySearchIndexReader::Create(this, ro, prefetch_buffer,
+                                             use_cache, prefetch, pin,
+                                             lookup_context, index_reader);
+    }
     case BlockBasedTableOptions::kBinarySearchWithFirstKey: {
       return BinarySearchIndexReader::Create(this, ro, prefetch_buffer,
                                              use_cache, prefetch, pin,
@@ -3210,6 +3475,59 @@ uint64_t BlockBasedTable::ApproximateSize(const Slice& start, const Slice& end,
                                static_cast<double>(rep_->file_size));
 }
 
+Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
+                                              std::vector<Anchor>* anchors) {
+  assert(anchors != nullptr);
+  const uint64_t kMaxNumAnchors = 128;
+  uint64_t data_size = GetApproximateDataSize();
+  uint64_t num_blocks = rep_->table_properties
+                            ? rep_->table_properties->num_data_blocks
+                            : 0;
+  const uint64_t blocks_per_anchor =
+      std::max<uint64_t>(num_blocks / kMaxNumAnchors, 1);
+
+  BlockCacheLookupContext context(TableReaderCaller::kCompaction);
+  IndexBlockIter iiter_on_stack;
+  ReadOptions ro = read_options;
+  ro.total_order_seek = true;
+  auto index_iter =
+      NewIndexIterator(ro, /*disable_prefix_seek=*/true,
+                       /*input_iter=*/&iiter_on_stack, /*get_context=*/nullptr,
+                       /*lookup_context=*/&context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (index_iter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(index_iter);
+  }
+
+  // Each index key is at or after the last key of its data block. Sizes are
+  // pro-rated to include the file metadata, like in ApproximateSize().
+  const double scale =
+      data_size == 0 ? 1.0
+                     : static_cast<double>(rep_->file_size) /
+                           static_cast<double>(data_size);
+  uint64_t count = 0;
+  uint64_t range_start = 0;
+  uint64_t range_end = 0;
+  std::string last_key;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    const BlockHandle handle = index_iter->value().handle;
+    range_end = handle.offset() + handle.size();
+    if (++count % blocks_per_anchor == 0) {
+      anchors->emplace_back(
+          index_iter->user_key(),
+          static_cast<uint64_t>(scale * (range_end - range_start)));
+      range_start = range_end;
+    } else {
+      last_key = index_iter->user_key().ToString();
+    }
+  }
+  if (range_end > range_start) {
+    anchors->emplace_back(
+        last_key, static_cast<uint64_t>(scale * (range_end - range_start)));
+  }
+  return index_iter->status();
+}
+
 bool BlockBasedTable::TEST_FilterBlockInCache() const {
   assert(rep_ != nullptr);
   return TEST_BlockInCache(rep_->filter_handle);
@@ -30,6 +30,12 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// With use_restart_key_prefixes, the restart array is followed by
+//     restart_key_prefixes: uint32[num_restarts]
+// where restart_key_prefixes[i] is RestartKeyPrefix() of the user key of the
+// ith restart key, and the flag set by PackRestartKeyPrefixes() tells the
+// reader that they are there.
 
 #include "table/block_based/block_builder.h"
 
@@ -46,10 +52,13 @@ BlockBuilder::BlockBuilder(
     int block_restart_interval, bool use_delta_encoding,
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    double data_block_hash_table_util_ratio)
+    double data_block_hash_table_util_ratio, bool use_restart_key_prefixes,
+    bool keys_include_seq)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
+      use_restart_key_prefixes_(use_restart_key_prefixes),
+      keys_include_seq_(keys_include_seq),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -65,14 +74,15 @@ BlockBuilder::BlockBuilder(
   }
   assert(block_restart_interval_ >= 1);
   restarts_.push_back(0);  // First restart point is at offset 0
-  estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  estimate_ = sizeof(uint32_t) + RestartEntrySize();
 }
 
 void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.clear();
+  restart_key_prefixes_.clear();
   restarts_.push_back(0);  // First restart point is at offset 0
-  estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  estimate_ = sizeof(uint32_t) + RestartEntrySize();
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
@@ -100,7 +110,7 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
           : value.size() / 2;
 
   if (counter_ >= block_restart_interval_) {
-    estimate += sizeof(uint32_t);  // a new restart entry.
+    estimate += RestartEntrySize();  // a new restart entry.
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -119,6 +129,15 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
+  // An empty block has one restart point but no restart key.
+  const bool with_restart_key_prefixes =
+      use_restart_key_prefixes_ &&
+      restart_key_prefixes_.size() == restarts_.size();
+  if (with_restart_key_prefixes) {
+    for (uint32_t prefix : restart_key_prefixes_) {
+      PutFixed32(&buffer_, prefix);
+    }
+  }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
   BlockBasedTableOptions::DataBlockIndexType index_type =
@@ -131,6 +150,9 @@ Slice BlockBuilder::Finish() {
 
   // footer is a packed format of data_block_index_type and num_restarts
   uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  if (with_restart_key_prefixes) {
+    block_footer = PackRestartKeyPrefixes(block_footer);
+  }
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
@@ -146,7 +168,7 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
-    estimate_ += sizeof(uint32_t);
+    estimate_ += RestartEntrySize();
     counter_ = 0;
 
     if (use_delta_encoding_) {
@@ -189,6 +211,11 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
     buffer_.append(value.data(), value.size());
   }
 
+  if (use_restart_key_prefixes_ && counter_ == 0) {
+    restart_key_prefixes_.push_back(
+        RestartKeyPrefix(keys_include_seq_ ? ExtractUserKey(key) : key));
+  }
+
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Add(ExtractUserKey(key),
                                        restarts_.size() - 1);
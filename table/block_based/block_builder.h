@@ -22,12 +22,17 @@ class BlockBuilder {
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
+  // With use_restart_key_prefixes, the block also stores a prefix of each
+  // restart key, of the user key part if keys_include_seq. Only meaningful
+  // for the bytewise comparator.
   explicit BlockBuilder(int block_restart_interval,
                         bool use_delta_encoding = true,
                         bool use_value_delta_encoding = false,
                         BlockBasedTableOptions::DataBlockIndexType index_type =
                             BlockBasedTableOptions::kDataBlockBinarySearch,
-                        double data_block_hash_table_util_ratio = 0.75);
+                        double data_block_hash_table_util_ratio = 0.75,
+                        bool use_restart_key_prefixes = false,
+                        bool keys_include_seq = true);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -60,14 +65,22 @@ class BlockBuilder {
   bool empty() const { return buffer_.empty(); }
 
  private:
+  // The size of the trailer of the block for each restart point.
+  size_t RestartEntrySize() const {
+    return use_restart_key_prefixes_ ? 2 * sizeof(uint32_t) : sizeof(uint32_t);
+  }
+
   const int block_restart_interval_;
   // TODO(myabandeh): put it into a separate IndexBlockBuilder
   const bool use_delta_encoding_;
   // Refer to BlockIter::DecodeCurrentValue for format of delta encoded values
   const bool use_value_delta_encoding_;
+  const bool use_restart_key_prefixes_;
+  const bool keys_include_seq_;
 
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
+  std::vector<uint32_t> restart_key_prefixes_;
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
   bool finished_;  // Has Finish() been called?
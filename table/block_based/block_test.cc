@@ -124,6 +124,85 @@ TEST_F(BlockTest, SimpleTest) {
   delete iter;
 }
 
+TEST_F(BlockTest, RestartKeyPrefixes) {
+  Options options = Options();
+  for (int restart_interval : {1, 16}) {
+    for (bool use_hash_index : {false, true}) {
+      // Keep blocks with a hash index under its limits on the size and on
+      // the number of restarts (kMaxRestartSupportedByHashIndex). Keys below
+      // 100 all share the same prefix of four spaces.
+      const int num_records = use_hash_index ? 200 : 20000;
+      std::vector<std::string> keys;
+      std::vector<std::string> values;
+      GenerateRandomKVs(&keys, &values, 0, num_records * 2, 2 /* step */);
+
+      const BlockBasedTableOptions::DataBlockIndexType index_type =
+          use_hash_index ? BlockBasedTableOptions::kDataBlockBinaryAndHash
+                         : BlockBasedTableOptions::kDataBlockBinarySearch;
+      BlockBuilder plain_builder(restart_interval, true, false, index_type);
+      BlockBuilder builder(restart_interval, true, false, index_type,
+                           0.75 /* data_block_hash_table_util_ratio */,
+                           true /* use_restart_key_prefixes */);
+      for (int i = 0; i < num_records; i++) {
+        plain_builder.Add(keys[i], values[i]);
+        builder.Add(keys[i], values[i]);
+      }
+      const size_t num_restarts =
+          (num_records + restart_interval - 1) / restart_interval;
+      BlockContents contents;
+      contents.data = builder.Finish();
+      ASSERT_EQ(plain_builder.Finish().size() + num_restarts * sizeof(uint32_t),
+                contents.data.size());
+      Block reader(std::move(contents));
+      ASSERT_EQ(num_restarts, reader.NumRestarts());
+      ASSERT_EQ(index_type, reader.IndexType());
+
+      std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+          options.comparator, kDisableGlobalSequenceNumber));
+      int count = 0;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        ASSERT_EQ(keys[count], iter->key().ToString());
+        ASSERT_EQ(values[count], iter->value().ToString());
+        count++;
+      }
+      ASSERT_EQ(num_records, count);
+
+      Random rnd(301);
+      for (int i = 0; i < num_records; i++) {
+        const int index = rnd.Uniform(num_records);
+        iter->Seek(keys[index]);
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(values[index], iter->value().ToString());
+        if (use_hash_index) {
+          ASSERT_TRUE(iter->SeekForGet(keys[index]));
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(values[index], iter->value().ToString());
+        }
+
+        // A key between two keys of the block, as their primary keys are
+        // even.
+        const std::string target =
+            GenerateInternalKey(2 * index + 1, 0, 0, &rnd);
+        iter->Seek(target);
+        if (index + 1 < num_records) {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(keys[index + 1], iter->key().ToString());
+        } else {
+          ASSERT_FALSE(iter->Valid());
+        }
+        iter->SeekForPrev(target);
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(keys[index], iter->key().ToString());
+      }
+      std::string smallest;
+      AppendInternalKeyFooter(&smallest, 0 /* seqno */, kTypeValue);
+      iter->Seek(smallest);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys[0], iter->key().ToString());
+    }
+  }
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
@@ -23,6 +23,8 @@ enum class BlockType : uint8_t {
   kHashIndexMetadata,
   kMetaIndex,
   kIndex,
+  kLearnedIndexModel,
+  kRangeFilter,
   // Note: keep kInvalid the last value when adding new enum values.
   kInvalid
 };
@@ -50,8 +50,10 @@ public:
     , cache_handle_(cache_handle)
     , own_value_(own_value)
   {
-    assert(value_ != nullptr ||
-      (cache_ == nullptr && cache_handle_ == nullptr && !own_value_));
+    // value_ may only be nullptr for an empty entry, or for a cache handle
+    // whose secondary cache lookup is still pending
+    assert(value_ != nullptr || cache_handle_ != nullptr ||
+      (cache_ == nullptr && !own_value_));
     assert(!!cache_ == !!cache_handle_);
     assert(!cache_handle_ || !own_value_);
   }
@@ -65,8 +67,10 @@ public:
     , cache_handle_(rhs.cache_handle_)
     , own_value_(rhs.own_value_)
   {
-    assert(value_ != nullptr ||
-      (cache_ == nullptr && cache_handle_ == nullptr && !own_value_));
+    // value_ may only be nullptr for an empty entry, or for a cache handle
+    // whose secondary cache lookup is still pending
+    assert(value_ != nullptr || cache_handle_ != nullptr ||
+      (cache_ == nullptr && !own_value_));
     assert(!!cache_ == !!cache_handle_);
     assert(!cache_handle_ || !own_value_);
 
@@ -85,8 +89,10 @@ public:
     cache_handle_ = rhs.cache_handle_;
     own_value_ = rhs.own_value_;
 
-    assert(value_ != nullptr ||
-      (cache_ == nullptr && cache_handle_ == nullptr && !own_value_));
+    // value_ may only be nullptr for an empty entry, or for a cache handle
+    // whose secondary cache lookup is still pending
+    assert(value_ != nullptr || cache_handle_ != nullptr ||
+      (cache_ == nullptr && !own_value_));
     assert(!!cache_ == !!cache_handle_);
     assert(!cache_handle_ || !own_value_);
 
@@ -161,8 +167,9 @@ public:
     assert(!own_value_);
   }
 
+  // value may be nullptr if cache_handle was returned by a non-blocking
+  // lookup that is still pending; see UpdateCachedValue().
   void SetCachedValue(T* value, Cache* cache, Cache::Handle* cache_handle) {
-    assert(value != nullptr);
     assert(cache != nullptr);
     assert(cache_handle != nullptr);
 
@@ -179,6 +186,24 @@ public:
     assert(!own_value_);
   }
 
+  // Refresh the value from the cache handle once a pending secondary cache
+  // lookup has completed (see Cache::Wait()). The value is still nullptr if
+  // the lookup did not find anything.
+  void UpdateCachedValue() {
+    assert(cache_ != nullptr);
+    assert(cache_handle_ != nullptr);
+
+    value_ = static_cast<T*>(cache_->Value(cache_handle_));
+  }
+
+  bool IsReady() {
+    if (!own_value_ && cache_handle_ != nullptr) {
+      assert(cache_ != nullptr);
+      return cache_->IsReady(cache_handle_);
+    }
+    return true;
+  }
+
 private:
   void ReleaseResource() {
     if (LIKELY(cache_handle_ != nullptr)) {
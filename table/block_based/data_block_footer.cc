@@ -56,4 +56,20 @@ void UnPackIndexTypeAndNumRestarts(
   }
 }
 
+// A block would need more than 4GiB for its restart array alone to have
+// 2^30 restarts, so this bit of num_restarts was always zero before.
+const int kRestartKeyPrefixesBitShift = 30;
+
+uint32_t PackRestartKeyPrefixes(uint32_t block_footer) {
+  assert((block_footer & (1u << kRestartKeyPrefixesBitShift)) == 0);
+  return block_footer | (1u << kRestartKeyPrefixesBitShift);
+}
+
+bool UnPackRestartKeyPrefixes(uint32_t* block_footer) {
+  const bool has_restart_key_prefixes =
+      (*block_footer & (1u << kRestartKeyPrefixesBitShift)) != 0;
+  *block_footer &= ~(1u << kRestartKeyPrefixesBitShift);
+  return has_restart_key_prefixes;
+}
+
 }  // namespace ROCKSDB_NAMESPACE
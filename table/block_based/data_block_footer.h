@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "rocksdb/slice.h"
 #include "rocksdb/table.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -22,4 +23,28 @@ void UnPackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType* index_type,
     uint32_t* num_restarts);
 
+// Sets the flag of the block footer telling that the restart array is
+// followed by the fixed-width prefixes of the restart keys
+// (BlockBasedTableOptions::store_restart_key_prefixes).
+uint32_t PackRestartKeyPrefixes(uint32_t block_footer);
+
+// Returns whether the block footer has the flag set by
+// PackRestartKeyPrefixes(), and clears it from *block_footer.
+bool UnPackRestartKeyPrefixes(uint32_t* block_footer);
+
+// Returns the prefix of a restart key stored in the block: its first four
+// bytes, padded with zeros, read as a big-endian integer. For the bytewise
+// comparator, a restart key whose prefix is less (greater) than the prefix of
+// a target key is less (greater) than the target key.
+inline uint32_t RestartKeyPrefix(const Slice& user_key) {
+  uint32_t prefix = 0;
+  for (size_t i = 0; i < sizeof(uint32_t); i++) {
+    prefix <<= 8;
+    if (i < user_key.size()) {
+      prefix |= static_cast<unsigned char>(user_key[i]);
+    }
+  }
+  return prefix;
+}
+
 }  // namespace ROCKSDB_NAMESPACE
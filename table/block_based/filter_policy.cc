@@ -12,6 +12,7 @@
 #include <array>
 #include <deque>
 
+#include "rocksdb/cache.h"
 #include "rocksdb/slice.h"
 #include "table/block_based/block_based_filter_block.h"
 #include "table/block_based/filter_policy_internal.h"
@@ -389,6 +390,53 @@ class FastLocalBloomBitsReader : public FilterBitsReader {
 
 // ##################### Ribbon filter implementation ################### //
 
+// Reserves memory in a cache with dummy entries, like WriteBufferManager does
+// for the memtables, until destroyed.
+class CacheReservation {
+ public:
+  explicit CacheReservation(Cache* cache) : cache_(cache), next_id_(0) {
+    memset(key_, 0, kKeyPrefixSize);
+    const void* self = this;
+    memcpy(key_, &self, sizeof(self));
+  }
+
+  // No Copy allowed
+  CacheReservation(const CacheReservation&) = delete;
+  void operator=(const CacheReservation&) = delete;
+
+  ~CacheReservation() {
+    for (Cache::Handle* handle : handles_) {
+      cache_->Release(handle, true /* force_erase */);
+    }
+  }
+
+  // Fails if the cache is full and has a strict capacity limit.
+  Status Reserve(size_t bytes) {
+    while (handles_.size() * kDummyEntrySize < bytes) {
+      char* end = EncodeVarint64(key_ + kKeyPrefixSize, next_id_++);
+      Cache::Handle* handle = nullptr;
+      Status s =
+          cache_->Insert(Slice(key_, static_cast<size_t>(end - key_)), nullptr,
+                         kDummyEntrySize, nullptr, &handle);
+      if (!s.ok()) {
+        return s;
+      }
+      handles_.push_back(handle);
+    }
+    return Status::OK();
+  }
+
+ private:
+  static constexpr size_t kDummyEntrySize = 256 * 1024;
+  // Longer than the keys of the blocks, so that they do not conflict
+  static constexpr size_t kKeyPrefixSize = kMaxVarint64Length * 4 + 1;
+
+  Cache* const cache_;
+  char key_[kKeyPrefixSize + kMaxVarint64Length];
+  uint64_t next_id_;
+  std::vector<Cache::Handle*> handles_;
+};
+
 // Implements concept RehasherTypesAndSettings in ribbon_impl.h
 struct Standard128RibbonRehasherTypesAndSettings {
   // These are schema-critical. Any change almost certainly changes
@@ -412,11 +460,15 @@ using Standard128RibbonTypesAndSettings =
 
 class Standard128RibbonBitsBuilder : public XXH3pFilterBitsBuilder {
  public:
+  // If `cache` is not nullptr, the memory used to build the filter is
+  // reserved in it while the filter is built.
   explicit Standard128RibbonBitsBuilder(double desired_one_in_fp_rate,
                                         int bloom_millibits_per_key,
-                                        Logger* info_log)
+                                        Logger* info_log,
+                                        std::shared_ptr<Cache> cache)
       : desired_one_in_fp_rate_(desired_one_in_fp_rate),
         info_log_(info_log),
+        cache_(std::move(cache)),
         bloom_fallback_(bloom_millibits_per_key, nullptr) {
     assert(desired_one_in_fp_rate >= 1.0);
   }
@@ -461,6 +513,26 @@ class Standard128RibbonBitsBuilder : public XXH3pFilterBitsBuilder {
       return bloom_fallback_.Finish(buf);
     }
 
+    // The hashes, banding and solution are all alive while solving
+    std::unique_ptr<CacheReservation> reservation;
+    if (cache_ != nullptr) {
+      reservation.reset(new CacheReservation(cache_.get()));
+      Status s = reservation->Reserve(
+          hash_entries_.size() * sizeof(uint64_t) +
+          num_slots * (sizeof(TS::CoeffRow) + sizeof(TS::ResultRow)) +
+          len_with_metadata);
+      if (!s.ok()) {
+        ROCKS_LOG_WARN(info_log_,
+                       "Unable to reserve memory for Ribbon filter, using "
+                       "Bloom filter instead: %s",
+                       s.ToString().c_str());
+        reservation.reset();
+        SwapEntriesWith(&bloom_fallback_);
+        assert(hash_entries_.empty());
+        return bloom_fallback_.Finish(buf);
+      }
+    }
+
     BandingType banding;
     bool success = banding.ResetAndFindSeedToSolve(
         num_slots, hash_entries_.begin(), hash_entries_.end(),
@@ -550,6 +622,9 @@ class Standard128RibbonBitsBuilder : public XXH3pFilterBitsBuilder {
   // For warnings, or can be nullptr
   Logger* info_log_;
 
+  // For reserving the memory used to build the filter, or nullptr
+  std::shared_ptr<Cache> cache_;
+
   // For falling back on Bloom filter in some exceptional cases and
   // very small filter cases
   FastLocalBloomBitsBuilder bloom_fallback_;
@@ -576,13 +651,23 @@ class Standard128RibbonBitsReader : public FilterBitsReader {
   }
 
   virtual void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
-    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> hashes;
+    struct SavedData {
+      uint64_t seeded_hash;
+      uint32_t segment_num;
+      uint32_t num_columns;
+      uint32_t start_bit;
+    };
+    std::array<SavedData, MultiGetContext::MAX_BATCH_SIZE> saved;
+    // Prefetch the solution data of all the keys before querying any
     for (int i = 0; i < num_keys; ++i) {
-      hashes[i] = GetSliceHash64(*keys[i]);
-      // FIXME: batched get optimization
+      ribbon::InterleavedPrepareQuery(
+          GetSliceHash64(*keys[i]), hasher_, soln_, &saved[i].seeded_hash,
+          &saved[i].segment_num, &saved[i].num_columns, &saved[i].start_bit);
     }
     for (int i = 0; i < num_keys; ++i) {
-      may_match[i] = soln_.FilterQuery(hashes[i], hasher_);
+      may_match[i] = soln_.FilterQuery(
+          saved[i].seeded_hash, saved[i].segment_num, saved[i].num_columns,
+          saved[i].start_bit, hasher_);
     }
   }
 
@@ -999,7 +1084,10 @@ FilterBitsBuilder* BloomFilterPolicy::GetBuilderWithContext(
                                           context.info_log);
       case kStandard128Ribbon:
         return new Standard128RibbonBitsBuilder(
-            desired_one_in_fp_rate_, millibits_per_key_, context.info_log);
+            desired_one_in_fp_rate_, millibits_per_key_, context.info_log,
+            context.table_options.reserve_filter_construction_memory
+                ? context.table_options.block_cache
+                : nullptr);
     }
   }
   assert(false);
@@ -1195,12 +1283,17 @@ const FilterPolicy* NewBloomFilterPolicy(double bits_per_key,
   return new BloomFilterPolicy(bits_per_key, m);
 }
 
-extern const FilterPolicy* NewExperimentalRibbonFilterPolicy(
+extern const FilterPolicy* NewRibbonFilterPolicy(
     double bloom_equivalent_bits_per_key) {
   return new BloomFilterPolicy(bloom_equivalent_bits_per_key,
                                BloomFilterPolicy::kStandard128Ribbon);
 }
 
+extern const FilterPolicy* NewExperimentalRibbonFilterPolicy(
+    double bloom_equivalent_bits_per_key) {
+  return NewRibbonFilterPolicy(bloom_equivalent_bits_per_key);
+}
+
 FilterBuildingContext::FilterBuildingContext(
     const BlockBasedTableOptions& _table_options)
     : table_options(_table_options) {}
@@ -1211,6 +1304,7 @@ Status FilterPolicy::CreateFromString(
     const ConfigOptions& /*options*/, const std::string& value,
     std::shared_ptr<const FilterPolicy>* policy) {
   const std::string kBloomName = "bloomfilter:";
+  const std::string kRibbonName = "ribbonfilter:";
   const std::string kExpRibbonName = "experimental_ribbon:";
   if (value == kNullptrString || value == "rocksdb.BuiltinBloomFilter") {
     policy->reset();
@@ -1228,11 +1322,14 @@ Status FilterPolicy::CreateFromString(
       policy->reset(
           NewBloomFilterPolicy(bits_per_key, use_block_based_builder));
     }
+  } else if (value.compare(0, kRibbonName.size(), kRibbonName) == 0) {
+    double bloom_equivalent_bits_per_key =
+        ParseDouble(trim(value.substr(kRibbonName.size())));
+    policy->reset(NewRibbonFilterPolicy(bloom_equivalent_bits_per_key));
   } else if (value.compare(0, kExpRibbonName.size(), kExpRibbonName) == 0) {
     double bloom_equivalent_bits_per_key =
         ParseDouble(trim(value.substr(kExpRibbonName.size())));
-    policy->reset(
-        NewExperimentalRibbonFilterPolicy(bloom_equivalent_bits_per_key));
+    policy->reset(NewRibbonFilterPolicy(bloom_equivalent_bits_per_key));
   } else {
     return Status::NotFound("Invalid filter policy name ", value);
 #else
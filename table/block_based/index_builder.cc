@@ -22,6 +22,16 @@
 
 // Without anonymous namespace here, we fail the warning -Wmissing-prototypes
 namespace ROCKSDB_NAMESPACE {
+namespace {
+// The prefixes of the restart keys are only ordered like the keys with the
+// bytewise comparator.
+bool UseRestartKeyPrefixes(const InternalKeyComparator* comparator,
+                           const BlockBasedTableOptions& table_opt) {
+  return table_opt.store_restart_key_prefixes &&
+         comparator->user_comparator() == BytewiseComparator();
+}
+}  // namespace
+
 // using namespace rocksdb;
 // Create a index builder based on its type.
 IndexBuilder* IndexBuilder::CreateIndexBuilder(
@@ -36,7 +46,8 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
       result = new ShortenedIndexBuilder(
           comparator, table_opt.index_block_restart_interval,
           table_opt.format_version, use_value_delta_encoding,
-          table_opt.index_shortening, /* include_first_key */ false);
+          table_opt.index_shortening, /* include_first_key */ false,
+          UseRestartKeyPrefixes(comparator, table_opt));
       break;
     }
     case BlockBasedTableOptions::kHashSearch: {
@@ -58,7 +69,15 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
       result = new ShortenedIndexBuilder(
           comparator, table_opt.index_block_restart_interval,
           table_opt.format_version, use_value_delta_encoding,
-          table_opt.index_shortening, /* include_first_key */ true);
+          table_opt.index_shortening, /* include_first_key */ true,
+          UseRestartKeyPrefixes(comparator, table_opt));
+      break;
+    }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      result = new LearnedIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding,
+          table_opt.index_shortening);
       break;
     }
     default: {
@@ -108,7 +127,8 @@ void PartitionedIndexBuilder::MakeNewSubIndexBuilder() {
   sub_index_builder_ = new ShortenedIndexBuilder(
       comparator_, table_opt_.index_block_restart_interval,
       table_opt_.format_version, use_value_delta_encoding_,
-      table_opt_.index_shortening, /* include_first_key */ false);
+      table_opt_.index_shortening, /* include_first_key */ false,
+      UseRestartKeyPrefixes(comparator_, table_opt_));
 
   // Set sub_index_builder_->seperator_is_key_plus_seq_ to true if
   // seperator_is_key_plus_seq_ is true (internal-key mode) (set to false by
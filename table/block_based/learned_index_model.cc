@@ -0,0 +1,206 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index_model.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+constexpr uint32_t LearnedIndexModel::kMaxError;
+
+namespace {
+// Meta block layout:
+//   num_restarts: varint32
+//   common_prefix: length prefixed slice
+//   num_segments: varint32
+//   segments: num_segments times
+//     first_position: fixed64
+//     first_index: varint32
+//     slope: fixed64 (bits of a double)
+uint64_t DoubleToBits(double d) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(d), "double is not 64 bits");
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits) {
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+}  // namespace
+
+uint64_t LearnedIndexModel::KeyToPosition(const Slice& user_key,
+                                          size_t common_prefix_size) {
+  assert(user_key.size() >= common_prefix_size);
+  const size_t n = std::min(user_key.size() - common_prefix_size,
+                            sizeof(uint64_t));
+  const char* suffix = user_key.data() + common_prefix_size;
+  uint64_t position = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    position <<= 8;
+    if (i < n) {
+      position |= static_cast<unsigned char>(suffix[i]);
+    }
+  }
+  return position;
+}
+
+Status LearnedIndexModel::Create(const Slice& contents,
+                                 std::unique_ptr<LearnedIndexModel>* model) {
+  assert(model != nullptr);
+  std::unique_ptr<LearnedIndexModel> result(new LearnedIndexModel());
+  Slice input = contents;
+  Slice common_prefix;
+  uint32_t num_segments = 0;
+  if (!GetVarint32(&input, &result->num_restarts_) ||
+      !GetLengthPrefixedSlice(&input, &common_prefix) ||
+      !GetVarint32(&input, &num_segments)) {
+    return Status::Corruption("bad learned index model header");
+  }
+  result->common_prefix_ = common_prefix.ToString();
+  result->segments_.reserve(num_segments);
+  for (uint32_t i = 0; i < num_segments; i++) {
+    Segment segment;
+    uint64_t slope_bits = 0;
+    if (!GetFixed64(&input, &segment.first_position) ||
+        !GetVarint32(&input, &segment.first_index) ||
+        !GetFixed64(&input, &slope_bits)) {
+      return Status::Corruption("bad learned index model segment");
+    }
+    segment.slope = BitsToDouble(slope_bits);
+    if ((!result->segments_.empty() &&
+         segment.first_position <= result->segments_.back().first_position) ||
+        segment.first_index >= result->num_restarts_ ||
+        !(segment.slope >= 0)) {
+      return Status::Corruption("bad learned index model segment");
+    }
+    result->segments_.push_back(segment);
+  }
+  if (!input.empty()) {
+    return Status::Corruption("unexpected data after learned index model");
+  }
+  *model = std::move(result);
+  return Status::OK();
+}
+
+uint32_t LearnedIndexModel::Predict(const Slice& user_key) const {
+  if (segments_.empty()) {
+    return 0;
+  }
+  const size_t prefix_size = common_prefix_.size();
+  if (!user_key.starts_with(common_prefix_)) {
+    // The key sorts before or after all the keys of the index.
+    return Slice(common_prefix_).compare(user_key) > 0 ? 0
+                                                       : num_restarts_ - 1;
+  }
+  const uint64_t position = KeyToPosition(user_key, prefix_size);
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), position,
+      [](uint64_t p, const Segment& s) { return p < s.first_position; });
+  if (it == segments_.begin()) {
+    return 0;
+  }
+  const uint32_t limit =
+      it == segments_.end() ? num_restarts_ - 1 : it->first_index;
+  --it;
+  const double predicted =
+      it->first_index +
+      it->slope * static_cast<double>(position - it->first_position);
+  if (predicted >= limit) {
+    return limit;
+  }
+  return static_cast<uint32_t>(predicted);
+}
+
+void LearnedIndexModelBuilder::Add(const Slice& user_key) {
+  key_offsets_.push_back(keys_.size());
+  keys_.append(user_key.data(), user_key.size());
+}
+
+std::string LearnedIndexModelBuilder::Finish() {
+  const size_t num_keys = key_offsets_.size();
+  auto key_at = [&](size_t i) {
+    const size_t end = i + 1 < num_keys ? key_offsets_[i + 1] : keys_.size();
+    return Slice(keys_.data() + key_offsets_[i], end - key_offsets_[i]);
+  };
+
+  // The keys are sorted, so the prefix of the first and the last key is
+  // shared by all of them.
+  size_t prefix_size = 0;
+  if (num_keys > 0) {
+    const Slice first = key_at(0);
+    const Slice last = key_at(num_keys - 1);
+    prefix_size = first.difference_offset(last);
+  }
+
+  std::string result;
+  PutVarint32(&result, static_cast<uint32_t>(num_keys));
+  PutLengthPrefixedSlice(&result,
+                         Slice(keys_.data(), num_keys > 0 ? prefix_size : 0));
+
+  // Greedily grows each segment as long as a slope keeping all of its keys
+  // within kMaxError of their index exists, narrowing the range of such
+  // slopes with each key.
+  std::string segments;
+  uint32_t num_segments = 0;
+  uint64_t first_position = 0;
+  uint32_t first_index = 0;
+  double min_slope = 0;
+  double max_slope = std::numeric_limits<double>::infinity();
+  auto add_segment = [&]() {
+    const double slope = max_slope == std::numeric_limits<double>::infinity()
+                             ? 0
+                             : (min_slope + max_slope) / 2;
+    PutFixed64(&segments, first_position);
+    PutVarint32(&segments, first_index);
+    PutFixed64(&segments, DoubleToBits(slope));
+    num_segments++;
+  };
+  for (size_t i = 0; i < num_keys; i++) {
+    const uint64_t position =
+        LearnedIndexModel::KeyToPosition(key_at(i), prefix_size);
+    const uint32_t index = static_cast<uint32_t>(i);
+    if (i == 0) {
+      first_position = position;
+      first_index = index;
+      continue;
+    }
+    if (position == first_position) {
+      // Keys sharing a position are predicted at the first of them.
+      continue;
+    }
+    const double dx = static_cast<double>(position - first_position);
+    const double dy = static_cast<double>(index - first_index);
+    const double lo =
+        std::max(min_slope, (dy - LearnedIndexModel::kMaxError) / dx);
+    const double hi =
+        std::min(max_slope, (dy + LearnedIndexModel::kMaxError) / dx);
+    if (lo <= hi) {
+      min_slope = lo;
+      max_slope = hi;
+    } else {
+      add_segment();
+      first_position = position;
+      first_index = index;
+      min_slope = 0;
+      max_slope = std::numeric_limits<double>::infinity();
+    }
+  }
+  if (num_keys > 0) {
+    add_segment();
+  }
+  PutVarint32(&result, num_segments);
+  result.append(segments);
+  return result;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,88 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A piecewise linear model of the position of the restart points of an index
+// block, used by kLearnedIndexSearch. Each user key is mapped to a 64-bit
+// integer made of the 8 bytes that follow the prefix shared by all the keys
+// of the index, so the mapping preserves the bytewise order. The model is a
+// sorted list of segments, each of which predicts the restart index of the
+// keys it covers within kMaxError of their actual index.
+//
+// The model only narrows down where the search over the restart points
+// starts. IndexBlockIter still compares the keys it lands on, so a bad or
+// stale model costs comparisons but never correctness.
+class LearnedIndexModel {
+ public:
+  // The bound of the error of the prediction for the keys the model was
+  // learned from.
+  static constexpr uint32_t kMaxError = 8;
+
+  // Creates the model from the contents of the meta block written by
+  // LearnedIndexModelBuilder.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<LearnedIndexModel>* model);
+
+  // Returns the predicted index of the last restart point whose key is
+  // less than or equal to user_key.
+  uint32_t Predict(const Slice& user_key) const;
+
+  uint32_t num_restarts() const { return num_restarts_; }
+
+  size_t num_segments() const { return segments_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(LearnedIndexModel) + common_prefix_.capacity() +
+           segments_.capacity() * sizeof(Segment);
+  }
+
+  // Maps the key, which has to start with a prefix of common_prefix_size
+  // bytes, to the integer it is modeled on.
+  static uint64_t KeyToPosition(const Slice& user_key,
+                                size_t common_prefix_size);
+
+ private:
+  struct Segment {
+    uint64_t first_position;
+    uint32_t first_index;
+    double slope;
+  };
+
+  LearnedIndexModel() = default;
+
+  uint32_t num_restarts_ = 0;
+  std::string common_prefix_;
+  std::vector<Segment> segments_;
+};
+
+// Learns a LearnedIndexModel from the keys of the restart points of an index
+// block, added in order.
+class LearnedIndexModelBuilder {
+ public:
+  void Add(const Slice& user_key);
+
+  // Returns the encoded model, to be stored in a meta block.
+  std::string Finish();
+
+  size_t num_keys() const { return key_offsets_.size(); }
+
+ private:
+  // The keys, concatenated.
+  std::string keys_;
+  std::vector<size_t> key_offsets_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,273 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/range_filter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "port/port.h"
+#include "table/block_based/learned_index_model.h"
+#include "util/coding.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+constexpr uint32_t RangeFilterReader::kBitsPerLevel;
+constexpr uint32_t RangeFilterReader::kMaxLevels;
+constexpr uint32_t RangeFilterReader::kMaxProbes;
+
+namespace {
+// Meta block layout:
+//   common_prefix: length prefixed slice
+//   base_shift: varint32
+//   base_bits: varint64, the dropped low bits, same for all the keys
+//   num_levels: varint32
+//   filters: num_levels times, from level 0
+//     filter: length prefixed slice
+//
+// The filter of a level holds the nodes of the level, each encoded as a
+// fixed64.
+Slice EncodeNode(uint64_t node, char* buf) {
+  EncodeFixed64(buf, node);
+  return Slice(buf, sizeof(uint64_t));
+}
+
+bool ValidShifts(uint32_t base_shift, uint32_t num_levels) {
+  return num_levels > 0 && num_levels <= RangeFilterReader::kMaxLevels &&
+         base_shift + RangeFilterReader::kBitsPerLevel * (num_levels - 1) < 64;
+}
+}  // namespace
+
+Status RangeFilterReader::Create(const FilterPolicy* policy,
+                                 const Slice& contents,
+                                 std::unique_ptr<RangeFilterReader>* reader) {
+  assert(policy != nullptr);
+  assert(reader != nullptr);
+  std::unique_ptr<RangeFilterReader> result(new RangeFilterReader());
+  result->data_ = contents.ToString();
+  Slice input = result->data_;
+  uint32_t num_levels = 0;
+  if (!GetLengthPrefixedSlice(&input, &result->common_prefix_) ||
+      !GetVarint32(&input, &result->base_shift_) ||
+      !GetVarint64(&input, &result->base_bits_) ||
+      !GetVarint32(&input, &num_levels) ||
+      !ValidShifts(result->base_shift_, num_levels) ||
+      (result->base_bits_ >> result->base_shift_) != 0) {
+    return Status::Corruption("bad range filter header");
+  }
+  result->levels_.reserve(num_levels);
+  for (uint32_t level = 0; level < num_levels; level++) {
+    Slice filter;
+    if (!GetLengthPrefixedSlice(&input, &filter)) {
+      return Status::Corruption("bad range filter level");
+    }
+    result->levels_.emplace_back(policy->GetFilterBitsReader(filter));
+    if (result->levels_.back() == nullptr) {
+      return Status::NotSupported("filter policy has no filter bits reader");
+    }
+  }
+  if (!input.empty()) {
+    return Status::Corruption("unexpected data after range filter");
+  }
+  *reader = std::move(result);
+  return Status::OK();
+}
+
+bool RangeFilterReader::RangeMayMatch(const Slice& start,
+                                      const Slice& end) const {
+  const size_t prefix_size = common_prefix_.size();
+  // Compares the key with the prefix shared by all the keys of the table
+  auto compare_prefix = [&](const Slice& key) {
+    int c = memcmp(key.data(), common_prefix_.data(),
+                   std::min(key.size(), prefix_size));
+    if (c == 0 && key.size() < prefix_size) {
+      c = -1;
+    }
+    return c;
+  };
+
+  // The keys of the table all end with base_bits_ once mapped to integers.
+  const uint64_t max_node = port::kMaxUint64 >> base_shift_;
+  const uint64_t base_mask = ~(max_node << base_shift_);
+
+  uint64_t lo = 0;
+  int c = compare_prefix(start);
+  if (c > 0) {
+    // start sorts after all the keys of the table.
+    return false;
+  } else if (c == 0) {
+    const uint64_t position =
+        LearnedIndexModel::KeyToPosition(start, prefix_size);
+    lo = position >> base_shift_;
+    if ((position & base_mask) > base_bits_) {
+      // The key of node lo would sort before start.
+      if (lo == max_node) {
+        return false;
+      }
+      lo++;
+    }
+  }
+  // The keys before end map to integers up to that of end, inclusive, since
+  // the mapping truncates the keys.
+  uint64_t hi = max_node;
+  c = compare_prefix(end);
+  if (c < 0) {
+    // end sorts before all the keys of the table.
+    return false;
+  } else if (c == 0) {
+    const uint64_t position = LearnedIndexModel::KeyToPosition(end, prefix_size);
+    hi = position >> base_shift_;
+    if ((position & base_mask) < base_bits_) {
+      // The key of node hi would sort after end.
+      if (hi == 0) {
+        return false;
+      }
+      hi--;
+    }
+  }
+  if (lo > hi) {
+    return false;
+  }
+
+  const uint32_t top = static_cast<uint32_t>(levels_.size()) - 1;
+  const uint32_t top_shift = kBitsPerLevel * top;
+  const uint64_t first = lo >> top_shift;
+  const uint64_t last = hi >> top_shift;
+  if (last - first >= kMaxProbes) {
+    return true;
+  }
+  uint32_t budget = kMaxProbes;
+  for (uint64_t node = first;; node++) {
+    if (NodeMayMatch(top, node, lo, hi, &budget)) {
+      return true;
+    }
+    if (node == last) {
+      return false;
+    }
+  }
+}
+
+bool RangeFilterReader::NodeMayMatch(uint32_t level, uint64_t node,
+                                     uint64_t lo, uint64_t hi,
+                                     uint32_t* budget) const {
+  if (*budget == 0) {
+    return true;
+  }
+  --*budget;
+  char buf[sizeof(uint64_t)];
+  if (!levels_[level]->MayMatch(EncodeNode(node, buf))) {
+    return false;
+  }
+  if (level == 0) {
+    return true;
+  }
+  // Only the children of the node within [lo, hi]
+  const uint32_t child_shift = kBitsPerLevel * (level - 1);
+  const uint64_t first_child = node << kBitsPerLevel;
+  const uint64_t last_child =
+      first_child | ((uint64_t{1} << kBitsPerLevel) - 1);
+  const uint64_t first = std::max(first_child, lo >> child_shift);
+  const uint64_t last = std::min(last_child, hi >> child_shift);
+  assert(first <= last);
+  for (uint64_t child = first;; child++) {
+    if (NodeMayMatch(level - 1, child, lo, hi, budget)) {
+      return true;
+    }
+    if (child == last) {
+      return false;
+    }
+  }
+}
+
+RangeFilterBuilder::RangeFilterBuilder(const FilterPolicy* policy,
+                                       const FilterBuildingContext& context,
+                                       uint32_t num_levels)
+    : policy_(policy),
+      context_(context),
+      num_levels_(std::min(num_levels, RangeFilterReader::kMaxLevels)) {
+  assert(policy_ != nullptr);
+  assert(num_levels_ > 0);
+}
+
+void RangeFilterBuilder::Add(const Slice& user_key) {
+  if (positions_.empty()) {
+    first_key_.assign(user_key.data(), user_key.size());
+    common_prefix_size_ = user_key.size();
+    positions_.push_back(0);
+    return;
+  }
+  const size_t prefix_size = std::min(
+      common_prefix_size_, Slice(first_key_).difference_offset(user_key));
+  if (prefix_size < common_prefix_size_) {
+    // The bytes the prefix no longer covers are those of the first key, so
+    // they move into the high bytes of the integers of the previous keys.
+    const size_t shift_bytes = common_prefix_size_ - prefix_size;
+    const uint64_t first_position =
+        LearnedIndexModel::KeyToPosition(first_key_, prefix_size);
+    for (uint64_t& position : positions_) {
+      if (shift_bytes >= sizeof(uint64_t)) {
+        position = first_position;
+      } else {
+        const uint32_t bits = static_cast<uint32_t>(shift_bytes * 8);
+        position = (first_position & ~(port::kMaxUint64 >> bits)) |
+                   (position >> bits);
+      }
+    }
+    common_prefix_size_ = prefix_size;
+  }
+  const uint64_t position =
+      LearnedIndexModel::KeyToPosition(user_key, common_prefix_size_);
+  // The keys are added in order, so the versions of a key, and the keys that
+  // only differ past the 8 bytes of their integer, are next to each other.
+  if (position != positions_.back()) {
+    positions_.push_back(position);
+  }
+}
+
+std::string RangeFilterBuilder::Finish() {
+  if (positions_.empty()) {
+    return std::string();
+  }
+  // Drop the low bits that are the same for all the keys.
+  uint64_t diff = 0;
+  for (uint64_t position : positions_) {
+    diff |= position ^ positions_[0];
+  }
+  const uint32_t base_shift =
+      diff == 0 ? 0 : static_cast<uint32_t>(CountTrailingZeroBits(diff));
+  const uint32_t num_levels = std::min(
+      num_levels_, (63 - base_shift) / RangeFilterReader::kBitsPerLevel + 1);
+  assert(ValidShifts(base_shift, num_levels));
+
+  std::string result;
+  PutLengthPrefixedSlice(&result, Slice(first_key_.data(), common_prefix_size_));
+  PutVarint32(&result, base_shift);
+  PutVarint64(&result, base_shift == 0
+                           ? 0
+                           : positions_[0] & ((uint64_t{1} << base_shift) - 1));
+  PutVarint32(&result, num_levels);
+  for (uint32_t level = 0; level < num_levels; level++) {
+    std::unique_ptr<FilterBitsBuilder> builder(
+        policy_->GetBuilderWithContext(context_));
+    if (builder == nullptr) {
+      return std::string();
+    }
+    const uint32_t shift = base_shift + RangeFilterReader::kBitsPerLevel * level;
+    char buf[sizeof(uint64_t)];
+    // The positions are sorted, so the nodes of a level are too.
+    for (size_t i = 0; i < positions_.size(); i++) {
+      const uint64_t node = positions_[i] >> shift;
+      if (i == 0 || node != positions_[i - 1] >> shift) {
+        builder->AddKey(EncodeNode(node, buf));
+      }
+    }
+    std::unique_ptr<const char[]> filter_buf;
+    PutLengthPrefixedSlice(&result, builder->Finish(&filter_buf));
+  }
+  return result;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,104 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A filter over the user keys of a table that tells whether the table may
+// hold a key in a range, used by BlockBasedTableOptions::range_filter_levels
+// so that a bounded scan skips the tables with no key in its range without
+// reading any of their blocks.
+//
+// Like for LearnedIndexModel, each user key is mapped to a 64-bit integer made
+// of the 8 bytes that follow the prefix shared by all the keys of the table,
+// which preserves the bytewise order. The low bits that are the same for all
+// the keys, such as those of a fixed suffix or padding, are then dropped, and
+// kept aside to narrow down the ranges to check. Following
+// Rosetta, the filter is a stack of filters built with the filter policy of
+// the table: the filter of level i holds the integers shifted right by
+// kBitsPerLevel * i bits, i.e. the nodes of a trie over the integers. A range
+// is checked from the top level down, only descending into the nodes the
+// filter of their level may hold, so that most false positives of a level are
+// caught by the levels below it. A range that covers too many nodes of the
+// top level is assumed to match.
+class RangeFilterReader {
+ public:
+  static constexpr uint32_t kBitsPerLevel = 4;
+  static constexpr uint32_t kMaxLevels = 64 / kBitsPerLevel;
+  // The bound of the number of nodes probed by RangeMayMatch()
+  static constexpr uint32_t kMaxProbes = 64;
+
+  // Creates the reader from the contents of the meta block written by
+  // RangeFilterBuilder, whose filters were built with `policy`.
+  static Status Create(const FilterPolicy* policy, const Slice& contents,
+                       std::unique_ptr<RangeFilterReader>* reader);
+
+  // Returns false if the table holds no user key in [start, end).
+  bool RangeMayMatch(const Slice& start, const Slice& end) const;
+
+  size_t num_levels() const { return levels_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(RangeFilterReader) + data_.capacity() +
+           levels_.capacity() * sizeof(levels_[0]);
+  }
+
+ private:
+  RangeFilterReader() = default;
+
+  // Returns false if none of the keys of the table are in [lo, hi] and under
+  // `node` of `level`. Gives up and returns true once *budget probes were
+  // made.
+  bool NodeMayMatch(uint32_t level, uint64_t node, uint64_t lo, uint64_t hi,
+                    uint32_t* budget) const;
+
+  // The contents of the meta block, which the filters point into.
+  std::string data_;
+  Slice common_prefix_;
+  uint32_t base_shift_ = 0;
+  uint64_t base_bits_ = 0;
+  std::vector<std::unique_ptr<FilterBitsReader>> levels_;
+};
+
+// Builds the RangeFilterReader of the user keys of a table, added in order.
+// Holds 8 bytes per distinct integer of the keys added until Finish(), which
+// is not charged to the block cache.
+class RangeFilterBuilder {
+ public:
+  RangeFilterBuilder(const FilterPolicy* policy,
+                     const FilterBuildingContext& context, uint32_t num_levels);
+
+  void Add(const Slice& user_key);
+
+  // Returns the contents of the meta block, or an empty string if no key was
+  // added or the filter policy has no filter bits builder.
+  std::string Finish();
+
+  // The number of distinct integers of the keys added so far
+  size_t num_added() const { return positions_.size(); }
+
+ private:
+  const FilterPolicy* policy_;
+  const FilterBuildingContext context_;
+  const uint32_t num_levels_;
+
+  std::string first_key_;
+  // The size of the prefix shared by the keys added so far
+  size_t common_prefix_size_ = 0;
+  // The integers of the keys added so far, following their common prefix
+  std::vector<uint64_t> positions_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
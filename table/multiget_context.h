@@ -35,6 +35,9 @@ struct KeyContext {
   PinnableSlice* value;
   std::string* timestamp;
   GetContext* get_context;
+  // Set if the value found is a reference into a blob file (integrated
+  // BlobDB), which still has to be resolved.
+  bool is_blob_index;
 
   KeyContext(ColumnFamilyHandle* col_family, const Slice& user_key,
              PinnableSlice* val, std::string* ts, Status* stat)
@@ -47,7 +50,8 @@ struct KeyContext {
         cb_arg(nullptr),
         value(val),
         timestamp(ts),
-        get_context(nullptr) {}
+        get_context(nullptr),
+        is_blob_index(false) {}
 
   KeyContext() = default;
 };
@@ -174,6 +174,14 @@ Status GetMemTableRepFactoryFromString(
     } else if (1 == len) {
       mem_factory = new SkipListFactory();
     }
+  } else if (opts_list[0] == "btree" || opts_list[0] == "BTreeFactory") {
+    // Expecting format
+    // btree
+    if (1 != len) {
+      return Status::InvalidArgument("Can't parse memtable_factory option ",
+                                     opts_str);
+    }
+    mem_factory = new BTreeFactory();
   } else if (opts_list[0] == "prefix_hash" ||
              opts_list[0] == "HashSkipListRepFactory") {
     // Expecting format
@@ -203,6 +211,16 @@ Status GetMemTableRepFactoryFromString(
     } else if (1 == len) {
       mem_factory = new VectorRepFactory();
     }
+  } else if (opts_list[0] == "sorted_run" ||
+             opts_list[0] == "SortedRunRepFactory") {
+    // Expecting format
+    // sorted_run:<run_size>
+    if (2 == len) {
+      size_t run_size = ParseSizeT(opts_list[1]);
+      mem_factory = new SortedRunRepFactory(run_size);
+    } else if (1 == len) {
+      mem_factory = new SortedRunRepFactory();
+    }
   } else if (opts_list[0] == "cuckoo") {
     return Status::NotSupported(
         "cuckoo hash memtable is not supported anymore.");
@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <algorithm>
+#include <cinttypes>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -41,6 +42,7 @@
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
 #include "table/block_based/flush_block_policy.h"
+#include "table/block_based/learned_index_model.h"
 #include "table/format.h"
 #include "table/get_context.h"
 #include "table/internal_iterator.h"
@@ -2145,6 +2147,131 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, RestartKeyPrefixesIndexTest) {
+  for (auto index_type : {BlockBasedTableOptions::kBinarySearch,
+                          BlockBasedTableOptions::kTwoLevelIndexSearch}) {
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.index_type = index_type;
+    table_options.store_restart_key_prefixes = true;
+    IndexTest(table_options);
+  }
+}
+
+TEST_P(BlockBasedTableTest, LearnedIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kLearnedIndexSearch;
+  IndexTest(table_options);
+}
+
+// Seeks a table with many data blocks, so the index has enough restart points
+// for the model to have several segments, and checks the results against the
+// sorted keys.
+TEST_P(BlockBasedTableTest, LearnedIndexSeek) {
+  for (int restart_interval : {1, 4}) {
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.index_type = BlockBasedTableOptions::kLearnedIndexSearch;
+    table_options.index_block_restart_interval = restart_interval;
+    table_options.block_size = 256;
+    Options options;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    const ImmutableCFOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+
+    auto user_key = [](uint64_t i) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "key%012" PRIu64, i);
+      return std::string(buf);
+    };
+    // Unevenly spaced keys, so a single line does not fit them.
+    Random rnd(301);
+    TableConstructor c(BytewiseComparator());
+    uint64_t n = 0;
+    for (int i = 0; i < 5000; i++) {
+      n += (i % 1000 < 500) ? 1 + rnd.Uniform(10) : 1 + rnd.Uniform(100000);
+      InternalKey k(user_key(n), 0, kTypeValue);
+      c.Add(k.Encode().ToString(), rnd.RandomString(20));
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    std::unique_ptr<InternalKeyComparator> comparator(
+        new InternalKeyComparator(BytewiseComparator()));
+    c.Finish(options, ioptions, moptions, table_options, *comparator, &keys,
+             &kvmap);
+    auto reader = c.GetTableReader();
+    ASSERT_GT(reader->GetTableProperties()->num_data_blocks, 100u);
+    // Recorded as a binary search index, for older versions to read.
+    const auto& props =
+        reader->GetTableProperties()->user_collected_properties;
+    auto index_type = props.find(BlockBasedTablePropertyNames::kIndexType);
+    ASSERT_NE(props.end(), index_type);
+    ASSERT_EQ(BlockBasedTableOptions::kBinarySearch,
+              DecodeFixed32(index_type->second.c_str()));
+
+    std::unique_ptr<InternalIterator> iter(reader->NewIterator(
+        ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+        /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+    for (int i = 0; i < 10000; i++) {
+      std::string target;
+      if (i % 2 == 0) {
+        // An existing key.
+        target = keys[rnd.Uniform(static_cast<int>(keys.size()))];
+      } else {
+        target = InternalKey(user_key(rnd.Uniform(static_cast<int>(n + 10))), 0, kTypeValue)
+                     .Encode()
+                     .ToString();
+      }
+      iter->Seek(target);
+      ASSERT_OK(iter->status());
+      auto expected = kvmap.lower_bound(target);
+      if (expected == kvmap.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(expected->first, iter->key().ToString());
+        ASSERT_EQ(expected->second, iter->value().ToString());
+      }
+    }
+    // Targets outside of the range of the keys of the table.
+    iter->Seek(InternalKey("a", 0, kTypeValue).Encode());
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys.front(), iter->key().ToString());
+    iter->Seek(InternalKey("z", 0, kTypeValue).Encode());
+    ASSERT_OK(iter->status());
+    ASSERT_FALSE(iter->Valid());
+    iter.reset();
+    c.ResetTableReader();
+  }
+}
+
+TEST_F(GeneralTableTest, LearnedIndexModel) {
+  Random rnd(301);
+  LearnedIndexModelBuilder builder;
+  std::vector<std::string> keys;
+  uint64_t n = 0;
+  for (int i = 0; i < 2000; i++) {
+    n += (i % 400 < 200) ? 1 : 1 + rnd.Uniform(1 << 20);
+    std::string key = "prefix";
+    PutFixed64(&key, EndianSwapValue(n));
+    keys.push_back(key);
+    builder.Add(key);
+  }
+  std::unique_ptr<LearnedIndexModel> model;
+  ASSERT_OK(LearnedIndexModel::Create(builder.Finish(), &model));
+  ASSERT_EQ(keys.size(), model->num_restarts());
+  ASSERT_GT(model->num_segments(), 1u);
+  for (size_t i = 0; i < keys.size(); i++) {
+    const uint32_t predicted = model->Predict(keys[i]);
+    ASSERT_LE(predicted, i + LearnedIndexModel::kMaxError);
+    ASSERT_LE(i, predicted + LearnedIndexModel::kMaxError);
+  }
+  ASSERT_EQ(0u, model->Predict("a"));
+  ASSERT_EQ(keys.size() - 1, model->Predict("z"));
+
+  std::unique_ptr<LearnedIndexModel> corrupted;
+  ASSERT_TRUE(
+      LearnedIndexModel::Create("garbage", &corrupted).IsCorruption());
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
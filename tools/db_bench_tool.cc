@@ -409,6 +409,15 @@ DEFINE_int32(max_background_flushes,
              "The maximum number of concurrent background flushes"
              " that can occur in parallel.");
 
+DEFINE_int32(max_flush_partitions,
+             ROCKSDB_NAMESPACE::Options().max_flush_partitions,
+             "The maximum number of L0 files a flush is split into and"
+             " written in parallel.");
+
+DEFINE_bool(enable_pipelined_compaction,
+            ROCKSDB_NAMESPACE::Options().enable_pipelined_compaction,
+            "Read the inputs of a compaction ahead on threads of their own.");
+
 static ROCKSDB_NAMESPACE::CompactionStyle FLAGS_compaction_style_e;
 DEFINE_int32(compaction_style,
              (int32_t)ROCKSDB_NAMESPACE::Options().compaction_style,
@@ -472,6 +481,10 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(use_learned_index, false,
+            "Seek the index blocks with the help of a learned model of the "
+            "position of their keys (kLearnedIndexSearch)");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -542,6 +555,19 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(store_restart_key_prefixes, false,
+            "Store the key prefixes of the restart points of data and index "
+            "blocks, to narrow down their binary search");
+
+DEFINE_uint32(range_filter_levels, 0,
+              "Number of levels of the range filter of each table, used by "
+              "the bounded scans. 0 means no range filter. Requires "
+              "bloom_bits >= 0");
+
+DEFINE_bool(reserve_filter_construction_memory, false,
+            "Charge the memory used to build the Ribbon filters to the block "
+            "cache");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -767,6 +793,11 @@ DEFINE_int32(transaction_sleep, 0,
 DEFINE_uint64(transaction_lock_timeout, 100,
               "If using a transaction_db, specifies the lock wait timeout in"
               " milliseconds before failing a transaction waiting on a lock");
+
+DEFINE_bool(use_per_key_point_lock_mgr, false,
+            "If using a transaction_db, manage the point locks with a queue of "
+            "waiters per key, for transactions contending for a few hot "
+            "keys (e.g. randomtransaction with a small --num).");
 DEFINE_string(
     options_file, "",
     "The path to a RocksDB options file.  If specified, then db_bench will "
@@ -879,6 +910,12 @@ DEFINE_int64(
 DEFINE_string(block_cache_trace_file, "", "Block cache trace file path.");
 DEFINE_int32(trace_replay_threads, 1,
              "The number of threads to replay, must >=1.");
+DEFINE_bool(trace_replay_preserve_key_order, false,
+            "Replay the queries on the same key in the order of the trace, "
+            "each key by one of the trace_replay_threads threads.");
+DEFINE_bool(trace_replay_fast_as_possible, false,
+            "Ignore the timestamps of the trace and replay the queries as fast "
+            "as the replay threads execute them.");
 
 static enum ROCKSDB_NAMESPACE::CompressionType StringToCompressionType(
     const char* ctype) {
@@ -922,6 +959,16 @@ static enum ROCKSDB_NAMESPACE::CompressionType FLAGS_compression_type_e =
 
 DEFINE_int64(sample_for_compression, 0, "Sample every N block for compression");
 
+DEFINE_string(wal_compression, "none",
+              "Algorithm to use to compress the WAL records (none or zstd)");
+static enum ROCKSDB_NAMESPACE::CompressionType FLAGS_wal_compression_e =
+    ROCKSDB_NAMESPACE::kNoCompression;
+
+DEFINE_bool(enable_pipelined_wal_recovery,
+            ROCKSDB_NAMESPACE::Options().enable_pipelined_wal_recovery,
+            "Read the WAL on a separate thread while replaying it into the "
+            "memtables when the DB is opened");
+
 DEFINE_int32(compression_level, ROCKSDB_NAMESPACE::CompressionOptions().level,
              "Compression level. The meaning of this value is library-"
              "dependent. If unset, we try to use the default for the library "
@@ -1025,6 +1072,10 @@ DEFINE_uint64(soft_pending_compaction_bytes_limit, 64ull * 1024 * 1024 * 1024,
 DEFINE_uint64(hard_pending_compaction_bytes_limit, 128ull * 1024 * 1024 * 1024,
               "Stop writes if pending compaction bytes exceed this number");
 
+DEFINE_uint64(pending_compaction_bytes_target, 0,
+              "If non-zero, throttle writes with a feedback controller that "
+              "keeps pending compaction bytes near this number");
+
 DEFINE_uint64(delayed_write_rate, 8388608u,
               "Limited bytes allowed to DB when soft_rate_limit or "
               "level0_slowdown_writes_trigger triggers");
@@ -1297,11 +1348,19 @@ DEFINE_int64(multiread_stride, 0,
              "Stride length for the keys in a MultiGet batch");
 DEFINE_bool(multiread_batched, false, "Use the new MultiGet API");
 
+DEFINE_bool(pin_slice, true,
+            "Read values into a PinnableSlice in readrandom and batched "
+            "multireadrandom, so that values found in the block cache or in "
+            "the blob cache are not copied. When false, the values are copied "
+            "into a std::string, to measure the cost of the copies.");
+
 enum RepFactory {
   kSkipList,
   kPrefixHash,
   kVectorRep,
   kHashLinkedList,
+  kBTree,
+  kSortedRun,
 };
 
 static enum RepFactory StringToRepFactory(const char* ctype) {
@@ -1315,6 +1374,10 @@ static enum RepFactory StringToRepFactory(const char* ctype) {
     return kVectorRep;
   else if (!strcasecmp(ctype, "hash_linkedlist"))
     return kHashLinkedList;
+  else if (!strcasecmp(ctype, "btree"))
+    return kBTree;
+  else if (!strcasecmp(ctype, "sorted_run"))
+    return kSortedRun;
 
   fprintf(stdout, "Cannot parse memreptable %s\n", ctype);
   return kSkipList;
@@ -1323,6 +1386,9 @@ static enum RepFactory StringToRepFactory(const char* ctype) {
 static enum RepFactory FLAGS_rep_factory;
 DEFINE_string(memtablerep, "skip_list", "");
 DEFINE_int64(hash_bucket_count, 1024 * 1024, "hash bucket count");
+DEFINE_int64(sorted_run_size, 4096,
+             "Number of keys each core buffers before sorting them into a "
+             "run, with --memtablerep=sorted_run");
 DEFINE_bool(use_plain_table, false, "if use plain table "
             "instead of block-based table format");
 DEFINE_bool(use_cuckoo_table, false, "if use cuckoo table format");
@@ -1333,6 +1399,8 @@ DEFINE_bool(use_hash_search, false, "if use kHashSearch "
 DEFINE_bool(use_block_based_filter, false, "if use kBlockBasedFilter "
             "instead of kFullFilter for filter block. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_ribbon_filter, false, "Use Ribbon instead of Bloom filter, "
+            "with bloom_bits as the Bloom equivalent bits per key");
 DEFINE_string(merge_operator, "", "The merge operator to use with the database."
               "If a new merge operator is specified, be sure to use fresh"
               " database The possible merge operators are defined in"
@@ -1344,6 +1412,10 @@ DEFINE_bool(report_file_operations, false, "if report number of file "
             "operations");
 DEFINE_int32(readahead_size, 0, "Iterator readahead size");
 
+DEFINE_bool(async_io, false,
+            "Set ReadOptions.async_io, so that iterators read the next "
+            "readahead chunk in the background");
+
 DEFINE_bool(read_with_latest_user_timestamp, true,
             "If true, always use the current latest timestamp for read. If "
             "false, choose a random timestamp from the past.");
@@ -2515,6 +2587,12 @@ class Benchmark {
       case kHashLinkedList:
         fprintf(stdout, "Memtablerep: hash_linkedlist\n");
         break;
+      case kBTree:
+        fprintf(stdout, "Memtablerep: btree\n");
+        break;
+      case kSortedRun:
+        fprintf(stdout, "Memtablerep: sorted_run\n");
+        break;
     }
     fprintf(stdout, "Perf Level: %d\n", FLAGS_perf_level);
 
@@ -2688,10 +2766,13 @@ class Benchmark {
   Benchmark()
       : cache_(NewCache(FLAGS_cache_size)),
         compressed_cache_(NewCache(FLAGS_compressed_cache_size)),
-        filter_policy_(FLAGS_bloom_bits >= 0
-                           ? NewBloomFilterPolicy(FLAGS_bloom_bits,
-                                                  FLAGS_use_block_based_filter)
-                           : nullptr),
+        filter_policy_(
+            FLAGS_bloom_bits >= 0
+                ? FLAGS_use_ribbon_filter
+                      ? NewRibbonFilterPolicy(FLAGS_bloom_bits)
+                      : NewBloomFilterPolicy(FLAGS_bloom_bits,
+                                             FLAGS_use_block_based_filter)
+                : nullptr),
         prefix_extractor_(NewFixedPrefixTransform(FLAGS_prefix_size)),
         num_(FLAGS_num),
         key_size_(FLAGS_key_size),
@@ -3643,6 +3724,9 @@ class Benchmark {
     options.max_background_compactions = FLAGS_max_background_compactions;
     options.max_subcompactions = static_cast<uint32_t>(FLAGS_subcompactions);
     options.max_background_flushes = FLAGS_max_background_flushes;
+    options.max_flush_partitions =
+        static_cast<uint32_t>(FLAGS_max_flush_partitions);
+    options.enable_pipelined_compaction = FLAGS_enable_pipelined_compaction;
     options.compaction_style = FLAGS_compaction_style_e;
     options.compaction_pri = FLAGS_compaction_pri_e;
     options.allow_mmap_reads = FLAGS_mmap_read;
@@ -3706,6 +3790,9 @@ class Benchmark {
         options.memtable_factory.reset(new SkipListFactory(
             FLAGS_skip_list_lookahead));
         break;
+      case kBTree:
+        options.memtable_factory.reset(new BTreeFactory());
+        break;
 #ifndef ROCKSDB_LITE
       case kPrefixHash:
         options.memtable_factory.reset(
@@ -3720,6 +3807,10 @@ class Benchmark {
           new VectorRepFactory
         );
         break;
+      case kSortedRun:
+        options.memtable_factory.reset(
+            new SortedRunRepFactory(FLAGS_sorted_run_size));
+        break;
 #else
       default:
         fprintf(stderr, "Only skip list is supported in lite mode\n");
@@ -3778,6 +3869,9 @@ class Benchmark {
           exit(1);
         }
         block_based_options.index_type = BlockBasedTableOptions::kHashSearch;
+      } else if (FLAGS_use_learned_index) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kLearnedIndexSearch;
       } else {
         block_based_options.index_type = BlockBasedTableOptions::kBinarySearch;
       }
@@ -3858,6 +3952,11 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.store_restart_key_prefixes =
+          FLAGS_store_restart_key_prefixes;
+      block_based_options.range_filter_levels = FLAGS_range_filter_levels;
+      block_based_options.reserve_filter_construction_memory =
+          FLAGS_reserve_filter_construction_memory;
       if (FLAGS_read_cache_path != "") {
 #ifndef ROCKSDB_LITE
         Status rc_status;
@@ -3939,6 +4038,8 @@ class Benchmark {
         FLAGS_soft_pending_compaction_bytes_limit;
     options.hard_pending_compaction_bytes_limit =
         FLAGS_hard_pending_compaction_bytes_limit;
+    options.pending_compaction_bytes_target =
+        FLAGS_pending_compaction_bytes_target;
     options.delayed_write_rate = FLAGS_delayed_write_rate;
     options.allow_concurrent_memtable_write =
         FLAGS_allow_concurrent_memtable_write;
@@ -3964,6 +4065,8 @@ class Benchmark {
     options.use_adaptive_mutex = FLAGS_use_adaptive_mutex;
     options.bytes_per_sync = FLAGS_bytes_per_sync;
     options.wal_bytes_per_sync = FLAGS_wal_bytes_per_sync;
+    options.wal_compression = FLAGS_wal_compression_e;
+    options.enable_pipelined_wal_recovery = FLAGS_enable_pipelined_wal_recovery;
 
     // merge operator options
     options.merge_operator = MergeOperators::CreateFromStringId(
@@ -4055,8 +4158,11 @@ class Benchmark {
         table_options->block_cache = cache_;
       }
       if (FLAGS_bloom_bits >= 0) {
-        table_options->filter_policy.reset(NewBloomFilterPolicy(
-            FLAGS_bloom_bits, FLAGS_use_block_based_filter));
+        table_options->filter_policy.reset(
+            FLAGS_use_ribbon_filter
+                ? NewRibbonFilterPolicy(FLAGS_bloom_bits)
+                : NewBloomFilterPolicy(FLAGS_bloom_bits,
+                                       FLAGS_use_block_based_filter));
       }
     }
     if (FLAGS_row_cache_size) {
@@ -4142,6 +4248,7 @@ class Benchmark {
 
   void OpenDb(Options options, const std::string& db_name,
       DBWithColumnFamilies* db) {
+    uint64_t open_start = FLAGS_env->NowMicros();
     Status s;
     // Open with column families if necessary.
     if (FLAGS_num_column_families > 1) {
@@ -4192,6 +4299,8 @@ class Benchmark {
       } else if (FLAGS_transaction_db) {
         TransactionDB* ptr;
         TransactionDBOptions txn_db_options;
+        txn_db_options.use_per_key_point_lock_mgr =
+            FLAGS_use_per_key_point_lock_mgr;
         if (options.unordered_write) {
           options.two_write_queues = true;
           txn_db_options.skip_concurrency_control = true;
@@ -4223,6 +4332,8 @@ class Benchmark {
     } else if (FLAGS_transaction_db) {
       TransactionDB* ptr = nullptr;
       TransactionDBOptions txn_db_options;
+      txn_db_options.use_per_key_point_lock_mgr =
+          FLAGS_use_per_key_point_lock_mgr;
       if (options.unordered_write) {
         options.two_write_queues = true;
         txn_db_options.skip_concurrency_control = true;
@@ -4285,6 +4396,9 @@ class Benchmark {
       fprintf(stderr, "open error: %s\n", s.ToString().c_str());
       exit(1);
     }
+    // Includes the WAL recovery time when opening an existing DB.
+    fprintf(stdout, "DB open:     %.3f seconds\n",
+            (FLAGS_env->NowMicros() - open_start) * 1e-6);
   }
 
   enum WriteMode {
@@ -4894,6 +5008,8 @@ class Benchmark {
   void ReadSequential(ThreadState* thread, DB* db) {
     ReadOptions options(FLAGS_verify_checksum, true);
     options.tailing = FLAGS_use_tailing_iterator;
+    options.readahead_size = FLAGS_readahead_size;
+    options.async_io = FLAGS_async_io;
     std::unique_ptr<char[]> ts_guard;
     Slice ts;
     if (user_timestamp_size_ > 0) {
@@ -5112,6 +5228,7 @@ class Benchmark {
     std::unique_ptr<const char[]> key_guard;
     Slice key = AllocateKey(&key_guard);
     PinnableSlice pinnable_val;
+    std::string copied_val;
     std::unique_ptr<char[]> ts_guard;
     Slice ts;
     if (user_timestamp_size_ > 0) {
@@ -5147,19 +5264,22 @@ class Benchmark {
         options.timestamp = &ts;
         ts_ptr = &ts_ret;
       }
+      ColumnFamilyHandle* cfh = FLAGS_num_column_families > 1
+                                    ? db_with_cfh->GetCfh(key_rand)
+                                    : db_with_cfh->db->DefaultColumnFamily();
       Status s;
-      if (FLAGS_num_column_families > 1) {
-        s = db_with_cfh->db->Get(options, db_with_cfh->GetCfh(key_rand), key,
-                                 &pinnable_val, ts_ptr);
-      } else {
+      size_t value_size = 0;
+      if (FLAGS_pin_slice) {
         pinnable_val.Reset();
-        s = db_with_cfh->db->Get(options,
-                                 db_with_cfh->db->DefaultColumnFamily(), key,
-                                 &pinnable_val, ts_ptr);
+        s = db_with_cfh->db->Get(options, cfh, key, &pinnable_val, ts_ptr);
+        value_size = pinnable_val.size();
+      } else {
+        s = db_with_cfh->db->Get(options, cfh, key, &copied_val, ts_ptr);
+        value_size = copied_val.size();
       }
       if (s.ok()) {
         found++;
-        bytes += key.size() + pinnable_val.size() + user_timestamp_size_;
+        bytes += key.size() + value_size + user_timestamp_size_;
       } else if (!s.IsNotFound()) {
         fprintf(stderr, "Get returned an error: %s\n", s.ToString().c_str());
         abort();
@@ -5257,6 +5377,9 @@ class Benchmark {
         for (int64_t i = 0; i < entries_per_batch_; ++i) {
           if (stat_list[i].ok()) {
             ++found;
+            if (!FLAGS_pin_slice) {
+              values[i].assign(pin_values[i].data(), pin_values[i].size());
+            }
           } else if (!stat_list[i].IsNotFound()) {
             fprintf(stderr, "MultiGet returned an error: %s\n",
                     stat_list[i].ToString().c_str());
@@ -5783,6 +5906,7 @@ class Benchmark {
     options.prefix_same_as_start = FLAGS_prefix_same_as_start;
     options.tailing = FLAGS_use_tailing_iterator;
     options.readahead_size = FLAGS_readahead_size;
+    options.async_io = FLAGS_async_io;
     std::unique_ptr<char[]> ts_guard;
     Slice ts;
     if (user_timestamp_size_ > 0) {
@@ -7242,11 +7366,16 @@ class Benchmark {
                       std::move(trace_reader));
     replayer.SetFastForward(
         static_cast<uint32_t>(FLAGS_trace_replay_fast_forward));
-    s = replayer.MultiThreadReplay(
-        static_cast<uint32_t>(FLAGS_trace_replay_threads));
+    ReplayOptions replay_options;
+    replay_options.num_threads =
+        static_cast<uint32_t>(FLAGS_trace_replay_threads);
+    replay_options.preserve_key_order = FLAGS_trace_replay_preserve_key_order;
+    replay_options.fast_as_possible = FLAGS_trace_replay_fast_as_possible;
+    s = replayer.Replay(replay_options);
     if (s.ok()) {
       fprintf(stdout, "Replay started from trace_file: %s\n",
               FLAGS_trace_file.c_str());
+      fprintf(stdout, "%s", replayer.GetLatencyReport().c_str());
     } else {
       fprintf(stderr, "Starting replay failed. Error: %s\n",
               s.ToString().c_str());
@@ -7304,6 +7433,8 @@ int db_bench_tool(int argc, char** argv) {
 
   FLAGS_compression_type_e =
     StringToCompressionType(FLAGS_compression_type.c_str());
+  FLAGS_wal_compression_e =
+      StringToCompressionType(FLAGS_wal_compression.c_str());
 
 #ifndef ROCKSDB_LITE
   FLAGS_blob_db_compression_type_e =
@@ -488,6 +488,19 @@ Status TraceAnalyzer::StartProcessing() {
         fprintf(stderr, "Cannot process the get in the trace\n");
         return s;
       }
+    } else if (trace.type == kTraceMultiGet) {
+      // Analyzed as one get per key
+      std::vector<uint32_t> cf_ids;
+      std::vector<Slice> keys;
+      s = TracerHelper::DecodeMultiGet(trace.payload, &cf_ids, &keys);
+      for (size_t i = 0; s.ok() && i < keys.size(); i++) {
+        total_gets_++;
+        s = HandleGet(cf_ids[i], keys[i].ToString(), trace.ts, 1);
+      }
+      if (!s.ok()) {
+        fprintf(stderr, "Cannot process the multiget in the trace\n");
+        return s;
+      }
     } else if (trace.type == kTraceIteratorSeek ||
                trace.type == kTraceIteratorSeekForPrev) {
       uint32_t cf_id = 0;
@@ -6,12 +6,16 @@
 #include "trace_replay/trace_replay.h"
 
 #include <chrono>
+#include <deque>
 #include <sstream>
 #include <thread>
 #include "db/db_impl/db_impl.h"
+#include "port/port.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/write_batch.h"
 #include "util/coding.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
 #include "util/string_util.h"
 #include "util/threadpool_imp.h"
 
@@ -30,6 +34,105 @@ void DecodeCFAndKey(std::string& buffer, uint32_t* cf_id, Slice* key) {
   GetFixed32(&buf, cf_id);
   GetLengthPrefixedSlice(&buf, key);
 }
+
+// Finds the first key of a write batch, which decides the replay thread of
+// the batch.
+class FirstKeyHandler : public WriteBatch::Handler {
+ public:
+  Status PutCF(uint32_t cf_id, const Slice& key, const Slice&) override {
+    return Found(cf_id, key);
+  }
+  Status DeleteCF(uint32_t cf_id, const Slice& key) override {
+    return Found(cf_id, key);
+  }
+  Status SingleDeleteCF(uint32_t cf_id, const Slice& key) override {
+    return Found(cf_id, key);
+  }
+  Status DeleteRangeCF(uint32_t cf_id, const Slice& begin_key,
+                       const Slice&) override {
+    return Found(cf_id, begin_key);
+  }
+  Status MergeCF(uint32_t cf_id, const Slice& key, const Slice&) override {
+    return Found(cf_id, key);
+  }
+  Status PutBlobIndexCF(uint32_t cf_id, const Slice& key,
+                        const Slice&) override {
+    return Found(cf_id, key);
+  }
+  Status MarkBeginPrepare(bool) override { return Status::OK(); }
+  Status MarkEndPrepare(const Slice&) override { return Status::OK(); }
+  Status MarkNoop(bool) override { return Status::OK(); }
+  Status MarkRollback(const Slice&) override { return Status::OK(); }
+  Status MarkCommit(const Slice&) override { return Status::OK(); }
+
+  bool Continue() override { return !found_; }
+
+  bool found() const { return found_; }
+  uint32_t cf_id() const { return cf_id_; }
+  const Slice& key() const { return key_; }
+
+ private:
+  Status Found(uint32_t cf_id, const Slice& key) {
+    found_ = true;
+    cf_id_ = cf_id;
+    key_ = key;
+    return Status::OK();
+  }
+
+  bool found_ = false;
+  uint32_t cf_id_ = 0;
+  Slice key_;
+};
+
+// Returns the hash of the first key of the query of `trace`, so that the
+// queries on the same key go to the same replay thread.
+uint64_t HashFirstKey(const Trace& trace) {
+  uint32_t cf_id = 0;
+  Slice key;
+  if (trace.type == kTraceWrite) {
+    WriteBatch batch(trace.payload);
+    FirstKeyHandler handler;
+    batch.Iterate(&handler).PermitUncheckedError();
+    if (!handler.found()) {
+      return 0;
+    }
+    cf_id = handler.cf_id();
+    // The key points into the batch
+    return Hash64(handler.key().data(), handler.key().size(), cf_id);
+  } else if (trace.type == kTraceMultiGet) {
+    std::vector<uint32_t> cf_ids;
+    std::vector<Slice> keys;
+    if (!TracerHelper::DecodeMultiGet(trace.payload, &cf_ids, &keys).ok() ||
+        keys.empty()) {
+      return 0;
+    }
+    cf_id = cf_ids[0];
+    key = keys[0];
+  } else {
+    Slice buf(trace.payload);
+    if (!GetFixed32(&buf, &cf_id) || !GetLengthPrefixedSlice(&buf, &key)) {
+      return 0;
+    }
+  }
+  return Hash64(key.data(), key.size(), cf_id);
+}
+
+const char* TraceTypeToString(TraceType type) {
+  switch (type) {
+    case kTraceWrite:
+      return "Write";
+    case kTraceGet:
+      return "Get";
+    case kTraceMultiGet:
+      return "MultiGet";
+    case kTraceIteratorSeek:
+      return "IteratorSeek";
+    case kTraceIteratorSeekForPrev:
+      return "IteratorSeekForPrev";
+    default:
+      return "Unknown";
+  }
+}
 }  // namespace
 
 void TracerHelper::EncodeTrace(const Trace& trace, std::string* encoded_trace) {
@@ -56,6 +159,29 @@ Status TracerHelper::DecodeTrace(const std::string& encoded_trace,
   return Status::OK();
 }
 
+// The payload of a MultiGet is the number of keys, followed by the column
+// family and the key of each.
+Status TracerHelper::DecodeMultiGet(const std::string& payload,
+                                    std::vector<uint32_t>* cf_ids,
+                                    std::vector<Slice>* keys) {
+  assert(cf_ids != nullptr);
+  assert(keys != nullptr);
+  Slice buf(payload);
+  uint32_t num_keys = 0;
+  if (!GetFixed32(&buf, &num_keys)) {
+    return Status::Corruption("Decode MultiGet trace failed");
+  }
+  cf_ids->resize(num_keys);
+  keys->resize(num_keys);
+  for (uint32_t i = 0; i < num_keys; i++) {
+    if (!GetFixed32(&buf, &(*cf_ids)[i]) ||
+        !GetLengthPrefixedSlice(&buf, &(*keys)[i])) {
+      return Status::Corruption("Decode MultiGet trace failed");
+    }
+  }
+  return Status::OK();
+}
+
 Tracer::Tracer(Env* env, const TraceOptions& trace_options,
                std::unique_ptr<TraceWriter>&& trace_writer)
     : env_(env),
@@ -116,12 +242,29 @@ Status Tracer::IteratorSeekForPrev(const uint32_t& cf_id, const Slice& key) {
   return WriteTrace(trace);
 }
 
+Status Tracer::MultiGet(size_t num_keys,
+                        ColumnFamilyHandle* const* column_families,
+                        const Slice* keys) {
+  TraceType trace_type = kTraceMultiGet;
+  if (ShouldSkipTrace(trace_type)) {
+    return Status::OK();
+  }
+  Trace trace;
+  trace.ts = env_->NowMicros();
+  trace.type = trace_type;
+  PutFixed32(&trace.payload, static_cast<uint32_t>(num_keys));
+  for (size_t i = 0; i < num_keys; i++) {
+    EncodeCFAndKey(&trace.payload, column_families[i]->GetID(), keys[i]);
+  }
+  return WriteTrace(trace);
+}
+
 bool Tracer::ShouldSkipTrace(const TraceType& trace_type) {
   if (IsTraceFileOverMax()) {
     return true;
   }
   if ((trace_options_.filter & kTraceFilterGet
-    && trace_type == kTraceGet)
+    && (trace_type == kTraceGet || trace_type == kTraceMultiGet))
    || (trace_options_.filter & kTraceFilterWrite
     && trace_type == kTraceWrite)) {
     return true;
@@ -180,6 +323,7 @@ Replayer::Replayer(DB* db, const std::vector<ColumnFamilyHandle*>& handles,
     cf_map_[cfh->GetID()] = cfh;
   }
   fast_forward_ = 1;
+  replay_micros_ = 0;
 }
 
 Replayer::~Replayer() { trace_reader_.reset(); }
@@ -272,6 +416,12 @@ Status Replayer::Replay() {
       single_iter->SeekForPrev(key);
       ops++;
       delete single_iter;
+    } else if (trace.type == kTraceMultiGet) {
+      s = Execute(trace, woptions, roptions);
+      if (!s.ok()) {
+        return s;
+      }
+      ops++;
     } else if (trace.type == kTraceEnd) {
       // Do nothing for now.
       // TODO: Add some validations later.
@@ -345,6 +495,10 @@ Status Replayer::MultiThreadReplay(uint32_t threads_num) {
       thread_pool.Schedule(&Replayer::BGWorkIterSeekForPrev, ra.release(),
                            nullptr, nullptr);
       ops++;
+    } else if (ra->trace_entry.type == kTraceMultiGet) {
+      thread_pool.Schedule(&Replayer::BGWorkMultiGet, ra.release(), nullptr,
+                           nullptr);
+      ops++;
     } else if (ra->trace_entry.type == kTraceEnd) {
       // Do nothing for now.
       // TODO: Add some validations later.
@@ -366,6 +520,248 @@ Status Replayer::MultiThreadReplay(uint32_t threads_num) {
   return s;
 }
 
+namespace {
+// The queries waiting for the replay threads reading the queue, which each
+// execute the next one.
+class ReplayQueue {
+ public:
+  ReplayQueue() : cv_(&mu_), closed_(false) {}
+
+  // Waits until the queue has room for `trace`, so that reading the trace
+  // does not run ahead of the replay.
+  void Add(Trace&& trace) {
+    MutexLock l(&mu_);
+    while (queue_.size() >= kMaxQueuedQueries) {
+      cv_.Wait();
+    }
+    queue_.push_back(std::move(trace));
+    cv_.SignalAll();
+  }
+
+  // No query is added after this.
+  void Close() {
+    MutexLock l(&mu_);
+    closed_ = true;
+    cv_.SignalAll();
+  }
+
+  // Returns false once the queue is closed and empty.
+  bool Pop(Trace* trace) {
+    MutexLock l(&mu_);
+    while (queue_.empty() && !closed_) {
+      cv_.Wait();
+    }
+    if (queue_.empty()) {
+      return false;
+    }
+    *trace = std::move(queue_.front());
+    queue_.pop_front();
+    cv_.SignalAll();
+    return true;
+  }
+
+ private:
+  static constexpr size_t kMaxQueuedQueries = 1024;
+
+  port::Mutex mu_;
+  port::CondVar cv_;
+  std::deque<Trace> queue_;
+  bool closed_;
+};
+}  // namespace
+
+// With preserve_key_order, each thread has a queue of its own, which the
+// queries on the keys hashing to it are added to. Otherwise, the threads share
+// a single queue.
+Status Replayer::Replay(const ReplayOptions& options) {
+  for (HistogramImpl& latencies : latencies_) {
+    latencies.Clear();
+  }
+  replay_micros_ = 0;
+
+  Status s;
+  Trace header;
+  s = ReadHeader(&header);
+  if (!s.ok()) {
+    return s;
+  }
+
+  const uint32_t num_threads = std::max(options.num_threads, 1U);
+  const uint32_t num_queues = options.preserve_key_order ? num_threads : 1;
+  std::vector<std::unique_ptr<ReplayQueue>> queues;
+  for (uint32_t i = 0; i < num_queues; i++) {
+    queues.emplace_back(new ReplayQueue());
+  }
+  // Of the queries each thread executed, merged once it is done
+  std::vector<std::unique_ptr<HistogramImpl[]>> thread_latencies;
+  std::vector<Status> thread_statuses(num_threads);
+  std::vector<port::Thread> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    thread_latencies.emplace_back(new HistogramImpl[kTraceMax]);
+    ReplayQueue* queue = queues[i % num_queues].get();
+    HistogramImpl* latencies = thread_latencies[i].get();
+    Status* status = &thread_statuses[i];
+    threads.emplace_back([this, queue, latencies, status]() {
+      WriteOptions woptions;
+      ReadOptions roptions;
+      Trace trace;
+      while (queue->Pop(&trace)) {
+        uint64_t start = env_->NowMicros();
+        Status query_status = Execute(trace, woptions, roptions);
+        latencies[trace.type].Add(env_->NowMicros() - start);
+        if (!query_status.ok() && status->ok()) {
+          *status = query_status;
+        }
+      }
+    });
+  }
+
+  std::chrono::system_clock::time_point replay_epoch =
+      std::chrono::system_clock::now();
+  uint64_t start = env_->NowMicros();
+  while (s.ok()) {
+    Trace trace;
+    s = ReadTrace(&trace);
+    if (!s.ok()) {
+      break;
+    }
+    if (trace.type == kTraceEnd) {
+      break;
+    }
+    if (trace.type != kTraceWrite && trace.type != kTraceGet &&
+        trace.type != kTraceMultiGet && trace.type != kTraceIteratorSeek &&
+        trace.type != kTraceIteratorSeekForPrev) {
+      // Other trace entry types that are not implemented for replay.
+      continue;
+    }
+    if (!options.fast_as_possible) {
+      std::this_thread::sleep_until(
+          replay_epoch +
+          std::chrono::microseconds((trace.ts - header.ts) / fast_forward_));
+    }
+    size_t queue = num_queues > 1 ? HashFirstKey(trace) % num_queues : 0;
+    queues[queue]->Add(std::move(trace));
+  }
+
+  if (s.IsIncomplete()) {
+    // Reaching eof returns Incomplete status at the moment.
+    // Could happen when killing a process without calling EndTrace() API.
+    s = Status::OK();
+  }
+  for (auto& queue : queues) {
+    queue->Close();
+  }
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads[i].join();
+    for (int type = 0; type < kTraceMax; type++) {
+      latencies_[type].Merge(thread_latencies[i][type]);
+    }
+    if (s.ok()) {
+      s = thread_statuses[i];
+    }
+  }
+  replay_micros_ = env_->NowMicros() - start;
+  return s;
+}
+
+const HistogramImpl& Replayer::GetLatencies(TraceType type) const {
+  assert(type < kTraceMax);
+  return latencies_[type];
+}
+
+std::string Replayer::GetLatencyReport() const {
+  uint64_t ops = 0;
+  for (const HistogramImpl& latencies : latencies_) {
+    ops += latencies.num();
+  }
+  std::ostringstream report;
+  report << "Replayed " << ops << " queries in " << replay_micros_ / 1e6
+         << " seconds, "
+         << (replay_micros_ > 0 ? ops * 1e6 / replay_micros_ : 0.0)
+         << " queries/second\n";
+  for (int type = 0; type < kTraceMax; type++) {
+    if (latencies_[type].num() > 0) {
+      report << TraceTypeToString(static_cast<TraceType>(type))
+             << " latency (us):\n"
+             << latencies_[type].ToString();
+    }
+  }
+  return report.str();
+}
+
+Status Replayer::ExecuteMultiGet(
+    DB* db, const std::unordered_map<uint32_t, ColumnFamilyHandle*>& cf_map,
+    const std::string& payload, const ReadOptions& roptions) {
+  std::vector<uint32_t> cf_ids;
+  std::vector<Slice> keys;
+  Status s = TracerHelper::DecodeMultiGet(payload, &cf_ids, &keys);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<ColumnFamilyHandle*> handles(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (cf_ids[i] == 0) {
+      handles[i] = db->DefaultColumnFamily();
+    } else {
+      auto it = cf_map.find(cf_ids[i]);
+      if (it == cf_map.end()) {
+        return Status::Corruption("Invalid Column Family ID.");
+      }
+      handles[i] = it->second;
+    }
+  }
+  std::unique_ptr<PinnableSlice[]> values(new PinnableSlice[keys.size()]);
+  std::vector<Status> statuses(keys.size());
+  db->MultiGet(roptions, keys.size(), handles.data(), keys.data(),
+               values.get(), statuses.data());
+  for (Status& status : statuses) {
+    status.PermitUncheckedError();
+  }
+  return Status::OK();
+}
+
+Status Replayer::Execute(const Trace& trace, const WriteOptions& woptions,
+                         const ReadOptions& roptions) {
+  if (trace.type == kTraceWrite) {
+    WriteBatch batch(trace.payload);
+    return db_->Write(woptions, &batch);
+  }
+  if (trace.type == kTraceMultiGet) {
+    return ExecuteMultiGet(db_, cf_map_, trace.payload, roptions);
+  }
+  if (trace.type != kTraceGet && trace.type != kTraceIteratorSeek &&
+      trace.type != kTraceIteratorSeekForPrev) {
+    return Status::OK();
+  }
+  uint32_t cf_id = 0;
+  Slice key;
+  Slice buf(trace.payload);
+  if (!GetFixed32(&buf, &cf_id) || !GetLengthPrefixedSlice(&buf, &key)) {
+    return Status::Corruption("Corrupted trace.");
+  }
+  ColumnFamilyHandle* handle = db_->DefaultColumnFamily();
+  if (cf_id > 0) {
+    auto it = cf_map_.find(cf_id);
+    if (it == cf_map_.end()) {
+      return Status::Corruption("Invalid Column Family ID.");
+    }
+    handle = it->second;
+  }
+  if (trace.type == kTraceGet) {
+    std::string value;
+    db_->Get(roptions, handle, key, &value).PermitUncheckedError();
+  } else {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(roptions, handle));
+    if (trace.type == kTraceIteratorSeek) {
+      iter->Seek(key);
+    } else {
+      iter->SeekForPrev(key);
+    }
+    iter->status().PermitUncheckedError();
+  }
+  return Status::OK();
+}
+
 Status Replayer::ReadHeader(Trace* header) {
   assert(header != nullptr);
   Status s = ReadTrace(header);
@@ -438,6 +834,15 @@ void Replayer::BGWorkWriteBatch(void* arg) {
   return;
 }
 
+void Replayer::BGWorkMultiGet(void* arg) {
+  std::unique_ptr<ReplayerWorkerArg> ra(
+      reinterpret_cast<ReplayerWorkerArg*>(arg));
+  assert(ra != nullptr);
+  ExecuteMultiGet(ra->db, *ra->cf_map, ra->trace_entry.payload, ra->roptions)
+      .PermitUncheckedError();
+  return;
+}
+
 void Replayer::BGWorkIterSeek(void* arg) {
   std::unique_ptr<ReplayerWorkerArg> ra(
       reinterpret_cast<ReplayerWorkerArg*>(arg));
@@ -6,9 +6,12 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "monitoring/histogram.h"
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
 #include "rocksdb/trace_reader_writer.h"
@@ -52,6 +55,7 @@ enum TraceType : char {
   kIOFileNameAndFileSize = 14,
   kIOLen = 15,
   kIOLenAndOffset = 16,
+  kTraceMultiGet = 17,
   // All trace types should be added before kTraceMax
   kTraceMax,
 };
@@ -79,6 +83,12 @@ class TracerHelper {
 
   // Decode a string into the given trace object.
   static Status DecodeTrace(const std::string& encoded_trace, Trace* trace);
+
+  // Decode the payload of a kTraceMultiGet trace into the column family IDs
+  // and the keys, which point into the payload.
+  static Status DecodeMultiGet(const std::string& payload,
+                               std::vector<uint32_t>* cf_ids,
+                               std::vector<Slice>* keys);
 };
 
 // Tracer captures all RocksDB operations using a user-provided TraceWriter.
@@ -100,6 +110,11 @@ class Tracer {
   Status IteratorSeek(const uint32_t& cf_id, const Slice& key);
   Status IteratorSeekForPrev(const uint32_t& cf_id, const Slice& key);
 
+  // Trace MultiGet operations, of keys[i] in column_families[i]. Skipped with
+  // kTraceFilterGet, like Get operations.
+  Status MultiGet(size_t num_keys, ColumnFamilyHandle* const* column_families,
+                  const Slice* keys);
+
   // Returns true if the trace is over the configured max trace file limit.
   // False otherwise.
   bool IsTraceFileOverMax();
@@ -130,6 +145,25 @@ class Tracer {
   uint64_t trace_request_count_;
 };
 
+// Options for Replayer::Replay(const ReplayOptions&)
+struct ReplayOptions {
+  // The number of threads executing the queries.
+  uint32_t num_threads = 1;
+
+  // If true, the queries on the same key are executed in the order of the
+  // trace, by the thread the key hashes to. A write batch or a MultiGet goes
+  // to the thread of its first key, so it may still run out of order with the
+  // queries on its other keys. If false, each query goes to the next idle
+  // thread, so that a slow query does not hold back the queries behind it.
+  bool preserve_key_order = true;
+
+  // If true, the timestamps of the trace are ignored and the queries are
+  // issued as fast as the threads execute them, to measure the peak
+  // throughput of the DB. Otherwise they are issued at the pace of the trace,
+  // sped up by the fast forward rate.
+  bool fast_as_possible = false;
+};
+
 // Replayer helps to replay the captured RocksDB operations, using a user
 // provided TraceReader.
 // The Replayer is instantiated via db_bench today, on using "replay" benchmark.
@@ -155,7 +189,30 @@ class Replayer {
   //   If > 1, speed up the replay by this amount.
   Status SetFastForward(uint32_t fast_forward);
 
+  // Replay the provided trace stream with options.num_threads threads, each
+  // executing the queries of its own queue in order. The latency of each
+  // query, from when a thread starts executing it, is recorded in the
+  // histogram of its type. Supports the same queries as MultiThreadReplay(),
+  // and MultiGet.
+  Status Replay(const ReplayOptions& options);
+
+  // Returns the latencies in microseconds of the queries of type `type`
+  // executed by the last Replay(const ReplayOptions&).
+  const HistogramImpl& GetLatencies(TraceType type) const;
+
+  // Returns the number of queries, the throughput and the latencies of the
+  // last Replay(const ReplayOptions&), by query type.
+  std::string GetLatencyReport() const;
+
  private:
+  // Executes the query of `trace`, if it is one.
+  Status Execute(const Trace& trace, const WriteOptions& woptions,
+                 const ReadOptions& roptions);
+  // Executes the MultiGet of `payload`, looking up the column families in
+  // `cf_map`. Shared by Execute() and BGWorkMultiGet().
+  static Status ExecuteMultiGet(
+      DB* db, const std::unordered_map<uint32_t, ColumnFamilyHandle*>& cf_map,
+      const std::string& payload, const ReadOptions& roptions);
   Status ReadHeader(Trace* header);
   Status ReadFooter(Trace* footer);
   Status ReadTrace(Trace* trace);
@@ -168,6 +225,10 @@ class Replayer {
   // (Put, Delete, SingleDelete, DeleteRange) based on the trace records.
   static void BGWorkWriteBatch(void* arg);
 
+  // The background function for MultiThreadReplay to execute MultiGet query
+  // based on the trace records.
+  static void BGWorkMultiGet(void* arg);
+
   // The background function for MultiThreadReplay to execute Iterator (Seek)
   // based on the trace records.
   static void BGWorkIterSeek(void* arg);
@@ -181,6 +242,10 @@ class Replayer {
   std::unique_ptr<TraceReader> trace_reader_;
   std::unordered_map<uint32_t, ColumnFamilyHandle*> cf_map_;
   uint32_t fast_forward_;
+
+  // Of the last Replay(const ReplayOptions&)
+  HistogramImpl latencies_[kTraceMax];
+  uint64_t replay_micros_;
 };
 
 // The passin arg of MultiThreadRepkay for each trace record.
@@ -21,6 +21,7 @@ int main() {
 
 #include "memory/arena.h"
 #include "port/jemalloc_helper.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "test_util/testharness.h"
@@ -329,6 +330,22 @@ class FullBloomTest : public testing::TestWithParam<BloomFilterPolicy::Mode> {
     return bits_reader_->MayMatch(s);
   }
 
+  // Queries the keys with the batched interface
+  std::vector<bool> BatchMatches(const std::vector<std::string>& keys) {
+    if (bits_reader_ == nullptr) {
+      Build();
+    }
+    std::vector<Slice> slices(keys.begin(), keys.end());
+    std::vector<Slice*> slice_ptrs;
+    for (Slice& slice : slices) {
+      slice_ptrs.push_back(&slice);
+    }
+    std::unique_ptr<bool[]> results(new bool[keys.size()]);
+    bits_reader_->MayMatch(static_cast<int>(keys.size()), slice_ptrs.data(),
+                           results.get());
+    return std::vector<bool>(results.get(), results.get() + keys.size());
+  }
+
   // Provides a kind of fingerprint on the Bloom filter's
   // behavior, for reasonbly high FP rates.
   uint64_t PackedMatches() {
@@ -502,6 +519,65 @@ TEST_P(FullBloomTest, FullVaryingLengths) {
   EXPECT_LE(mediocre_filters, good_filters / 5);
 }
 
+TEST_P(FullBloomTest, BatchMatches) {
+  char buffer[sizeof(int)];
+  for (int length : {1, 100, 10000}) {
+    Reset();
+    for (int i = 0; i < length; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+    // Added keys and, mostly, keys not added, in full batches
+    std::vector<std::string> keys;
+    for (int i = 0; i < 32 * 20; i++) {
+      keys.push_back(
+          Key(i % 32 == 0 ? i / 32 % length : i + 1000000000, buffer)
+              .ToString());
+    }
+    for (size_t start = 0; start < keys.size(); start += 32) {
+      std::vector<std::string> batch(keys.begin() + start,
+                                     keys.begin() + start + 32);
+      std::vector<bool> results = BatchMatches(batch);
+      for (size_t i = 0; i < batch.size(); i++) {
+        ASSERT_EQ(Matches(batch[i]), results[i])
+            << "Length " << length << "; key " << start + i;
+      }
+      ASSERT_TRUE(results[0]);
+    }
+  }
+}
+
+TEST_P(FullBloomTest, ReserveFilterConstructionMemory) {
+  if (GetParam() != BloomFilterPolicy::kStandard128Ribbon) {
+    return;
+  }
+  char buffer[sizeof(int)];
+  constexpr int kNumKeys = 100000;
+  table_options_.reserve_filter_construction_memory = true;
+  for (bool large_cache : {true, false}) {
+    // The construction of the filter of kNumKeys keys needs a few MB
+    table_options_.block_cache =
+        NewLRUCache(large_cache ? 64 << 20 : 1 << 20, 0 /* num_shard_bits */,
+                    true /* strict_capacity_limit */);
+    ResetPolicy();
+    for (int i = 0; i < kNumKeys; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+    // Ribbon, or else Bloom
+    EXPECT_EQ(large_cache ? -2 : -1, static_cast<int8_t>(FilterData()[
+                                         FilterSize() - 5]));
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)));
+    }
+    // Released once built
+    EXPECT_EQ(0, table_options_.block_cache->GetUsage());
+  }
+  table_options_.block_cache.reset();
+  table_options_.reserve_filter_construction_memory = false;
+  ResetPolicy();
+}
+
 TEST_P(FullBloomTest, OptimizeForMemory) {
   if (GetParam() == BloomFilterPolicy::kStandard128Ribbon) {
     // TODO Not yet implemented
@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
 #ifdef OS_FREEBSD
 #include <malloc_np.h>
@@ -1526,4 +1527,171 @@ inline CacheAllocationPtr UncompressData(
   }
 }
 
+inline bool StreamingCompressionTypeSupported(
+    CompressionType compression_type) {
+  switch (compression_type) {
+    case kNoCompression:
+      return true;
+    case kZSTD:
+      return ZSTD_Supported();
+    default:
+      return false;
+  }
+}
+
+// Compresses a sequence of records with a single compression context, so that
+// each record is compressed with the history of the records before it. Every
+// record is flushed on its own, which lets StreamingUncompress recover it as
+// soon as it has been fed the records up to and including it. Only ZSTD
+// supports streaming compression.
+class StreamingCompress {
+ public:
+  StreamingCompress() {}
+  virtual ~StreamingCompress() {}
+
+  // Appends the compressed form of input to *output.
+  virtual Status Compress(const Slice& input, std::string* output) = 0;
+
+  // Returns nullptr if compression_type does not support streaming, or
+  // kNoCompression is passed.
+  static std::unique_ptr<StreamingCompress> Create(
+      CompressionType compression_type, int level);
+
+ private:
+  // No copying allowed
+  StreamingCompress(const StreamingCompress&);
+  void operator=(const StreamingCompress&);
+};
+
+// Uncompresses the records produced by a StreamingCompress, in the same
+// order.
+class StreamingUncompress {
+ public:
+  StreamingUncompress() {}
+  virtual ~StreamingUncompress() {}
+
+  // Appends the uncompressed form of input to *output.
+  virtual Status Uncompress(const Slice& input, std::string* output) = 0;
+
+  // Returns nullptr if compression_type does not support streaming, or
+  // kNoCompression is passed.
+  static std::unique_ptr<StreamingUncompress> Create(
+      CompressionType compression_type);
+
+ private:
+  // No copying allowed
+  StreamingUncompress(const StreamingUncompress&);
+  void operator=(const StreamingUncompress&);
+};
+
+#ifdef ZSTD
+class ZSTDStreamingCompress : public StreamingCompress {
+ public:
+  explicit ZSTDStreamingCompress(int level)
+      : cstream_(ZSTD_createCStream()),
+        buf_(new char[ZSTD_CStreamOutSize()]) {
+    // Level 3 is the ZSTD default, see ZSTD_Compress.
+    ZSTD_initCStream(
+        cstream_,
+        level == CompressionOptions::kDefaultCompressionLevel ? 3 : level);
+  }
+  ~ZSTDStreamingCompress() override { ZSTD_freeCStream(cstream_); }
+
+  Status Compress(const Slice& input, std::string* output) override {
+    const size_t buf_size = ZSTD_CStreamOutSize();
+    ZSTD_inBuffer in = {input.data(), input.size(), 0};
+    while (in.pos < in.size) {
+      ZSTD_outBuffer out = {buf_.get(), buf_size, 0};
+      const size_t ret = ZSTD_compressStream(cstream_, &out, &in);
+      if (ZSTD_isError(ret)) {
+        return Status::Corruption("ZSTD streaming compression failed",
+                                  ZSTD_getErrorName(ret));
+      }
+      output->append(buf_.get(), out.pos);
+    }
+    size_t remaining;
+    do {
+      ZSTD_outBuffer out = {buf_.get(), buf_size, 0};
+      remaining = ZSTD_flushStream(cstream_, &out);
+      if (ZSTD_isError(remaining)) {
+        return Status::Corruption("ZSTD streaming compression failed",
+                                  ZSTD_getErrorName(remaining));
+      }
+      output->append(buf_.get(), out.pos);
+    } while (remaining > 0);
+    return Status::OK();
+  }
+
+ private:
+  ZSTD_CStream* cstream_;
+  std::unique_ptr<char[]> buf_;
+};
+
+class ZSTDStreamingUncompress : public StreamingUncompress {
+ public:
+  ZSTDStreamingUncompress()
+      : dstream_(ZSTD_createDStream()),
+        buf_(new char[ZSTD_DStreamOutSize()]) {
+    ZSTD_initDStream(dstream_);
+  }
+  ~ZSTDStreamingUncompress() override { ZSTD_freeDStream(dstream_); }
+
+  Status Uncompress(const Slice& input, std::string* output) override {
+    const size_t buf_size = ZSTD_DStreamOutSize();
+    ZSTD_inBuffer in = {input.data(), input.size(), 0};
+    // Keep going while there is input left, or the last call filled the
+    // output buffer and may have more data buffered internally.
+    bool output_full = false;
+    while (in.pos < in.size || output_full) {
+      ZSTD_outBuffer out = {buf_.get(), buf_size, 0};
+      const size_t ret = ZSTD_decompressStream(dstream_, &out, &in);
+      if (ZSTD_isError(ret)) {
+        return Status::Corruption("ZSTD streaming decompression failed",
+                                  ZSTD_getErrorName(ret));
+      }
+      output->append(buf_.get(), out.pos);
+      output_full = (out.pos == out.size);
+    }
+    return Status::OK();
+  }
+
+ private:
+  ZSTD_DStream* dstream_;
+  std::unique_ptr<char[]> buf_;
+};
+#endif  // ZSTD
+
+inline std::unique_ptr<StreamingCompress> StreamingCompress::Create(
+    CompressionType compression_type, int level) {
+  switch (compression_type) {
+#ifdef ZSTD
+    case kZSTD:
+      if (ZSTD_Supported()) {
+        return std::unique_ptr<StreamingCompress>(
+            new ZSTDStreamingCompress(level));
+      }
+      return nullptr;
+#endif  // ZSTD
+    default:
+      (void)level;
+      return nullptr;
+  }
+}
+
+inline std::unique_ptr<StreamingUncompress> StreamingUncompress::Create(
+    CompressionType compression_type) {
+  switch (compression_type) {
+#ifdef ZSTD
+    case kZSTD:
+      if (ZSTD_Supported()) {
+        return std::unique_ptr<StreamingUncompress>(
+            new ZSTDStreamingUncompress());
+      }
+      return nullptr;
+#endif  // ZSTD
+    default:
+      return nullptr;
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -1258,6 +1258,67 @@ uint32_t Extend(uint32_t crc, const char* buf, size_t size) {
   return ChosenExtend(crc, buf, size);
 }
 
+// The crc32c of a string followed by zero bits is a linear function of the
+// crc32c of the string over GF(2), so appending zeros can be computed with a
+// 32x32 bit matrix, squared for each doubling of the number of zeros, as in
+// crc32_combine() of zlib.
+static uint32_t gf2_matrix_times(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  while (vec) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+    vec >>= 1;
+    mat++;
+  }
+  return sum;
+}
+
+static void gf2_matrix_square(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = gf2_matrix_times(mat, mat[n]);
+  }
+}
+
+uint32_t Crc32cCombine(uint32_t crc1, uint32_t crc2, size_t crc2len) {
+  if (crc2len == 0) {
+    return crc1;
+  }
+  uint32_t even[32];  // even-power-of-two zeros operator
+  uint32_t odd[32];   // odd-power-of-two zeros operator
+
+  // Put operator for one zero bit in odd
+  odd[0] = 0x82f63b78;  // CRC-32C polynomial, reflected
+  uint32_t row = 1;
+  for (int n = 1; n < 32; n++) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  // Put operator for two zero bits in even, then four zero bits in odd
+  gf2_matrix_square(even, odd);
+  gf2_matrix_square(odd, even);
+
+  // Apply crc2len zero bytes to crc1, the first square putting the operator
+  // for one zero byte, eight zero bits, in even
+  do {
+    gf2_matrix_square(even, odd);
+    if (crc2len & 1) {
+      crc1 = gf2_matrix_times(even, crc1);
+    }
+    crc2len >>= 1;
+    if (crc2len == 0) {
+      break;
+    }
+    gf2_matrix_square(odd, even);
+    if (crc2len & 1) {
+      crc1 = gf2_matrix_times(odd, crc1);
+    }
+    crc2len >>= 1;
+  } while (crc2len != 0);
+
+  return crc1 ^ crc2;
+}
+
 
 }  // namespace crc32c
 }  // namespace ROCKSDB_NAMESPACE
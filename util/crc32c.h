@@ -29,6 +29,11 @@ inline uint32_t Value(const char* data, size_t n) {
   return Extend(0, data, n);
 }
 
+// Return the crc32c of concat(A, B) where crc1 is the crc32c of A and crc2
+// is the crc32c of B, which is crc2len bytes long. This lets the crc32c of
+// the pieces of a string be computed independently, e.g. in parallel.
+extern uint32_t Crc32cCombine(uint32_t crc1, uint32_t crc2, size_t crc2len);
+
 static const uint32_t kMaskDelta = 0xa282ead8ul;
 
 // Return a masked representation of crc.
@@ -129,6 +129,20 @@ TEST(CRC, Extend) {
             Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, Combine) {
+  std::string data;
+  for (int i = 0; i < 1000; i++) {
+    data.push_back(static_cast<char>(i * 7 + i / 13));
+  }
+  const uint32_t crc = Value(data.data(), data.size());
+  for (size_t split : {size_t{0}, size_t{1}, size_t{3}, size_t{8}, size_t{100},
+                       size_t{999}, size_t{1000}}) {
+    uint32_t crc1 = Value(data.data(), split);
+    uint32_t crc2 = Value(data.data() + split, data.size() - split);
+    ASSERT_EQ(crc, Crc32cCombine(crc1, crc2, data.size() - split));
+  }
+}
+
 TEST(CRC, Mask) {
   uint32_t crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
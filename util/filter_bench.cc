@@ -14,6 +14,7 @@ int main() {
 #include <cinttypes>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include "memory/arena.h"
@@ -84,6 +85,11 @@ DEFINE_uint32(impl, 0,
               "2 = format_version 5 Bloom filter, 3 = Ribbon128 filter. With "
               "-use_plain_table_bloom: 0 = no locality, 1 = locality.");
 
+DEFINE_string(compare_impls, "",
+              "Comma-separated list of -impl values (e.g. \"2,3\") to run "
+              "one after the other, followed by a summary comparing them. "
+              "Overrides -impl.");
+
 DEFINE_bool(net_includes_hashing, false,
             "Whether query net ns/op times should include hashing. "
             "(if not, dry run will include hashing) "
@@ -263,6 +269,18 @@ static uint32_t DryRunHash64(Slice &s) {
   return Lower32of64(GetSliceHash64(s));
 }
 
+// Results of a run, for comparing implementations
+struct FilterBenchSummary {
+  uint32_t impl = 0;
+  double bits_per_key = 0.0;
+  double build_ns_per_key = 0.0;
+  // Of the mixed inside/outside queries
+  double fp_rate = 0.0;
+  // Net ns/op of the mixed inside/outside batched, prepared queries, or
+  // negative if not run
+  double batch_ns_per_op = -1.0;
+};
+
 struct FilterBench : public MockBlockBasedTableTester {
   std::vector<KeyMaker> kms_;
   std::vector<FilterInfo> infos_;
@@ -271,13 +289,17 @@ struct FilterBench : public MockBlockBasedTableTester {
   Arena arena_;
   StderrLogger stderr_logger_;
   double m_queries_;
+  FilterBenchSummary summary_;
+  // FP rate of the last RandomQueryTest() that was not a dry run
+  double last_fp_rate_;
 
   FilterBench()
       : MockBlockBasedTableTester(new BloomFilterPolicy(
             FLAGS_bits_per_key,
             static_cast<BloomFilterPolicy::Mode>(FLAGS_impl))),
         random_(FLAGS_seed),
-        m_queries_(0) {
+        m_queries_(0),
+        last_fp_rate_(0.0) {
     for (uint32_t i = 0; i < FLAGS_batch_size; ++i) {
       kms_.emplace_back(FLAGS_key_size < 8 ? 8 : FLAGS_key_size);
     }
@@ -435,6 +457,10 @@ void FilterBench::Go() {
 
   double bpk = total_size * 8.0 / total_keys_added;
   std::cout << "Bits/key stored: " << bpk << std::endl;
+  summary_ = FilterBenchSummary();
+  summary_.impl = FLAGS_impl;
+  summary_.bits_per_key = bpk;
+  summary_.build_ns_per_key = ns;
 #ifdef PREDICT_FP_RATE
   std::cout << "Predicted FP rate %: "
             << 100.0 * (weighted_predicted_fp_rate / total_keys_added)
@@ -491,9 +517,15 @@ void FilterBench::Go() {
     random_.Seed(FLAGS_seed + 1);
     double f = RandomQueryTest(inside_threshold, /*dry_run*/ false, tm);
     random_.Seed(FLAGS_seed + 1);
+    double fp_rate = last_fp_rate_;
+    random_.Seed(FLAGS_seed + 1);
     double d = RandomQueryTest(inside_threshold, /*dry_run*/ true, tm);
     std::cout << "  " << TestModeToString(tm) << " net ns/op: " << (f - d)
               << std::endl;
+    if (tm == kBatchPrepared) {
+      summary_.batch_ns_per_op = f - d;
+    }
+    summary_.fp_rate = fp_rate;
   }
 
   if (!FLAGS_quick) {
@@ -708,6 +740,7 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
         best_fp_rate = std::min(best_fp_rate, fp_rate);
       }
     }
+    last_fp_rate_ = q > 0 ? double(fp) / q : 0.0;
     fp_rate_report_ << "    Average FP rate %: " << 100.0 * fp / q << std::endl;
     if (!FLAGS_quick && !FLAGS_best_case) {
       fp_rate_report_ << "    Worst   FP rate %: " << 100.0 * worst_fp_rate
@@ -756,6 +789,38 @@ int main(int argc, char **argv) {
         << "  \"Skewed X% in Y%\" - like \"Random filter\" except Y% of"
         << "\n      the filters are designated as \"hot\" and receive X%"
         << "\n      of queries." << std::endl;
+  } else if (!FLAGS_compare_impls.empty()) {
+    std::vector<FilterBenchSummary> summaries;
+    const uint32_t seed = FLAGS_seed;
+    std::stringstream impls(FLAGS_compare_impls);
+    std::string impl;
+    while (std::getline(impls, impl, ',')) {
+      FLAGS_impl = static_cast<uint32_t>(std::stoul(impl));
+      // Same keys and queries for every implementation
+      FLAGS_seed = seed;
+      std::cout << "==== impl " << FLAGS_impl << " ====" << std::endl;
+      FilterBench b;
+      for (uint32_t i = 0; i < FLAGS_runs; ++i) {
+        b.Go();
+        summaries.push_back(b.summary_);
+        FLAGS_seed += 100;
+        b.random_.Seed(FLAGS_seed);
+      }
+    }
+    std::cout << "==== Summary ====" << std::endl;
+    std::cout << "impl  bits/key  build ns/key  FP rate %  batched ns/op"
+              << std::endl;
+    for (const auto &s : summaries) {
+      char line[100];
+      snprintf(line, sizeof(line), "%4u  %8.3f  %12.2f  %9.4f  ", s.impl,
+               s.bits_per_key, s.build_ns_per_key, 100.0 * s.fp_rate);
+      std::cout << line;
+      if (s.batch_ns_per_op < 0) {
+        std::cout << "n/a" << std::endl;
+      } else {
+        std::cout << s.batch_ns_per_op << std::endl;
+      }
+    }
   } else {
     FilterBench b;
     for (uint32_t i = 0; i < FLAGS_runs; ++i) {
@@ -58,6 +58,7 @@ GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
       exit_cv_(&request_mutex_),
       requests_to_wait_(0),
       available_bytes_(0),
+      num_queued_(0),
       next_refill_us_(NowMicrosMonotonic(env_)),
       fairness_(fairness > 100 ? 100 : fairness),
       rnd_((uint32_t)time(nullptr)),
@@ -67,22 +68,23 @@ GenericRateLimiter::GenericRateLimiter(int64_t rate_bytes_per_sec,
       prev_num_drains_(0),
       max_bytes_per_sec_(rate_bytes_per_sec),
       tuned_time_(NowMicrosMonotonic(env_)) {
-  total_requests_[0] = 0;
-  total_requests_[1] = 0;
-  total_bytes_through_[0] = 0;
-  total_bytes_through_[1] = 0;
+  for (int i = Env::IO_LOW; i < Env::IO_TOTAL; ++i) {
+    total_requests_[i].store(0, std::memory_order_relaxed);
+    total_bytes_through_[i].store(0, std::memory_order_relaxed);
+  }
 }
 
 GenericRateLimiter::~GenericRateLimiter() {
   MutexLock g(&request_mutex_);
   stop_ = true;
-  requests_to_wait_ = static_cast<int32_t>(queue_[Env::IO_LOW].size() +
-                                           queue_[Env::IO_HIGH].size());
-  for (auto& r : queue_[Env::IO_HIGH]) {
-    r->cv.Signal();
+  requests_to_wait_ = 0;
+  for (int i = Env::IO_LOW; i < Env::IO_TOTAL; ++i) {
+    requests_to_wait_ += static_cast<int32_t>(queue_[i].size());
   }
-  for (auto& r : queue_[Env::IO_LOW]) {
-    r->cv.Signal();
+  for (int i = Env::IO_TOTAL - 1; i >= Env::IO_LOW; --i) {
+    for (auto& r : queue_[i]) {
+      r->cv.Signal();
+    }
   }
   while (requests_to_wait_ > 0) {
     exit_cv_.Wait();
@@ -98,12 +100,46 @@ void GenericRateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
       std::memory_order_relaxed);
 }
 
+bool GenericRateLimiter::TryConsumeAvailableBytes(int64_t bytes) {
+  int64_t available = available_bytes_.load(std::memory_order_relaxed);
+  while (available >= bytes) {
+    if (available_bytes_.compare_exchange_weak(available, available - bytes,
+                                               std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool GenericRateLimiter::IsFrontOfAnyQueue(const Req* r) const {
+  for (int i = Env::IO_LOW; i < Env::IO_TOTAL; ++i) {
+    if (!queue_[i].empty() && r == queue_[i].front()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
                                  Statistics* stats) {
   assert(bytes <= refill_bytes_per_period_.load(std::memory_order_relaxed));
+  assert(pri < Env::IO_TOTAL);
   TEST_SYNC_POINT("GenericRateLimiter::Request");
   TEST_SYNC_POINT_CALLBACK("GenericRateLimiter::Request:1",
                            &rate_bytes_per_sec_);
+
+  // Fast path: while no request is queued, the bytes left over from the last
+  // refill are handed out without request_mutex_. A request queued
+  // concurrently may be overtaken once, which the fairness of Refill() makes
+  // up for. The auto-tuner needs every request to check the time, so it
+  // always takes the mutex.
+  if (!auto_tuned_ && num_queued_.load(std::memory_order_acquire) == 0 &&
+      TryConsumeAvailableBytes(bytes)) {
+    total_requests_[pri].fetch_add(1, std::memory_order_relaxed);
+    total_bytes_through_[pri].fetch_add(bytes, std::memory_order_relaxed);
+    return;
+  }
+
   MutexLock g(&request_mutex_);
 
   if (auto_tuned_) {
@@ -119,20 +155,21 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
     return;
   }
 
-  ++total_requests_[pri];
+  total_requests_[pri].fetch_add(1, std::memory_order_relaxed);
 
-  if (available_bytes_ >= bytes) {
+  if (num_queued_.load(std::memory_order_relaxed) == 0 &&
+      TryConsumeAvailableBytes(bytes)) {
     // Refill thread assigns quota and notifies requests waiting on
     // the queue under mutex. So if we get here, that means nobody
     // is waiting?
-    available_bytes_ -= bytes;
-    total_bytes_through_[pri] += bytes;
+    total_bytes_through_[pri].fetch_add(bytes, std::memory_order_relaxed);
     return;
   }
 
   // Request cannot be satisfied at this moment, enqueue
   Req r(bytes, &request_mutex_);
   queue_[pri].push_back(&r);
+  num_queued_.fetch_add(1, std::memory_order_release);
 
   do {
     bool timedout = false;
@@ -142,11 +179,7 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
     //     to lower priority
     // (3) a previous waiter at the front of queue, who got notified by
     //     previous leader
-    if (leader_ == nullptr &&
-        ((!queue_[Env::IO_HIGH].empty() &&
-            &r == queue_[Env::IO_HIGH].front()) ||
-         (!queue_[Env::IO_LOW].empty() &&
-            &r == queue_[Env::IO_LOW].front()))) {
+    if (leader_ == nullptr && &r == queue_[pri].front()) {
       leader_ = &r;
       int64_t delta = next_refill_us_ - NowMicrosMonotonic(env_);
       delta = delta > 0 ? delta : 0;
@@ -171,16 +204,8 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
     }
 
     // Make sure the waken up request is always the header of its queue
-    assert(r.granted ||
-           (!queue_[Env::IO_HIGH].empty() &&
-            &r == queue_[Env::IO_HIGH].front()) ||
-           (!queue_[Env::IO_LOW].empty() &&
-            &r == queue_[Env::IO_LOW].front()));
-    assert(leader_ == nullptr ||
-           (!queue_[Env::IO_HIGH].empty() &&
-            leader_ == queue_[Env::IO_HIGH].front()) ||
-           (!queue_[Env::IO_LOW].empty() &&
-            leader_ == queue_[Env::IO_LOW].front()));
+    assert(r.granted || IsFrontOfAnyQueue(&r));
+    assert(leader_ == nullptr || IsFrontOfAnyQueue(leader_));
 
     if (leader_ == &r) {
       // Waken up from TimedWait()
@@ -195,15 +220,14 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
         // Notify the header of queue if current leader is going away
         if (r.granted) {
           // Current leader already got granted with quota. Notify header
-          // of waiting queue to participate next round of election.
-          assert((queue_[Env::IO_HIGH].empty() ||
-                    &r != queue_[Env::IO_HIGH].front()) &&
-                 (queue_[Env::IO_LOW].empty() ||
-                    &r != queue_[Env::IO_LOW].front()));
-          if (!queue_[Env::IO_HIGH].empty()) {
-            queue_[Env::IO_HIGH].front()->cv.Signal();
-          } else if (!queue_[Env::IO_LOW].empty()) {
-            queue_[Env::IO_LOW].front()->cv.Signal();
+          // of waiting queue of the highest priority to participate next
+          // round of election.
+          assert(!IsFrontOfAnyQueue(&r));
+          for (int i = Env::IO_TOTAL - 1; i >= Env::IO_LOW; --i) {
+            if (!queue_[i].empty()) {
+              queue_[i].front()->cv.Signal();
+              break;
+            }
           }
           // Done
           break;
@@ -226,32 +250,70 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
   } while (!r.granted);
 }
 
+void GenericRateLimiter::GeneratePriorityIterationOrder(
+    Env::IOPriority* order) {
+  // IO_USER requests are always served first, since a user is waiting on
+  // them. Then each of IO_HIGH and IO_MID is served after the priorities
+  // below it with a 1/fairness chance, so that those are not starved.
+  bool high_pri_after_mid_low_pri = rnd_.OneIn(fairness_);
+  TEST_SYNC_POINT_CALLBACK(
+      "GenericRateLimiter::GeneratePriorityIterationOrder:HighPriAfterMidLow",
+      &high_pri_after_mid_low_pri);
+  bool mid_pri_after_low_pri = rnd_.OneIn(fairness_);
+  TEST_SYNC_POINT_CALLBACK(
+      "GenericRateLimiter::GeneratePriorityIterationOrder:MidPriAfterLow",
+      &mid_pri_after_low_pri);
+
+  int i = 0;
+  order[i++] = Env::IO_USER;
+  if (!high_pri_after_mid_low_pri) {
+    order[i++] = Env::IO_HIGH;
+  }
+  if (mid_pri_after_low_pri) {
+    order[i++] = Env::IO_LOW;
+    order[i++] = Env::IO_MID;
+  } else {
+    order[i++] = Env::IO_MID;
+    order[i++] = Env::IO_LOW;
+  }
+  if (high_pri_after_mid_low_pri) {
+    order[i++] = Env::IO_HIGH;
+  }
+  assert(i == Env::IO_TOTAL);
+  TEST_SYNC_POINT_CALLBACK(
+      "GenericRateLimiter::GeneratePriorityIterationOrder:Order", order);
+}
+
 void GenericRateLimiter::Refill() {
   TEST_SYNC_POINT("GenericRateLimiter::Refill");
   next_refill_us_ = NowMicrosMonotonic(env_) + refill_period_us_;
   // Carry over the left over quota from the last period
   auto refill_bytes_per_period =
       refill_bytes_per_period_.load(std::memory_order_relaxed);
-  if (available_bytes_ < refill_bytes_per_period) {
-    available_bytes_ += refill_bytes_per_period;
+  if (available_bytes_.load(std::memory_order_relaxed) <
+      refill_bytes_per_period) {
+    available_bytes_.fetch_add(refill_bytes_per_period,
+                               std::memory_order_relaxed);
   }
 
-  int use_low_pri_first = rnd_.OneIn(fairness_) ? 0 : 1;
-  for (int q = 0; q < 2; ++q) {
-    auto use_pri = (use_low_pri_first == q) ? Env::IO_LOW : Env::IO_HIGH;
+  Env::IOPriority order[Env::IO_TOTAL];
+  GeneratePriorityIterationOrder(order);
+  for (int q = 0; q < Env::IO_TOTAL; ++q) {
+    auto use_pri = order[q];
     auto* queue = &queue_[use_pri];
     while (!queue->empty()) {
       auto* next_req = queue->front();
-      if (available_bytes_ < next_req->request_bytes) {
+      if (!TryConsumeAvailableBytes(next_req->request_bytes)) {
         // avoid starvation
-        next_req->request_bytes -= available_bytes_;
-        available_bytes_ = 0;
+        next_req->request_bytes -=
+            available_bytes_.exchange(0, std::memory_order_relaxed);
         break;
       }
-      available_bytes_ -= next_req->request_bytes;
       next_req->request_bytes = 0;
-      total_bytes_through_[use_pri] += next_req->bytes;
+      total_bytes_through_[use_pri].fetch_add(next_req->bytes,
+                                              std::memory_order_relaxed);
       queue->pop_front();
+      num_queued_.fetch_sub(1, std::memory_order_relaxed);
 
       next_req->granted = true;
       if (next_req != leader_) {
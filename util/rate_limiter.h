@@ -45,21 +45,12 @@ class GenericRateLimiter : public RateLimiter {
 
   virtual int64_t GetTotalBytesThrough(
       const Env::IOPriority pri = Env::IO_TOTAL) const override {
-    MutexLock g(&request_mutex_);
-    if (pri == Env::IO_TOTAL) {
-      return total_bytes_through_[Env::IO_LOW] +
-             total_bytes_through_[Env::IO_HIGH];
-    }
-    return total_bytes_through_[pri];
+    return SumOverPriorities(total_bytes_through_, pri);
   }
 
   virtual int64_t GetTotalRequests(
       const Env::IOPriority pri = Env::IO_TOTAL) const override {
-    MutexLock g(&request_mutex_);
-    if (pri == Env::IO_TOTAL) {
-      return total_requests_[Env::IO_LOW] + total_requests_[Env::IO_HIGH];
-    }
-    return total_requests_[pri];
+    return SumOverPriorities(total_requests_, pri);
   }
 
   virtual int64_t GetBytesPerSecond() const override {
@@ -67,10 +58,33 @@ class GenericRateLimiter : public RateLimiter {
   }
 
  private:
+  struct Req;
+
   void Refill();
   int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec);
   Status Tune();
 
+  // Takes bytes from available_bytes_ if there are that many left.
+  bool TryConsumeAvailableBytes(int64_t bytes);
+
+  // Fills order with the priorities in the order Refill() serves them.
+  void GeneratePriorityIterationOrder(Env::IOPriority* order);
+
+  // Returns whether r is waiting at the front of one of the queues.
+  bool IsFrontOfAnyQueue(const Req* r) const;
+
+  static int64_t SumOverPriorities(const std::atomic<int64_t>* counters,
+                                   Env::IOPriority pri) {
+    if (pri != Env::IO_TOTAL) {
+      return counters[pri].load(std::memory_order_relaxed);
+    }
+    int64_t total = 0;
+    for (int i = Env::IO_LOW; i < Env::IO_TOTAL; ++i) {
+      total += counters[i].load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
   uint64_t NowMicrosMonotonic(Env* env) {
     return env->NowNanos() / std::milli::den;
   }
@@ -91,15 +105,18 @@ class GenericRateLimiter : public RateLimiter {
   port::CondVar exit_cv_;
   int32_t requests_to_wait_;
 
-  int64_t total_requests_[Env::IO_TOTAL];
-  int64_t total_bytes_through_[Env::IO_TOTAL];
-  int64_t available_bytes_;
+  // The counters and available_bytes_ are also updated without
+  // request_mutex_ by the requests granted on the fast path, which is only
+  // taken while no request is queued.
+  std::atomic<int64_t> total_requests_[Env::IO_TOTAL];
+  std::atomic<int64_t> total_bytes_through_[Env::IO_TOTAL];
+  std::atomic<int64_t> available_bytes_;
+  std::atomic<int32_t> num_queued_;
   int64_t next_refill_us_;
 
   int32_t fairness_;
   Random rnd_;
 
-  struct Req;
   Req* leader_;
   std::deque<Req*> queue_[Env::IO_TOTAL];
 
@@ -59,6 +59,72 @@ TEST_F(RateLimiterTest, Modes) {
   }
 }
 
+TEST_F(RateLimiterTest, Priorities) {
+  GenericRateLimiter limiter(1000 * 1000 /* rate_bytes_per_sec */,
+                             100 * 1000 /* refill_period_us */,
+                             10 /* fairness */, RateLimiter::Mode::kAllIo,
+                             Env::Default(), false /* auto_tuned */);
+  for (int i = Env::IO_LOW; i < Env::IO_TOTAL; ++i) {
+    limiter.Request(100 * (i + 1) /* bytes */, static_cast<Env::IOPriority>(i),
+                    nullptr /* stats */, RateLimiter::OpType::kRead);
+  }
+  for (int i = Env::IO_LOW; i < Env::IO_TOTAL; ++i) {
+    auto pri = static_cast<Env::IOPriority>(i);
+    ASSERT_EQ(1, limiter.GetTotalRequests(pri));
+    ASSERT_EQ(100 * (i + 1), limiter.GetTotalBytesThrough(pri));
+  }
+  ASSERT_EQ(Env::IO_TOTAL, limiter.GetTotalRequests());
+  ASSERT_EQ(1000, limiter.GetTotalBytesThrough());
+}
+
+TEST_F(RateLimiterTest, PriorityIterationOrder) {
+  std::unique_ptr<RateLimiter> limiter(NewGenericRateLimiter(
+      200 /* rate_bytes_per_sec */, 1000 * 1000 /* refill_period_us */,
+      10 /* fairness */));
+
+  bool high_pri_after_mid_low_pri = false;
+  bool mid_pri_after_low_pri = false;
+  std::vector<Env::IOPriority> order;
+  SyncPoint::GetInstance()->SetCallBack(
+      "GenericRateLimiter::GeneratePriorityIterationOrder:HighPriAfterMidLow",
+      [&](void* arg) {
+        *static_cast<bool*>(arg) = high_pri_after_mid_low_pri;
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "GenericRateLimiter::GeneratePriorityIterationOrder:MidPriAfterLow",
+      [&](void* arg) { *static_cast<bool*>(arg) = mid_pri_after_low_pri; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "GenericRateLimiter::GeneratePriorityIterationOrder:Order",
+      [&](void* arg) {
+        auto* pris = static_cast<Env::IOPriority*>(arg);
+        order.assign(pris, pris + Env::IO_TOTAL);
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool high_after : {false, true}) {
+    for (bool mid_after : {false, true}) {
+      high_pri_after_mid_low_pri = high_after;
+      mid_pri_after_low_pri = mid_after;
+      order.clear();
+      // Drains what is left and waits for the next refill
+      limiter->Request(limiter->GetSingleBurstBytes(), Env::IO_LOW,
+                       nullptr /* stats */, RateLimiter::OpType::kWrite);
+      ASSERT_EQ(static_cast<size_t>(Env::IO_TOTAL), order.size());
+      // IO_USER always goes first
+      ASSERT_EQ(Env::IO_USER, order[0]);
+      auto pos = [&](Env::IOPriority pri) {
+        return std::find(order.begin(), order.end(), pri) - order.begin();
+      };
+      ASSERT_EQ(high_after, pos(Env::IO_HIGH) > pos(Env::IO_MID));
+      ASSERT_EQ(high_after, pos(Env::IO_HIGH) > pos(Env::IO_LOW));
+      ASSERT_EQ(mid_after, pos(Env::IO_MID) > pos(Env::IO_LOW));
+    }
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 #if !((defined(TRAVIS) || defined(CIRCLECI)) && defined(OS_MACOSX))
 TEST_F(RateLimiterTest, Rate) {
   auto* env = Env::Default();
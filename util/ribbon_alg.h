@@ -958,6 +958,8 @@ bool SimpleFilterQuery(const typename FilterQueryHasher::Key &key,
 //   Index GetNumSegments() const;
 //   // Load an entry from the logical array of segments
 //   CoeffRow LoadSegment(Index segment_num) const;
+//   // Hint that the given entries are about to be loaded (queries only)
+//   void PrefetchSegments(Index segment_num, Index count) const;
 //   // Store an entry to the logical array of segments
 //   void StoreSegment(Index segment_num, CoeffRow data);
 // };
@@ -1126,26 +1128,26 @@ typename InterleavedSolutionStorage::ResultRow InterleavedPhsfQuery(
   return sr;
 }
 
-// Filter query a key from InterleavedFilterQuery.
+// Prepares a filter query of a key from InterleavedSolutionStorage, by
+// computing where its solution data is and prefetching it, so that the
+// memory latency of several queries in a batch overlaps. Returns the hash
+// and position to pass to InterleavedFilterQuery.
 template <typename InterleavedSolutionStorage, typename FilterQueryHasher>
-bool InterleavedFilterQuery(const typename FilterQueryHasher::Key &key,
-                            const FilterQueryHasher &hasher,
-                            const InterleavedSolutionStorage &iss) {
+inline void InterleavedPrepareQuery(
+    const typename FilterQueryHasher::Key &key, const FilterQueryHasher &hasher,
+    const InterleavedSolutionStorage &iss,
+    typename FilterQueryHasher::Hash *saved_hash,
+    typename InterleavedSolutionStorage::Index *saved_segment_num,
+    typename InterleavedSolutionStorage::Index *saved_num_columns,
+    typename InterleavedSolutionStorage::Index *saved_start_bit) {
   // BEGIN mostly copied from InterleavedPhsfQuery
   using Hash = typename FilterQueryHasher::Hash;
 
   using CoeffRow = typename InterleavedSolutionStorage::CoeffRow;
   using Index = typename InterleavedSolutionStorage::Index;
-  using ResultRow = typename InterleavedSolutionStorage::ResultRow;
 
   static_assert(sizeof(Index) == sizeof(typename FilterQueryHasher::Index),
                 "must be same");
-  static_assert(
-      sizeof(CoeffRow) == sizeof(typename FilterQueryHasher::CoeffRow),
-      "must be same");
-  static_assert(
-      sizeof(ResultRow) == sizeof(typename FilterQueryHasher::ResultRow),
-      "must be same");
 
   constexpr auto kCoeffBits = static_cast<Index>(sizeof(CoeffRow) * 8U);
 
@@ -1155,35 +1157,70 @@ bool InterleavedFilterQuery(const typename FilterQueryHasher::Key &key,
   const Index upper_start_block = iss.GetUpperStartBlock();
   Index num_columns = iss.GetUpperNumColumns();
   Index start_block_num = start_slot / kCoeffBits;
-  Index segment = start_block_num * num_columns -
-                  std::min(start_block_num, upper_start_block);
+  Index segment_num = start_block_num * num_columns -
+                      std::min(start_block_num, upper_start_block);
   // Change to lower num columns if applicable.
   // (This should not compile to a conditional branch.)
   num_columns -= (start_block_num < upper_start_block) ? 1 : 0;
 
-  const CoeffRow cr = hasher.GetCoeffRow(hash);
   Index start_bit = start_slot % kCoeffBits;
   // END mostly copied from InterleavedPhsfQuery.
 
+  // The segments of the next block are only needed if the coefficients
+  // straddle the two blocks.
+  iss.PrefetchSegments(segment_num,
+                       start_bit == 0 ? num_columns : 2 * num_columns);
+
+  *saved_hash = hash;
+  *saved_segment_num = segment_num;
+  *saved_num_columns = num_columns;
+  *saved_start_bit = start_bit;
+}
+
+// Filter query a key from InterleavedSolutionStorage, given the results of
+// InterleavedPrepareQuery.
+template <typename InterleavedSolutionStorage, typename FilterQueryHasher>
+inline bool InterleavedFilterQuery(
+    typename FilterQueryHasher::Hash hash,
+    typename InterleavedSolutionStorage::Index segment_num,
+    typename InterleavedSolutionStorage::Index num_columns,
+    typename InterleavedSolutionStorage::Index start_bit,
+    const FilterQueryHasher &hasher, const InterleavedSolutionStorage &iss) {
+  using CoeffRow = typename InterleavedSolutionStorage::CoeffRow;
+  using Index = typename InterleavedSolutionStorage::Index;
+  using ResultRow = typename InterleavedSolutionStorage::ResultRow;
+
+  static_assert(
+      sizeof(CoeffRow) == sizeof(typename FilterQueryHasher::CoeffRow),
+      "must be same");
+  static_assert(
+      sizeof(ResultRow) == sizeof(typename FilterQueryHasher::ResultRow),
+      "must be same");
+
+  constexpr auto kCoeffBits = static_cast<Index>(sizeof(CoeffRow) * 8U);
+
+  const CoeffRow cr = hasher.GetCoeffRow(hash);
   const ResultRow expected = hasher.GetResultRowFromHash(hash);
 
-  // TODO: consider optimizations such as
-  // * mask fetched values and shift cr, rather than shifting fetched values
-  // * get rid of start_bit == 0 condition with careful fetching & shifting
   if (start_bit == 0) {
     for (Index i = 0; i < num_columns; ++i) {
-      if (BitParity(iss.LoadSegment(segment + i) & cr) !=
+      if (BitParity(iss.LoadSegment(segment_num + i) & cr) !=
           (static_cast<int>(expected >> i) & 1)) {
         return false;
       }
     }
   } else {
+    // Mask the fetched values with the shifted coefficients, rather than
+    // shifting the fetched values, since the parity of the two halves
+    // combines with xor.
+    const CoeffRow cr_left = cr << static_cast<unsigned>(start_bit);
+    const CoeffRow cr_right =
+        cr >> static_cast<unsigned>(kCoeffBits - start_bit);
     for (Index i = 0; i < num_columns; ++i) {
-      CoeffRow soln_col =
-          (iss.LoadSegment(segment + i) >> static_cast<unsigned>(start_bit)) |
-          (iss.LoadSegment(segment + num_columns + i)
-           << static_cast<unsigned>(kCoeffBits - start_bit));
-      if (BitParity(soln_col & cr) != (static_cast<int>(expected >> i) & 1)) {
+      CoeffRow soln_data =
+          (iss.LoadSegment(segment_num + i) & cr_left) ^
+          (iss.LoadSegment(segment_num + num_columns + i) & cr_right);
+      if (BitParity(soln_data) != (static_cast<int>(expected >> i) & 1)) {
         return false;
       }
     }
@@ -1192,9 +1229,20 @@ bool InterleavedFilterQuery(const typename FilterQueryHasher::Key &key,
   return true;
 }
 
-// TODO: refactor Interleaved*Query so that queries can be "prepared" by
-// prefetching memory, to hide memory latency for multiple queries in a
-// single thread.
+// Filter query a key from InterleavedSolutionStorage.
+template <typename InterleavedSolutionStorage, typename FilterQueryHasher>
+bool InterleavedFilterQuery(const typename FilterQueryHasher::Key &key,
+                            const FilterQueryHasher &hasher,
+                            const InterleavedSolutionStorage &iss) {
+  typename FilterQueryHasher::Hash hash;
+  typename InterleavedSolutionStorage::Index segment_num;
+  typename InterleavedSolutionStorage::Index num_columns;
+  typename InterleavedSolutionStorage::Index start_bit;
+  InterleavedPrepareQuery(key, hasher, iss, &hash, &segment_num, &num_columns,
+                          &start_bit);
+  return InterleavedFilterQuery(hash, segment_num, num_columns, start_bit,
+                                hasher, iss);
+}
 
 }  // namespace ribbon
 
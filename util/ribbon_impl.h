@@ -10,6 +10,10 @@
 #include "port/port.h"  // for PREFETCH
 #include "util/ribbon_alg.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace ROCKSDB_NAMESPACE {
 
 namespace ribbon {
@@ -810,6 +814,22 @@ class SerializableInterleavedSolution {
     assert(data_ != nullptr);  // suppress clang analyzer report
     EncodeFixedGeneric(data_ + segment_num * sizeof(CoeffRow), val);
   }
+  void PrefetchSegments(Index segment_num, Index count) const {
+    if (count == 0) {
+      // No columns, e.g. for an empty solution
+      return;
+    }
+    assert(data_ != nullptr);  // suppress clang analyzer report
+    const uintptr_t end = reinterpret_cast<uintptr_t>(
+        data_ + (segment_num + count) * sizeof(CoeffRow));
+    for (uintptr_t line = reinterpret_cast<uintptr_t>(
+                              data_ + segment_num * sizeof(CoeffRow)) &
+                          ~uintptr_t{CACHE_LINE_SIZE - 1};
+         line < end; line += CACHE_LINE_SIZE) {
+      PREFETCH(reinterpret_cast<const char*>(line), 0 /* rw */,
+               1 /* locality */);
+    }
+  }
 
   // ********************************************************************
   // High-level API
@@ -859,10 +879,33 @@ class SerializableInterleavedSolution {
     } else {
       // Normal, or upper_num_columns_ == 0 means "no space for data" and
       // thus will always return true.
-      return InterleavedFilterQuery(input, hasher, *this);
+      Hash hash;
+      Index segment_num;
+      Index num_columns;
+      Index start_bit;
+      InterleavedPrepareQuery(input, hasher, *this, &hash, &segment_num,
+                              &num_columns, &start_bit);
+      return FilterQuery(hash, segment_num, num_columns, start_bit, hasher);
     }
   }
 
+  // Filter query of a key prepared with InterleavedPrepareQuery(), such as
+  // one of a batch for which the solution data was prefetched. Not for the
+  // "unusual" zero starts case.
+  template <typename FilterQueryHasher>
+  bool FilterQuery(Hash hash, Index segment_num, Index num_columns,
+                   Index start_bit, const FilterQueryHasher& hasher) const {
+    assert(TypesAndSettings::kIsFilter);
+#ifdef __AVX2__
+    if (sizeof(CoeffRow) == 16) {
+      return FilterQueryAvx2(hash, segment_num, num_columns, start_bit,
+                             hasher);
+    }
+#endif  // __AVX2__
+    return InterleavedFilterQuery(hash, segment_num, num_columns, start_bit,
+                                  hasher, *this);
+  }
+
   double ExpectedFpRate() {
     assert(TypesAndSettings::kIsFilter);
     if (TypesAndSettings::kAllowZeroStarts && num_starts_ == 0) {
@@ -922,6 +965,63 @@ class SerializableInterleavedSolution {
   }
 
  protected:
+#ifdef __AVX2__
+  // Like InterleavedFilterQuery() for 128-bit coefficient rows, but checks
+  // two columns at a time, with the segments of both in a 256-bit register.
+  template <typename FilterQueryHasher>
+  bool FilterQueryAvx2(Hash hash, Index segment_num, Index num_columns,
+                       Index start_bit,
+                       const FilterQueryHasher& hasher) const {
+    const Unsigned128 cr = hasher.GetCoeffRow(hash);
+    const ResultRow expected = hasher.GetResultRowFromHash(hash);
+    // The coefficients straddle the segments of two blocks unless start_bit
+    // is 0, in which case the next block (if any) must not be read.
+    const Unsigned128 cr_left = cr << static_cast<unsigned>(start_bit);
+    const Unsigned128 cr_right =
+        start_bit == 0 ? Unsigned128{0}
+                       : cr >> static_cast<unsigned>(128 - start_bit);
+    const Index right_segment_num =
+        start_bit == 0 ? segment_num : segment_num + num_columns;
+
+    const __m256i left_mask = _mm256_set_epi64x(
+        static_cast<long long>(Upper64of128(cr_left)),
+        static_cast<long long>(Lower64of128(cr_left)),
+        static_cast<long long>(Upper64of128(cr_left)),
+        static_cast<long long>(Lower64of128(cr_left)));
+    const __m256i right_mask = _mm256_set_epi64x(
+        static_cast<long long>(Upper64of128(cr_right)),
+        static_cast<long long>(Lower64of128(cr_right)),
+        static_cast<long long>(Upper64of128(cr_right)),
+        static_cast<long long>(Lower64of128(cr_right)));
+    Index i = 0;
+    for (; i + 1 < num_columns; i += 2) {
+      const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+          data_ + (segment_num + i) * sizeof(CoeffRow)));
+      const __m256i right =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+              data_ + (right_segment_num + i) * sizeof(CoeffRow)));
+      __m256i soln_data = _mm256_xor_si256(_mm256_and_si256(left, left_mask),
+                                           _mm256_and_si256(right, right_mask));
+      // Fold each 128-bit column to 64 bits, which keeps its parity
+      soln_data = _mm256_xor_si256(soln_data, _mm256_srli_si256(soln_data, 8));
+      const int parities =
+          BitParity(static_cast<uint64_t>(_mm256_extract_epi64(soln_data, 0))) |
+          (BitParity(static_cast<uint64_t>(_mm256_extract_epi64(soln_data, 2)))
+           << 1);
+      if (parities != static_cast<int>((expected >> i) & 3)) {
+        return false;
+      }
+    }
+    if (i < num_columns) {
+      const Unsigned128 soln_data =
+          (LoadSegment(segment_num + i) & cr_left) ^
+          (LoadSegment(right_segment_num + i) & cr_right);
+      return BitParity(soln_data) == (static_cast<int>(expected >> i) & 1);
+    }
+    return true;
+  }
+#endif  // __AVX2__
+
   static size_t InternalGetBytesForFpRate(Index num_slots,
                                           double desired_fp_rate,
                                           double desired_one_in_fp_rate,
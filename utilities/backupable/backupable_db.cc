@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cinttypes>
+#include <condition_variable>
 #include <functional>
 #include <future>
 #include <limits>
@@ -104,6 +105,8 @@ void BackupableDBOptions::Dump(Logger* logger) const {
                  restore_rate_limit);
   ROCKS_LOG_INFO(logger, "Options.max_background_operations: %d",
                  max_background_operations);
+  ROCKS_LOG_INFO(logger, " Options.parallel_copy_chunk_size: %" PRIu64,
+                 parallel_copy_chunk_size);
 }
 
 // -------- BackupEngineImpl class ---------
@@ -409,9 +412,51 @@ class BackupEngineImpl : public BackupEngine {
     Status status;
   };
 
+  // State shared by the background threads copying one file in chunks of
+  // options_.parallel_copy_chunk_size. Chunks are claimed in order through
+  // next_chunk, and the thread owning the file copies chunks as well, so it
+  // never waits for a chunk that no thread has claimed. Each thread writes
+  // through a RandomRWFile of its own, which it syncs and closes before
+  // counting its chunks as done.
+  struct ChunkedCopyState {
+    std::unique_ptr<RandomAccessFile> src_file;
+    std::string src_path;
+    std::string dst_path;
+    Env* dst_env;
+    bool sync;
+    uint64_t file_size;
+    uint64_t chunk_size;
+    size_t num_chunks;
+    RateLimiter* rate_limiter;
+    std::function<void()> progress_callback;
+    std::atomic<size_t> next_chunk;
+    std::atomic<bool> failed;
+    // Each element is only written by the thread that claimed its chunk
+    std::vector<uint32_t> chunk_checksums;
+    // Protected by mutex
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t chunks_done;
+    Status status;
+
+    ChunkedCopyState()
+        : dst_env(nullptr),
+          sync(false),
+          file_size(0),
+          chunk_size(0),
+          num_chunks(0),
+          rate_limiter(nullptr),
+          next_chunk(0),
+          failed(false),
+          chunks_done(0) {}
+  };
+
   // Exactly one of src_path and contents must be non-empty. If src_path is
   // non-empty, the file is copied from this pathname. Otherwise, if contents is
   // non-empty, the file will be created at dst_path with these contents.
+  //
+  // If chunked_copy is set, the item only asks the thread reading it to help
+  // copy the chunks of a file owned by another thread, and has no result.
   struct CopyOrCreateWorkItem {
     std::string src_path;
     std::string dst_path;
@@ -429,6 +474,7 @@ class BackupEngineImpl : public BackupEngine {
     std::string src_checksum_hex;
     std::string db_id;
     std::string db_session_id;
+    std::shared_ptr<ChunkedCopyState> chunked_copy;
 
     CopyOrCreateWorkItem()
         : src_path(""),
@@ -470,6 +516,7 @@ class BackupEngineImpl : public BackupEngine {
       src_checksum_hex = std::move(o.src_checksum_hex);
       db_id = std::move(o.db_id);
       db_session_id = std::move(o.db_session_id);
+      chunked_copy = std::move(o.chunked_copy);
       return *this;
     }
 
@@ -498,8 +545,24 @@ class BackupEngineImpl : public BackupEngine {
           src_checksum_hex(_src_checksum_hex),
           db_id(_db_id),
           db_session_id(_db_session_id) {}
+
+    explicit CopyOrCreateWorkItem(std::shared_ptr<ChunkedCopyState> _state)
+        : CopyOrCreateWorkItem() {
+      chunked_copy = std::move(_state);
+    }
   };
 
+  // Copies work_item's source file in chunks of
+  // options_.parallel_copy_chunk_size, handing chunks to the other background
+  // threads through files_to_copy_or_create_. Returns NotSupported if the
+  // file is not worth splitting or the destination Env cannot write it at
+  // arbitrary offsets, in which case it is to be copied in one piece.
+  Status CopyFileInChunks(const CopyOrCreateWorkItem& work_item,
+                          uint64_t* size, std::string* checksum_hex);
+
+  // Copies chunks of state's file until none is left to claim.
+  void CopyChunks(ChunkedCopyState* state);
+
   struct BackupAfterCopyOrCreateWorkItem {
     std::future<CopyOrCreateResult> result;
     bool shared;
@@ -873,13 +936,26 @@ Status BackupEngineImpl::Initialize() {
           port::SetCpuPriority(0, priority);
           current_priority = priority;
         }
+        if (work_item.chunked_copy != nullptr) {
+          CopyChunks(work_item.chunked_copy.get());
+          continue;
+        }
         CopyOrCreateResult result;
-        result.status = CopyOrCreateFile(
-            work_item.src_path, work_item.dst_path, work_item.contents,
-            work_item.src_env, work_item.dst_env, work_item.src_env_options,
-            work_item.sync, work_item.rate_limiter, &result.size,
-            &result.checksum_hex, work_item.size_limit,
-            work_item.progress_callback);
+        result.status = Status::NotSupported();
+        if (!work_item.src_path.empty() &&
+            options_.parallel_copy_chunk_size > 0 &&
+            options_.max_background_operations > 1) {
+          result.status = CopyFileInChunks(work_item, &result.size,
+                                           &result.checksum_hex);
+        }
+        if (result.status.IsNotSupported()) {
+          result.status = CopyOrCreateFile(
+              work_item.src_path, work_item.dst_path, work_item.contents,
+              work_item.src_env, work_item.dst_env, work_item.src_env_options,
+              work_item.sync, work_item.rate_limiter, &result.size,
+              &result.checksum_hex, work_item.size_limit,
+              work_item.progress_callback);
+        }
         result.db_id = work_item.db_id;
         result.db_session_id = work_item.db_session_id;
         if (result.status.ok() && work_item.verify_checksum_after_work) {
@@ -1574,6 +1650,188 @@ Status BackupEngineImpl::CopyOrCreateFile(
   return s;
 }
 
+Status BackupEngineImpl::CopyFileInChunks(const CopyOrCreateWorkItem& work_item,
+                                          uint64_t* size,
+                                          std::string* checksum_hex) {
+  uint64_t file_size = 0;
+  Status s = work_item.src_env->GetFileSize(work_item.src_path, &file_size);
+  if (!s.ok()) {
+    return s;
+  }
+  if (work_item.size_limit != 0) {
+    file_size = std::min(file_size, work_item.size_limit);
+  }
+  const uint64_t chunk_size = options_.parallel_copy_chunk_size;
+  if (file_size <= chunk_size) {
+    return Status::NotSupported();
+  }
+
+  auto state = std::make_shared<ChunkedCopyState>();
+  // The chunks are read into plain buffers, which are not aligned for
+  // direct I/O.
+  EnvOptions src_env_options = work_item.src_env_options;
+  src_env_options.use_direct_reads = false;
+  s = work_item.src_env->NewRandomAccessFile(
+      work_item.src_path, &state->src_file, src_env_options);
+  if (!s.ok()) {
+    return s;
+  }
+  // Create or truncate the destination, which the threads then fill in at
+  // the offsets of their chunks
+  {
+    std::unique_ptr<WritableFile> dst_file;
+    EnvOptions dst_env_options;
+    dst_env_options.use_mmap_writes = false;
+    s = work_item.dst_env->NewWritableFile(work_item.dst_path, &dst_file,
+                                           dst_env_options);
+    if (s.ok()) {
+      s = dst_file->Close();
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  state->src_path = work_item.src_path;
+  state->dst_path = work_item.dst_path;
+  state->dst_env = work_item.dst_env;
+  state->sync = work_item.sync;
+  state->file_size = file_size;
+  state->chunk_size = chunk_size;
+  state->num_chunks =
+      static_cast<size_t>((file_size + chunk_size - 1) / chunk_size);
+  state->rate_limiter = work_item.rate_limiter;
+  state->progress_callback = work_item.progress_callback;
+  state->chunk_checksums.resize(state->num_chunks);
+  TEST_SYNC_POINT("BackupEngineImpl::CopyFileInChunks:Split");
+
+  // This thread copies chunks too, so at most one helper per other thread
+  size_t helpers =
+      std::min(state->num_chunks,
+               static_cast<size_t>(options_.max_background_operations)) -
+      1;
+  for (size_t i = 0; i < helpers; ++i) {
+    files_to_copy_or_create_.write(CopyOrCreateWorkItem(state));
+  }
+  CopyChunks(state.get());
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock,
+                   [&state] { return state->chunks_done == state->num_chunks; });
+    s = state->status;
+  }
+  if (!s.ok()) {
+    // A NotSupported from the destination Env makes the caller copy the file
+    // in one piece instead
+    return s;
+  }
+  uint32_t checksum_value = state->chunk_checksums[0];
+  for (size_t i = 1; i < state->num_chunks; ++i) {
+    uint64_t chunk_len = std::min(chunk_size, file_size - i * chunk_size);
+    checksum_value =
+        crc32c::Crc32cCombine(checksum_value, state->chunk_checksums[i],
+                              static_cast<size_t>(chunk_len));
+  }
+  *size = file_size;
+  checksum_hex->assign(ChecksumInt32ToHex(checksum_value));
+  return s;
+}
+
+void BackupEngineImpl::CopyChunks(ChunkedCopyState* state) {
+  std::unique_ptr<RandomRWFile> dst_file;
+  std::unique_ptr<char[]> buf;
+  Status s;
+  size_t num_claimed = 0;
+  size_t chunk;
+  while ((chunk = state->next_chunk.fetch_add(1, std::memory_order_relaxed)) <
+         state->num_chunks) {
+    ++num_claimed;
+    if (!s.ok() || state->failed.load(std::memory_order_relaxed)) {
+      continue;
+    }
+    if (dst_file == nullptr) {
+      EnvOptions dst_env_options;
+      dst_env_options.use_mmap_writes = false;
+      s = state->dst_env->NewRandomRWFile(state->dst_path, &dst_file,
+                                          dst_env_options);
+      if (!s.ok()) {
+        state->failed.store(true, std::memory_order_relaxed);
+        continue;
+      }
+      buf.reset(new char[copy_file_buffer_size_]);
+    }
+    uint32_t checksum_value = 0;
+    uint64_t offset = chunk * state->chunk_size;
+    uint64_t end = std::min(offset + state->chunk_size, state->file_size);
+    uint64_t processed_buffer_size = 0;
+    while (offset < end) {
+      if (stop_backup_.load(std::memory_order_acquire)) {
+        s = Status::Incomplete("Backup stopped");
+        break;
+      }
+      size_t buffer_to_read = static_cast<size_t>(std::min(
+          static_cast<uint64_t>(copy_file_buffer_size_), end - offset));
+      Slice data;
+      s = state->src_file->Read(offset, buffer_to_read, &data, buf.get());
+      TEST_SYNC_POINT_CALLBACK(
+          "BackupEngineImpl::CopyChunks:CorruptionDuringBackup",
+          (state->src_path.length() > 4 &&
+           state->src_path.rfind(".sst") == state->src_path.length() - 4)
+              ? &data
+              : nullptr);
+      if (s.ok() && data.size() != buffer_to_read) {
+        s = Status::IOError("Unexpected end of file while copying " +
+                            state->src_path);
+      }
+      if (!s.ok()) {
+        break;
+      }
+      checksum_value = crc32c::Extend(checksum_value, data.data(), data.size());
+      s = dst_file->Write(offset, data);
+      if (!s.ok()) {
+        break;
+      }
+      if (state->rate_limiter != nullptr) {
+        state->rate_limiter->Request(data.size(), Env::IO_LOW,
+                                     nullptr /* stats */,
+                                     RateLimiter::OpType::kWrite);
+      }
+      offset += data.size();
+      processed_buffer_size += data.size();
+      if (processed_buffer_size > options_.callback_trigger_interval_size) {
+        processed_buffer_size -= options_.callback_trigger_interval_size;
+        std::lock_guard<std::mutex> lock(byte_report_mutex_);
+        state->progress_callback();
+      }
+    }
+    if (s.ok()) {
+      state->chunk_checksums[chunk] = checksum_value;
+    } else {
+      state->failed.store(true, std::memory_order_relaxed);
+    }
+  }
+  if (num_claimed == 0) {
+    return;
+  }
+  if (dst_file != nullptr) {
+    if (s.ok() && state->sync) {
+      s = dst_file->Fsync();
+    }
+    Status close_s = dst_file->Close();
+    if (s.ok()) {
+      s = close_s;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (!s.ok() && state->status.ok()) {
+    state->status = s;
+  }
+  state->chunks_done += num_claimed;
+  if (state->chunks_done == state->num_chunks) {
+    state->cv.notify_all();
+  }
+}
+
 // fname will always start with "/"
 Status BackupEngineImpl::AddBackupFileWorkItem(
     std::unordered_set<std::string>& live_dst_paths,
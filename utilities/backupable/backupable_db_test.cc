@@ -1424,18 +1424,20 @@ TEST_F(BackupableDBTest, TableFileWithoutDbChecksumCorruptedDuringBackup) {
 
   FillDB(db_.get(), 0, keys_iteration);
   std::atomic<bool> corrupted{false};
-  // corrupt files when copying to the backup directory
-  SyncPoint::GetInstance()->SetCallBack(
-      "BackupEngineImpl::CopyOrCreateFile:CorruptionDuringBackup",
-      [&](void* data) {
-        if (data != nullptr) {
-          Slice* d = reinterpret_cast<Slice*>(data);
-          if (!d->empty()) {
-            d->remove_suffix(1);
-            corrupted = true;
-          }
+  // corrupt files when copying to the backup directory, whole or in chunks
+  for (const char* point :
+       {"BackupEngineImpl::CopyOrCreateFile:CorruptionDuringBackup",
+        "BackupEngineImpl::CopyChunks:CorruptionDuringBackup"}) {
+    SyncPoint::GetInstance()->SetCallBack(point, [&](void* data) {
+      if (data != nullptr) {
+        Slice* d = reinterpret_cast<Slice*>(data);
+        if (!d->empty()) {
+          d->remove_suffix(1);
+          corrupted = true;
         }
-      });
+      }
+    });
+  }
   SyncPoint::GetInstance()->EnableProcessing();
   Status s = backup_engine_->CreateNewBackup(db_.get());
   if (corrupted) {
@@ -1456,20 +1458,26 @@ TEST_F(BackupableDBTest, TableFileWithoutDbChecksumCorruptedDuringBackup) {
 TEST_F(BackupableDBTest, TableFileWithDbChecksumCorruptedDuringBackup) {
   const int keys_iteration = 50000;
   options_.file_checksum_gen_factory = GetFileChecksumGenCrc32cFactory();
-  for (auto& sopt : kAllShareOptions) {
-    // Since the default DB table file checksum is on, we obtain checksums of
-    // table files from the DB manifest before copying and verify it with the
-    // one calculated during copying.
-    // Therefore, we can test whether a corruption has happened during the file
-    // being copied to backup directory.
-    OpenDBAndBackupEngine(true /* destroy_old_data */, false /* dummy */, sopt);
-
-    FillDB(db_.get(), 0, keys_iteration);
-
-    // corrupt files when copying to the backup directory
-    SyncPoint::GetInstance()->SetCallBack(
-        "BackupEngineImpl::CopyOrCreateFile:CorruptionDuringBackup",
-        [&](void* data) {
+  // Also corrupt the files when they are copied in parallel chunks
+  backupable_options_->max_background_operations = 4;
+  for (uint64_t chunk_size : {uint64_t{0}, uint64_t{4096}}) {
+    backupable_options_->parallel_copy_chunk_size = chunk_size;
+    for (auto& sopt : kAllShareOptions) {
+      // Since the default DB table file checksum is on, we obtain checksums of
+      // table files from the DB manifest before copying and verify it with the
+      // one calculated during copying.
+      // Therefore, we can test whether a corruption has happened during the
+      // file being copied to backup directory.
+      OpenDBAndBackupEngine(true /* destroy_old_data */, false /* dummy */,
+                            sopt);
+
+      FillDB(db_.get(), 0, keys_iteration);
+
+      // corrupt files when copying to the backup directory, whole or in chunks
+      for (const char* point :
+           {"BackupEngineImpl::CopyOrCreateFile:CorruptionDuringBackup",
+            "BackupEngineImpl::CopyChunks:CorruptionDuringBackup"}) {
+        SyncPoint::GetInstance()->SetCallBack(point, [&](void* data) {
           if (data != nullptr) {
             Slice* d = reinterpret_cast<Slice*>(data);
             if (!d->empty()) {
@@ -1477,19 +1485,21 @@ TEST_F(BackupableDBTest, TableFileWithDbChecksumCorruptedDuringBackup) {
             }
           }
         });
-    SyncPoint::GetInstance()->EnableProcessing();
-    // The only case that we can't detect a corruption is when the file
-    // being backed up is empty. But as keys_iteration is large, such
-    // a case shouldn't have happened and we should be able to detect
-    // the corruption.
-    ASSERT_NOK(backup_engine_->CreateNewBackup(db_.get()));
+      }
+      SyncPoint::GetInstance()->EnableProcessing();
+      // The only case that we can't detect a corruption is when the file
+      // being backed up is empty. But as keys_iteration is large, such
+      // a case shouldn't have happened and we should be able to detect
+      // the corruption.
+      ASSERT_NOK(backup_engine_->CreateNewBackup(db_.get()));
 
-    SyncPoint::GetInstance()->DisableProcessing();
-    SyncPoint::GetInstance()->ClearAllCallBacks();
+      SyncPoint::GetInstance()->DisableProcessing();
+      SyncPoint::GetInstance()->ClearAllCallBacks();
 
-    CloseDBAndBackupEngine();
-    // delete old files in db
-    ASSERT_OK(DestroyDB(dbname_, options_));
+      CloseDBAndBackupEngine();
+      // delete old files in db
+      ASSERT_OK(DestroyDB(dbname_, options_));
+    }
   }
 }
 
@@ -2449,6 +2459,40 @@ TEST_P(BackupableDBRateLimitingTestWithParam, RateLimiting) {
   AssertBackupConsistency(0, 0, 100000, 100010);
 }
 
+TEST_F(BackupableDBTest, ParallelChunkedCopy) {
+  for (ShareOption share : kAllShareOptions) {
+    DestroyDB(dbname_, Options());
+    backupable_options_->max_background_operations = 4;
+    backupable_options_->parallel_copy_chunk_size = 4096;
+    options_.compression = kNoCompression;
+    OpenDBAndBackupEngine(true /* destroy_old_data */, false /* dummy */,
+                          share);
+    FillDB(db_.get(), 0, 10000);
+
+    std::atomic<int> num_split_files{0};
+    SyncPoint::GetInstance()->SetCallBack(
+        "BackupEngineImpl::CopyFileInChunks:Split",
+        [&](void* /*arg*/) { ++num_split_files; });
+    SyncPoint::GetInstance()->EnableProcessing();
+
+    ASSERT_OK(backup_engine_->CreateNewBackup(db_.get(), true));
+    ASSERT_GT(num_split_files.load(), 0);
+    // The combined chunk checksums must match those read back in one piece
+    ASSERT_OK(backup_engine_->VerifyBackup(1, true /* verify_with_checksum */));
+    CloseDBAndBackupEngine();
+
+    num_split_files = 0;
+    OpenBackupEngine();
+    ASSERT_OK(backup_engine_->RestoreDBFromLatestBackup(dbname_, dbname_));
+    ASSERT_GT(num_split_files.load(), 0);
+    CloseBackupEngine();
+
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+    AssertBackupConsistency(1, 0, 10000, 20000);
+  }
+}
+
 TEST_F(BackupableDBTest, ReadOnlyBackupEngine) {
   DestroyDB(dbname_, options_);
   OpenDBAndBackupEngine(true);
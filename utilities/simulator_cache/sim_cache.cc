@@ -162,6 +162,10 @@ class SimCacheImpl : public SimCache {
         stats_(nullptr) {}
 
   ~SimCacheImpl() override {}
+
+  using Cache::Insert;
+  using Cache::Lookup;
+
   void SetCapacity(size_t capacity) override { cache_->SetCapacity(capacity); }
 
   void SetStrictCapacityLimit(bool strict_capacity_limit) override {
@@ -7,6 +7,7 @@
 
 #include "utilities/transactions/lock/lock_manager.h"
 
+#include "utilities/transactions/lock/point/per_key_point_lock_manager.h"
 #include "utilities/transactions/lock/point/point_lock_manager.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -14,7 +15,9 @@ namespace ROCKSDB_NAMESPACE {
 LockManager* NewLockManager(PessimisticTransactionDB* db,
                             const TransactionDBOptions& opt) {
   assert(db);
-  // TODO: determine the lock manager implementation based on configuration.
+  if (opt.use_per_key_point_lock_mgr) {
+    return new PerKeyPointLockManager(db, opt);
+  }
   return new PointLockManager(db, opt);
 }
 
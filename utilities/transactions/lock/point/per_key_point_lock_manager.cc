@@ -0,0 +1,818 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include "utilities/transactions/lock/point/per_key_point_lock_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+
+#include "monitoring/perf_context_imp.h"
+#include "port/port.h"
+#include "rocksdb/slice.h"
+#include "test_util/sync_point.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+#include "utilities/transactions/pessimistic_transaction_db.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A transaction waiting for a key, queued in the KeyLock of the key.
+struct KeyLockWaiter {
+  KeyLockWaiter(TransactionID id, bool ex, bool detect)
+      : txn_id(id), exclusive(ex), deadlock_detect(detect) {}
+
+  void Notify() {
+    std::lock_guard<std::mutex> lock(mutex);
+    notified = true;
+    cv.notify_one();
+  }
+
+  // Waits until notified, or until end_time in microseconds according to
+  // env->NowMicros() if it is not negative. Returns false on timeout.
+  bool Wait(Env* env, int64_t end_time) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (end_time < 0) {
+      cv.wait(lock, [this] { return notified; });
+    } else {
+      uint64_t now = env->NowMicros();
+      if (static_cast<uint64_t>(end_time) > now) {
+        cv.wait_for(lock, std::chrono::microseconds(end_time - now),
+                    [this] { return notified; });
+      }
+    }
+    bool result = notified;
+    notified = false;
+    return result;
+  }
+
+  const TransactionID txn_id;
+  const bool exclusive;
+  const bool deadlock_detect;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool notified = false;
+};
+
+// The lock of a key, present in its bucket as long as the key is locked or
+// waited for.
+struct KeyLock {
+  bool exclusive = false;
+  // The transactions holding the lock, empty if the key is only waited for
+  autovector<TransactionID> txn_ids;
+
+  // Transaction locks are not valid after this time in us
+  uint64_t expiration_time = 0;
+
+  // In arrival order
+  std::vector<KeyLockWaiter*> waiters;
+
+  // Whether the lock can be granted to the waiter right away, ignoring the
+  // expiration of the holders.
+  bool CanGrant(const KeyLockWaiter& waiter) const {
+    if (txn_ids.empty()) {
+      return true;
+    }
+    if (txn_ids.size() == 1 && txn_ids[0] == waiter.txn_id) {
+      return true;
+    }
+    return !exclusive && !waiter.exclusive;
+  }
+
+  // Wakes the waiters at the front of the queue that the lock can be granted
+  // to: the first one, and the shared ones following it if it is shared. A
+  // holder waiting to upgrade its lock is not queued behind the others, and
+  // is woken once it is the only holder left.
+  void WakeFront() {
+    for (size_t i = 0; i < waiters.size(); i++) {
+      KeyLockWaiter* waiter = waiters[i];
+      if ((i > 0 && waiter->exclusive) || !CanGrant(*waiter)) {
+        break;
+      }
+      waiter->Notify();
+      if (waiter->exclusive) {
+        break;
+      }
+    }
+    if (txn_ids.size() == 1) {
+      for (KeyLockWaiter* waiter : waiters) {
+        if (waiter->txn_id == txn_ids[0]) {
+          waiter->Notify();
+          break;
+        }
+      }
+    }
+  }
+};
+
+struct ALIGN_AS(CACHE_LINE_SIZE) KeyLockBucket {
+  // Only held while updating the locks of the keys, never while waiting
+  SpinMutex mutex;
+  std::unordered_map<std::string, KeyLock> keys;
+};
+
+// The locks of the keys of a column family
+struct KeyLockTable {
+  explicit KeyLockTable(size_t num_buckets) : num_buckets_(num_buckets) {
+    assert(num_buckets_ > 0);
+    buckets_ = reinterpret_cast<KeyLockBucket*>(
+        port::cacheline_aligned_alloc(sizeof(KeyLockBucket) * num_buckets_));
+    for (size_t i = 0; i < num_buckets_; i++) {
+      new (&buckets_[i]) KeyLockBucket();
+    }
+  }
+
+  ~KeyLockTable() {
+    for (size_t i = 0; i < num_buckets_; i++) {
+      buckets_[i].~KeyLockBucket();
+    }
+    port::cacheline_aligned_free(buckets_);
+  }
+
+  KeyLockBucket* GetBucket(const std::string& key) const {
+    return &buckets_[FastRange64(GetSliceNPHash64(key), num_buckets_)];
+  }
+
+  const size_t num_buckets_;
+
+  // Count of keys that are currently locked in this column family.
+  // (Only maintained if PerKeyPointLockManager::max_num_locks_ is positive.)
+  std::atomic<int64_t> lock_cnt{0};
+
+  KeyLockBucket* buckets_;
+};
+
+namespace {
+void UnrefLockTablesCache(void* ptr) {
+  // Called when a thread exits or a ThreadLocalPtr gets destroyed.
+  auto lock_tables_cache = static_cast<
+      std::unordered_map<uint32_t, std::shared_ptr<KeyLockTable>>*>(ptr);
+  delete lock_tables_cache;
+}
+
+// The buckets of a column family per stripe of PointLockManager, since the
+// buckets are only locked briefly and much smaller than a stripe.
+const size_t kBucketsPerStripe = 64;
+}  // anonymous namespace
+
+constexpr size_t PerKeyPointLockManager::kNumWaitShards;
+
+PerKeyPointLockManager::PerKeyPointLockManager(
+    PessimisticTransactionDB* txn_db, const TransactionDBOptions& opt)
+    : txn_db_impl_(txn_db),
+      num_buckets_(std::max(opt.num_stripes, static_cast<size_t>(1)) *
+                   kBucketsPerStripe),
+      max_num_locks_(opt.max_num_locks),
+      lock_tables_cache_(new ThreadLocalPtr(&UnrefLockTablesCache)),
+      dlock_buffer_(opt.max_num_deadlocks) {}
+
+PerKeyPointLockManager::~PerKeyPointLockManager() {}
+
+void PerKeyPointLockManager::AddColumnFamily(const ColumnFamilyHandle* cf) {
+  InstrumentedMutexLock l(&lock_table_mutex_);
+
+  if (lock_tables_.find(cf->GetID()) == lock_tables_.end()) {
+    lock_tables_.emplace(cf->GetID(),
+                         std::make_shared<KeyLockTable>(num_buckets_));
+  } else {
+    // column_family already exists in lock map
+    assert(false);
+  }
+}
+
+void PerKeyPointLockManager::RemoveColumnFamily(const ColumnFamilyHandle* cf) {
+  // Remove the lock table of this column family.  Since it is stored as a
+  // shared ptr, concurrent transactions can still keep using it until they
+  // release their references to it.
+  {
+    InstrumentedMutexLock l(&lock_table_mutex_);
+
+    auto lock_tables_iter = lock_tables_.find(cf->GetID());
+    if (lock_tables_iter == lock_tables_.end()) {
+      return;
+    }
+
+    lock_tables_.erase(lock_tables_iter);
+  }  // lock_table_mutex_
+
+  // Clear all thread-local caches
+  autovector<void*> local_caches;
+  lock_tables_cache_->Scrape(&local_caches, nullptr);
+  for (auto cache : local_caches) {
+    delete static_cast<LockTables*>(cache);
+  }
+}
+
+// Look up the KeyLockTable std::shared_ptr for a given column_family_id.
+// Note:  The KeyLockTable is only valid as long as the caller is still
+//   holding on to the returned std::shared_ptr.
+std::shared_ptr<KeyLockTable> PerKeyPointLockManager::GetLockTable(
+    ColumnFamilyId column_family_id) {
+  // First check thread-local cache
+  if (lock_tables_cache_->Get() == nullptr) {
+    lock_tables_cache_->Reset(new LockTables());
+  }
+
+  auto lock_tables_cache = static_cast<LockTables*>(lock_tables_cache_->Get());
+
+  auto lock_table_iter = lock_tables_cache->find(column_family_id);
+  if (lock_table_iter != lock_tables_cache->end()) {
+    // Found lock table for this column family.
+    return lock_table_iter->second;
+  }
+
+  // Not found in local cache, grab mutex and check shared LockTables
+  InstrumentedMutexLock l(&lock_table_mutex_);
+
+  lock_table_iter = lock_tables_.find(column_family_id);
+  if (lock_table_iter == lock_tables_.end()) {
+    return std::shared_ptr<KeyLockTable>(nullptr);
+  } else {
+    // Found lock table.  Store in thread-local cache and return.
+    std::shared_ptr<KeyLockTable>& lock_table = lock_table_iter->second;
+    lock_tables_cache->insert({column_family_id, lock_table});
+
+    return lock_table;
+  }
+}
+
+// Returns true if this lock has expired and can be acquired by another
+// transaction.
+// If false, sets *expire_time to the expiration time of the lock according
+// to Env->GetMicros() or 0 if no expiration.
+bool PerKeyPointLockManager::IsLockExpired(TransactionID txn_id,
+                                           const KeyLock& lock, Env* env,
+                                           uint64_t* expire_time) {
+  if (lock.expiration_time == 0) {
+    *expire_time = 0;
+    return false;
+  }
+
+  auto now = env->NowMicros();
+  bool expired = lock.expiration_time <= now;
+  if (!expired) {
+    // return how many microseconds until lock will be expired
+    *expire_time = lock.expiration_time;
+  } else {
+    for (auto id : lock.txn_ids) {
+      if (txn_id == id) {
+        continue;
+      }
+
+      bool success = txn_db_impl_->TryStealingExpiredTransactionLocks(id);
+      if (!success) {
+        expired = false;
+        *expire_time = 0;
+        break;
+      }
+    }
+  }
+
+  return expired;
+}
+
+Status PerKeyPointLockManager::TryLock(PessimisticTransaction* txn,
+                                       ColumnFamilyId column_family_id,
+                                       const std::string& key, Env* env,
+                                       bool exclusive) {
+  // Lookup lock table for this column family id
+  std::shared_ptr<KeyLockTable> lock_table_ptr = GetLockTable(column_family_id);
+  KeyLockTable* lock_table = lock_table_ptr.get();
+  if (lock_table == nullptr) {
+    char msg[255];
+    snprintf(msg, sizeof(msg), "Column family id not found: %" PRIu32,
+             column_family_id);
+
+    return Status::InvalidArgument(msg);
+  }
+
+  return AcquireWithTimeout(txn, lock_table, column_family_id, key, env,
+                            txn->GetLockTimeout(), exclusive);
+}
+
+// Helper function for TryLock().
+Status PerKeyPointLockManager::AcquireWithTimeout(
+    PessimisticTransaction* txn, KeyLockTable* lock_table,
+    ColumnFamilyId column_family_id, const std::string& key, Env* env,
+    int64_t timeout, bool exclusive) {
+  const TransactionID txn_id = txn->GetID();
+  const uint64_t expiration_time = txn->GetExpirationTime();
+  uint64_t end_time = 0;
+
+  if (timeout > 0) {
+    uint64_t start_time = env->NowMicros();
+    end_time = start_time + timeout;
+  }
+
+  KeyLockBucket* bucket = lock_table->GetBucket(key);
+  std::unique_lock<SpinMutex> bucket_lock(bucket->mutex);
+  KeyLock* lock = &bucket->keys[key];
+
+  // Acquire lock if we are able to
+  uint64_t expire_time_hint = 0;
+  autovector<TransactionID> wait_ids;
+  Status result =
+      AcquireLocked(lock_table, lock, /*waiter=*/nullptr, txn_id,
+                    expiration_time, exclusive, env, &expire_time_hint,
+                    &wait_ids);
+
+  if (!result.ok() && !result.IsBusy() && timeout != 0) {
+    PERF_TIMER_GUARD(key_lock_wait_time);
+    PERF_COUNTER_ADD(key_lock_wait_count, 1);
+    // If we weren't able to acquire the lock, we will wait in the queue of
+    // the key and keep retrying as long as the timeout allows.
+    KeyLockWaiter waiter(txn_id, exclusive, txn->IsDeadlockDetect());
+    lock->waiters.push_back(&waiter);
+    bool timed_out = false;
+    do {
+      // Decide how long to wait
+      int64_t cv_end_time = -1;
+      if (expire_time_hint > 0 && end_time > 0) {
+        cv_end_time = std::min(expire_time_hint, end_time);
+      } else if (expire_time_hint > 0) {
+        cv_end_time = expire_time_hint;
+      } else if (end_time > 0) {
+        cv_end_time = end_time;
+      }
+
+      assert(wait_ids.size() != 0);
+      // The edges are published before the bucket is unlocked, so that the
+      // transactions leaving the key remove themselves from them.
+      if (wait_ids.size() != 0 && txn->IsDeadlockDetect()) {
+        IncrementWaiters(txn, wait_ids, key, column_family_id, exclusive);
+      }
+      bucket_lock.unlock();
+
+      // We are dependent on a transaction to finish, so perform deadlock
+      // detection.
+      bool deadlock = false;
+      if (wait_ids.size() != 0) {
+        if (txn->IsDeadlockDetect()) {
+          deadlock = DetectDeadlock(txn, wait_ids, key, column_family_id,
+                                    exclusive, env);
+        }
+        if (!deadlock) {
+          txn->SetWaitingTxn(wait_ids, column_family_id, &key);
+        }
+      }
+
+      if (!deadlock) {
+        TEST_SYNC_POINT(
+            "PerKeyPointLockManager::AcquireWithTimeout:WaitingTxn");
+        // Even though we timed out, we will still make one more attempt to
+        // acquire lock below (it is possible the lock expired and we
+        // were never signaled).
+        timed_out = !waiter.Wait(env, cv_end_time);
+
+        if (wait_ids.size() != 0) {
+          txn->ClearWaitingTxn();
+          if (txn->IsDeadlockDetect()) {
+            DecrementWaiters(txn);
+          }
+        }
+      }
+
+      bucket_lock.lock();
+      // The lock of the key stays in its bucket while we are in its queue.
+      lock = &bucket->keys.find(key)->second;
+      if (deadlock) {
+        result = Status::Busy(Status::SubCode::kDeadlock);
+        break;
+      }
+      wait_ids.clear();
+      result = AcquireLocked(lock_table, lock, &waiter, txn_id,
+                             expiration_time, exclusive, env,
+                             &expire_time_hint, &wait_ids);
+    } while (!result.ok() && !result.IsBusy() && !timed_out);
+
+    auto waiter_iter =
+        std::find(lock->waiters.begin(), lock->waiters.end(), &waiter);
+    assert(waiter_iter != lock->waiters.end());
+    lock->waiters.erase(waiter_iter);
+    if (!result.ok() && std::find(lock->txn_ids.begin(), lock->txn_ids.end(),
+                                  txn_id) == lock->txn_ids.end()) {
+      // The waiters behind us no longer wait for us.
+      RemoveWaitee(*lock, txn_id);
+    }
+    if (!(result.ok() && exclusive)) {
+      // Pass on the wakeup we may have been given, or the place we gave up,
+      // to the waiters behind us.
+      lock->WakeFront();
+    } else if (lock->expiration_time > 0 && !lock->waiters.empty()) {
+      // The new first waiter times its wait by the expiration of our lock.
+      lock->waiters.front()->Notify();
+    }
+  }
+
+  if (lock->txn_ids.empty() && lock->waiters.empty()) {
+    bucket->keys.erase(key);
+  }
+
+  return result;
+}
+
+void PerKeyPointLockManager::DecrementWaiter(TransactionID wait_id) {
+  WaitShard& shard = GetWaitShard(wait_id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto iter = shard.num_waiters.find(wait_id);
+  assert(iter != shard.num_waiters.end());
+  if (--iter->second == 0) {
+    shard.num_waiters.erase(iter);
+  }
+}
+
+void PerKeyPointLockManager::DecrementWaiters(
+    const PessimisticTransaction* txn) {
+  auto id = txn->GetID();
+  // The edges may have been updated since they were published, so the ones
+  // in the graph are removed rather than those the transaction waited for.
+  autovector<TransactionID> wait_ids;
+  {
+    WaitShard& shard = GetWaitShard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.wait_txns.find(id);
+    assert(iter != shard.wait_txns.end());
+    wait_ids = std::move(iter->second.m_neighbors);
+    shard.wait_txns.erase(iter);
+  }
+
+  for (auto wait_id : wait_ids) {
+    DecrementWaiter(wait_id);
+  }
+}
+
+void PerKeyPointLockManager::IncrementWaiters(
+    const PessimisticTransaction* txn,
+    const autovector<TransactionID>& wait_ids, const std::string& key,
+    uint32_t cf_id, bool exclusive) {
+  auto id = txn->GetID();
+  {
+    WaitShard& shard = GetWaitShard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    assert(shard.wait_txns.count(id) == 0);
+    shard.wait_txns.emplace(id, TrackedTrxInfo{wait_ids, cf_id, exclusive, key});
+  }
+
+  for (auto wait_id : wait_ids) {
+    WaitShard& shard = GetWaitShard(wait_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.num_waiters[wait_id]++;
+  }
+}
+
+void PerKeyPointLockManager::RemoveWaitee(const KeyLock& lock,
+                                          TransactionID wait_id) {
+  for (KeyLockWaiter* waiter : lock.waiters) {
+    if (!waiter->deadlock_detect || waiter->txn_id == wait_id) {
+      continue;
+    }
+    bool removed = false;
+    {
+      WaitShard& shard = GetWaitShard(waiter->txn_id);
+      std::lock_guard<std::mutex> shard_lock(shard.mutex);
+      auto iter = shard.wait_txns.find(waiter->txn_id);
+      if (iter == shard.wait_txns.end()) {
+        // Not waiting at the moment, it will look at the key again first.
+        continue;
+      }
+      auto& neighbors = iter->second.m_neighbors;
+      auto it = std::find(neighbors.begin(), neighbors.end(), wait_id);
+      if (it != neighbors.end()) {
+        *it = neighbors.back();
+        neighbors.pop_back();
+        removed = true;
+      }
+    }
+    if (removed) {
+      DecrementWaiter(wait_id);
+    }
+  }
+}
+
+bool PerKeyPointLockManager::DetectDeadlock(
+    const PessimisticTransaction* txn,
+    const autovector<TransactionID>& wait_ids, const std::string& key,
+    uint32_t cf_id, bool exclusive, Env* const env) {
+  auto id = txn->GetID();
+  // No deadlock if nobody is waiting on self.
+  {
+    WaitShard& shard = GetWaitShard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.num_waiters.count(id) == 0) {
+      return false;
+    }
+  }
+
+  const int depth = txn->GetDeadlockDetectDepth();
+  std::vector<int> queue_parents(static_cast<size_t>(depth));
+  std::vector<TransactionID> queue_values(static_cast<size_t>(depth));
+  // The wait info of the transactions followed, as seen when followed
+  std::vector<TrackedTrxInfo> queue_infos(static_cast<size_t>(depth));
+  const auto* next_ids = &wait_ids;
+  int parent = -1;
+  int64_t deadlock_time = 0;
+  for (int tail = 0, head = 0; head < depth; head++) {
+    int i = 0;
+    if (next_ids) {
+      for (; i < static_cast<int>(next_ids->size()) && tail + i < depth; i++) {
+        queue_values[tail + i] = (*next_ids)[i];
+        queue_parents[tail + i] = parent;
+      }
+      tail += i;
+    }
+
+    // No more items in the list, meaning no deadlock.
+    if (tail == head) {
+      return false;
+    }
+
+    auto next = queue_values[head];
+    if (next == id) {
+      std::vector<DeadlockInfo> path;
+      path.push_back({id, cf_id, exclusive, key});
+      head = queue_parents[head];
+      while (head != -1) {
+        const TrackedTrxInfo& info = queue_infos[head];
+        path.push_back({queue_values[head], info.m_cf_id, info.m_exclusive,
+                        info.m_waiting_key});
+        head = queue_parents[head];
+      }
+      env->GetCurrentTime(&deadlock_time);
+      std::reverse(path.begin(), path.end());
+      dlock_buffer_.AddNewPath(DeadlockPath(path, deadlock_time));
+      DecrementWaiters(txn);
+      return true;
+    }
+
+    {
+      WaitShard& shard = GetWaitShard(next);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto iter = shard.wait_txns.find(next);
+      if (iter == shard.wait_txns.end()) {
+        next_ids = nullptr;
+        continue;
+      }
+      queue_infos[head] = iter->second;
+    }
+    parent = head;
+    next_ids = &queue_infos[head].m_neighbors;
+  }
+
+  // Wait cycle too big, just assume deadlock.
+  env->GetCurrentTime(&deadlock_time);
+  dlock_buffer_.AddNewPath(DeadlockPath(deadlock_time, true));
+  DecrementWaiters(txn);
+  return true;
+}
+
+// Try to lock this key after we have acquired the bucket mutex. The waiter
+// is the one of the transaction if it is in the queue of the key, and
+// nullptr for a new request, which queues behind all the waiters.
+// Sets *expire_time to the expiration time in microseconds
+//  or 0 if no expiration.
+// REQUIRED:  Bucket mutex must be held.
+Status PerKeyPointLockManager::AcquireLocked(
+    KeyLockTable* lock_table, KeyLock* lock, const KeyLockWaiter* waiter,
+    TransactionID txn_id, uint64_t expiration_time, bool exclusive, Env* env,
+    uint64_t* expire_time, autovector<TransactionID>* txn_ids) {
+  // The waiters in front of us that we conflict with take the key first. A
+  // holder does not wait for them, as they already wait for it.
+  autovector<TransactionID> waiters_ahead;
+  if (std::find(lock->txn_ids.begin(), lock->txn_ids.end(), txn_id) ==
+      lock->txn_ids.end()) {
+    for (const KeyLockWaiter* ahead : lock->waiters) {
+      if (ahead == waiter) {
+        break;
+      }
+      if (ahead->exclusive || exclusive) {
+        waiters_ahead.push_back(ahead->txn_id);
+      }
+    }
+  }
+
+  Status result;
+  if (!lock->txn_ids.empty()) {
+    // Lock already held
+    assert(lock->txn_ids.size() == 1 || !lock->exclusive);
+
+    if (lock->exclusive || exclusive) {
+      if (lock->txn_ids.size() == 1 && lock->txn_ids[0] == txn_id) {
+        // The list contains one txn and we're it, so just take it.
+        lock->exclusive = exclusive;
+        lock->expiration_time = expiration_time;
+      } else if (waiters_ahead.empty() &&
+                 IsLockExpired(txn_id, *lock, env, expire_time)) {
+        // Check if it's expired. Skips over txn_id in case it's there for a
+        // shared lock with multiple holders which was not caught in the
+        // first case.
+        // lock is expired, can steal it
+        autovector<TransactionID> expired_ids = lock->txn_ids;
+        lock->txn_ids.clear();
+        lock->txn_ids.push_back(txn_id);
+        lock->exclusive = exclusive;
+        lock->expiration_time = expiration_time;
+        // lock_cnt does not change
+        for (auto id : expired_ids) {
+          if (id != txn_id) {
+            RemoveWaitee(*lock, id);
+          }
+        }
+      } else {
+        result = Status::TimedOut(Status::SubCode::kLockTimeout);
+        *txn_ids = lock->txn_ids;
+        if (!waiters_ahead.empty()) {
+          // The expiration is looked at once we are first in line.
+          *expire_time = 0;
+        }
+      }
+    } else if (waiters_ahead.empty()) {
+      // We are requesting shared access to a shared lock, so just grant it.
+      if (std::find(lock->txn_ids.begin(), lock->txn_ids.end(), txn_id) ==
+          lock->txn_ids.end()) {
+        lock->txn_ids.push_back(txn_id);
+      }
+      // Using std::max means that expiration time never goes down even when
+      // a transaction is removed from the list.
+      lock->expiration_time =
+          std::max(lock->expiration_time, expiration_time);
+    } else {
+      result = Status::TimedOut(Status::SubCode::kLockTimeout);
+      *expire_time = 0;
+    }
+  } else if (!waiters_ahead.empty()) {
+    // Lock not held, but handed to the waiters in front of us.
+    result = Status::TimedOut(Status::SubCode::kLockTimeout);
+    *expire_time = 0;
+  } else {  // Lock not held.
+    // Check lock limit
+    if (max_num_locks_ > 0 &&
+        lock_table->lock_cnt.load(std::memory_order_acquire) >=
+            max_num_locks_) {
+      result = Status::Busy(Status::SubCode::kLockLimit);
+    } else {
+      // acquire lock
+      lock->txn_ids.push_back(txn_id);
+      lock->exclusive = exclusive;
+      lock->expiration_time = expiration_time;
+
+      // Maintain lock count if there is a limit on the number of locks
+      if (max_num_locks_ > 0) {
+        lock_table->lock_cnt++;
+      }
+    }
+  }
+
+  if (result.IsTimedOut()) {
+    for (auto id : waiters_ahead) {
+      // A holder waiting to upgrade its lock is already there
+      if (std::find(txn_ids->begin(), txn_ids->end(), id) == txn_ids->end()) {
+        txn_ids->push_back(id);
+      }
+    }
+  }
+  return result;
+}
+
+bool PerKeyPointLockManager::UnLockKey(PessimisticTransaction* txn,
+                                       KeyLockTable* lock_table,
+                                       KeyLock* lock) {
+  auto& txns = lock->txn_ids;
+  auto txn_it = std::find(txns.begin(), txns.end(), txn->GetID());
+  if (txn_it == txns.end()) {
+    // This key is locked by someone else.  This should only happen if the
+    // unlocking transaction has expired.
+    return false;
+  }
+
+  // Found the key we locked.  unlock it.
+  auto last_it = txns.end() - 1;
+  if (txn_it != last_it) {
+    *txn_it = *last_it;
+  }
+  txns.pop_back();
+
+  if (txns.empty() && max_num_locks_ > 0) {
+    // Maintain lock count if there is a limit on the number of locks.
+    assert(lock_table->lock_cnt.load(std::memory_order_relaxed) > 0);
+    lock_table->lock_cnt--;
+  }
+
+  // The waiters no longer wait for us, and the ones that can now take the
+  // lock are signaled.
+  RemoveWaitee(*lock, txn->GetID());
+  lock->WakeFront();
+  return txns.empty() && lock->waiters.empty();
+}
+
+void PerKeyPointLockManager::UnLock(PessimisticTransaction* txn,
+                                    ColumnFamilyId column_family_id,
+                                    const std::string& key, Env* env) {
+#ifdef NDEBUG
+  (void)env;
+#endif
+  std::shared_ptr<KeyLockTable> lock_table_ptr = GetLockTable(column_family_id);
+  KeyLockTable* lock_table = lock_table_ptr.get();
+  if (lock_table == nullptr) {
+    // Column Family must have been dropped.
+    return;
+  }
+
+  KeyLockBucket* bucket = lock_table->GetBucket(key);
+  std::lock_guard<SpinMutex> bucket_lock(bucket->mutex);
+  auto iter = bucket->keys.find(key);
+  if (iter == bucket->keys.end()) {
+    // This key is not locked.  This should only happen if the unlocking
+    // transaction has expired.
+    assert(txn->GetExpirationTime() > 0 &&
+           txn->GetExpirationTime() < env->NowMicros());
+    return;
+  }
+  if (UnLockKey(txn, lock_table, &iter->second)) {
+    bucket->keys.erase(iter);
+  }
+}
+
+void PerKeyPointLockManager::UnLock(PessimisticTransaction* txn,
+                                    const LockTracker& tracker, Env* env) {
+  std::unique_ptr<LockTracker::ColumnFamilyIterator> cf_it(
+      tracker.GetColumnFamilyIterator());
+  assert(cf_it != nullptr);
+  while (cf_it->HasNext()) {
+    ColumnFamilyId cf = cf_it->Next();
+    std::unique_ptr<LockTracker::KeyIterator> key_it(
+        tracker.GetKeyIterator(cf));
+    assert(key_it != nullptr);
+    while (key_it->HasNext()) {
+      UnLock(txn, cf, key_it->Next(), env);
+    }
+  }
+}
+
+PerKeyPointLockManager::PointLockStatus
+PerKeyPointLockManager::GetPointLockStatus() {
+  PointLockStatus data;
+  InstrumentedMutexLock l(&lock_table_mutex_);
+
+  for (const auto& table : lock_tables_) {
+    const KeyLockTable& lock_table = *table.second;
+    // The buckets are copied one at a time, so that this does not stop all
+    // the transactions.
+    for (size_t i = 0; i < lock_table.num_buckets_; i++) {
+      KeyLockBucket& bucket = lock_table.buckets_[i];
+      std::lock_guard<SpinMutex> bucket_lock(bucket.mutex);
+      for (const auto& it : bucket.keys) {
+        if (it.second.txn_ids.empty()) {
+          continue;
+        }
+        struct KeyLockInfo info;
+        info.exclusive = it.second.exclusive;
+        info.key = it.first;
+        for (const auto& id : it.second.txn_ids) {
+          info.ids.push_back(id);
+        }
+        data.insert({table.first, info});
+      }
+    }
+  }
+
+  return data;
+}
+
+std::vector<DeadlockPath> PerKeyPointLockManager::GetDeadlockInfoBuffer() {
+  return dlock_buffer_.PrepareBuffer();
+}
+
+void PerKeyPointLockManager::Resize(uint32_t target_size) {
+  dlock_buffer_.Resize(target_size);
+}
+
+PerKeyPointLockManager::RangeLockStatus
+PerKeyPointLockManager::GetRangeLockStatus() {
+  return {};
+}
+
+Status PerKeyPointLockManager::TryLock(PessimisticTransaction* /* txn */,
+                                       ColumnFamilyId /* cf_id */,
+                                       const Endpoint& /* start */,
+                                       const Endpoint& /* end */,
+                                       Env* /* env */, bool /* exclusive */) {
+  return Status::NotSupported(
+      "PerKeyPointLockManager does not support range locking");
+}
+
+void PerKeyPointLockManager::UnLock(PessimisticTransaction* /* txn */,
+                                    ColumnFamilyId /* cf_id */,
+                                    const Endpoint& /* start */,
+                                    const Endpoint& /* end */,
+                                    Env* /* env */) {
+  // no-op
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,172 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "monitoring/instrumented_mutex.h"
+#include "rocksdb/utilities/transaction.h"
+#include "util/autovector.h"
+#include "util/thread_local.h"
+#include "utilities/transactions/lock/lock_manager.h"
+#include "utilities/transactions/lock/point/point_lock_manager.h"
+#include "utilities/transactions/lock/point/point_lock_tracker.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct KeyLock;
+struct KeyLockTable;
+struct KeyLockWaiter;
+
+// A point lock manager for workloads where many transactions contend for the
+// same few keys, selected by TransactionDBOptions::use_per_key_point_lock_mgr.
+//
+// Unlike PointLockManager, no mutex is held while a transaction waits for a
+// lock. The keys of a column family are spread over many buckets, each
+// guarded by a spin lock that is only held to update the locks of its keys.
+// Every locked key has its own FIFO queue of waiters: a transaction does not
+// take a lock ahead of the waiters it conflicts with, unless it already holds
+// the lock. Releasing a lock only wakes the waiters at the front of the queue
+// of that key, instead of all the waiters of a stripe.
+//
+// The wait-for graph of deadlock detection is split into shards by waiting
+// transaction, each with its own mutex, and a detection only holds one of
+// them at a time while following the graph. A transaction publishes the
+// transactions it waits for before following the graph, so that of the
+// transactions closing a cycle at the same time, at least one sees it. The
+// waiters are not woken to follow the changes of the holders: a transaction
+// releasing a key, or giving up on it, removes itself from the edges of the
+// waiters of the key.
+class PerKeyPointLockManager : public LockManager {
+ public:
+  PerKeyPointLockManager(PessimisticTransactionDB* db,
+                         const TransactionDBOptions& opt);
+  // No copying allowed
+  PerKeyPointLockManager(const PerKeyPointLockManager&) = delete;
+  PerKeyPointLockManager& operator=(const PerKeyPointLockManager&) = delete;
+
+  ~PerKeyPointLockManager() override;
+
+  bool IsPointLockSupported() const override { return true; }
+
+  bool IsRangeLockSupported() const override { return false; }
+
+  const LockTrackerFactory& GetLockTrackerFactory() const override {
+    return PointLockTrackerFactory::Get();
+  }
+
+  void AddColumnFamily(const ColumnFamilyHandle* cf) override;
+  void RemoveColumnFamily(const ColumnFamilyHandle* cf) override;
+
+  Status TryLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+                 const std::string& key, Env* env, bool exclusive) override;
+  Status TryLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+                 const Endpoint& start, const Endpoint& end, Env* env,
+                 bool exclusive) override;
+
+  void UnLock(PessimisticTransaction* txn, const LockTracker& tracker,
+              Env* env) override;
+  void UnLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+              const std::string& key, Env* env) override;
+  void UnLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+              const Endpoint& start, const Endpoint& end, Env* env) override;
+
+  PointLockStatus GetPointLockStatus() override;
+
+  RangeLockStatus GetRangeLockStatus() override;
+
+  std::vector<DeadlockPath> GetDeadlockInfoBuffer() override;
+
+  void Resize(uint32_t new_size) override;
+
+ private:
+  // A shard of the wait-for graph
+  struct WaitShard {
+    std::mutex mutex;
+    // Maps from waiter -> waitees.
+    std::unordered_map<TransactionID, TrackedTrxInfo> wait_txns;
+    // Maps from waitee -> number of waiters.
+    std::unordered_map<TransactionID, int> num_waiters;
+  };
+
+  static constexpr size_t kNumWaitShards = 64;
+
+  PessimisticTransactionDB* txn_db_impl_;
+
+  // Number of buckets of the lock table of each column family
+  const size_t num_buckets_;
+
+  // Limit on number of keys locked per column family
+  const int64_t max_num_locks_;
+
+  // Must be held when accessing/modifying lock_tables_.
+  InstrumentedMutex lock_table_mutex_;
+
+  // Map of ColumnFamilyId to locked key info
+  using LockTables = std::unordered_map<uint32_t, std::shared_ptr<KeyLockTable>>;
+  LockTables lock_tables_;
+
+  // Thread-local cache of entries in lock_tables_.  This is an optimization
+  // to avoid acquiring a mutex in order to look up a KeyLockTable
+  std::unique_ptr<ThreadLocalPtr> lock_tables_cache_;
+
+  WaitShard wait_shards_[kNumWaitShards];
+  DeadlockInfoBuffer dlock_buffer_;
+
+  WaitShard& GetWaitShard(TransactionID id) {
+    return wait_shards_[id % kNumWaitShards];
+  }
+
+  bool IsLockExpired(TransactionID txn_id, const KeyLock& lock, Env* env,
+                     uint64_t* expire_time);
+
+  std::shared_ptr<KeyLockTable> GetLockTable(uint32_t column_family_id);
+
+  Status AcquireWithTimeout(PessimisticTransaction* txn,
+                            KeyLockTable* lock_table, uint32_t column_family_id,
+                            const std::string& key, Env* env, int64_t timeout,
+                            bool exclusive);
+
+  Status AcquireLocked(KeyLockTable* lock_table, KeyLock* lock,
+                       const KeyLockWaiter* waiter, TransactionID txn_id,
+                       uint64_t expiration_time, bool exclusive, Env* env,
+                       uint64_t* expire_time,
+                       autovector<TransactionID>* txn_ids);
+
+  // Returns true if the key has no holder and no waiter left, so that it can
+  // be removed from its bucket.
+  bool UnLockKey(PessimisticTransaction* txn, KeyLockTable* lock_table,
+                 KeyLock* lock);
+
+  // Publishes the edges of txn in the wait-for graph.
+  // REQUIRED: the mutex of the bucket of the key must be held.
+  void IncrementWaiters(const PessimisticTransaction* txn,
+                        const autovector<TransactionID>& wait_ids,
+                        const std::string& key, uint32_t cf_id,
+                        bool exclusive);
+  // Removes the edges of txn from the wait-for graph.
+  void DecrementWaiters(const PessimisticTransaction* txn);
+  void DecrementWaiter(TransactionID wait_id);
+  // Removes the edges from the waiters of the key to wait_id, which neither
+  // holds the key nor waits for it any longer.
+  // REQUIRED: the mutex of the bucket of the key must be held.
+  void RemoveWaitee(const KeyLock& lock, TransactionID wait_id);
+  // Follows the edges published by IncrementWaiters(), and removes them if
+  // they close a cycle.
+  bool DetectDeadlock(const PessimisticTransaction* txn,
+                      const autovector<TransactionID>& wait_ids,
+                      const std::string& key, uint32_t cf_id, bool exclusive,
+                      Env* const env);
+};
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -13,6 +13,7 @@
 #include "rocksdb/utilities/transaction_db.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
+#include "utilities/transactions/lock/point/per_key_point_lock_manager.h"
 #include "utilities/transactions/pessimistic_transaction_db.h"
 #include "utilities/transactions/transaction_db_mutex_impl.h"
 
@@ -39,7 +40,9 @@ class MockColumnFamilyHandle : public ColumnFamilyHandle {
   std::string name_ = "MockCF";
 };
 
-class PointLockManagerTest : public testing::Test {
+// The parameter tells whether to test PerKeyPointLockManager instead of
+// PointLockManager.
+class PointLockManagerTest : public testing::TestWithParam<bool> {
  public:
   void SetUp() override {
     env_ = Env::Default();
@@ -54,8 +57,12 @@ class PointLockManagerTest : public testing::Test {
     txn_opt.custom_mutex_factory = mutex_factory_;
     ASSERT_OK(TransactionDB::Open(opt, txn_opt, db_dir_, &db_));
 
-    locker_.reset(new PointLockManager(
-        static_cast<PessimisticTransactionDB*>(db_), txn_opt));
+    auto txn_db = static_cast<PessimisticTransactionDB*>(db_);
+    if (GetParam()) {
+      locker_.reset(new PerKeyPointLockManager(txn_db, txn_opt));
+    } else {
+      locker_.reset(new PointLockManager(txn_db, txn_opt));
+    }
   }
 
   void TearDown() override {
@@ -71,7 +78,7 @@ class PointLockManagerTest : public testing::Test {
 
  protected:
   Env* env_;
-  std::unique_ptr<PointLockManager> locker_;
+  std::unique_ptr<LockManager> locker_;
 
  private:
   std::string db_dir_;
@@ -79,7 +86,7 @@ class PointLockManagerTest : public testing::Test {
   TransactionDB* db_;
 };
 
-TEST_F(PointLockManagerTest, LockNonExistingColumnFamily) {
+TEST_P(PointLockManagerTest, LockNonExistingColumnFamily) {
   MockColumnFamilyHandle cf(1024);
   locker_->RemoveColumnFamily(&cf);
   auto txn = NewTxn();
@@ -89,7 +96,7 @@ TEST_F(PointLockManagerTest, LockNonExistingColumnFamily) {
   delete txn;
 }
 
-TEST_F(PointLockManagerTest, LockStatus) {
+TEST_P(PointLockManagerTest, LockStatus) {
   MockColumnFamilyHandle cf1(1024), cf2(2048);
   locker_->AddColumnFamily(&cf1);
   locker_->AddColumnFamily(&cf2);
@@ -125,7 +132,7 @@ TEST_F(PointLockManagerTest, LockStatus) {
   delete txn2;
 }
 
-TEST_F(PointLockManagerTest, UnlockExclusive) {
+TEST_P(PointLockManagerTest, UnlockExclusive) {
   MockColumnFamilyHandle cf(1);
   locker_->AddColumnFamily(&cf);
 
@@ -140,7 +147,7 @@ TEST_F(PointLockManagerTest, UnlockExclusive) {
   delete txn2;
 }
 
-TEST_F(PointLockManagerTest, UnlockShared) {
+TEST_P(PointLockManagerTest, UnlockShared) {
   MockColumnFamilyHandle cf(1);
   locker_->AddColumnFamily(&cf);
 
@@ -155,7 +162,7 @@ TEST_F(PointLockManagerTest, UnlockShared) {
   delete txn2;
 }
 
-TEST_F(PointLockManagerTest, ReentrantExclusiveLock) {
+TEST_P(PointLockManagerTest, ReentrantExclusiveLock) {
   // Tests that a txn can acquire exclusive lock on the same key repeatedly.
   MockColumnFamilyHandle cf(1);
   locker_->AddColumnFamily(&cf);
@@ -165,7 +172,7 @@ TEST_F(PointLockManagerTest, ReentrantExclusiveLock) {
   delete txn;
 }
 
-TEST_F(PointLockManagerTest, ReentrantSharedLock) {
+TEST_P(PointLockManagerTest, ReentrantSharedLock) {
   // Tests that a txn can acquire shared lock on the same key repeatedly.
   MockColumnFamilyHandle cf(1);
   locker_->AddColumnFamily(&cf);
@@ -175,7 +182,7 @@ TEST_F(PointLockManagerTest, ReentrantSharedLock) {
   delete txn;
 }
 
-TEST_F(PointLockManagerTest, LockUpgrade) {
+TEST_P(PointLockManagerTest, LockUpgrade) {
   // Tests that a txn can upgrade from a shared lock to an exclusive lock.
   MockColumnFamilyHandle cf(1);
   locker_->AddColumnFamily(&cf);
@@ -185,7 +192,7 @@ TEST_F(PointLockManagerTest, LockUpgrade) {
   delete txn;
 }
 
-TEST_F(PointLockManagerTest, LockDowngrade) {
+TEST_P(PointLockManagerTest, LockDowngrade) {
   // Tests that a txn can acquire a shared lock after acquiring an exclusive
   // lock on the same key.
   MockColumnFamilyHandle cf(1);
@@ -196,7 +203,7 @@ TEST_F(PointLockManagerTest, LockDowngrade) {
   delete txn;
 }
 
-TEST_F(PointLockManagerTest, LockConflict) {
+TEST_P(PointLockManagerTest, LockConflict) {
   // Tests that lock conflicts lead to lock timeout.
   MockColumnFamilyHandle cf(1);
   locker_->AddColumnFamily(&cf);
@@ -230,9 +237,12 @@ TEST_F(PointLockManagerTest, LockConflict) {
 
 port::Thread BlockUntilWaitingTxn(std::function<void()> f) {
   std::atomic<bool> reached(false);
-  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
-      "PointLockManager::AcquireWithTimeout:WaitingTxn",
-      [&](void* /*arg*/) { reached.store(true); });
+  for (const char* point :
+       {"PointLockManager::AcquireWithTimeout:WaitingTxn",
+        "PerKeyPointLockManager::AcquireWithTimeout:WaitingTxn"}) {
+    ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+        point, [&](void* /*arg*/) { reached.store(true); });
+  }
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
 
   port::Thread t(f);
@@ -246,7 +256,7 @@ port::Thread BlockUntilWaitingTxn(std::function<void()> f) {
   return t;
 }
 
-TEST_F(PointLockManagerTest, SharedLocks) {
+TEST_P(PointLockManagerTest, SharedLocks) {
   // Tests that shared locks can be concurrently held by multiple transactions.
   MockColumnFamilyHandle cf(1);
   locker_->AddColumnFamily(&cf);
@@ -258,7 +268,7 @@ TEST_F(PointLockManagerTest, SharedLocks) {
   delete txn2;
 }
 
-TEST_F(PointLockManagerTest, Deadlock) {
+TEST_P(PointLockManagerTest, Deadlock) {
   // Tests that deadlock can be detected.
   // Deadlock scenario:
   // txn1 exclusively locks k1, and wants to lock k2;
@@ -308,7 +318,7 @@ TEST_F(PointLockManagerTest, Deadlock) {
   delete txn1;
 }
 
-TEST_F(PointLockManagerTest, DeadlockDepthExceeded) {
+TEST_P(PointLockManagerTest, DeadlockDepthExceeded) {
   // Tests that when detecting deadlock, if the detection depth is exceeded,
   // it's also viewed as deadlock.
   MockColumnFamilyHandle cf(1);
@@ -364,6 +374,115 @@ TEST_F(PointLockManagerTest, DeadlockDepthExceeded) {
   delete txn1;
 }
 
+TEST_P(PointLockManagerTest, SharedWaiters) {
+  // Tests that the transactions waiting for shared access to a key all get
+  // it once the exclusive lock on the key is released.
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 1000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+  auto txn3 = NewTxn(txn_opt);
+
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, true));
+  port::Thread t2 = BlockUntilWaitingTxn(
+      [&]() { ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, false)); });
+  port::Thread t3 = BlockUntilWaitingTxn(
+      [&]() { ASSERT_OK(locker_->TryLock(txn3, 1, "k", env_, false)); });
+
+  locker_->UnLock(txn1, 1, "k", env_);
+  t2.join();
+  t3.join();
+
+  auto s = locker_->GetPointLockStatus();
+  ASSERT_EQ(s.size(), 1u);
+  ASSERT_FALSE(s.begin()->second.exclusive);
+  ASSERT_EQ(s.begin()->second.ids.size(), 2u);
+
+  locker_->UnLock(txn2, 1, "k", env_);
+  locker_->UnLock(txn3, 1, "k", env_);
+  ASSERT_TRUE(locker_->GetPointLockStatus().empty());
+
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
+TEST_P(PointLockManagerTest, NoBargingAheadOfWaiters) {
+  if (!GetParam()) {
+    // PointLockManager grants a lock as soon as it is compatible.
+    return;
+  }
+  // Tests that a shared request waits behind an exclusive waiter, unless it
+  // comes from a holder of the lock.
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 1000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+  txn_opt.lock_timeout = 1000;
+  auto txn3 = NewTxn(txn_opt);
+
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, false));
+  port::Thread t2 = BlockUntilWaitingTxn(
+      [&]() { ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, true)); });
+  ASSERT_TRUE(locker_->TryLock(txn3, 1, "k", env_, false).IsTimedOut());
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, false));
+
+  locker_->UnLock(txn1, 1, "k", env_);
+  t2.join();
+  auto s = locker_->GetPointLockStatus();
+  ASSERT_EQ(s.size(), 1u);
+  ASSERT_TRUE(s.begin()->second.exclusive);
+  ASSERT_EQ(s.begin()->second.ids, std::vector<TransactionID>{txn2->GetID()});
+
+  locker_->UnLock(txn2, 1, "k", env_);
+  ASSERT_TRUE(locker_->GetPointLockStatus().empty());
+
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
+TEST_P(PointLockManagerTest, HotKey) {
+  // Tests that an exclusive lock on a key contended by many transactions is
+  // held by one of them at a time.
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.deadlock_detect = true;
+  txn_opt.lock_timeout = 10000000;
+
+  const int kNumThreads = 8;
+  const int kNumLocks = 200;
+  std::atomic<int> holders(0);
+  int counter = 0;
+  std::vector<port::Thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < kNumLocks; j++) {
+        auto txn = NewTxn(txn_opt);
+        ASSERT_OK(locker_->TryLock(txn, 1, "hot", env_, true));
+        ASSERT_EQ(holders.fetch_add(1), 0);
+        counter++;
+        holders.fetch_sub(1);
+        locker_->UnLock(txn, 1, "hot", env_);
+        delete txn;
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(counter, kNumThreads * kNumLocks);
+  ASSERT_TRUE(locker_->GetPointLockStatus().empty());
+}
+
+INSTANTIATE_TEST_CASE_P(PointLockManagerTest, PointLockManagerTest,
+                        ::testing::Bool());
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
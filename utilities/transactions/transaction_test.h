@@ -152,6 +152,13 @@ class TransactionTestBase : public ::testing::Test {
     return s;
   }
 
+  // The sync point reached by a transaction about to wait for a lock
+  const char* WaitingTxnSyncPoint() const {
+    return txn_db_options.use_per_key_point_lock_mgr
+               ? "PerKeyPointLockManager::AcquireWithTimeout:WaitingTxn"
+               : "PointLockManager::AcquireWithTimeout:WaitingTxn";
+  }
+
   Status OpenWithStackableDB(std::vector<ColumnFamilyDescriptor>& cfs,
                              std::vector<ColumnFamilyHandle*>* handles) {
     std::vector<size_t> compaction_enabled_cf_indices;
@@ -479,14 +486,20 @@ class TransactionTestBase : public ::testing::Test {
   }
 };
 
+// The last parameter tells whether to use PerKeyPointLockManager.
 class TransactionTest
     : public TransactionTestBase,
       virtual public ::testing::WithParamInterface<
-          std::tuple<bool, bool, TxnDBWritePolicy, WriteOrdering>> {
+          std::tuple<bool, bool, TxnDBWritePolicy, WriteOrdering, bool>> {
  public:
   TransactionTest()
       : TransactionTestBase(std::get<0>(GetParam()), std::get<1>(GetParam()),
-                            std::get<2>(GetParam()), std::get<3>(GetParam())){};
+                            std::get<2>(GetParam()), std::get<3>(GetParam())) {
+    if (std::get<4>(GetParam())) {
+      txn_db_options.use_per_key_point_lock_mgr = true;
+      EXPECT_OK(ReOpen());
+    }
+  };
 };
 
 class TransactionStressTest : public TransactionTest {};